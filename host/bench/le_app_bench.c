@@ -0,0 +1,405 @@
+/*******************************************************************************
+ * File Name: le_app_bench.c
+ *
+ * Description:
+ *   Benchmark of the GATT and management event handlers on the host. It drives
+ *   le_app_gatt_event_callback() and le_app_management_callback() with synthetic events and
+ *   reports the time and the heap and GATT buffer allocations per event.
+ *
+ *   Usage: le_app_bench [iterations]
+ *
+ * Related Document: See Readme.md
+ *
+ *******************************************************************************
+ * Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/*******************************************************************************
+ *        Header Files
+ *******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "host_harness.h"
+#include "le_app_event_handler.h"
+#include "le_app_gatts.h"
+#include "cycfg_gatt_db.h"
+
+/*******************************************************************************
+ *        Macro Definitions
+ *******************************************************************************/
+#define BENCH_ITERATIONS_DEFAULT        (100000u)
+#define BENCH_MTU                       (247u)
+#define BENCH_NS_PER_SEC                (1000000000ull)
+
+/*******************************************************************************
+ *        Structures and Enumerations
+ *******************************************************************************/
+typedef struct
+{
+    const char *name;
+    void (*run)(void);
+} bench_case_t;
+
+/*******************************************************************************
+ *        Variable Definitions
+ *******************************************************************************/
+/* Only allocations made by the handlers on the benchmark thread are counted */
+static __thread bool bench_counting;
+static __thread uint32_t bench_allocs;
+
+static const uint8_t bench_peer = 0x42;
+static uint8_t bench_write_value[2] = {0x01, 0x00};
+static uint8_t bench_alert_level[1] = {0x00};
+static uint8_t bench_read_multi_handles[4] = {0x03, 0x00, 0x05, 0x00};
+
+/*******************************************************************************
+ *        Function Prototypes
+ *******************************************************************************/
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_app_alloc_buffer(int len);
+
+/*******************************************************************************
+ *        Function Definitions
+ *******************************************************************************/
+
+/* Allocation counters, linked in with --wrap */
+void *__wrap_malloc(size_t size)
+{
+    if (bench_counting)
+    {
+        bench_allocs++;
+    }
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size)
+{
+    if (bench_counting)
+    {
+        bench_allocs++;
+    }
+    return __real_calloc(nmemb, size);
+}
+
+void *__wrap_app_alloc_buffer(int len)
+{
+    if (bench_counting)
+    {
+        bench_allocs++;
+    }
+    return __real_app_alloc_buffer(len);
+}
+
+static void bench_request(wiced_bt_gatt_opcode_t opcode, const wiced_bt_gatt_request_params_t *p_data)
+{
+    host_harness_request(HOST_HARNESS_CONN_ID, opcode, p_data, BENCH_MTU - 1);
+}
+
+static void bench_mgmt(wiced_bt_management_evt_t event, wiced_bt_management_evt_data_t *p_data)
+{
+    le_app_management_callback(event, p_data);
+}
+
+static void bench_peer_addr(wiced_bt_device_address_t bd_addr)
+{
+    const wiced_bt_device_address_t addr = {0x00, 0xA0, 0x50, 0x00, 0x00, bench_peer};
+
+    memcpy(bd_addr, addr, sizeof(wiced_bt_device_address_t));
+}
+
+static void bench_gatt_mtu(void)
+{
+    wiced_bt_gatt_request_params_t req = {.remote_mtu = BENCH_MTU};
+
+    bench_request(GATT_REQ_MTU, &req);
+}
+
+static void bench_gatt_read(void)
+{
+    wiced_bt_gatt_request_params_t req = {.read_req = {.handle = HDLC_GAP_DEVICE_NAME_VALUE}};
+
+    bench_request(GATT_REQ_READ, &req);
+}
+
+static void bench_gatt_read_blob(void)
+{
+    wiced_bt_gatt_request_params_t req = {.read_req = {.handle = HDLC_GAP_DEVICE_NAME_VALUE, .offset = 4}};
+
+    bench_request(GATT_REQ_READ_BLOB, &req);
+}
+
+static void bench_gatt_read_by_type(void)
+{
+    wiced_bt_gatt_request_params_t req = {.read_by_type = {.s_handle = 0x0001, .e_handle = 0xFFFF}};
+
+    req.read_by_type.uuid.len = LEN_UUID_16;
+    req.read_by_type.uuid.uu.uuid16 = 0x2A00;
+    bench_request(GATT_REQ_READ_BY_TYPE, &req);
+}
+
+static void bench_gatt_read_multi(void)
+{
+    wiced_bt_gatt_request_params_t req = {.read_multiple_req = {.num_handles = 2,
+                                                                .p_handle_stream = bench_read_multi_handles}};
+
+    bench_request(GATT_REQ_READ_MULTI, &req);
+}
+
+static void bench_gatt_write(void)
+{
+    wiced_bt_gatt_request_params_t req = {.write_req = {.handle = HDLD_GATT_SERVICE_CHANGED_CLIENT_CHAR_CONFIG,
+                                                        .val_len = sizeof(bench_write_value),
+                                                        .p_val = bench_write_value}};
+
+    bench_request(GATT_REQ_WRITE, &req);
+}
+
+static void bench_gatt_write_cmd(void)
+{
+    wiced_bt_gatt_request_params_t req = {.write_req = {.handle = HDLC_IAS_ALERT_LEVEL_VALUE,
+                                                        .val_len = sizeof(bench_alert_level),
+                                                        .p_val = bench_alert_level}};
+
+    bench_request(GATT_CMD_WRITE, &req);
+}
+
+static void bench_gatt_prepare_execute(void)
+{
+    wiced_bt_gatt_request_params_t req = {.write_req = {.handle = HDLD_GATT_SERVICE_CHANGED_CLIENT_CHAR_CONFIG,
+                                                        .val_len = sizeof(bench_write_value),
+                                                        .p_val = bench_write_value}};
+
+    bench_request(GATT_REQ_PREPARE_WRITE, &req);
+    memset(&req, 0, sizeof(req));
+    req.exec_write_req.exec_write = GATT_PREPARE_WRITE_EXEC;
+    bench_request(GATT_REQ_EXECUTE_WRITE, &req);
+}
+
+static void bench_gatt_confirm(void)
+{
+    wiced_bt_gatt_request_params_t req = {.confirm = HDLC_IAS_ALERT_LEVEL_VALUE};
+
+    bench_request(GATT_HANDLE_VALUE_CONF, &req);
+}
+
+static void bench_gatt_rsp_buffer(void)
+{
+    wiced_bt_gatt_event_data_t event_data;
+
+    memset(&event_data, 0, sizeof(event_data));
+    event_data.buffer_request.len_requested = BENCH_MTU - 1;
+    le_app_gatt_event_callback(GATT_GET_RESPONSE_BUFFER_EVT, &event_data);
+
+    event_data.buffer_xmitted.p_app_data = event_data.buffer_request.buffer.p_app_rsp_buffer;
+    event_data.buffer_xmitted.p_app_ctxt = event_data.buffer_request.buffer.p_app_ctxt;
+    le_app_gatt_event_callback(GATT_APP_BUFFER_TRANSMITTED_EVT, &event_data);
+}
+
+static void bench_mgmt_io_caps(void)
+{
+    wiced_bt_management_evt_data_t data;
+
+    memset(&data, 0, sizeof(data));
+    bench_peer_addr(data.pairing_io_capabilities_ble_request.bd_addr);
+    bench_mgmt(BTM_PAIRING_IO_CAPABILITIES_BLE_REQUEST_EVT, &data);
+}
+
+static void bench_mgmt_security_request(void)
+{
+    wiced_bt_management_evt_data_t data;
+
+    memset(&data, 0, sizeof(data));
+    bench_peer_addr(data.security_request.bd_addr);
+    bench_mgmt(BTM_SECURITY_REQUEST_EVT, &data);
+}
+
+static void bench_mgmt_link_keys_request(void)
+{
+    wiced_bt_management_evt_data_t data;
+
+    memset(&data, 0, sizeof(data));
+    bench_peer_addr(data.paired_device_link_keys_request.bd_addr);
+    bench_mgmt(BTM_PAIRED_DEVICE_LINK_KEYS_REQUEST_EVT, &data);
+}
+
+static void bench_mgmt_local_keys_request(void)
+{
+    wiced_bt_management_evt_data_t data;
+
+    memset(&data, 0, sizeof(data));
+    bench_mgmt(BTM_LOCAL_IDENTITY_KEYS_REQUEST_EVT, &data);
+}
+
+static void bench_mgmt_advert_state(void)
+{
+    wiced_bt_management_evt_data_t data;
+
+    memset(&data, 0, sizeof(data));
+    data.ble_advert_state_changed = BTM_BLE_ADVERT_UNDIRECTED_LOW;
+    bench_mgmt(BTM_BLE_ADVERT_STATE_CHANGED_EVT, &data);
+}
+
+static void bench_mgmt_data_length(void)
+{
+    wiced_bt_management_evt_data_t data;
+
+    memset(&data, 0, sizeof(data));
+    bench_peer_addr(data.ble_data_length_update_event.bd_address);
+    data.ble_data_length_update_event.max_tx_octets = 251;
+    data.ble_data_length_update_event.max_tx_time = 2120;
+    data.ble_data_length_update_event.max_rx_octets = 251;
+    data.ble_data_length_update_event.max_rx_time = 2120;
+    bench_mgmt(BTM_BLE_DATA_LENGTH_UPDATE_EVENT, &data);
+}
+
+static void bench_mgmt_phy_update(void)
+{
+    wiced_bt_management_evt_data_t data;
+
+    memset(&data, 0, sizeof(data));
+    bench_peer_addr(data.ble_phy_update_event.bd_address);
+    data.ble_phy_update_event.tx_phy = 2;
+    data.ble_phy_update_event.rx_phy = 2;
+    bench_mgmt(BTM_BLE_PHY_UPDATE_EVT, &data);
+}
+
+static void bench_mgmt_conn_param_update(void)
+{
+    wiced_bt_management_evt_data_t data;
+
+    memset(&data, 0, sizeof(data));
+    bench_peer_addr(data.ble_connection_param_update.bd_addr);
+    data.ble_connection_param_update.conn_interval = 24;
+    data.ble_connection_param_update.supervision_timeout = 500;
+    bench_mgmt(BTM_BLE_CONNECTION_PARAM_UPDATE, &data);
+}
+
+static const bench_case_t bench_cases[] =
+{
+    {"GATT_REQ_MTU",                            bench_gatt_mtu},
+    {"GATT_REQ_READ",                           bench_gatt_read},
+    {"GATT_REQ_READ_BLOB",                      bench_gatt_read_blob},
+    {"GATT_REQ_READ_BY_TYPE",                   bench_gatt_read_by_type},
+    {"GATT_REQ_READ_MULTI",                     bench_gatt_read_multi},
+    {"GATT_REQ_WRITE",                          bench_gatt_write},
+    {"GATT_CMD_WRITE",                          bench_gatt_write_cmd},
+    {"GATT_REQ_PREPARE_WRITE+EXECUTE_WRITE",    bench_gatt_prepare_execute},
+    {"GATT_HANDLE_VALUE_CONF",                  bench_gatt_confirm},
+    {"GATT_GET_RESPONSE_BUFFER_EVT+TRANSMITTED", bench_gatt_rsp_buffer},
+    {"BTM_PAIRING_IO_CAPABILITIES_BLE_REQUEST", bench_mgmt_io_caps},
+    {"BTM_SECURITY_REQUEST_EVT",                bench_mgmt_security_request},
+    {"BTM_PAIRED_DEVICE_LINK_KEYS_REQUEST_EVT", bench_mgmt_link_keys_request},
+    {"BTM_LOCAL_IDENTITY_KEYS_REQUEST_EVT",     bench_mgmt_local_keys_request},
+    {"BTM_BLE_ADVERT_STATE_CHANGED_EVT",        bench_mgmt_advert_state},
+    {"BTM_BLE_DATA_LENGTH_UPDATE_EVENT",        bench_mgmt_data_length},
+    {"BTM_BLE_PHY_UPDATE_EVT",                  bench_mgmt_phy_update},
+    {"BTM_BLE_CONNECTION_PARAM_UPDATE",         bench_mgmt_conn_param_update},
+};
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * BENCH_NS_PER_SEC) + (uint64_t)ts.tv_nsec;
+}
+
+/* Runs one case; the responses queued by the stub are released as the stack would after each event */
+static void bench_run(const bench_case_t *p_case, uint32_t iterations, FILE *out)
+{
+    uint64_t start_ns;
+    uint64_t elapsed_ns;
+    uint32_t allocs;
+
+    for (uint32_t i = 0; i < (iterations / 10u) + 1u; i++)
+    {
+        p_case->run();
+        host_bt_complete_tx();
+    }
+
+    bench_allocs = 0;
+    bench_counting = true;
+    start_ns = bench_now_ns();
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        p_case->run();
+        host_bt_complete_tx();
+    }
+    elapsed_ns = bench_now_ns() - start_ns;
+    bench_counting = false;
+    allocs = bench_allocs;
+
+    fprintf(out, "%-42s %10.1f ns/op %8.2f allocs/op\n", p_case->name,
+            (double)elapsed_ns / iterations, (double)allocs / iterations);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t iterations = BENCH_ITERATIONS_DEFAULT;
+    wiced_bt_gatt_request_params_t mtu_req = {.remote_mtu = BENCH_MTU};
+    FILE *out;
+
+    if (argc > 1)
+    {
+        iterations = (uint32_t)strtoul(argv[1], NULL, 0);
+        if (0 == iterations)
+        {
+            fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    host_harness_start(true);
+    out = host_harness_out();
+
+    /* One connection with a large MTU, as most handlers need a link */
+    if ((WICED_BT_GATT_SUCCESS != host_harness_connect(HOST_HARNESS_CONN_ID, bench_peer, true)) ||
+        (WICED_BT_GATT_SUCCESS != host_harness_request(HOST_HARNESS_CONN_ID, GATT_REQ_MTU, &mtu_req, 0)))
+    {
+        fprintf(out, "failed to connect\n");
+        return EXIT_FAILURE;
+    }
+    host_bt_complete_tx();
+
+    fprintf(out, "%u iterations per event\n", (unsigned)iterations);
+    for (size_t i = 0; i < sizeof(bench_cases) / sizeof(bench_cases[0]); i++)
+    {
+        bench_run(&bench_cases[i], iterations, out);
+    }
+
+    fflush(out);
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
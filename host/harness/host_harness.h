@@ -0,0 +1,162 @@
+/*******************************************************************************
+* File Name: host_harness.h
+*
+* Description:
+*   Helpers shared by the host tests and the benchmark: they start the application and
+*   deliver connection and attribute request events as the stack would
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef HOST_HARNESS_H_
+#define HOST_HARNESS_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include <stdbool.h>
+#include <stdio.h>
+#include "wiced_bt_gatt.h"
+#include "host_stub.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Connection ID used by the helpers when the caller does not need its own */
+#define HOST_HARNESS_CONN_ID            (0x8001u)
+
+/* Fails the calling test with the location of the check */
+#define HOST_CHECK(cond)                                                         \
+    do                                                                          \
+    {                                                                           \
+        if (!(cond))                                                            \
+        {                                                                       \
+            host_harness_fail(__FILE__, __LINE__, #cond);                       \
+        }                                                                       \
+    } while (0)
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+
+/**************************************************************************************************
+* Function Name: host_harness_start
+***************************************************************************************************
+* Summary:
+*   This function starts the application through main() of main.c, which brings up the log and
+*   application threads and the stack. The console output of the application is discarded if
+*   quiet; host_harness_out() still writes to the console.
+*
+* Parameters:
+*   bool quiet                  : true to discard the console output of the application
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void host_harness_start(bool quiet);
+
+/**************************************************************************************************
+* Function Name: host_harness_out
+***************************************************************************************************
+* Summary:
+*   This function returns the stream for the output of the test or benchmark.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  FILE *: Console stream
+*
+**************************************************************************************************/
+FILE *host_harness_out(void);
+
+/**************************************************************************************************
+* Function Name: host_harness_connect
+***************************************************************************************************
+* Summary:
+*   This function reports a connection, or a disconnection, to the application.
+*
+* Parameters:
+*   uint16_t conn_id            : Connection ID
+*   uint8_t peer                : Last byte of the peer address
+*   bool connected              : true for a connection, false for a disconnection
+*
+* Return:
+*  wiced_bt_gatt_status_t: Status of le_app_gatt_event_callback()
+*
+**************************************************************************************************/
+wiced_bt_gatt_status_t host_harness_connect(uint16_t conn_id, uint8_t peer, bool connected);
+
+/**************************************************************************************************
+* Function Name: host_harness_request
+***************************************************************************************************
+* Summary:
+*   This function delivers an attribute request to the application.
+*
+* Parameters:
+*   uint16_t conn_id                            : Connection ID
+*   wiced_bt_gatt_opcode_t opcode               : Opcode
+*   const wiced_bt_gatt_request_params_t *p_data: Request parameters
+*   uint16_t len_requested                      : Response length the stack allows
+*
+* Return:
+*  wiced_bt_gatt_status_t: Status of le_app_gatt_event_callback()
+*
+**************************************************************************************************/
+wiced_bt_gatt_status_t host_harness_request(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                                            const wiced_bt_gatt_request_params_t *p_data,
+                                            uint16_t len_requested);
+
+/**************************************************************************************************
+* Function Name: host_harness_fail
+***************************************************************************************************
+* Summary:
+*   This function reports a failed check and ends the process with a failure. Use HOST_CHECK().
+*
+* Parameters:
+*   const char *file            : Source file of the check
+*   int line                    : Line of the check
+*   const char *cond            : Condition that failed
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void host_harness_fail(const char *file, int line, const char *cond) __attribute__((noreturn));
+
+#endif /* HOST_HARNESS_H_ */
+
+/* [] END OF FILE */
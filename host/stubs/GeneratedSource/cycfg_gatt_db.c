@@ -0,0 +1,119 @@
+/*******************************************************************************
+ * File Name: cycfg_gatt_db.c
+ *
+ * Description:
+ *   Host copy of the GATT database that the Bluetooth Configurator generates from
+ *   design.cybt, in the layout of the host wiced_bt_gatt.h
+ *
+ * Related Document: See Readme.md
+ *
+ *******************************************************************************
+ * Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/*******************************************************************************
+ *        Header Files
+ *******************************************************************************/
+#include "cycfg_gatt_db.h"
+
+/*******************************************************************************
+ *        Variable Definitions
+ *******************************************************************************/
+const uint8_t gatt_database[] =
+{
+    /* Primary Service: Generic Access */
+    PRIMARY_SERVICE_UUID16(HDLS_GAP, __UUID_SERVICE_GENERIC_ACCESS),
+        CHARACTERISTIC_UUID16(HDLC_GAP_DEVICE_NAME, HDLC_GAP_DEVICE_NAME_VALUE,
+                              __UUID_CHARACTERISTIC_DEVICE_NAME,
+                              GATTDB_CHAR_PROP_READ, GATTDB_PERM_READABLE),
+        CHARACTERISTIC_UUID16(HDLC_GAP_APPEARANCE, HDLC_GAP_APPEARANCE_VALUE,
+                              __UUID_CHARACTERISTIC_APPEARANCE,
+                              GATTDB_CHAR_PROP_READ, GATTDB_PERM_READABLE),
+
+    /* Primary Service: Generic Attribute */
+    PRIMARY_SERVICE_UUID16(HDLS_GATT, __UUID_SERVICE_GENERIC_ATTRIBUTE),
+        CHARACTERISTIC_UUID16(HDLC_GATT_SERVICE_CHANGED, HDLC_GATT_SERVICE_CHANGED_VALUE,
+                              __UUID_CHARACTERISTIC_SERVICE_CHANGED,
+                              GATTDB_CHAR_PROP_INDICATE, GATTDB_PERM_NONE),
+            CHAR_DESCRIPTOR_UUID16_WRITABLE(HDLD_GATT_SERVICE_CHANGED_CLIENT_CHAR_CONFIG,
+                                            __UUID_DESCRIPTOR_CLIENT_CHARACTERISTIC_CONFIGURATION,
+                                            GATTDB_PERM_READABLE | GATTDB_PERM_WRITE_REQ),
+        CHARACTERISTIC_UUID16_WRITABLE(HDLC_GATT_CLIENT_SUPPORTED_FEATURES,
+                                       HDLC_GATT_CLIENT_SUPPORTED_FEATURES_VALUE,
+                                       __UUID_CHARACTERISTIC_CLIENT_SUPPORTED_FEATURES,
+                                       GATTDB_CHAR_PROP_READ | GATTDB_CHAR_PROP_WRITE,
+                                       GATTDB_PERM_READABLE | GATTDB_PERM_WRITE_REQ),
+        CHARACTERISTIC_UUID16(HDLC_GATT_DATABASE_HASH, HDLC_GATT_DATABASE_HASH_VALUE,
+                              __UUID_CHARACTERISTIC_DATABASE_HASH,
+                              GATTDB_CHAR_PROP_READ, GATTDB_PERM_READABLE),
+
+    /* Primary Service: Immediate Alert */
+    PRIMARY_SERVICE_UUID16(HDLS_IAS, __UUID_SERVICE_IMMEDIATE_ALERT),
+        CHARACTERISTIC_UUID16_WRITABLE(HDLC_IAS_ALERT_LEVEL, HDLC_IAS_ALERT_LEVEL_VALUE,
+                                       __UUID_CHARACTERISTIC_ALERT_LEVEL,
+                                       GATTDB_CHAR_PROP_WRITE_NO_RESPONSE, GATTDB_PERM_WRITE_CMD),
+};
+
+const uint16_t gatt_database_len = sizeof(gatt_database);
+
+uint8_t app_gap_device_name[]                           = {'F', 'i', 'n', 'd', ' ', 'M', 'e', ' ',
+                                                           'T', 'a', 'r', 'g', 'e', 't'};
+uint8_t app_gap_appearance[]                            = {0x00, 0x00};
+uint8_t app_gatt_service_changed[]                      = {0x00, 0x00, 0x00, 0x00};
+uint8_t app_gatt_service_changed_client_char_config[]   = {0x00, 0x00};
+uint8_t app_gatt_client_supported_features[]            = {0x00};
+uint8_t app_gatt_database_hash[]                        = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                                           0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+uint8_t app_ias_alert_level[]                           = {0x00};
+
+gatt_db_lookup_table_t app_gatt_db_ext_attr_tbl[] =
+{
+    /* { attribute handle, max length, actual length, pointer to data } */
+    {HDLC_GAP_DEVICE_NAME_VALUE, sizeof(app_gap_device_name), sizeof(app_gap_device_name),
+     app_gap_device_name},
+    {HDLC_GAP_APPEARANCE_VALUE, sizeof(app_gap_appearance), sizeof(app_gap_appearance),
+     app_gap_appearance},
+    {HDLC_GATT_SERVICE_CHANGED_VALUE, sizeof(app_gatt_service_changed), sizeof(app_gatt_service_changed),
+     app_gatt_service_changed},
+    {HDLD_GATT_SERVICE_CHANGED_CLIENT_CHAR_CONFIG, sizeof(app_gatt_service_changed_client_char_config),
+     sizeof(app_gatt_service_changed_client_char_config), app_gatt_service_changed_client_char_config},
+    {HDLC_GATT_CLIENT_SUPPORTED_FEATURES_VALUE, sizeof(app_gatt_client_supported_features),
+     sizeof(app_gatt_client_supported_features), app_gatt_client_supported_features},
+    {HDLC_GATT_DATABASE_HASH_VALUE, sizeof(app_gatt_database_hash), sizeof(app_gatt_database_hash),
+     app_gatt_database_hash},
+    {HDLC_IAS_ALERT_LEVEL_VALUE, sizeof(app_ias_alert_level), sizeof(app_ias_alert_level),
+     app_ias_alert_level},
+};
+
+const uint16_t app_gatt_db_ext_attr_tbl_size = (sizeof(app_gatt_db_ext_attr_tbl) / sizeof(gatt_db_lookup_table_t));
+
+/* [] END OF FILE */
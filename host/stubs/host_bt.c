@@ -0,0 +1,1372 @@
+/*******************************************************************************
+ * File Name: host_bt.c
+ *
+ * Description:
+ *   Host implementation of the btstack API that the application uses. It records what the
+ *   application sends, holds transmitted buffers until host_bt_complete_tx() and keeps the
+ *   stack timers for host_time_advance()
+ *
+ * Related Document: See Readme.md
+ *
+ *******************************************************************************
+ * Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/*******************************************************************************
+ *        Header Files
+ *******************************************************************************/
+#include <pthread.h>
+#include <string.h>
+#include "wiced_bt_stack.h"
+#include "wiced_bt_ble.h"
+#include "wiced_bt_gatt.h"
+#include "wiced_timer.h"
+#include "host_stub.h"
+
+/*******************************************************************************
+ *        Macro Definitions
+ *******************************************************************************/
+/* Buffers the stack may hold before host_bt_complete_tx() */
+#define HOST_BT_TX_QUEUE_SIZE           (256u)
+
+/* Header of an attribute in the host database: handle, permission and type length */
+#define HOST_BT_DB_ATTR_HDR_SIZE        (4u)
+
+#define HOST_BT_FNV_OFFSET              (0xCBF29CE484222325ull)
+#define HOST_BT_FNV_PRIME               (0x00000100000001B3ull)
+
+/*******************************************************************************
+ *        Structures and Enumerations
+ *******************************************************************************/
+/* Buffer the application handed to a send function with a free callback */
+typedef struct
+{
+    uint8_t *p_data;
+    void *p_ctxt;
+} host_bt_tx_t;
+
+/*******************************************************************************
+ *        Variable Definitions
+ *******************************************************************************/
+static pthread_mutex_t host_bt_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static wiced_bt_management_cback_t *host_bt_management_cback;
+static wiced_bt_gatt_cback_t *host_bt_gatt_cback;
+
+static wiced_bt_device_address_t host_bt_local_bdaddr;
+
+static const uint8_t *host_bt_db;
+static uint32_t host_bt_db_len;
+
+static host_gatt_rsp_t host_bt_last_rsp;
+static host_bt_calls_t host_bt_call_counts;
+
+static host_bt_tx_t host_bt_tx_queue[HOST_BT_TX_QUEUE_SIZE];
+static uint32_t host_bt_tx_count;
+static bool host_bt_tx_stalled;
+
+static wiced_bt_dev_cmpl_cback_t *host_bt_rssi_cback;
+static wiced_bt_device_address_t host_bt_rssi_bdaddr;
+
+static wiced_timer_t *host_bt_timer_list;
+
+/*******************************************************************************
+ *        Function Prototypes
+ *******************************************************************************/
+static wiced_bt_gatt_status_t host_bt_record(host_gatt_rsp_type_t type, uint16_t conn_id,
+                                             wiced_bt_gatt_opcode_t opcode, uint16_t handle,
+                                             wiced_bt_gatt_status_t status, uint16_t offset,
+                                             uint16_t len, const uint8_t *p_data, void *p_app_ctx);
+static uint16_t host_bt_get_u16(const uint8_t *p);
+static void host_bt_put_u16(uint8_t *p, uint16_t value);
+
+/*******************************************************************************
+ *        Function Definitions
+ *******************************************************************************/
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_stack_init
+ ***************************************************************************************************
+ * Summary:
+ *   This function registers the management callback and reports BTM_ENABLED_EVT to it before
+ *   returning, as the host has no controller to wait for.
+ *
+ * Parameters:
+ *   wiced_bt_management_cback_t *p_bt_management_cback  : Management callback
+ *   const wiced_bt_cfg_settings_t *p_bt_cfg_settings    : Unused
+ *
+ * Return:
+ *  wiced_result_t: WICED_BT_SUCCESS
+ *
+ **************************************************************************************************/
+wiced_result_t wiced_bt_stack_init(wiced_bt_management_cback_t *p_bt_management_cback,
+                                   const wiced_bt_cfg_settings_t *p_bt_cfg_settings)
+{
+    wiced_bt_management_evt_data_t event_data;
+
+    (void)p_bt_cfg_settings;
+
+    host_bt_management_cback = p_bt_management_cback;
+
+    memset(&event_data, 0, sizeof(event_data));
+    event_data.enabled.status = WICED_BT_SUCCESS;
+    host_bt_management_cback(BTM_ENABLED_EVT, &event_data);
+
+    return WICED_BT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_set_local_bdaddr
+ ***************************************************************************************************
+ * Summary:
+ *   This function sets the local Bluetooth device address.
+ *
+ * Parameters:
+ *   wiced_bt_device_address_t bd_addr       : Address
+ *   wiced_bt_ble_address_type_t addr_type   : Unused
+ *
+ * Return:
+ *  wiced_result_t: WICED_BT_SUCCESS
+ *
+ **************************************************************************************************/
+wiced_result_t wiced_bt_set_local_bdaddr(wiced_bt_device_address_t bd_addr, wiced_bt_ble_address_type_t addr_type)
+{
+    (void)addr_type;
+    memcpy(host_bt_local_bdaddr, bd_addr, BD_ADDR_LEN);
+
+    return WICED_BT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_dev_read_local_addr
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns the local Bluetooth device address.
+ *
+ * Parameters:
+ *   wiced_bt_device_address_t bd_addr   : Returns the address
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void wiced_bt_dev_read_local_addr(wiced_bt_device_address_t bd_addr)
+{
+    memcpy(bd_addr, host_bt_local_bdaddr, BD_ADDR_LEN);
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_set_pairable_mode
+ ***************************************************************************************************
+ * Summary:
+ *   This function sets the pairable mode. The host accepts every pairing.
+ *
+ * Parameters:
+ *   uint8_t allow_pairing           : Unused
+ *   uint8_t connect_only_paired     : Unused
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void wiced_bt_set_pairable_mode(uint8_t allow_pairing, uint8_t connect_only_paired)
+{
+    (void)allow_pairing;
+    (void)connect_only_paired;
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_dev_read_rssi
+ ***************************************************************************************************
+ * Summary:
+ *   This function starts an RSSI read. The result is reported by host_bt_complete_rssi().
+ *
+ * Parameters:
+ *   wiced_bt_device_address_t remote_bda    : Peer
+ *   wiced_bt_transport_t transport          : Unused
+ *   wiced_bt_dev_cmpl_cback_t *p_cback      : Result callback
+ *
+ * Return:
+ *  wiced_result_t: WICED_BT_PENDING
+ *
+ **************************************************************************************************/
+wiced_result_t wiced_bt_dev_read_rssi(wiced_bt_device_address_t remote_bda, wiced_bt_transport_t transport,
+                                      wiced_bt_dev_cmpl_cback_t *p_cback)
+{
+    (void)transport;
+
+    pthread_mutex_lock(&host_bt_lock);
+    memcpy(host_bt_rssi_bdaddr, remote_bda, BD_ADDR_LEN);
+    host_bt_rssi_cback = p_cback;
+    host_bt_call_counts.rssi_reads++;
+    pthread_mutex_unlock(&host_bt_lock);
+
+    return WICED_BT_PENDING;
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_dev_add_device_to_address_resolution_db
+ ***************************************************************************************************
+ * Summary:
+ *   This function adds a peer to the resolving list.
+ *
+ * Parameters:
+ *   wiced_bt_device_link_keys_t *p_link_keys    : Unused
+ *
+ * Return:
+ *  wiced_result_t: WICED_BT_SUCCESS
+ *
+ **************************************************************************************************/
+wiced_result_t wiced_bt_dev_add_device_to_address_resolution_db(wiced_bt_device_link_keys_t *p_link_keys)
+{
+    (void)p_link_keys;
+
+    return WICED_BT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_dev_remove_device_from_address_resolution_db
+ ***************************************************************************************************
+ * Summary:
+ *   This function removes a peer from the resolving list.
+ *
+ * Parameters:
+ *   wiced_bt_device_link_keys_t *p_link_keys    : Unused
+ *
+ * Return:
+ *  wiced_result_t: WICED_BT_SUCCESS
+ *
+ **************************************************************************************************/
+wiced_result_t wiced_bt_dev_remove_device_from_address_resolution_db(wiced_bt_device_link_keys_t *p_link_keys)
+{
+    (void)p_link_keys;
+
+    return WICED_BT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_dev_delete_bonded_device
+ ***************************************************************************************************
+ * Summary:
+ *   This function removes the keys of a peer from the stack.
+ *
+ * Parameters:
+ *   wiced_bt_device_address_t bd_addr   : Unused
+ *
+ * Return:
+ *  wiced_result_t: WICED_BT_SUCCESS
+ *
+ **************************************************************************************************/
+wiced_result_t wiced_bt_dev_delete_bonded_device(wiced_bt_device_address_t bd_addr)
+{
+    (void)bd_addr;
+
+    return WICED_BT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_app_event_serialize
+ ***************************************************************************************************
+ * Summary:
+ *   This function runs a function in the stack context. The caller of the host stubs is the
+ *   stack context, so the function runs at once.
+ *
+ * Parameters:
+ *   int (*fn)(void *)           : Function to run
+ *   void *data                  : Its argument
+ *
+ * Return:
+ *  wiced_result_t: WICED_BT_SUCCESS
+ *
+ **************************************************************************************************/
+wiced_result_t wiced_app_event_serialize(int (*fn)(void *), void *data)
+{
+    fn(data);
+
+    return WICED_BT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_ble_set_raw_advertisement_data
+ ***************************************************************************************************
+ * Summary:
+ *   This function sets the advertisement data.
+ *
+ * Parameters:
+ *   uint8_t num_elem                        : Unused
+ *   wiced_bt_ble_advert_elem_t *p_data      : Unused
+ *
+ * Return:
+ *  wiced_result_t: WICED_BT_SUCCESS
+ *
+ **************************************************************************************************/
+wiced_result_t wiced_bt_ble_set_raw_advertisement_data(uint8_t num_elem, wiced_bt_ble_advert_elem_t *p_data)
+{
+    (void)num_elem;
+    (void)p_data;
+
+    return WICED_BT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_start_advertisements
+ ***************************************************************************************************
+ * Summary:
+ *   This function records the requested advertising mode. BTM_BLE_ADVERT_STATE_CHANGED_EVT is
+ *   left to the caller of the host stubs.
+ *
+ * Parameters:
+ *   wiced_bt_ble_advert_mode_t advert_mode                          : Mode
+ *   wiced_bt_ble_address_type_t directed_advertisement_bdaddr_type  : Unused
+ *   wiced_bt_device_address_t directed_advertisement_bdaddr_ptr     : Unused
+ *
+ * Return:
+ *  wiced_result_t: WICED_BT_SUCCESS
+ *
+ **************************************************************************************************/
+wiced_result_t wiced_bt_start_advertisements(wiced_bt_ble_advert_mode_t advert_mode,
+                                             wiced_bt_ble_address_type_t directed_advertisement_bdaddr_type,
+                                             wiced_bt_device_address_t directed_advertisement_bdaddr_ptr)
+{
+    (void)directed_advertisement_bdaddr_type;
+    (void)directed_advertisement_bdaddr_ptr;
+
+    pthread_mutex_lock(&host_bt_lock);
+    host_bt_call_counts.adv_starts++;
+    host_bt_call_counts.adv_mode = advert_mode;
+    pthread_mutex_unlock(&host_bt_lock);
+
+    return WICED_BT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_ble_set_phy
+ ***************************************************************************************************
+ * Summary:
+ *   This function records the requested PHY preferences.
+ *
+ * Parameters:
+ *   wiced_bt_ble_phy_preferences_t *p_phy_preferences   : Preferences
+ *
+ * Return:
+ *  wiced_result_t: WICED_BT_SUCCESS
+ *
+ **************************************************************************************************/
+wiced_result_t wiced_bt_ble_set_phy(wiced_bt_ble_phy_preferences_t *p_phy_preferences)
+{
+    pthread_mutex_lock(&host_bt_lock);
+    host_bt_call_counts.set_phy++;
+    host_bt_call_counts.phy_preferences = *p_phy_preferences;
+    pthread_mutex_unlock(&host_bt_lock);
+
+    return WICED_BT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_ble_set_data_packet_length
+ ***************************************************************************************************
+ * Summary:
+ *   This function records a data length update.
+ *
+ * Parameters:
+ *   wiced_bt_device_address_t bd_addr   : Unused
+ *   uint16_t tx_pdu_length              : Unused
+ *   uint16_t tx_time                    : Unused
+ *
+ * Return:
+ *  wiced_result_t: WICED_BT_SUCCESS
+ *
+ **************************************************************************************************/
+wiced_result_t wiced_bt_ble_set_data_packet_length(wiced_bt_device_address_t bd_addr, uint16_t tx_pdu_length,
+                                                   uint16_t tx_time)
+{
+    (void)bd_addr;
+    (void)tx_pdu_length;
+    (void)tx_time;
+
+    pthread_mutex_lock(&host_bt_lock);
+    host_bt_call_counts.data_length_updates++;
+    pthread_mutex_unlock(&host_bt_lock);
+
+    return WICED_BT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_ble_security_grant
+ ***************************************************************************************************
+ * Summary:
+ *   This function answers a security request of the peer.
+ *
+ * Parameters:
+ *   wiced_bt_device_address_t bd_addr   : Unused
+ *   uint8_t res                         : Unused
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void wiced_bt_ble_security_grant(wiced_bt_device_address_t bd_addr, uint8_t res)
+{
+    (void)bd_addr;
+    (void)res;
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_l2cap_update_ble_conn_params
+ ***************************************************************************************************
+ * Summary:
+ *   This function records a connection parameter update request.
+ *
+ * Parameters:
+ *   wiced_bt_device_address_t rem_bdRa  : Unused
+ *   uint16_t min_int                    : Unused
+ *   uint16_t max_int                    : Unused
+ *   uint16_t latency                    : Unused
+ *   uint16_t timeout                    : Unused
+ *
+ * Return:
+ *  wiced_bool_t: WICED_TRUE
+ *
+ **************************************************************************************************/
+wiced_bool_t wiced_bt_l2cap_update_ble_conn_params(wiced_bt_device_address_t rem_bdRa, uint16_t min_int,
+                                                   uint16_t max_int, uint16_t latency, uint16_t timeout)
+{
+    (void)rem_bdRa;
+    (void)min_int;
+    (void)max_int;
+    (void)latency;
+    (void)timeout;
+
+    pthread_mutex_lock(&host_bt_lock);
+    host_bt_call_counts.conn_params_updates++;
+    pthread_mutex_unlock(&host_bt_lock);
+
+    return WICED_TRUE;
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_gatt_register
+ ***************************************************************************************************
+ * Summary:
+ *   This function registers the GATT event callback.
+ *
+ * Parameters:
+ *   wiced_bt_gatt_cback_t *p_gatt_cback     : Callback
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_SUCCESS
+ *
+ **************************************************************************************************/
+wiced_bt_gatt_status_t wiced_bt_gatt_register(wiced_bt_gatt_cback_t *p_gatt_cback)
+{
+    host_bt_gatt_cback = p_gatt_cback;
+
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_gatt_db_init
+ ***************************************************************************************************
+ * Summary:
+ *   This function keeps the database for the handle lookups and writes its hash. The hash is
+ *   FNV-1a rather than the AES-CMAC of the specification; it only has to change with the
+ *   database.
+ *
+ * Parameters:
+ *   const uint8_t *p_gatt_db    : Database, kept by the caller
+ *   uint32_t gatt_db_size       : Database length
+ *   wiced_bt_db_hash_t hash     : Returns the database hash
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_SUCCESS
+ *
+ **************************************************************************************************/
+wiced_bt_gatt_status_t wiced_bt_gatt_db_init(const uint8_t *p_gatt_db, uint32_t gatt_db_size,
+                                             wiced_bt_db_hash_t hash)
+{
+    uint64_t fnv[2] = {HOST_BT_FNV_OFFSET, HOST_BT_FNV_OFFSET ^ gatt_db_size};
+
+    host_bt_db = p_gatt_db;
+    host_bt_db_len = gatt_db_size;
+
+    for (uint32_t i = 0; i < gatt_db_size; i++)
+    {
+        fnv[0] = (fnv[0] ^ p_gatt_db[i]) * HOST_BT_FNV_PRIME;
+        fnv[1] = (fnv[1] ^ p_gatt_db[gatt_db_size - 1u - i]) * HOST_BT_FNV_PRIME;
+    }
+    if (NULL != hash)
+    {
+        memcpy(hash, fnv, sizeof(wiced_bt_db_hash_t));
+    }
+
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_gatt_find_handle_by_type
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns the first attribute of a type in a handle range.
+ *
+ * Parameters:
+ *   uint16_t s_handle           : First handle of the range
+ *   uint16_t e_handle           : Last handle of the range
+ *   wiced_bt_uuid_t *p_uuid     : Attribute type
+ *
+ * Return:
+ *  uint16_t: Handle, or 0 if the range holds no attribute of the type
+ *
+ **************************************************************************************************/
+uint16_t wiced_bt_gatt_find_handle_by_type(uint16_t s_handle, uint16_t e_handle, wiced_bt_uuid_t *p_uuid)
+{
+    uint32_t pos = 0;
+    uint16_t handle;
+    uint8_t type_len;
+
+    while ((pos + HOST_BT_DB_ATTR_HDR_SIZE) <= host_bt_db_len)
+    {
+        handle = host_bt_get_u16(&host_bt_db[pos]);
+        type_len = host_bt_db[pos + 3u];
+
+        if ((handle >= s_handle) && (handle <= e_handle) && (type_len == p_uuid->len) &&
+            (((LEN_UUID_16 == type_len) && (host_bt_get_u16(&host_bt_db[pos + 4u]) == p_uuid->uu.uuid16)) ||
+             ((LEN_UUID_128 == type_len) && (0 == memcmp(&host_bt_db[pos + 4u], p_uuid->uu.uuid128, LEN_UUID_128)))))
+        {
+            return handle;
+        }
+        pos += HOST_BT_DB_ATTR_HDR_SIZE + type_len;
+    }
+
+    return 0;
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_gatt_server_send_mtu_rsp
+ ***************************************************************************************************
+ * Summary:
+ *   This function records an MTU exchange response. The handle holds the local MTU.
+ *
+ * Parameters:
+ *   uint16_t conn_id            : Connection ID
+ *   uint16_t remote_mtu         : MTU of the peer
+ *   uint16_t local_mtu          : MTU of the application
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_SUCCESS
+ *
+ **************************************************************************************************/
+wiced_bt_gatt_status_t wiced_bt_gatt_server_send_mtu_rsp(uint16_t conn_id, uint16_t remote_mtu,
+                                                         uint16_t local_mtu)
+{
+    (void)remote_mtu;
+
+    return host_bt_record(HOST_GATT_RSP_MTU, conn_id, GATT_REQ_MTU, local_mtu, WICED_BT_GATT_SUCCESS,
+                          0, 0, NULL, NULL);
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_gatt_server_send_error_rsp
+ ***************************************************************************************************
+ * Summary:
+ *   This function records an error response.
+ *
+ * Parameters:
+ *   uint16_t conn_id                : Connection ID
+ *   wiced_bt_gatt_opcode_t opcode   : Opcode of the request
+ *   uint16_t handle                 : Handle in error
+ *   wiced_bt_gatt_status_t status   : Error
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_SUCCESS
+ *
+ **************************************************************************************************/
+wiced_bt_gatt_status_t wiced_bt_gatt_server_send_error_rsp(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                                                           uint16_t handle, wiced_bt_gatt_status_t status)
+{
+    return host_bt_record(HOST_GATT_RSP_ERROR, conn_id, opcode, handle, status, 0, 0, NULL, NULL);
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_gatt_server_send_write_rsp
+ ***************************************************************************************************
+ * Summary:
+ *   This function records a write response.
+ *
+ * Parameters:
+ *   uint16_t conn_id                : Connection ID
+ *   wiced_bt_gatt_opcode_t opcode   : Opcode of the request
+ *   uint16_t handle                 : Written handle
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_SUCCESS
+ *
+ **************************************************************************************************/
+wiced_bt_gatt_status_t wiced_bt_gatt_server_send_write_rsp(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                                                           uint16_t handle)
+{
+    return host_bt_record(HOST_GATT_RSP_WRITE, conn_id, opcode, handle, WICED_BT_GATT_SUCCESS, 0, 0, NULL, NULL);
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_gatt_server_send_read_handle_rsp
+ ***************************************************************************************************
+ * Summary:
+ *   This function records a read or read blob response.
+ *
+ * Parameters:
+ *   uint16_t conn_id                : Connection ID
+ *   wiced_bt_gatt_opcode_t opcode   : Opcode of the request
+ *   uint16_t len                    : Value length
+ *   uint8_t *p_attr                 : Value
+ *   void *p_app_ctx                 : Free function of the value, or NULL
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_SUCCESS, or WICED_BT_GATT_NO_RESOURCES if the stack
+ *                          holds HOST_BT_TX_QUEUE_SIZE buffers
+ *
+ **************************************************************************************************/
+wiced_bt_gatt_status_t wiced_bt_gatt_server_send_read_handle_rsp(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                                                                 uint16_t len, uint8_t *p_attr, void *p_app_ctx)
+{
+    return host_bt_record(HOST_GATT_RSP_READ, conn_id, opcode, 0, WICED_BT_GATT_SUCCESS, 0, len, p_attr,
+                          p_app_ctx);
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_gatt_server_send_read_by_type_rsp
+ ***************************************************************************************************
+ * Summary:
+ *   This function records a read by type response. The handle holds the length of a pair.
+ *
+ * Parameters:
+ *   uint16_t conn_id                : Connection ID
+ *   wiced_bt_gatt_opcode_t opcode   : Opcode of the request
+ *   uint8_t type_len                : Length of a handle and value pair
+ *   uint16_t data_len               : Length of the pairs
+ *   uint8_t *p_data                 : Pairs
+ *   void *p_app_ctx                 : Free function of the pairs, or NULL
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_SUCCESS, or WICED_BT_GATT_NO_RESOURCES if the stack
+ *                          holds HOST_BT_TX_QUEUE_SIZE buffers
+ *
+ **************************************************************************************************/
+wiced_bt_gatt_status_t wiced_bt_gatt_server_send_read_by_type_rsp(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                                                                  uint8_t type_len, uint16_t data_len,
+                                                                  uint8_t *p_data, void *p_app_ctx)
+{
+    return host_bt_record(HOST_GATT_RSP_READ_BY_TYPE, conn_id, opcode, type_len, WICED_BT_GATT_SUCCESS, 0,
+                          data_len, p_data, p_app_ctx);
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_gatt_server_send_read_multiple_rsp
+ ***************************************************************************************************
+ * Summary:
+ *   This function records a read multiple response.
+ *
+ * Parameters:
+ *   uint16_t conn_id                : Connection ID
+ *   wiced_bt_gatt_opcode_t opcode   : Opcode of the request
+ *   uint16_t data_len               : Length of the values
+ *   uint8_t *p_data                 : Values
+ *   void *p_app_ctx                 : Free function of the values, or NULL
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_SUCCESS, or WICED_BT_GATT_NO_RESOURCES if the stack
+ *                          holds HOST_BT_TX_QUEUE_SIZE buffers
+ *
+ **************************************************************************************************/
+wiced_bt_gatt_status_t wiced_bt_gatt_server_send_read_multiple_rsp(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                                                                   uint16_t data_len, uint8_t *p_data,
+                                                                   void *p_app_ctx)
+{
+    return host_bt_record(HOST_GATT_RSP_READ_MULTIPLE, conn_id, opcode, 0, WICED_BT_GATT_SUCCESS, 0,
+                          data_len, p_data, p_app_ctx);
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_gatt_server_send_prepare_write_rsp
+ ***************************************************************************************************
+ * Summary:
+ *   This function records a prepare write response.
+ *
+ * Parameters:
+ *   uint16_t conn_id                : Connection ID
+ *   wiced_bt_gatt_opcode_t opcode   : Opcode of the request
+ *   uint16_t handle                 : Handle of the segment
+ *   uint16_t offset                 : Offset of the segment
+ *   uint16_t len                    : Segment length
+ *   uint8_t *p_data                 : Segment
+ *   void *p_app_ctx                 : Free function of the segment, or NULL
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_SUCCESS, or WICED_BT_GATT_NO_RESOURCES if the stack
+ *                          holds HOST_BT_TX_QUEUE_SIZE buffers
+ *
+ **************************************************************************************************/
+wiced_bt_gatt_status_t wiced_bt_gatt_server_send_prepare_write_rsp(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                                                                   uint16_t handle, uint16_t offset, uint16_t len,
+                                                                   uint8_t *p_data, void *p_app_ctx)
+{
+    return host_bt_record(HOST_GATT_RSP_PREPARE_WRITE, conn_id, opcode, handle, WICED_BT_GATT_SUCCESS, offset,
+                          len, p_data, p_app_ctx);
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_gatt_server_send_execute_write_rsp
+ ***************************************************************************************************
+ * Summary:
+ *   This function records an execute write response.
+ *
+ * Parameters:
+ *   uint16_t conn_id                : Connection ID
+ *   wiced_bt_gatt_opcode_t opcode   : Opcode of the request
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_SUCCESS
+ *
+ **************************************************************************************************/
+wiced_bt_gatt_status_t wiced_bt_gatt_server_send_execute_write_rsp(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode)
+{
+    return host_bt_record(HOST_GATT_RSP_EXECUTE_WRITE, conn_id, opcode, 0, WICED_BT_GATT_SUCCESS, 0, 0, NULL,
+                          NULL);
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_gatt_server_send_notification
+ ***************************************************************************************************
+ * Summary:
+ *   This function counts a notification. It is not kept as the last response.
+ *
+ * Parameters:
+ *   uint16_t conn_id            : Connection ID
+ *   uint16_t attr_handle        : Notified handle
+ *   uint16_t attr_len           : Value length
+ *   uint8_t *p_attr             : Value
+ *   void *p_app_ctx             : Free function of the value, or NULL
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_CONGESTED while host_bt_set_tx_stalled() holds off
+ *                          transmission, WICED_BT_GATT_SUCCESS otherwise
+ *
+ **************************************************************************************************/
+wiced_bt_gatt_status_t wiced_bt_gatt_server_send_notification(uint16_t conn_id, uint16_t attr_handle,
+                                                              uint16_t attr_len, uint8_t *p_attr, void *p_app_ctx)
+{
+    return host_bt_record(HOST_GATT_RSP_NOTIFICATION, conn_id, GATT_HANDLE_VALUE_NOTIF, attr_handle,
+                          WICED_BT_GATT_SUCCESS, 0, attr_len, p_attr, p_app_ctx);
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_gatt_server_send_indication
+ ***************************************************************************************************
+ * Summary:
+ *   This function counts an indication. It is not kept as the last response.
+ *
+ * Parameters:
+ *   uint16_t conn_id            : Connection ID
+ *   uint16_t attr_handle        : Indicated handle
+ *   uint16_t attr_len           : Value length
+ *   uint8_t *p_attr             : Value
+ *   void *p_app_ctx             : Free function of the value, or NULL
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_CONGESTED while host_bt_set_tx_stalled() holds off
+ *                          transmission, WICED_BT_GATT_SUCCESS otherwise
+ *
+ **************************************************************************************************/
+wiced_bt_gatt_status_t wiced_bt_gatt_server_send_indication(uint16_t conn_id, uint16_t attr_handle,
+                                                            uint16_t attr_len, uint8_t *p_attr, void *p_app_ctx)
+{
+    return host_bt_record(HOST_GATT_RSP_INDICATION, conn_id, GATT_HANDLE_VALUE_IND, attr_handle,
+                          WICED_BT_GATT_SUCCESS, 0, attr_len, p_attr, p_app_ctx);
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_gatt_put_read_by_type_rsp_in_stream
+ ***************************************************************************************************
+ * Summary:
+ *   This function appends a handle and value pair to a read by type response. The first pair
+ *   sets the pair length; pairs of another length are refused.
+ *
+ * Parameters:
+ *   uint8_t *p_stream           : Response position
+ *   int stream_len              : Bytes left in the response
+ *   uint8_t *p_elem_len         : Pair length, 0 before the first pair
+ *   uint16_t attr_handle        : Handle
+ *   uint16_t attr_len           : Value length
+ *   uint8_t *p_attr             : Value
+ *
+ * Return:
+ *  int: Bytes written, 0 if the pair does not fit or has another length
+ *
+ **************************************************************************************************/
+int wiced_bt_gatt_put_read_by_type_rsp_in_stream(uint8_t *p_stream, int stream_len, uint8_t *p_elem_len,
+                                                 uint16_t attr_handle, uint16_t attr_len, uint8_t *p_attr)
+{
+    int pair_len = (int)MIN(attr_len, 253u) + 2;
+
+    if ((pair_len > stream_len) || ((0 != *p_elem_len) && (pair_len != *p_elem_len)))
+    {
+        return 0;
+    }
+
+    *p_elem_len = (uint8_t)pair_len;
+    host_bt_put_u16(p_stream, attr_handle);
+    memcpy(&p_stream[2], p_attr, (size_t)pair_len - 2u);
+
+    return pair_len;
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_gatt_put_read_multi_rsp_in_stream
+ ***************************************************************************************************
+ * Summary:
+ *   This function appends a value to a read multiple response. The variable length variant
+ *   writes the value length first; the value is truncated to the bytes left.
+ *
+ * Parameters:
+ *   wiced_bt_gatt_opcode_t opcode   : GATT_REQ_READ_MULTI or GATT_REQ_READ_MULTI_VAR_LENGTH
+ *   uint8_t *p_stream               : Response position
+ *   int stream_len                  : Bytes left in the response
+ *   uint16_t attr_handle            : Unused
+ *   uint16_t attr_len               : Value length
+ *   uint8_t *p_attr                 : Value
+ *
+ * Return:
+ *  int: Bytes written, 0 if nothing fits
+ *
+ **************************************************************************************************/
+int wiced_bt_gatt_put_read_multi_rsp_in_stream(wiced_bt_gatt_opcode_t opcode, uint8_t *p_stream, int stream_len,
+                                               uint16_t attr_handle, uint16_t attr_len, uint8_t *p_attr)
+{
+    int hdr_len = (GATT_REQ_READ_MULTI_VAR_LENGTH == opcode) ? 2 : 0;
+    int copy_len;
+
+    (void)attr_handle;
+
+    if (stream_len <= hdr_len)
+    {
+        return 0;
+    }
+    copy_len = MIN((int)attr_len, stream_len - hdr_len);
+
+    if (0 != hdr_len)
+    {
+        host_bt_put_u16(p_stream, attr_len);
+    }
+    memcpy(&p_stream[hdr_len], p_attr, (size_t)copy_len);
+
+    return hdr_len + copy_len;
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_bt_gatt_get_handle_from_stream
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns a handle of a read multiple request.
+ *
+ * Parameters:
+ *   uint8_t *p_stream           : Handles of the request
+ *   int index                   : Index of the handle
+ *
+ * Return:
+ *  uint16_t: Handle
+ *
+ **************************************************************************************************/
+uint16_t wiced_bt_gatt_get_handle_from_stream(uint8_t *p_stream, int index)
+{
+    return host_bt_get_u16(&p_stream[index * 2]);
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_init_timer
+ ***************************************************************************************************
+ * Summary:
+ *   This function initializes a stopped stack timer.
+ *
+ * Parameters:
+ *   wiced_timer_t *p_timer              : Timer
+ *   wiced_timer_callback_t TimerCb      : Expiry callback
+ *   TIMER_PARAM_TYPE cBackparam         : Argument of the callback
+ *   wiced_timer_type_t type             : Unit and periodicity
+ *
+ * Return:
+ *  wiced_result_t: WICED_BT_SUCCESS
+ *
+ **************************************************************************************************/
+wiced_result_t wiced_init_timer(wiced_timer_t *p_timer, wiced_timer_callback_t TimerCb,
+                                TIMER_PARAM_TYPE cBackparam, wiced_timer_type_t type)
+{
+    wiced_timer_t *p_listed;
+
+    pthread_mutex_lock(&host_bt_lock);
+    for (p_listed = host_bt_timer_list; (NULL != p_listed) && (p_listed != p_timer); p_listed = p_listed->p_next)
+    {
+    }
+    if (NULL == p_listed)
+    {
+        p_timer->p_next = host_bt_timer_list;
+        host_bt_timer_list = p_timer;
+    }
+    p_timer->p_cb = TimerCb;
+    p_timer->cb_params = cBackparam;
+    p_timer->type = type;
+    p_timer->in_use = WICED_FALSE;
+    pthread_mutex_unlock(&host_bt_lock);
+
+    return WICED_BT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_start_timer
+ ***************************************************************************************************
+ * Summary:
+ *   This function (re)starts a stack timer.
+ *
+ * Parameters:
+ *   wiced_timer_t *p_timer      : Timer
+ *   uint32_t timeout            : Timeout, in the unit of the timer type
+ *
+ * Return:
+ *  wiced_result_t: WICED_BT_SUCCESS
+ *
+ **************************************************************************************************/
+wiced_result_t wiced_start_timer(wiced_timer_t *p_timer, uint32_t timeout)
+{
+    bool seconds = (WICED_SECONDS_TIMER == p_timer->type) || (WICED_SECONDS_PERIODIC_TIMER == p_timer->type);
+
+    pthread_mutex_lock(&host_bt_lock);
+    p_timer->interval_ms = seconds ? (timeout * 1000u) : timeout;
+    p_timer->due_ms = host_time_now_ms() + p_timer->interval_ms;
+    p_timer->in_use = WICED_TRUE;
+    pthread_mutex_unlock(&host_bt_lock);
+
+    return WICED_BT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_stop_timer
+ ***************************************************************************************************
+ * Summary:
+ *   This function stops a stack timer.
+ *
+ * Parameters:
+ *   wiced_timer_t *p_timer      : Timer
+ *
+ * Return:
+ *  wiced_result_t: WICED_BT_SUCCESS
+ *
+ **************************************************************************************************/
+wiced_result_t wiced_stop_timer(wiced_timer_t *p_timer)
+{
+    pthread_mutex_lock(&host_bt_lock);
+    p_timer->in_use = WICED_FALSE;
+    pthread_mutex_unlock(&host_bt_lock);
+
+    return WICED_BT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: wiced_is_timer_in_use
+ ***************************************************************************************************
+ * Summary:
+ *   This function reports whether a stack timer is started.
+ *
+ * Parameters:
+ *   wiced_timer_t *p_timer      : Timer
+ *
+ * Return:
+ *  wiced_bool_t: WICED_TRUE if started
+ *
+ **************************************************************************************************/
+wiced_bool_t wiced_is_timer_in_use(wiced_timer_t *p_timer)
+{
+    wiced_bool_t in_use;
+
+    pthread_mutex_lock(&host_bt_lock);
+    in_use = p_timer->in_use;
+    pthread_mutex_unlock(&host_bt_lock);
+
+    return in_use;
+}
+
+/**************************************************************************************************
+ * Function Name: host_bt_run_timers
+ ***************************************************************************************************
+ * Summary:
+ *   This function fires the due stack timers from the calling thread. The lock is dropped
+ *   around each callback, which may start or stop timers.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void host_bt_run_timers(void)
+{
+    wiced_timer_t *p_timer;
+    bool fired;
+
+    do
+    {
+        fired = false;
+        pthread_mutex_lock(&host_bt_lock);
+        for (p_timer = host_bt_timer_list; NULL != p_timer; p_timer = p_timer->p_next)
+        {
+            if (p_timer->in_use && (p_timer->due_ms <= host_time_now_ms()))
+            {
+                if (((WICED_SECONDS_PERIODIC_TIMER == p_timer->type) ||
+                     (WICED_MILLI_SECONDS_PERIODIC_TIMER == p_timer->type)) && (0 != p_timer->interval_ms))
+                {
+                    p_timer->due_ms += p_timer->interval_ms;
+                }
+                else
+                {
+                    p_timer->in_use = WICED_FALSE;
+                }
+                pthread_mutex_unlock(&host_bt_lock);
+                p_timer->p_cb(p_timer->cb_params);
+                fired = true;
+                break;
+            }
+        }
+        if (!fired)
+        {
+            pthread_mutex_unlock(&host_bt_lock);
+        }
+    } while (fired);
+}
+
+/**************************************************************************************************
+ * Function Name: host_bt_reset
+ ***************************************************************************************************
+ * Summary:
+ *   This function clears the recorded calls and the last response. Buffers the stack holds
+ *   stay queued for host_bt_complete_tx().
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void host_bt_reset(void)
+{
+    pthread_mutex_lock(&host_bt_lock);
+    memset(&host_bt_last_rsp, 0, sizeof(host_bt_last_rsp));
+    memset(&host_bt_call_counts, 0, sizeof(host_bt_call_counts));
+    host_bt_tx_stalled = false;
+    pthread_mutex_unlock(&host_bt_lock);
+}
+
+/**************************************************************************************************
+ * Function Name: host_gatt_last_rsp
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns the last response the application sent, other than notifications
+ *   and indications.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  const host_gatt_rsp_t *: Last response; its type is HOST_GATT_RSP_NONE after a reset
+ *
+ **************************************************************************************************/
+const host_gatt_rsp_t *host_gatt_last_rsp(void)
+{
+    return &host_bt_last_rsp;
+}
+
+/**************************************************************************************************
+ * Function Name: host_bt_calls
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns the calls the application made since the last reset.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  const host_bt_calls_t *: Counts
+ *
+ **************************************************************************************************/
+const host_bt_calls_t *host_bt_calls(void)
+{
+    return &host_bt_call_counts;
+}
+
+/**************************************************************************************************
+ * Function Name: host_bt_set_tx_stalled
+ ***************************************************************************************************
+ * Summary:
+ *   This function makes notifications and indications fail as on a congested link.
+ *
+ * Parameters:
+ *   bool stalled                : true to refuse notifications and indications
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void host_bt_set_tx_stalled(bool stalled)
+{
+    pthread_mutex_lock(&host_bt_lock);
+    host_bt_tx_stalled = stalled;
+    pthread_mutex_unlock(&host_bt_lock);
+}
+
+/**************************************************************************************************
+ * Function Name: host_bt_complete_tx
+ ***************************************************************************************************
+ * Summary:
+ *   This function reports GATT_APP_BUFFER_TRANSMITTED_EVT for every buffer the stack holds, in
+ *   the order they were sent.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  uint32_t: Number of buffers returned
+ *
+ **************************************************************************************************/
+uint32_t host_bt_complete_tx(void)
+{
+    wiced_bt_gatt_event_data_t event_data;
+    uint32_t completed = 0;
+    host_bt_tx_t tx;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&host_bt_lock);
+        if (completed >= host_bt_tx_count)
+        {
+            host_bt_tx_count = 0;
+            pthread_mutex_unlock(&host_bt_lock);
+            break;
+        }
+        tx = host_bt_tx_queue[completed++];
+        pthread_mutex_unlock(&host_bt_lock);
+
+        memset(&event_data, 0, sizeof(event_data));
+        event_data.buffer_xmitted.p_app_data = tx.p_data;
+        event_data.buffer_xmitted.p_app_ctxt = tx.p_ctxt;
+        host_bt_gatt_event(GATT_APP_BUFFER_TRANSMITTED_EVT, &event_data);
+    }
+
+    return completed;
+}
+
+/**************************************************************************************************
+ * Function Name: host_bt_complete_rssi
+ ***************************************************************************************************
+ * Summary:
+ *   This function completes the pending RSSI read.
+ *
+ * Parameters:
+ *   int8_t rssi                 : RSSI to report, in dBm
+ *
+ * Return:
+ *  uint32_t: 1 if a read was pending, 0 otherwise
+ *
+ **************************************************************************************************/
+uint32_t host_bt_complete_rssi(int8_t rssi)
+{
+    wiced_bt_dev_rssi_result_t result;
+    wiced_bt_dev_cmpl_cback_t *p_cback;
+
+    memset(&result, 0, sizeof(result));
+
+    pthread_mutex_lock(&host_bt_lock);
+    p_cback = host_bt_rssi_cback;
+    host_bt_rssi_cback = NULL;
+    memcpy(result.rem_bda, host_bt_rssi_bdaddr, BD_ADDR_LEN);
+    pthread_mutex_unlock(&host_bt_lock);
+
+    if (NULL == p_cback)
+    {
+        return 0;
+    }
+    memcpy(result.bd_addr, result.rem_bda, BD_ADDR_LEN);
+    result.status = WICED_BT_SUCCESS;
+    result.rssi = rssi;
+    p_cback(&result);
+
+    return 1;
+}
+
+/**************************************************************************************************
+ * Function Name: host_bt_gatt_event
+ ***************************************************************************************************
+ * Summary:
+ *   This function reports a GATT event to the registered callback, as the stack would.
+ *
+ * Parameters:
+ *   wiced_bt_gatt_evt_t event                   : Event
+ *   wiced_bt_gatt_event_data_t *p_event_data    : Event data
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: Status of the callback, WICED_BT_GATT_WRONG_STATE if none is
+ *                          registered
+ *
+ **************************************************************************************************/
+wiced_bt_gatt_status_t host_bt_gatt_event(wiced_bt_gatt_evt_t event, wiced_bt_gatt_event_data_t *p_event_data)
+{
+    if (NULL == host_bt_gatt_cback)
+    {
+        return WICED_BT_GATT_WRONG_STATE;
+    }
+
+    return host_bt_gatt_cback(event, p_event_data);
+}
+
+/**************************************************************************************************
+ * Function Name: host_bt_record
+ ***************************************************************************************************
+ * Summary:
+ *   This function counts a send and keeps the buffer for host_bt_complete_tx() if the
+ *   application passed a free function. Responses are copied as the last response.
+ *
+ * Parameters:
+ *   host_gatt_rsp_type_t type           : Kind of send
+ *   uint16_t conn_id                    : Connection ID
+ *   wiced_bt_gatt_opcode_t opcode       : Opcode
+ *   uint16_t handle                     : Handle
+ *   wiced_bt_gatt_status_t status       : Status of an error response
+ *   uint16_t offset                     : Offset of a prepare write response
+ *   uint16_t len                        : Data length
+ *   const uint8_t *p_data               : Data, or NULL
+ *   void *p_app_ctx                     : Free function of the data, or NULL
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_SUCCESS if sent
+ *
+ **************************************************************************************************/
+static wiced_bt_gatt_status_t host_bt_record(host_gatt_rsp_type_t type, uint16_t conn_id,
+                                             wiced_bt_gatt_opcode_t opcode, uint16_t handle,
+                                             wiced_bt_gatt_status_t status, uint16_t offset,
+                                             uint16_t len, const uint8_t *p_data, void *p_app_ctx)
+{
+    bool notify = (HOST_GATT_RSP_NOTIFICATION == type) || (HOST_GATT_RSP_INDICATION == type);
+    wiced_bt_gatt_status_t gatt_status = WICED_BT_GATT_SUCCESS;
+
+    pthread_mutex_lock(&host_bt_lock);
+    if (notify && host_bt_tx_stalled)
+    {
+        gatt_status = WICED_BT_GATT_CONGESTED;
+    }
+    else if ((NULL != p_app_ctx) && (HOST_BT_TX_QUEUE_SIZE <= host_bt_tx_count))
+    {
+        gatt_status = WICED_BT_GATT_NO_RESOURCES;
+    }
+    else
+    {
+        if (NULL != p_app_ctx)
+        {
+            host_bt_tx_queue[host_bt_tx_count].p_data = (uint8_t *)p_data;
+            host_bt_tx_queue[host_bt_tx_count].p_ctxt = p_app_ctx;
+            host_bt_tx_count++;
+        }
+
+        if (HOST_GATT_RSP_NOTIFICATION == type)
+        {
+            host_bt_call_counts.notifications++;
+        }
+        else if (HOST_GATT_RSP_INDICATION == type)
+        {
+            host_bt_call_counts.indications++;
+        }
+        else
+        {
+            host_bt_call_counts.responses++;
+            host_bt_last_rsp.type = type;
+            host_bt_last_rsp.conn_id = conn_id;
+            host_bt_last_rsp.opcode = opcode;
+            host_bt_last_rsp.handle = handle;
+            host_bt_last_rsp.status = status;
+            host_bt_last_rsp.offset = offset;
+            host_bt_last_rsp.len = len;
+            if (NULL != p_data)
+            {
+                memcpy(host_bt_last_rsp.data, p_data, MIN(len, HOST_GATT_RSP_DATA_MAX));
+            }
+        }
+    }
+    pthread_mutex_unlock(&host_bt_lock);
+
+    return gatt_status;
+}
+
+/**************************************************************************************************
+ * Function Name: host_bt_get_u16
+ ***************************************************************************************************
+ * Summary:
+ *   This function reads a little endian 16 bit value.
+ *
+ * Parameters:
+ *   const uint8_t *p            : Value
+ *
+ * Return:
+ *  uint16_t: Value
+ *
+ **************************************************************************************************/
+static uint16_t host_bt_get_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/**************************************************************************************************
+ * Function Name: host_bt_put_u16
+ ***************************************************************************************************
+ * Summary:
+ *   This function writes a little endian 16 bit value.
+ *
+ * Parameters:
+ *   uint8_t *p                  : Destination
+ *   uint16_t value              : Value
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void host_bt_put_u16(uint8_t *p, uint16_t value)
+{
+    p[0] = (uint8_t)(value & 0xFFu);
+    p[1] = (uint8_t)(value >> 8);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,593 @@
+/*******************************************************************************
+ * File Name: host_hal.c
+ *
+ * Description:
+ *   Host implementation of the board support package, retarget-io and the part of cyhal
+ *   that the application uses. GPIOs are plain levels and the flash is emulated in memory
+ *
+ * Related Document: See Readme.md
+ *
+ *******************************************************************************
+ * Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/*******************************************************************************
+ *        Header Files
+ *******************************************************************************/
+#include <string.h>
+#include "cybsp.h"
+#include "cy_retarget_io.h"
+#include "host_stub.h"
+
+/*******************************************************************************
+ *        Macro Definitions
+ *******************************************************************************/
+#define HOST_FLASH_SECTOR_SIZE          (512u)
+#define HOST_FLASH_SECTORS              (64u)
+#define HOST_FLASH_ERASE_VALUE          (0x00u)
+
+/*******************************************************************************
+ *        Structures and Enumerations
+ *******************************************************************************/
+/* Flash sector that was erased or programmed at least once */
+typedef struct
+{
+    bool used;
+    uint32_t address;
+    uint8_t data[HOST_FLASH_SECTOR_SIZE];
+} host_flash_sector_t;
+
+typedef struct
+{
+    bool level;
+    cyhal_gpio_event_t events;
+    cyhal_gpio_callback_data_t *p_callback;
+} host_gpio_t;
+
+/*******************************************************************************
+ *        Variable Definitions
+ *******************************************************************************/
+cyhal_uart_t cy_retarget_io_uart_obj;
+
+static DWT_Type host_dwt;
+static CoreDebug_Type host_core_debug;
+DWT_Type *DWT = &host_dwt;
+CoreDebug_Type *CoreDebug = &host_core_debug;
+uint32_t SystemCoreClock = 100000000ul;
+
+static host_gpio_t host_gpio[CYBSP_PIN_COUNT];
+
+/* One block covers the 32 bit address space, as the bond region address is truncated to
+ * 32 bits on a 64 bit host */
+static const cyhal_flash_block_info_t host_flash_block =
+{
+    .start_address  = 0,
+    .size           = 0xFFFFFFFFu,
+    .sector_size    = HOST_FLASH_SECTOR_SIZE,
+    .page_size      = HOST_FLASH_SECTOR_SIZE,
+    .erase_value    = HOST_FLASH_ERASE_VALUE,
+};
+
+static host_flash_sector_t host_flash[HOST_FLASH_SECTORS];
+
+/*******************************************************************************
+ *        Function Prototypes
+ *******************************************************************************/
+static host_flash_sector_t *host_flash_sector(uint32_t address, bool create);
+
+/*******************************************************************************
+ *        Function Definitions
+ *******************************************************************************/
+
+/**************************************************************************************************
+ * Function Name: cybsp_init
+ ***************************************************************************************************
+ * Summary:
+ *   This function initializes the board. Nothing needs to be done on the host.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS
+ *
+ **************************************************************************************************/
+cy_rslt_t cybsp_init(void)
+{
+    return CY_RSLT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: cy_retarget_io_init
+ ***************************************************************************************************
+ * Summary:
+ *   This function initializes retarget-io. printf() already writes to stdout on the host.
+ *
+ * Parameters:
+ *   cyhal_gpio_t tx             : Unused
+ *   cyhal_gpio_t rx             : Unused
+ *   uint32_t baudrate           : Unused
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS
+ *
+ **************************************************************************************************/
+cy_rslt_t cy_retarget_io_init(cyhal_gpio_t tx, cyhal_gpio_t rx, uint32_t baudrate)
+{
+    (void)tx;
+    (void)rx;
+    (void)baudrate;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: cyhal_uart_is_tx_active
+ ***************************************************************************************************
+ * Summary:
+ *   This function reports whether the UART is transmitting. stdout never holds off sleep.
+ *
+ * Parameters:
+ *   cyhal_uart_t *obj           : Unused
+ *
+ * Return:
+ *  bool: false
+ *
+ **************************************************************************************************/
+bool cyhal_uart_is_tx_active(cyhal_uart_t *obj)
+{
+    (void)obj;
+
+    return false;
+}
+
+/**************************************************************************************************
+ * Function Name: cyhal_gpio_init
+ ***************************************************************************************************
+ * Summary:
+ *   This function sets the initial level of a pin.
+ *
+ * Parameters:
+ *   cyhal_gpio_t pin                    : Pin
+ *   cyhal_gpio_direction_t direction    : Unused
+ *   cyhal_gpio_drive_mode_t drive_mode  : Unused
+ *   bool init_val                       : Initial level
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS, or CY_RSLT_HOST_STUB_ERROR for an unknown pin
+ *
+ **************************************************************************************************/
+cy_rslt_t cyhal_gpio_init(cyhal_gpio_t pin, cyhal_gpio_direction_t direction,
+                          cyhal_gpio_drive_mode_t drive_mode, bool init_val)
+{
+    (void)direction;
+    (void)drive_mode;
+
+    if ((pin < 0) || (pin >= CYBSP_PIN_COUNT))
+    {
+        return CY_RSLT_HOST_STUB_ERROR;
+    }
+    host_gpio[pin].level = init_val;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: cyhal_gpio_write
+ ***************************************************************************************************
+ * Summary:
+ *   This function drives a pin.
+ *
+ * Parameters:
+ *   cyhal_gpio_t pin            : Pin
+ *   bool value                  : Level
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void cyhal_gpio_write(cyhal_gpio_t pin, bool value)
+{
+    host_gpio[pin].level = value;
+}
+
+/**************************************************************************************************
+ * Function Name: cyhal_gpio_read
+ ***************************************************************************************************
+ * Summary:
+ *   This function reads a pin.
+ *
+ * Parameters:
+ *   cyhal_gpio_t pin            : Pin
+ *
+ * Return:
+ *  bool: Level
+ *
+ **************************************************************************************************/
+bool cyhal_gpio_read(cyhal_gpio_t pin)
+{
+    return host_gpio[pin].level;
+}
+
+/**************************************************************************************************
+ * Function Name: cyhal_gpio_register_callback
+ ***************************************************************************************************
+ * Summary:
+ *   This function registers the edge callback of a pin.
+ *
+ * Parameters:
+ *   cyhal_gpio_t pin                            : Pin
+ *   cyhal_gpio_callback_data_t *callback_data   : Callback, kept by the caller
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void cyhal_gpio_register_callback(cyhal_gpio_t pin, cyhal_gpio_callback_data_t *callback_data)
+{
+    host_gpio[pin].p_callback = callback_data;
+}
+
+/**************************************************************************************************
+ * Function Name: cyhal_gpio_enable_event
+ ***************************************************************************************************
+ * Summary:
+ *   This function enables or disables the edges that call the pin callback.
+ *
+ * Parameters:
+ *   cyhal_gpio_t pin            : Pin
+ *   cyhal_gpio_event_t event    : Edges
+ *   uint8_t intr_priority       : Unused
+ *   bool enable                 : true to enable the edges
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void cyhal_gpio_enable_event(cyhal_gpio_t pin, cyhal_gpio_event_t event, uint8_t intr_priority,
+                             bool enable)
+{
+    (void)intr_priority;
+
+    host_gpio[pin].events = enable ? (host_gpio[pin].events | event) : (host_gpio[pin].events & ~event);
+}
+
+/**************************************************************************************************
+ * Function Name: cyhal_syspm_register_callback
+ ***************************************************************************************************
+ * Summary:
+ *   This function registers a power transition callback. The host never sleeps.
+ *
+ * Parameters:
+ *   cyhal_syspm_callback_data_t *callback_data  : Unused
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void cyhal_syspm_register_callback(cyhal_syspm_callback_data_t *callback_data)
+{
+    (void)callback_data;
+}
+
+/**************************************************************************************************
+ * Function Name: cyhal_lptimer_init
+ ***************************************************************************************************
+ * Summary:
+ *   This function initializes the low power timer.
+ *
+ * Parameters:
+ *   cyhal_lptimer_t *obj        : Unused
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS
+ *
+ **************************************************************************************************/
+cy_rslt_t cyhal_lptimer_init(cyhal_lptimer_t *obj)
+{
+    (void)obj;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: cyhal_syspm_tickless_deepsleep
+ ***************************************************************************************************
+ * Summary:
+ *   This function stands in for deep sleep. It returns at once, having slept for no time.
+ *
+ * Parameters:
+ *   cyhal_lptimer_t *obj        : Unused
+ *   uint32_t desired_ms         : Unused
+ *   uint32_t *actual_ms         : Returns 0
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS
+ *
+ **************************************************************************************************/
+cy_rslt_t cyhal_syspm_tickless_deepsleep(cyhal_lptimer_t *obj, uint32_t desired_ms, uint32_t *actual_ms)
+{
+    (void)obj;
+    (void)desired_ms;
+    *actual_ms = 0;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: cyhal_syspm_tickless_sleep
+ ***************************************************************************************************
+ * Summary:
+ *   This function stands in for sleep. It returns at once, having slept for no time.
+ *
+ * Parameters:
+ *   cyhal_lptimer_t *obj        : Unused
+ *   uint32_t desired_ms         : Unused
+ *   uint32_t *actual_ms         : Returns 0
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS
+ *
+ **************************************************************************************************/
+cy_rslt_t cyhal_syspm_tickless_sleep(cyhal_lptimer_t *obj, uint32_t desired_ms, uint32_t *actual_ms)
+{
+    return cyhal_syspm_tickless_deepsleep(obj, desired_ms, actual_ms);
+}
+
+/**************************************************************************************************
+ * Function Name: cyhal_flash_init
+ ***************************************************************************************************
+ * Summary:
+ *   This function initializes the emulated flash.
+ *
+ * Parameters:
+ *   cyhal_flash_t *obj          : Unused
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS
+ *
+ **************************************************************************************************/
+cy_rslt_t cyhal_flash_init(cyhal_flash_t *obj)
+{
+    (void)obj;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: cyhal_flash_get_info
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns the geometry of the emulated flash.
+ *
+ * Parameters:
+ *   const cyhal_flash_t *obj    : Unused
+ *   cyhal_flash_info_t *info    : Returns the geometry
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void cyhal_flash_get_info(const cyhal_flash_t *obj, cyhal_flash_info_t *info)
+{
+    (void)obj;
+
+    info->block_count = 1;
+    info->blocks = &host_flash_block;
+}
+
+/**************************************************************************************************
+ * Function Name: cyhal_flash_read
+ ***************************************************************************************************
+ * Summary:
+ *   This function reads the emulated flash. Sectors never written read as erased.
+ *
+ * Parameters:
+ *   cyhal_flash_t *obj          : Unused
+ *   uint32_t address            : Start address
+ *   uint8_t *data               : Returns the data
+ *   size_t size                 : Bytes to read
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS
+ *
+ **************************************************************************************************/
+cy_rslt_t cyhal_flash_read(cyhal_flash_t *obj, uint32_t address, uint8_t *data, size_t size)
+{
+    host_flash_sector_t *p_sector;
+    uint32_t offset;
+
+    (void)obj;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        offset = (address + (uint32_t)i) % HOST_FLASH_SECTOR_SIZE;
+        p_sector = host_flash_sector(address + (uint32_t)i - offset, false);
+        data[i] = (NULL != p_sector) ? p_sector->data[offset] : HOST_FLASH_ERASE_VALUE;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: cyhal_flash_erase
+ ***************************************************************************************************
+ * Summary:
+ *   This function erases one sector of the emulated flash.
+ *
+ * Parameters:
+ *   cyhal_flash_t *obj          : Unused
+ *   uint32_t address            : Sector address
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS, or CY_RSLT_HOST_STUB_ERROR if the emulated flash is full
+ *
+ **************************************************************************************************/
+cy_rslt_t cyhal_flash_erase(cyhal_flash_t *obj, uint32_t address)
+{
+    host_flash_sector_t *p_sector = host_flash_sector(address, true);
+
+    (void)obj;
+
+    if (NULL == p_sector)
+    {
+        return CY_RSLT_HOST_STUB_ERROR;
+    }
+    memset(p_sector->data, HOST_FLASH_ERASE_VALUE, sizeof(p_sector->data));
+
+    return CY_RSLT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: cyhal_flash_program
+ ***************************************************************************************************
+ * Summary:
+ *   This function programs one page of the emulated flash.
+ *
+ * Parameters:
+ *   cyhal_flash_t *obj          : Unused
+ *   uint32_t address            : Page address
+ *   const uint32_t *data        : One page of data
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS, or CY_RSLT_HOST_STUB_ERROR if the emulated flash is full
+ *
+ **************************************************************************************************/
+cy_rslt_t cyhal_flash_program(cyhal_flash_t *obj, uint32_t address, const uint32_t *data)
+{
+    host_flash_sector_t *p_sector = host_flash_sector(address, true);
+
+    (void)obj;
+
+    if (NULL == p_sector)
+    {
+        return CY_RSLT_HOST_STUB_ERROR;
+    }
+    memcpy(p_sector->data, data, sizeof(p_sector->data));
+
+    return CY_RSLT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: host_hal_gpio_get
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns the level the application drives on a pin.
+ *
+ * Parameters:
+ *   cyhal_gpio_t pin            : Pin
+ *
+ * Return:
+ *  bool: Level
+ *
+ **************************************************************************************************/
+bool host_hal_gpio_get(cyhal_gpio_t pin)
+{
+    return host_gpio[pin].level;
+}
+
+/**************************************************************************************************
+ * Function Name: host_hal_gpio_set_input
+ ***************************************************************************************************
+ * Summary:
+ *   This function changes the level of an input and calls its callback if the edge is
+ *   enabled, as the GPIO interrupt would.
+ *
+ * Parameters:
+ *   cyhal_gpio_t pin            : Pin
+ *   bool value                  : New level
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void host_hal_gpio_set_input(cyhal_gpio_t pin, bool value)
+{
+    cyhal_gpio_event_t edge = value ? CYHAL_GPIO_IRQ_RISE : CYHAL_GPIO_IRQ_FALL;
+    host_gpio_t *p_gpio = &host_gpio[pin];
+
+    if (p_gpio->level == value)
+    {
+        return;
+    }
+    p_gpio->level = value;
+
+    if ((NULL != p_gpio->p_callback) && (0 != (p_gpio->events & edge)))
+    {
+        p_gpio->p_callback->callback(p_gpio->p_callback->callback_arg, edge);
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: host_flash_sector
+ ***************************************************************************************************
+ * Summary:
+ *   This function finds the emulated sector at an address, taking a free one if asked to.
+ *   A new sector reads as erased.
+ *
+ * Parameters:
+ *   uint32_t address            : Sector aligned address
+ *   bool create                 : true to take a free sector if none is found
+ *
+ * Return:
+ *  host_flash_sector_t *: Sector, or NULL if not found and not created
+ *
+ **************************************************************************************************/
+static host_flash_sector_t *host_flash_sector(uint32_t address, bool create)
+{
+    host_flash_sector_t *p_free = NULL;
+
+    address -= address % HOST_FLASH_SECTOR_SIZE;
+    for (uint32_t i = 0; i < HOST_FLASH_SECTORS; i++)
+    {
+        if (host_flash[i].used && (host_flash[i].address == address))
+        {
+            return &host_flash[i];
+        }
+        if (!host_flash[i].used && (NULL == p_free))
+        {
+            p_free = &host_flash[i];
+        }
+    }
+
+    if (!create || (NULL == p_free))
+    {
+        return NULL;
+    }
+    p_free->used = true;
+    p_free->address = address;
+    memset(p_free->data, HOST_FLASH_ERASE_VALUE, sizeof(p_free->data));
+
+    return p_free;
+}
+
+/* [] END OF FILE */
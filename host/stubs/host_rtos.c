@@ -0,0 +1,623 @@
+/*******************************************************************************
+ * File Name: host_rtos.c
+ *
+ * Description:
+ *   Host implementation of the RTOS abstraction and the critical section. Threads and
+ *   semaphores map onto pthreads; timers fire only when host_time_advance() moves time forward
+ *
+ * Related Document: See Readme.md
+ *
+ *******************************************************************************
+ * Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/*******************************************************************************
+ *        Header Files
+ *******************************************************************************/
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+#include <errno.h>
+#include "cyabs_rtos.h"
+#include "cyhal.h"
+#include "host_stub.h"
+
+/*******************************************************************************
+ *        Structures and Enumerations
+ *******************************************************************************/
+struct host_rtos_thread
+{
+    pthread_t thread;
+    cy_thread_entry_fn_t entry;
+    cy_thread_arg_t arg;
+};
+
+struct host_rtos_semaphore
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    uint32_t count;
+    uint32_t maxcount;
+};
+
+struct host_timer
+{
+    struct host_timer *p_next;
+    cy_timer_callback_t fun;
+    cy_timer_callback_arg_t arg;
+    cy_timer_trigger_type_t type;
+    uint32_t period_ms;
+    uint64_t due_ms;
+    bool running;
+};
+
+/*******************************************************************************
+ *        Variable Definitions
+ *******************************************************************************/
+/* Stands in for masking interrupts: one recursive lock shared by every context */
+static pthread_mutex_t host_critical_section;
+static pthread_once_t host_critical_section_once = PTHREAD_ONCE_INIT;
+
+/* Time added by host_time_advance() to the monotonic clock */
+static uint64_t host_time_offset_ms;
+
+static pthread_mutex_t host_timer_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct host_timer *host_timer_list;
+
+/*******************************************************************************
+ *        Function Prototypes
+ *******************************************************************************/
+static void host_critical_section_init(void);
+static void *host_rtos_thread_entry(void *arg);
+static void host_rtos_run_timers(void);
+
+/*******************************************************************************
+ *        Function Definitions
+ *******************************************************************************/
+
+/**************************************************************************************************
+ * Function Name: cyhal_system_critical_section_enter
+ ***************************************************************************************************
+ * Summary:
+ *   This function takes the lock that stands in for disabled interrupts. It may be nested.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  uint32_t: Always 0, there is no interrupt state to restore
+ *
+ **************************************************************************************************/
+uint32_t cyhal_system_critical_section_enter(void)
+{
+    pthread_once(&host_critical_section_once, host_critical_section_init);
+    pthread_mutex_lock(&host_critical_section);
+
+    return 0;
+}
+
+/**************************************************************************************************
+ * Function Name: cyhal_system_critical_section_exit
+ ***************************************************************************************************
+ * Summary:
+ *   This function releases one level of the critical section lock.
+ *
+ * Parameters:
+ *   uint32_t old_state          : Value returned by cyhal_system_critical_section_enter()
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void cyhal_system_critical_section_exit(uint32_t old_state)
+{
+    (void)old_state;
+    pthread_mutex_unlock(&host_critical_section);
+}
+
+/**************************************************************************************************
+ * Function Name: cy_rtos_thread_create
+ ***************************************************************************************************
+ * Summary:
+ *   This function starts a pthread for the entry function. The stack and the priority are
+ *   ignored; the thread is detached, as application threads never return.
+ *
+ * Parameters:
+ *   cy_thread_t *thread                 : Returns the thread
+ *   cy_thread_entry_fn_t entry_function : Thread entry
+ *   const char *name                    : Thread name
+ *   void *stack                         : Unused
+ *   uint32_t stack_size                 : Unused
+ *   cy_thread_priority_t priority       : Unused
+ *   cy_thread_arg_t arg                 : Argument of the entry function
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS if the thread was started
+ *
+ **************************************************************************************************/
+cy_rslt_t cy_rtos_thread_create(cy_thread_t *thread, cy_thread_entry_fn_t entry_function,
+                                const char *name, void *stack, uint32_t stack_size,
+                                cy_thread_priority_t priority, cy_thread_arg_t arg)
+{
+    struct host_rtos_thread *p_thread = calloc(1, sizeof(*p_thread));
+
+    (void)stack;
+    (void)stack_size;
+    (void)priority;
+
+    if (NULL == p_thread)
+    {
+        return CY_RSLT_HOST_STUB_ERROR;
+    }
+    p_thread->entry = entry_function;
+    p_thread->arg = arg;
+
+    if (0 != pthread_create(&p_thread->thread, NULL, host_rtos_thread_entry, p_thread))
+    {
+        free(p_thread);
+        return CY_RSLT_HOST_STUB_ERROR;
+    }
+    pthread_setname_np(p_thread->thread, name);
+    pthread_detach(p_thread->thread);
+    *thread = p_thread;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: cy_rtos_delay_milliseconds
+ ***************************************************************************************************
+ * Summary:
+ *   This function sleeps the calling thread.
+ *
+ * Parameters:
+ *   cy_time_t num_ms            : Milliseconds to sleep
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS
+ *
+ **************************************************************************************************/
+cy_rslt_t cy_rtos_delay_milliseconds(cy_time_t num_ms)
+{
+    struct timespec delay = {.tv_sec = num_ms / 1000u, .tv_nsec = (long)(num_ms % 1000u) * 1000000L};
+
+    while ((0 != nanosleep(&delay, &delay)) && (EINTR == errno))
+    {
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: cy_rtos_get_time
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns the milliseconds since boot, including the time added by
+ *   host_time_advance().
+ *
+ * Parameters:
+ *   cy_time_t *tval             : Returns the time
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS
+ *
+ **************************************************************************************************/
+cy_rslt_t cy_rtos_get_time(cy_time_t *tval)
+{
+    *tval = (cy_time_t)host_time_now_ms();
+
+    return CY_RSLT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: cy_rtos_semaphore_init
+ ***************************************************************************************************
+ * Summary:
+ *   This function creates a counting semaphore.
+ *
+ * Parameters:
+ *   cy_semaphore_t *semaphore   : Returns the semaphore
+ *   uint32_t maxcount           : Highest count
+ *   uint32_t initcount          : Initial count
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS if the semaphore was created
+ *
+ **************************************************************************************************/
+cy_rslt_t cy_rtos_semaphore_init(cy_semaphore_t *semaphore, uint32_t maxcount, uint32_t initcount)
+{
+    struct host_rtos_semaphore *p_sem = calloc(1, sizeof(*p_sem));
+    pthread_condattr_t attr;
+
+    if (NULL == p_sem)
+    {
+        return CY_RSLT_HOST_STUB_ERROR;
+    }
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&p_sem->cond, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_mutex_init(&p_sem->mutex, NULL);
+    p_sem->count = initcount;
+    p_sem->maxcount = maxcount;
+    *semaphore = p_sem;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: cy_rtos_semaphore_get
+ ***************************************************************************************************
+ * Summary:
+ *   This function takes the semaphore, waiting up to the timeout for it.
+ *
+ * Parameters:
+ *   cy_semaphore_t *semaphore   : Semaphore
+ *   cy_time_t timeout_ms        : Wait in milliseconds, or CY_RTOS_NEVER_TIMEOUT
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS if taken, CY_RSLT_HOST_STUB_ERROR on timeout
+ *
+ **************************************************************************************************/
+cy_rslt_t cy_rtos_semaphore_get(cy_semaphore_t *semaphore, cy_time_t timeout_ms)
+{
+    struct host_rtos_semaphore *p_sem = *semaphore;
+    struct timespec deadline;
+    cy_rslt_t cy_result = CY_RSLT_SUCCESS;
+
+    if (NULL == p_sem)
+    {
+        return CY_RSLT_HOST_STUB_ERROR;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout_ms / 1000u;
+    deadline.tv_nsec += (long)(timeout_ms % 1000u) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&p_sem->mutex);
+    while (0 == p_sem->count)
+    {
+        if (CY_RTOS_NEVER_TIMEOUT == timeout_ms)
+        {
+            pthread_cond_wait(&p_sem->cond, &p_sem->mutex);
+        }
+        else if (ETIMEDOUT == pthread_cond_timedwait(&p_sem->cond, &p_sem->mutex, &deadline))
+        {
+            cy_result = CY_RSLT_HOST_STUB_ERROR;
+            break;
+        }
+    }
+    if (CY_RSLT_SUCCESS == cy_result)
+    {
+        p_sem->count--;
+    }
+    pthread_mutex_unlock(&p_sem->mutex);
+
+    return cy_result;
+}
+
+/**************************************************************************************************
+ * Function Name: cy_rtos_semaphore_set
+ ***************************************************************************************************
+ * Summary:
+ *   This function gives the semaphore. Giving a semaphore that was never created fails, so
+ *   tests may post to a queue whose thread was not started.
+ *
+ * Parameters:
+ *   cy_semaphore_t *semaphore   : Semaphore
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS if given, CY_RSLT_HOST_STUB_ERROR otherwise
+ *
+ **************************************************************************************************/
+cy_rslt_t cy_rtos_semaphore_set(cy_semaphore_t *semaphore)
+{
+    struct host_rtos_semaphore *p_sem = *semaphore;
+    cy_rslt_t cy_result = CY_RSLT_SUCCESS;
+
+    if (NULL == p_sem)
+    {
+        return CY_RSLT_HOST_STUB_ERROR;
+    }
+
+    pthread_mutex_lock(&p_sem->mutex);
+    if (p_sem->count < p_sem->maxcount)
+    {
+        p_sem->count++;
+        pthread_cond_signal(&p_sem->cond);
+    }
+    else
+    {
+        cy_result = CY_RSLT_HOST_STUB_ERROR;
+    }
+    pthread_mutex_unlock(&p_sem->mutex);
+
+    return cy_result;
+}
+
+/**************************************************************************************************
+ * Function Name: cy_rtos_timer_init
+ ***************************************************************************************************
+ * Summary:
+ *   This function creates a stopped timer.
+ *
+ * Parameters:
+ *   cy_timer_t *timer                   : Returns the timer
+ *   cy_timer_trigger_type_t type        : One shot or periodic
+ *   cy_timer_callback_t fun             : Expiry callback
+ *   cy_timer_callback_arg_t arg         : Argument of the callback
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS if the timer was created
+ *
+ **************************************************************************************************/
+cy_rslt_t cy_rtos_timer_init(cy_timer_t *timer, cy_timer_trigger_type_t type,
+                             cy_timer_callback_t fun, cy_timer_callback_arg_t arg)
+{
+    struct host_timer *p_timer = calloc(1, sizeof(*p_timer));
+
+    if (NULL == p_timer)
+    {
+        return CY_RSLT_HOST_STUB_ERROR;
+    }
+    p_timer->fun = fun;
+    p_timer->arg = arg;
+    p_timer->type = type;
+
+    pthread_mutex_lock(&host_timer_lock);
+    p_timer->p_next = host_timer_list;
+    host_timer_list = p_timer;
+    pthread_mutex_unlock(&host_timer_lock);
+    *timer = p_timer;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: cy_rtos_timer_start
+ ***************************************************************************************************
+ * Summary:
+ *   This function (re)starts a timer.
+ *
+ * Parameters:
+ *   cy_timer_t *timer           : Timer
+ *   cy_time_t num_ms            : Time to the first expiry, and the period
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS
+ *
+ **************************************************************************************************/
+cy_rslt_t cy_rtos_timer_start(cy_timer_t *timer, cy_time_t num_ms)
+{
+    struct host_timer *p_timer = *timer;
+
+    pthread_mutex_lock(&host_timer_lock);
+    p_timer->period_ms = num_ms;
+    p_timer->due_ms = host_time_now_ms() + num_ms;
+    p_timer->running = true;
+    pthread_mutex_unlock(&host_timer_lock);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: cy_rtos_timer_stop
+ ***************************************************************************************************
+ * Summary:
+ *   This function stops a timer.
+ *
+ * Parameters:
+ *   cy_timer_t *timer           : Timer
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS
+ *
+ **************************************************************************************************/
+cy_rslt_t cy_rtos_timer_stop(cy_timer_t *timer)
+{
+    pthread_mutex_lock(&host_timer_lock);
+    (*timer)->running = false;
+    pthread_mutex_unlock(&host_timer_lock);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: cy_rtos_timer_is_running
+ ***************************************************************************************************
+ * Summary:
+ *   This function reports whether a timer is started.
+ *
+ * Parameters:
+ *   cy_timer_t *timer           : Timer
+ *   bool *state                 : Returns true if the timer is started
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS
+ *
+ **************************************************************************************************/
+cy_rslt_t cy_rtos_timer_is_running(cy_timer_t *timer, bool *state)
+{
+    pthread_mutex_lock(&host_timer_lock);
+    *state = (*timer)->running;
+    pthread_mutex_unlock(&host_timer_lock);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: host_time_now_ms
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns the host time in milliseconds: the monotonic clock plus the time
+ *   added by host_time_advance().
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  uint64_t: Milliseconds
+ *
+ **************************************************************************************************/
+uint64_t host_time_now_ms(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((uint64_t)now.tv_sec * 1000u) + ((uint64_t)now.tv_nsec / 1000000u) +
+           __atomic_load_n(&host_time_offset_ms, __ATOMIC_RELAXED);
+}
+
+/**************************************************************************************************
+ * Function Name: host_time_advance
+ ***************************************************************************************************
+ * Summary:
+ *   This function moves time forward and fires the RTOS and stack timers that are due, from
+ *   the calling thread.
+ *
+ * Parameters:
+ *   uint32_t ms                 : Milliseconds to add
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void host_time_advance(uint32_t ms)
+{
+    __atomic_add_fetch(&host_time_offset_ms, ms, __ATOMIC_RELAXED);
+
+    host_rtos_run_timers();
+    host_bt_run_timers();
+}
+
+/**************************************************************************************************
+ * Function Name: host_rtos_run_timers
+ ***************************************************************************************************
+ * Summary:
+ *   This function fires the due RTOS timers. The list lock is dropped around each callback,
+ *   which may start or stop timers.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void host_rtos_run_timers(void)
+{
+    struct host_timer *p_timer;
+    bool fired;
+
+    do
+    {
+        fired = false;
+        pthread_mutex_lock(&host_timer_lock);
+        for (p_timer = host_timer_list; NULL != p_timer; p_timer = p_timer->p_next)
+        {
+            if (p_timer->running && (p_timer->due_ms <= host_time_now_ms()))
+            {
+                if ((CY_TIMER_TYPE_PERIODIC == p_timer->type) && (0 != p_timer->period_ms))
+                {
+                    p_timer->due_ms += p_timer->period_ms;
+                }
+                else
+                {
+                    p_timer->running = false;
+                }
+                pthread_mutex_unlock(&host_timer_lock);
+                p_timer->fun(p_timer->arg);
+                fired = true;
+                break;
+            }
+        }
+        if (!fired)
+        {
+            pthread_mutex_unlock(&host_timer_lock);
+        }
+    } while (fired);
+}
+
+/**************************************************************************************************
+ * Function Name: host_critical_section_init
+ ***************************************************************************************************
+ * Summary:
+ *   This function creates the recursive critical section lock.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void host_critical_section_init(void)
+{
+    pthread_mutexattr_t attr;
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&host_critical_section, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+/**************************************************************************************************
+ * Function Name: host_rtos_thread_entry
+ ***************************************************************************************************
+ * Summary:
+ *   This function runs the entry function of a thread.
+ *
+ * Parameters:
+ *   void *arg                   : Thread created by cy_rtos_thread_create()
+ *
+ * Return:
+ *  void *: NULL
+ *
+ **************************************************************************************************/
+static void *host_rtos_thread_entry(void *arg)
+{
+    struct host_rtos_thread *p_thread = arg;
+
+    p_thread->entry(p_thread->arg);
+
+    return NULL;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,106 @@
+/*******************************************************************************
+* File Name: cycfg_gatt_db.h
+*
+* Description:
+*   Host copy of the GATT database handles and values that the Bluetooth Configurator
+*   generates from design.cybt
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CYCFG_GATT_DB_H_
+#define CYCFG_GATT_DB_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "stdint.h"
+#include "wiced_bt_gatt.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+#define __UUID_SERVICE_GENERIC_ACCESS                       0x1800
+#define __UUID_CHARACTERISTIC_DEVICE_NAME                   0x2A00
+#define __UUID_CHARACTERISTIC_APPEARANCE                    0x2A01
+#define __UUID_SERVICE_GENERIC_ATTRIBUTE                    0x1801
+#define __UUID_CHARACTERISTIC_SERVICE_CHANGED               0x2A05
+#define __UUID_DESCRIPTOR_CLIENT_CHARACTERISTIC_CONFIGURATION 0x2902
+#define __UUID_CHARACTERISTIC_CLIENT_SUPPORTED_FEATURES     0x2B29
+#define __UUID_CHARACTERISTIC_DATABASE_HASH                 0x2B2A
+#define __UUID_SERVICE_IMMEDIATE_ALERT                      0x1802
+#define __UUID_CHARACTERISTIC_ALERT_LEVEL                   0x2A06
+
+/* Service Generic Access */
+#define HDLS_GAP                                            0x0001
+#define HDLC_GAP_DEVICE_NAME                                0x0002
+#define HDLC_GAP_DEVICE_NAME_VALUE                          0x0003
+#define HDLC_GAP_APPEARANCE                                 0x0004
+#define HDLC_GAP_APPEARANCE_VALUE                           0x0005
+
+/* Service Generic Attribute */
+#define HDLS_GATT                                           0x0006
+#define HDLC_GATT_SERVICE_CHANGED                           0x0007
+#define HDLC_GATT_SERVICE_CHANGED_VALUE                     0x0008
+#define HDLD_GATT_SERVICE_CHANGED_CLIENT_CHAR_CONFIG        0x0009
+#define HDLC_GATT_CLIENT_SUPPORTED_FEATURES                 0x000A
+#define HDLC_GATT_CLIENT_SUPPORTED_FEATURES_VALUE           0x000B
+#define HDLC_GATT_DATABASE_HASH                             0x000C
+#define HDLC_GATT_DATABASE_HASH_VALUE                       0x000D
+
+/* Service Immediate Alert */
+#define HDLS_IAS                                            0x000E
+#define HDLC_IAS_ALERT_LEVEL                                0x000F
+#define HDLC_IAS_ALERT_LEVEL_VALUE                          0x0010
+
+/*******************************************************************************
+*        Variable Declarations
+*******************************************************************************/
+extern const uint8_t gatt_database[];
+extern const uint16_t gatt_database_len;
+extern gatt_db_lookup_table_t app_gatt_db_ext_attr_tbl[];
+extern const uint16_t app_gatt_db_ext_attr_tbl_size;
+
+extern uint8_t app_gap_device_name[];
+extern uint8_t app_gap_appearance[];
+extern uint8_t app_gatt_service_changed[];
+extern uint8_t app_gatt_service_changed_client_char_config[];
+extern uint8_t app_gatt_client_supported_features[];
+extern uint8_t app_gatt_database_hash[];
+extern uint8_t app_ias_alert_level[];
+
+#endif /* CYCFG_GATT_DB_H_ */
+
+/* [] END OF FILE */
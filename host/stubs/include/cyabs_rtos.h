@@ -0,0 +1,114 @@
+/*******************************************************************************
+* File Name: cyabs_rtos.h
+*
+* Description:
+*   Host stub of the RTOS abstraction. host_rtos.c runs threads and semaphores on POSIX
+*   threads and fires timers only when the test asks for it
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CYABS_RTOS_H_
+#define CYABS_RTOS_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_result.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+#define CY_RTOS_NEVER_TIMEOUT           (0xFFFFFFFFu)
+#define CY_RTOS_MIN_STACK_SIZE          (300u)
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+typedef enum
+{
+    CY_RTOS_PRIORITY_MIN,
+    CY_RTOS_PRIORITY_LOW,
+    CY_RTOS_PRIORITY_BELOWNORMAL,
+    CY_RTOS_PRIORITY_NORMAL,
+    CY_RTOS_PRIORITY_ABOVENORMAL,
+    CY_RTOS_PRIORITY_HIGH,
+    CY_RTOS_PRIORITY_REALTIME,
+    CY_RTOS_PRIORITY_MAX
+} cy_thread_priority_t;
+
+typedef enum
+{
+    CY_TIMER_TYPE_PERIODIC,
+    CY_TIMER_TYPE_ONCE,
+} cy_timer_trigger_type_t;
+
+typedef void *cy_thread_arg_t;
+typedef void (*cy_thread_entry_fn_t)(cy_thread_arg_t arg);
+typedef struct host_rtos_thread *cy_thread_t;
+
+typedef struct host_rtos_semaphore *cy_semaphore_t;
+
+typedef void *cy_timer_callback_arg_t;
+typedef void (*cy_timer_callback_t)(cy_timer_callback_arg_t arg);
+typedef struct host_timer *cy_timer_t;
+
+typedef uint32_t cy_time_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+cy_rslt_t cy_rtos_thread_create(cy_thread_t *thread, cy_thread_entry_fn_t entry_function,
+                                const char *name, void *stack, uint32_t stack_size,
+                                cy_thread_priority_t priority, cy_thread_arg_t arg);
+cy_rslt_t cy_rtos_delay_milliseconds(cy_time_t num_ms);
+cy_rslt_t cy_rtos_get_time(cy_time_t *tval);
+
+cy_rslt_t cy_rtos_semaphore_init(cy_semaphore_t *semaphore, uint32_t maxcount, uint32_t initcount);
+cy_rslt_t cy_rtos_semaphore_get(cy_semaphore_t *semaphore, cy_time_t timeout_ms);
+cy_rslt_t cy_rtos_semaphore_set(cy_semaphore_t *semaphore);
+
+cy_rslt_t cy_rtos_timer_init(cy_timer_t *timer, cy_timer_trigger_type_t type,
+                             cy_timer_callback_t fun, cy_timer_callback_arg_t arg);
+cy_rslt_t cy_rtos_timer_start(cy_timer_t *timer, cy_time_t num_ms);
+cy_rslt_t cy_rtos_timer_stop(cy_timer_t *timer);
+cy_rslt_t cy_rtos_timer_is_running(cy_timer_t *timer, bool *state);
+
+#endif /* CYABS_RTOS_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,64 @@
+/*******************************************************************************
+* File Name: cycfg_pins.h
+*
+* Description:
+*   Host stub of the generated pin configuration, for the host build only
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CYCFG_PINS_H_
+#define CYCFG_PINS_H_
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Pins of the host stubs; cyhal_gpio_t is an index into the pin states of host_hal.c */
+#define CYBSP_USER_LED1                 (0)
+#define CYBSP_USER_LED2                 (1)
+#define CYBSP_USER_BTN                  (2)
+#define CYBSP_DEBUG_UART_TX             (3)
+#define CYBSP_DEBUG_UART_RX             (4)
+#define CYBSP_PIN_COUNT                 (5)
+
+#define CYBSP_LED_STATE_ON              (0)
+#define CYBSP_LED_STATE_OFF             (1)
+#define CYBSP_BTN_PRESSED               (0)
+#define CYBSP_BTN_OFF                   (1)
+#define CYBSP_USER_BTN_DRIVE            (CYHAL_GPIO_DRIVE_PULLUP)
+
+#endif /* CYCFG_PINS_H_ */
+
+/* [] END OF FILE */
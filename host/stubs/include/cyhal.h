@@ -0,0 +1,218 @@
+/*******************************************************************************
+* File Name: cyhal.h
+*
+* Description:
+*   Host stub of the hardware abstraction layer. It declares the part of cyhal that the
+*   application uses; host_hal.c implements it on plain memory
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CYHAL_H_
+#define CYHAL_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_result.h"
+#include "cy_utils.h"
+#include "cycfg_pins.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+#define NC                              (-1)
+#define CYHAL_ISR_PRIORITY_DEFAULT      (7u)
+
+/* Cycle counter registers; the host counter stands still */
+#define CoreDebug_DEMCR_TRCENA_Msk      (1ul << 24)
+#define DWT_CTRL_CYCCNTENA_Msk          (1ul)
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+typedef int cyhal_gpio_t;
+
+typedef enum
+{
+    CYHAL_GPIO_DIR_INPUT,
+    CYHAL_GPIO_DIR_OUTPUT,
+    CYHAL_GPIO_DIR_BIDIRECTIONAL,
+} cyhal_gpio_direction_t;
+
+typedef enum
+{
+    CYHAL_GPIO_DRIVE_NONE,
+    CYHAL_GPIO_DRIVE_ANALOG,
+    CYHAL_GPIO_DRIVE_PULLUP,
+    CYHAL_GPIO_DRIVE_PULLDOWN,
+    CYHAL_GPIO_DRIVE_OPENDRAINDRIVESLOW,
+    CYHAL_GPIO_DRIVE_OPENDRAINDRIVESHIGH,
+    CYHAL_GPIO_DRIVE_STRONG,
+    CYHAL_GPIO_DRIVE_PULLUPDOWN,
+} cyhal_gpio_drive_mode_t;
+
+typedef enum
+{
+    CYHAL_GPIO_IRQ_NONE = 0,
+    CYHAL_GPIO_IRQ_RISE = 1,
+    CYHAL_GPIO_IRQ_FALL = 2,
+    CYHAL_GPIO_IRQ_BOTH = 3,
+} cyhal_gpio_event_t;
+
+typedef void (*cyhal_gpio_event_callback_t)(void *callback_arg, cyhal_gpio_event_t event);
+
+typedef struct cyhal_gpio_callback_data
+{
+    cyhal_gpio_event_callback_t callback;
+    void *callback_arg;
+    struct cyhal_gpio_callback_data *next;
+    cyhal_gpio_t pin;
+} cyhal_gpio_callback_data_t;
+
+typedef enum
+{
+    CYHAL_SYSPM_CHECK_READY         = 0x01,
+    CYHAL_SYSPM_CHECK_FAIL          = 0x02,
+    CYHAL_SYSPM_BEFORE_TRANSITION   = 0x04,
+    CYHAL_SYSPM_AFTER_TRANSITION    = 0x08,
+} cyhal_syspm_callback_mode_t;
+
+typedef enum
+{
+    CYHAL_SYSPM_CB_CPU_SLEEP        = 0x01,
+    CYHAL_SYSPM_CB_CPU_DEEPSLEEP    = 0x02,
+    CYHAL_SYSPM_CB_SYSTEM_HIBERNATE = 0x04,
+} cyhal_syspm_callback_state_t;
+
+typedef bool (*cyhal_syspm_callback_t)(cyhal_syspm_callback_state_t state,
+                                       cyhal_syspm_callback_mode_t mode, void *callback_arg);
+
+typedef struct cyhal_syspm_callback_data
+{
+    cyhal_syspm_callback_t callback;
+    cyhal_syspm_callback_state_t states;
+    cyhal_syspm_callback_mode_t ignore_modes;
+    void *args;
+    struct cyhal_syspm_callback_data *next;
+} cyhal_syspm_callback_data_t;
+
+typedef struct
+{
+    int unused;
+} cyhal_uart_t;
+
+typedef struct
+{
+    int unused;
+} cyhal_lptimer_t;
+
+typedef struct
+{
+    int unused;
+} cyhal_flash_t;
+
+typedef struct
+{
+    uint32_t start_address;
+    uint32_t size;
+    uint32_t sector_size;
+    uint32_t page_size;
+    uint8_t erase_value;
+} cyhal_flash_block_info_t;
+
+typedef struct
+{
+    uint8_t block_count;
+    const cyhal_flash_block_info_t *blocks;
+} cyhal_flash_info_t;
+
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+/*******************************************************************************
+*        Variable Declarations
+*******************************************************************************/
+extern DWT_Type *DWT;
+extern CoreDebug_Type *CoreDebug;
+extern uint32_t SystemCoreClock;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+uint32_t cyhal_system_critical_section_enter(void);
+void cyhal_system_critical_section_exit(uint32_t old_state);
+
+cy_rslt_t cyhal_gpio_init(cyhal_gpio_t pin, cyhal_gpio_direction_t direction,
+                          cyhal_gpio_drive_mode_t drive_mode, bool init_val);
+void cyhal_gpio_write(cyhal_gpio_t pin, bool value);
+bool cyhal_gpio_read(cyhal_gpio_t pin);
+void cyhal_gpio_register_callback(cyhal_gpio_t pin, cyhal_gpio_callback_data_t *callback_data);
+void cyhal_gpio_enable_event(cyhal_gpio_t pin, cyhal_gpio_event_t event, uint8_t intr_priority,
+                             bool enable);
+
+void cyhal_syspm_register_callback(cyhal_syspm_callback_data_t *callback_data);
+cy_rslt_t cyhal_syspm_tickless_deepsleep(cyhal_lptimer_t *obj, uint32_t desired_ms, uint32_t *actual_ms);
+cy_rslt_t cyhal_syspm_tickless_sleep(cyhal_lptimer_t *obj, uint32_t desired_ms, uint32_t *actual_ms);
+cy_rslt_t cyhal_lptimer_init(cyhal_lptimer_t *obj);
+
+bool cyhal_uart_is_tx_active(cyhal_uart_t *obj);
+
+cy_rslt_t cyhal_flash_init(cyhal_flash_t *obj);
+void cyhal_flash_get_info(const cyhal_flash_t *obj, cyhal_flash_info_t *info);
+cy_rslt_t cyhal_flash_read(cyhal_flash_t *obj, uint32_t address, uint8_t *data, size_t size);
+cy_rslt_t cyhal_flash_erase(cyhal_flash_t *obj, uint32_t address);
+cy_rslt_t cyhal_flash_program(cyhal_flash_t *obj, uint32_t address, const uint32_t *data);
+
+/* Count of leading zero bits, as the CLZ instruction */
+static inline uint32_t __CLZ(uint32_t value)
+{
+    return (0u == value) ? 32u : (uint32_t)__builtin_clz(value);
+}
+
+#endif /* CYHAL_H_ */
+
+/* [] END OF FILE */
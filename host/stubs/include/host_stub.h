@@ -0,0 +1,131 @@
+/*******************************************************************************
+* File Name: host_stub.h
+*
+* Description:
+*   Control interface of the host stubs. Tests and benchmarks use it to move time forward,
+*   complete transmissions and inspect what the application sent to the stack
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef HOST_STUB_H_
+#define HOST_STUB_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "cyhal.h"
+#include "wiced_bt_ble.h"
+#include "wiced_bt_gatt.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Bytes of a response kept by the recorder */
+#define HOST_GATT_RSP_DATA_MAX          (512u)
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+/* Kind of the last GATT server response */
+typedef enum
+{
+    HOST_GATT_RSP_NONE,
+    HOST_GATT_RSP_ERROR,
+    HOST_GATT_RSP_MTU,
+    HOST_GATT_RSP_WRITE,
+    HOST_GATT_RSP_READ,
+    HOST_GATT_RSP_READ_BY_TYPE,
+    HOST_GATT_RSP_READ_MULTIPLE,
+    HOST_GATT_RSP_PREPARE_WRITE,
+    HOST_GATT_RSP_EXECUTE_WRITE,
+    HOST_GATT_RSP_NOTIFICATION,
+    HOST_GATT_RSP_INDICATION,
+} host_gatt_rsp_type_t;
+
+/* Copy of the last response the application sent */
+typedef struct
+{
+    host_gatt_rsp_type_t type;
+    uint16_t conn_id;
+    wiced_bt_gatt_opcode_t opcode;
+    uint16_t handle;
+    wiced_bt_gatt_status_t status;
+    uint16_t offset;
+    uint16_t len;
+    uint8_t data[HOST_GATT_RSP_DATA_MAX];
+} host_gatt_rsp_t;
+
+/* Calls the application made to the controller */
+typedef struct
+{
+    uint32_t adv_starts;
+    wiced_bt_ble_advert_mode_t adv_mode;
+    uint32_t set_phy;
+    wiced_bt_ble_phy_preferences_t phy_preferences;
+    uint32_t conn_params_updates;
+    uint32_t data_length_updates;
+    uint32_t rssi_reads;
+    uint32_t responses;
+    uint32_t notifications;
+    uint32_t indications;
+} host_bt_calls_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+/* host_rtos.c */
+void host_time_advance(uint32_t ms);
+uint64_t host_time_now_ms(void);
+
+/* host_bt.c */
+void host_bt_reset(void);
+const host_gatt_rsp_t *host_gatt_last_rsp(void);
+const host_bt_calls_t *host_bt_calls(void);
+uint32_t host_bt_complete_tx(void);
+void host_bt_set_tx_stalled(bool stalled);
+void host_bt_run_timers(void);
+uint32_t host_bt_complete_rssi(int8_t rssi);
+wiced_bt_gatt_status_t host_bt_gatt_event(wiced_bt_gatt_evt_t event, wiced_bt_gatt_event_data_t *p_event_data);
+
+/* host_hal.c */
+bool host_hal_gpio_get(cyhal_gpio_t pin);
+void host_hal_gpio_set_input(cyhal_gpio_t pin, bool value);
+
+#endif /* HOST_STUB_H_ */
+
+/* [] END OF FILE */
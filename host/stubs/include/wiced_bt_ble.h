@@ -0,0 +1,142 @@
+/*******************************************************************************
+* File Name: wiced_bt_ble.h
+*
+* Description:
+*   Host stub of the btstack LE API, for the host build only
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef WICED_BT_BLE_H_
+#define WICED_BT_BLE_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_result.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+#define BTM_BLE_PREFER_1M_PHY           (0x01)
+#define BTM_BLE_PREFER_2M_PHY           (0x02)
+#define BTM_BLE_PREFER_LELR_PHY         (0x04)
+
+#define BTM_BLE_PREFER_CODED_PHY_NONE   (0x00)
+#define BTM_BLE_PREFER_CODED_PHY_S2     (0x01)
+#define BTM_BLE_PREFER_CODED_PHY_S8     (0x02)
+
+#define BTM_BLE_ADVERT_TYPE_FLAG            (0x01)
+#define BTM_BLE_ADVERT_TYPE_16SRV_COMPLETE  (0x03)
+#define BTM_BLE_ADVERT_TYPE_NAME_COMPLETE   (0x09)
+
+#define BTM_BLE_GENERAL_DISCOVERABLE_FLAG   (0x02)
+#define BTM_BLE_BREDR_NOT_SUPPORTED         (0x04)
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+enum wiced_bt_ble_advert_mode_e
+{
+    BTM_BLE_ADVERT_OFF,
+    BTM_BLE_ADVERT_DIRECTED_HIGH,
+    BTM_BLE_ADVERT_DIRECTED_LOW,
+    BTM_BLE_ADVERT_UNDIRECTED_HIGH,
+    BTM_BLE_ADVERT_UNDIRECTED_LOW,
+    BTM_BLE_ADVERT_NONCONN_HIGH,
+    BTM_BLE_ADVERT_NONCONN_LOW,
+    BTM_BLE_ADVERT_DISCOVERABLE_HIGH,
+    BTM_BLE_ADVERT_DISCOVERABLE_LOW,
+};
+typedef uint8_t wiced_bt_ble_advert_mode_t;
+
+typedef struct
+{
+    uint8_t *p_data;
+    uint16_t len;
+    uint8_t advert_type;
+} wiced_bt_ble_advert_elem_t;
+
+typedef struct
+{
+    wiced_bt_device_address_t remote_bd_addr;
+    uint8_t tx_phys;
+    uint8_t rx_phys;
+    uint16_t phy_opts;
+} wiced_bt_ble_phy_preferences_t;
+
+typedef struct
+{
+    uint8_t status;
+    wiced_bt_device_address_t bd_address;
+    uint8_t tx_phy;
+    uint8_t rx_phy;
+} wiced_bt_ble_phy_update_t;
+
+typedef struct
+{
+    uint8_t status;
+    wiced_bt_device_address_t bd_addr;
+    uint16_t conn_interval;
+    uint16_t conn_latency;
+    uint16_t supervision_timeout;
+} wiced_bt_ble_connection_param_update_t;
+
+typedef struct
+{
+    wiced_bt_device_address_t bd_address;
+    uint16_t max_tx_octets;
+    uint16_t max_tx_time;
+    uint16_t max_rx_octets;
+    uint16_t max_rx_time;
+} wiced_bt_ble_phy_data_length_update_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+wiced_result_t wiced_bt_ble_set_raw_advertisement_data(uint8_t num_elem, wiced_bt_ble_advert_elem_t *p_data);
+wiced_result_t wiced_bt_start_advertisements(wiced_bt_ble_advert_mode_t advert_mode,
+                                             wiced_bt_ble_address_type_t directed_advertisement_bdaddr_type,
+                                             wiced_bt_device_address_t directed_advertisement_bdaddr_ptr);
+wiced_result_t wiced_bt_ble_set_phy(wiced_bt_ble_phy_preferences_t *p_phy_preferences);
+wiced_result_t wiced_bt_ble_set_data_packet_length(wiced_bt_device_address_t bd_addr, uint16_t tx_pdu_length,
+                                                   uint16_t tx_time);
+void wiced_bt_ble_security_grant(wiced_bt_device_address_t bd_addr, uint8_t res);
+wiced_bool_t wiced_bt_l2cap_update_ble_conn_params(wiced_bt_device_address_t rem_bdRa, uint16_t min_int,
+                                                   uint16_t max_int, uint16_t latency, uint16_t timeout);
+
+#endif /* WICED_BT_BLE_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,264 @@
+/*******************************************************************************
+* File Name: wiced_bt_dev.h
+*
+* Description:
+*   Host stub of the btstack device management API, for the host build only
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef WICED_BT_DEV_H_
+#define WICED_BT_DEV_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_result.h"
+#include "wiced_bt_ble.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+#define BT_TRANSPORT_BR_EDR             (1)
+#define BT_TRANSPORT_LE                 (2)
+
+#define BTM_SUCCESS                     (0)
+#define WICED_BT_SMP_RES_SUCCESS        (0)
+
+#define BTM_IO_CAPABILITIES_NONE        (3)
+#define BTM_OOB_NONE                    (0)
+
+#define BTM_LE_AUTH_REQ_BOND            (0x01)
+#define BTM_LE_AUTH_REQ_MITM            (0x04)
+#define BTM_LE_AUTH_REQ_SC              (0x08)
+#define BTM_LE_AUTH_REQ_SC_BOND         (BTM_LE_AUTH_REQ_SC | BTM_LE_AUTH_REQ_BOND)
+
+#define BTM_LE_KEY_PENC                 (0x01)
+#define BTM_LE_KEY_PID                  (0x02)
+#define BTM_LE_KEY_PCSRK                (0x04)
+#define BTM_LE_KEY_SIZE_MAX             (16)
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+enum wiced_bt_management_evt_e
+{
+    BTM_ENABLED_EVT,
+    BTM_DISABLED_EVT,
+    BTM_POWER_MANAGEMENT_STATUS_EVT,
+    BTM_PIN_REQUEST_EVT,
+    BTM_USER_CONFIRMATION_REQUEST_EVT,
+    BTM_PASSKEY_NOTIFICATION_EVT,
+    BTM_PASSKEY_REQUEST_EVT,
+    BTM_KEYPRESS_NOTIFICATION_EVT,
+    BTM_PAIRING_IO_CAPABILITIES_BR_EDR_REQUEST_EVT,
+    BTM_PAIRING_IO_CAPABILITIES_BR_EDR_RESPONSE_EVT,
+    BTM_PAIRING_IO_CAPABILITIES_BLE_REQUEST_EVT,
+    BTM_PAIRING_COMPLETE_EVT,
+    BTM_ENCRYPTION_STATUS_EVT,
+    BTM_SECURITY_REQUEST_EVT,
+    BTM_SECURITY_FAILED_EVT,
+    BTM_SECURITY_ABORTED_EVT,
+    BTM_READ_LOCAL_OOB_DATA_COMPLETE_EVT,
+    BTM_REMOTE_OOB_DATA_REQUEST_EVT,
+    BTM_PAIRED_DEVICE_LINK_KEYS_UPDATE_EVT,
+    BTM_PAIRED_DEVICE_LINK_KEYS_REQUEST_EVT,
+    BTM_LOCAL_IDENTITY_KEYS_UPDATE_EVT,
+    BTM_LOCAL_IDENTITY_KEYS_REQUEST_EVT,
+    BTM_BLE_SCAN_STATE_CHANGED_EVT,
+    BTM_BLE_ADVERT_STATE_CHANGED_EVT,
+    BTM_SMP_REMOTE_OOB_DATA_REQUEST_EVT,
+    BTM_SMP_SC_REMOTE_OOB_DATA_REQUEST_EVT,
+    BTM_SMP_SC_LOCAL_OOB_DATA_NOTIFICATION_EVT,
+    BTM_SCO_CONNECTED_EVT,
+    BTM_SCO_DISCONNECTED_EVT,
+    BTM_SCO_CONNECTION_REQUEST_EVT,
+    BTM_SCO_CONNECTION_CHANGE_EVT,
+    BTM_BLE_CONNECTION_PARAM_UPDATE,
+    BTM_BLE_PHY_UPDATE_EVT,
+    BTM_LPM_STATE_LOW_POWER,
+    BTM_MULTI_ADVERT_RESP_EVENT,
+    BTM_BLE_DATA_LENGTH_UPDATE_EVENT,
+};
+typedef uint8_t wiced_bt_management_evt_t;
+
+/* SMP results reported in the pairing complete event */
+enum wiced_bt_smp_status_e
+{
+    SMP_SUCCESS,
+    SMP_PASSKEY_ENTRY_FAIL,
+    SMP_OOB_FAIL,
+    SMP_PAIR_AUTH_FAIL,
+    SMP_CONFIRM_VALUE_ERR,
+    SMP_PAIR_NOT_SUPPORT,
+    SMP_ENC_KEY_SIZE,
+    SMP_INVALID_CMD,
+    SMP_PAIR_FAIL_UNKNOWN,
+    SMP_REPEATED_ATTEMPTS,
+    SMP_INVALID_PARAMETERS,
+    SMP_DHKEY_CHK_FAIL,
+    SMP_NUMERIC_COMPAR_FAIL,
+    SMP_BR_PAIRING_IN_PROGR,
+    SMP_XTRANS_DERIVE_NOT_ALLOW,
+    SMP_PAIR_INTERNAL_ERR,
+    SMP_UNKNOWN_IO_CAP,
+    SMP_INIT_FAIL,
+    SMP_CONFIRM_FAIL,
+    SMP_BUSY,
+    SMP_ENC_FAIL,
+    SMP_STARTED,
+    SMP_RSP_TIMEOUT,
+    SMP_FAIL,
+    SMP_CONN_TOUT,
+};
+typedef uint8_t wiced_bt_smp_status_t;
+
+typedef uint8_t wiced_bt_transport_t;
+
+typedef struct
+{
+    wiced_result_t status;
+} wiced_bt_dev_enabled_t;
+
+typedef struct
+{
+    wiced_bt_device_address_t bd_addr;
+    uint8_t local_io_cap;
+    uint8_t oob_data;
+    uint8_t auth_req;
+    uint8_t max_key_size;
+    uint8_t init_keys;
+    uint8_t resp_keys;
+} wiced_bt_dev_ble_io_caps_req_t;
+
+typedef struct
+{
+    uint8_t reason;
+    uint8_t sec_level;
+    wiced_bool_t is_pair_cancel;
+    wiced_bt_device_address_t resolved_bd_addr;
+    wiced_bt_ble_address_type_t resolved_bd_addr_type;
+} wiced_bt_dev_ble_pairing_info_t;
+
+typedef union
+{
+    wiced_bt_dev_ble_pairing_info_t ble;
+} wiced_bt_dev_pairing_info_t;
+
+typedef struct
+{
+    uint8_t *bd_addr;
+    wiced_bt_transport_t transport;
+    wiced_bt_dev_pairing_info_t pairing_complete_info;
+    wiced_bt_ble_address_type_t bd_addr_type;
+} wiced_bt_dev_pairing_cplt_t;
+
+typedef struct
+{
+    uint8_t *bd_addr;
+    wiced_bt_transport_t transport;
+    wiced_result_t result;
+} wiced_bt_dev_encryption_status_t;
+
+typedef struct
+{
+    wiced_bt_device_address_t bd_addr;
+} wiced_bt_dev_security_request_t;
+
+/* Opaque on the host: the application only stores and returns the keys */
+typedef struct
+{
+    uint8_t le_keys[80];
+    wiced_bt_ble_address_type_t ble_addr_type;
+} wiced_bt_device_sec_keys_t;
+
+typedef struct
+{
+    wiced_bt_device_address_t bd_addr;
+    wiced_bt_device_sec_keys_t key_data;
+} wiced_bt_device_link_keys_t;
+
+typedef struct
+{
+    uint8_t local_key_data[100];
+} wiced_bt_local_identity_keys_t;
+
+typedef struct
+{
+    wiced_bt_device_address_t bd_addr;
+    uint8_t status;
+    uint8_t hci_status;
+    int8_t rssi;
+    wiced_bt_device_address_t rem_bda;
+} wiced_bt_dev_rssi_result_t;
+
+typedef union
+{
+    wiced_bt_dev_enabled_t enabled;
+    wiced_bt_dev_ble_io_caps_req_t pairing_io_capabilities_ble_request;
+    wiced_bt_dev_pairing_cplt_t pairing_complete;
+    wiced_bt_dev_encryption_status_t encryption_status;
+    wiced_bt_dev_security_request_t security_request;
+    wiced_bt_device_link_keys_t paired_device_link_keys_update;
+    wiced_bt_device_link_keys_t paired_device_link_keys_request;
+    wiced_bt_local_identity_keys_t local_identity_keys_update;
+    wiced_bt_local_identity_keys_t local_identity_keys_request;
+    wiced_bt_ble_advert_mode_t ble_advert_state_changed;
+    wiced_bt_ble_connection_param_update_t ble_connection_param_update;
+    wiced_bt_ble_phy_update_t ble_phy_update_event;
+    wiced_bt_ble_phy_data_length_update_t ble_data_length_update_event;
+} wiced_bt_management_evt_data_t;
+
+typedef wiced_result_t (wiced_bt_management_cback_t)(wiced_bt_management_evt_t event,
+                                                      wiced_bt_management_evt_data_t *p_event_data);
+
+typedef void (wiced_bt_dev_cmpl_cback_t)(void *p_data);
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+wiced_result_t wiced_bt_set_local_bdaddr(wiced_bt_device_address_t bd_addr, wiced_bt_ble_address_type_t addr_type);
+void wiced_bt_dev_read_local_addr(wiced_bt_device_address_t bd_addr);
+void wiced_bt_set_pairable_mode(uint8_t allow_pairing, uint8_t connect_only_paired);
+wiced_result_t wiced_bt_dev_read_rssi(wiced_bt_device_address_t remote_bda, wiced_bt_transport_t transport,
+                                      wiced_bt_dev_cmpl_cback_t *p_cback);
+wiced_result_t wiced_bt_dev_add_device_to_address_resolution_db(wiced_bt_device_link_keys_t *p_link_keys);
+wiced_result_t wiced_bt_dev_remove_device_from_address_resolution_db(wiced_bt_device_link_keys_t *p_link_keys);
+wiced_result_t wiced_bt_dev_delete_bonded_device(wiced_bt_device_address_t bd_addr);
+wiced_result_t wiced_app_event_serialize(int (*fn)(void *), void *data);
+
+#endif /* WICED_BT_DEV_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,194 @@
+/*******************************************************************************
+ * File Name: test_le_app_gatts.c
+ *
+ * Description:
+ *   Host test: reads at offsets past the value, and the prepared write queue limits and
+ *   segment gaps
+ *
+ * Related Document: See Readme.md
+ *
+ *******************************************************************************
+ * Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/*******************************************************************************
+ *        Header Files
+ *******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include "host_harness.h"
+#include "le_app_conn.h"
+#include "cycfg_gatt_db.h"
+
+/*******************************************************************************
+ *        Macro Definitions
+ *******************************************************************************/
+#define TEST_MTU                        (23u)
+#define TEST_DEVICE_NAME                "Find Me Target"
+
+/*******************************************************************************
+ *        Variable Definitions
+ *******************************************************************************/
+static uint8_t test_value[LE_APP_PREP_WRITE_ARENA_SIZE + 1];
+
+/*******************************************************************************
+ *        Function Definitions
+ *******************************************************************************/
+static const host_gatt_rsp_t *test_read(wiced_bt_gatt_opcode_t opcode, uint16_t handle, uint16_t offset)
+{
+    wiced_bt_gatt_request_params_t req = {.read_req = {.handle = handle, .offset = offset}};
+
+    host_bt_reset();
+    host_harness_request(HOST_HARNESS_CONN_ID, opcode, &req, TEST_MTU - 1);
+    host_bt_complete_tx();
+    return host_gatt_last_rsp();
+}
+
+static wiced_bt_gatt_status_t test_prepare(uint16_t handle, uint16_t offset, uint16_t len)
+{
+    wiced_bt_gatt_request_params_t req = {.write_req = {.handle = handle, .offset = offset, .val_len = len,
+                                                        .p_val = test_value}};
+    wiced_bt_gatt_status_t status;
+
+    host_bt_reset();
+    status = host_harness_request(HOST_HARNESS_CONN_ID, GATT_REQ_PREPARE_WRITE, &req, TEST_MTU - 1);
+    host_bt_complete_tx();
+    return status;
+}
+
+static wiced_bt_gatt_status_t test_execute(wiced_bt_gatt_exec_flag_t exec_write)
+{
+    wiced_bt_gatt_request_params_t req = {.exec_write_req = {.exec_write = exec_write}};
+    wiced_bt_gatt_status_t status;
+
+    host_bt_reset();
+    status = host_harness_request(HOST_HARNESS_CONN_ID, GATT_REQ_EXECUTE_WRITE, &req, TEST_MTU - 1);
+    host_bt_complete_tx();
+    return status;
+}
+
+static void test_error_rsp(wiced_bt_gatt_opcode_t opcode, uint16_t handle, wiced_bt_gatt_status_t status)
+{
+    const host_gatt_rsp_t *p_rsp = host_gatt_last_rsp();
+
+    HOST_CHECK(HOST_GATT_RSP_ERROR == p_rsp->type);
+    HOST_CHECK(opcode == p_rsp->opcode);
+    HOST_CHECK(handle == p_rsp->handle);
+    HOST_CHECK(status == p_rsp->status);
+}
+
+/* A long read continues where the previous part stopped; offsets past the value are refused */
+static void test_read_offsets(void)
+{
+    const uint16_t name_len = (uint16_t)strlen(TEST_DEVICE_NAME);
+    const host_gatt_rsp_t *p_rsp;
+
+    p_rsp = test_read(GATT_REQ_READ, HDLC_GAP_DEVICE_NAME_VALUE, 0);
+    HOST_CHECK(HOST_GATT_RSP_READ == p_rsp->type);
+    HOST_CHECK(name_len == p_rsp->len);
+    HOST_CHECK(0 == memcmp(p_rsp->data, TEST_DEVICE_NAME, name_len));
+
+    /* Offsets need not follow the previous part */
+    p_rsp = test_read(GATT_REQ_READ_BLOB, HDLC_GAP_DEVICE_NAME_VALUE, 8);
+    HOST_CHECK(HOST_GATT_RSP_READ == p_rsp->type);
+    HOST_CHECK(6 == p_rsp->len);
+    HOST_CHECK(0 == memcmp(p_rsp->data, "Target", 6));
+
+    p_rsp = test_read(GATT_REQ_READ_BLOB, HDLC_GAP_DEVICE_NAME_VALUE, 2);
+    HOST_CHECK(HOST_GATT_RSP_READ == p_rsp->type);
+    HOST_CHECK((name_len - 2) == p_rsp->len);
+    HOST_CHECK(0 == memcmp(p_rsp->data, &TEST_DEVICE_NAME[2], name_len - 2));
+
+    test_read(GATT_REQ_READ_BLOB, HDLC_GAP_DEVICE_NAME_VALUE, name_len);
+    test_error_rsp(GATT_REQ_READ_BLOB, HDLC_GAP_DEVICE_NAME_VALUE, WICED_BT_GATT_INVALID_OFFSET);
+
+    test_read(GATT_REQ_READ_BLOB, HDLC_GAP_DEVICE_NAME_VALUE, name_len + 10);
+    test_error_rsp(GATT_REQ_READ_BLOB, HDLC_GAP_DEVICE_NAME_VALUE, WICED_BT_GATT_INVALID_OFFSET);
+}
+
+/* The queue refuses requests beyond its entries or its arena, and cancel releases it */
+static void test_prepare_queue_full(void)
+{
+    for (uint16_t i = 0; i < LE_APP_PREP_WRITE_MAX_ENTRIES; i++)
+    {
+        HOST_CHECK(WICED_BT_GATT_SUCCESS == test_prepare(HDLC_GAP_DEVICE_NAME_VALUE, i, 1));
+        HOST_CHECK(HOST_GATT_RSP_PREPARE_WRITE == host_gatt_last_rsp()->type);
+    }
+    HOST_CHECK(WICED_BT_GATT_PREPARE_Q_FULL == test_prepare(HDLC_GAP_DEVICE_NAME_VALUE, 16, 1));
+    test_error_rsp(GATT_REQ_PREPARE_WRITE, HDLC_GAP_DEVICE_NAME_VALUE, WICED_BT_GATT_PREPARE_Q_FULL);
+
+    HOST_CHECK(WICED_BT_GATT_SUCCESS == test_execute(GATT_PREPARE_WRITE_CANCEL));
+    HOST_CHECK(HOST_GATT_RSP_EXECUTE_WRITE == host_gatt_last_rsp()->type);
+
+    HOST_CHECK(WICED_BT_GATT_SUCCESS == test_prepare(HDLC_GAP_DEVICE_NAME_VALUE, 0, LE_APP_PREP_WRITE_ARENA_SIZE));
+    HOST_CHECK(WICED_BT_GATT_PREPARE_Q_FULL == test_prepare(HDLC_GAP_DEVICE_NAME_VALUE, 0, 1));
+    test_error_rsp(GATT_REQ_PREPARE_WRITE, HDLC_GAP_DEVICE_NAME_VALUE, WICED_BT_GATT_PREPARE_Q_FULL);
+    HOST_CHECK(WICED_BT_GATT_SUCCESS == test_execute(GATT_PREPARE_WRITE_CANCEL));
+
+    HOST_CHECK(WICED_BT_GATT_PREPARE_Q_FULL ==
+               test_prepare(HDLC_GAP_DEVICE_NAME_VALUE, 0, LE_APP_PREP_WRITE_ARENA_SIZE + 1));
+    HOST_CHECK(WICED_BT_GATT_SUCCESS == test_execute(GATT_PREPARE_WRITE_CANCEL));
+}
+
+/* A gap between the segments of one write rejects the whole queue and applies nothing */
+static void test_execute_offset_gap(void)
+{
+    const host_gatt_rsp_t *p_rsp;
+
+    memcpy(test_value, "Gap", 3);
+    HOST_CHECK(WICED_BT_GATT_SUCCESS == test_prepare(HDLC_GAP_DEVICE_NAME_VALUE, 0, 2));
+    HOST_CHECK(WICED_BT_GATT_SUCCESS == test_prepare(HDLC_GAP_DEVICE_NAME_VALUE, 3, 1));
+    HOST_CHECK(WICED_BT_GATT_INVALID_OFFSET == test_execute(GATT_PREPARE_WRITE_EXEC));
+    test_error_rsp(GATT_REQ_EXECUTE_WRITE, HDLC_GAP_DEVICE_NAME_VALUE, WICED_BT_GATT_INVALID_OFFSET);
+
+    p_rsp = test_read(GATT_REQ_READ, HDLC_GAP_DEVICE_NAME_VALUE, 0);
+    HOST_CHECK(HOST_GATT_RSP_READ == p_rsp->type);
+    HOST_CHECK(0 == memcmp(p_rsp->data, TEST_DEVICE_NAME, strlen(TEST_DEVICE_NAME)));
+
+    /* The rejected queue was released */
+    HOST_CHECK(WICED_BT_GATT_SUCCESS == test_execute(GATT_PREPARE_WRITE_EXEC));
+    HOST_CHECK(HOST_GATT_RSP_EXECUTE_WRITE == host_gatt_last_rsp()->type);
+}
+
+int main(void)
+{
+    host_harness_start(true);
+    HOST_CHECK(WICED_BT_GATT_SUCCESS == host_harness_connect(HOST_HARNESS_CONN_ID, 0x01, true));
+
+    test_read_offsets();
+    test_prepare_queue_full();
+    test_execute_offset_gap();
+
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,70 @@
+/*******************************************************************************
+ * File Name: test_le_app_start.c
+ *
+ * Description:
+ *   Host test: the application starts on the stubs, advertises and accepts a connection
+ *
+ * Related Document: See Readme.md
+ *
+ *******************************************************************************
+ * Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/*******************************************************************************
+ *        Header Files
+ *******************************************************************************/
+#include <stdlib.h>
+#include "host_harness.h"
+
+/*******************************************************************************
+ *        Function Definitions
+ *******************************************************************************/
+int main(void)
+{
+    wiced_bt_gatt_request_params_t req = {.remote_mtu = 247};
+    const host_gatt_rsp_t *p_rsp = host_gatt_last_rsp();
+
+    host_harness_start(true);
+    HOST_CHECK(host_bt_calls()->adv_starts > 0);
+    HOST_CHECK(BTM_BLE_ADVERT_OFF != host_bt_calls()->adv_mode);
+
+    HOST_CHECK(WICED_BT_GATT_SUCCESS == host_harness_connect(HOST_HARNESS_CONN_ID, 0x01, true));
+    HOST_CHECK(WICED_BT_GATT_SUCCESS == host_harness_request(HOST_HARNESS_CONN_ID, GATT_REQ_MTU, &req, 0));
+    HOST_CHECK(HOST_GATT_RSP_MTU == p_rsp->type);
+    HOST_CHECK(HOST_HARNESS_CONN_ID == p_rsp->conn_id);
+
+    HOST_CHECK(WICED_BT_GATT_SUCCESS == host_harness_connect(HOST_HARNESS_CONN_ID, 0x01, false));
+
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
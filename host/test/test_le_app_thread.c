@@ -0,0 +1,72 @@
+/*******************************************************************************
+ * File Name: test_le_app_thread.c
+ *
+ * Description:
+ *   Host test: a full application thread queue refuses the event and counts it as dropped
+ *
+ * Related Document: See Readme.md
+ *
+ *******************************************************************************
+ * Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/*******************************************************************************
+ *        Header Files
+ *******************************************************************************/
+#include <stdlib.h>
+#include "host_harness.h"
+#include "le_app_thread.h"
+
+/*******************************************************************************
+ *        Function Definitions
+ *******************************************************************************/
+int main(void)
+{
+    /* le_app_thread_init() is not called, so nothing drains the queues */
+    for (uint16_t i = 0; i < LE_APP_THREAD_QUEUE_SIZE; i++)
+    {
+        HOST_CHECK(le_app_thread_post(LE_APP_THREAD_PRODUCER_STACK, LE_APP_EVT_ALERT_LEVEL, i));
+    }
+    HOST_CHECK(0 == le_app_thread_get_dropped());
+
+    HOST_CHECK(!le_app_thread_post(LE_APP_THREAD_PRODUCER_STACK, LE_APP_EVT_ALERT_LEVEL, 0));
+    HOST_CHECK(!le_app_thread_post(LE_APP_THREAD_PRODUCER_STACK, LE_APP_EVT_LED_TICK, 0));
+    HOST_CHECK(2 == le_app_thread_get_dropped());
+
+    /* Each producer has its own queue */
+    HOST_CHECK(le_app_thread_post(LE_APP_THREAD_PRODUCER_TIMER, LE_APP_EVT_LED_TICK, 0));
+    HOST_CHECK(2 == le_app_thread_get_dropped());
+
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,959 @@
+/*******************************************************************************
+ * File Name: le_app_adv.c
+ *
+ * Description:
+ *   Source file for the advertising policy. After a disconnection the last
+ *   peer is invited back with directed advertising before falling back to undirected.
+ *   Undirected advertising steps through burst, fast, slow and idle stages
+ *
+ * Related Document: See Readme.md
+ *
+ *******************************************************************************
+ * Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/*******************************************************************************
+ *        Header Files
+ *******************************************************************************/
+#include "le_app_adv.h"
+#include "le_app_event_handler.h"
+#include "le_app_conn.h"
+#include "le_app_log.h"
+#include "le_app_metrics.h"
+#include "le_app_trace.h"
+#include "le_app_utils.h"
+#include "wiced_timer.h"
+#include "cyabs_rtos.h"
+#include "cyhal.h"
+#include "cybsp.h"
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *        Macro Definitions
+ *******************************************************************************/
+/* Air time of a legacy advertising PDU with 31 bytes of data on the LE 1M PHY:
+ * preamble, access address, header, AdvA, data and CRC at 8 us per byte */
+#define LE_APP_ADV_PDU_US               ((1u + 4u + 2u + 6u + 31u + 3u) * 8u)
+
+/* Receive time after each PDU for a scan or connect request: T_IFS and the
+ * access address and header of a request */
+#define LE_APP_ADV_RX_US                (150u + 56u)
+
+/* Radio on time of one advertising event on the three primary channels */
+#define LE_APP_ADV_EVENT_US             (3u * (LE_APP_ADV_PDU_US + LE_APP_ADV_RX_US))
+
+/* Average advDelay added to every advertising interval */
+#define LE_APP_ADV_DELAY_US             (5000u)
+
+#define LE_APP_ADV_SLOT_US              (625u)
+
+/*******************************************************************************
+ *        Variable Definitions
+ *******************************************************************************/
+static le_app_adv_config_t le_app_adv_config =
+{
+    .directed_enable = WICED_TRUE,
+    .directed_window_ms = LE_APP_ADV_DIRECTED_WINDOW_MS,
+    .stages =
+    {
+        [LE_APP_ADV_STAGE_BURST] = { BTM_BLE_ADVERT_UNDIRECTED_HIGH, 10000u, 10000u, 10000u },
+        [LE_APP_ADV_STAGE_FAST]  = { BTM_BLE_ADVERT_UNDIRECTED_LOW,  50000u, 50000u, 50000u },
+        [LE_APP_ADV_STAGE_SLOW]  = { BTM_BLE_ADVERT_UNDIRECTED_LOW,  2000u,  20000u, 600000u },
+        [LE_APP_ADV_STAGE_IDLE]  = { BTM_BLE_ADVERT_OFF,             0u,     0u,     0u },
+    },
+    .history_window_ms = 600000u,
+    .burst_min_connects = 2u,
+};
+
+/* Ends the directed advertising window; runs in the stack context */
+static wiced_timer_t le_app_adv_window_timer;
+
+/* Last disconnected peer and whether it is being invited back */
+static wiced_bt_device_address_t le_app_adv_last_peer;
+static wiced_bt_ble_address_type_t le_app_adv_last_peer_type;
+static wiced_bool_t le_app_adv_reconnect_pending = WICED_FALSE;
+static wiced_bool_t le_app_adv_directed_active = WICED_FALSE;
+static cy_time_t le_app_adv_disconnect_time;
+
+static le_app_adv_reconnect_stats_t le_app_adv_stats[LE_APP_ADV_PATH_COUNT];
+
+/* Stage scheduler. The timer fires at the next on/off switch or stage end */
+static wiced_timer_t le_app_adv_stage_timer;
+static wiced_bool_t le_app_adv_stages_active = WICED_FALSE;
+static le_app_adv_stage_t le_app_adv_stage = LE_APP_ADV_STAGE_IDLE;
+static cy_time_t le_app_adv_stage_start;
+static wiced_bool_t le_app_adv_stage_on = WICED_FALSE;    /* Advertising in the current period */
+static wiced_bool_t le_app_adv_stage_logged = WICED_TRUE; /* Stage transition already logged */
+static le_app_adv_stage_stats_t le_app_adv_stage_stats[LE_APP_ADV_STAGE_COUNT];
+
+/* Times of the most recent connections, oldest overwritten first */
+static cy_time_t le_app_adv_history[LE_APP_ADV_HISTORY_SIZE];
+static uint8_t le_app_adv_history_count;
+static uint8_t le_app_adv_history_next;
+
+/* Stage names for le_app_adv_print_stats(); the log uses le_app_adv_stage_log_name() */
+static const char *const le_app_adv_stage_names[LE_APP_ADV_STAGE_COUNT] =
+{
+    "burst", "fast", "slow", "idle"
+};
+
+#ifdef CYBSP_USER_BTN
+static cyhal_gpio_callback_data_t le_app_adv_btn_cb_data;
+/* Time of the last press of the user button */
+static cy_time_t le_app_adv_btn_press_ms;
+#endif
+
+/*******************************************************************************
+ *        Function Prototypes
+ *******************************************************************************/
+static void le_app_adv_window_expired(WICED_TIMER_PARAM_TYPE cb_params);
+static wiced_result_t le_app_adv_start_directed(void);
+static wiced_result_t le_app_adv_enter_stage(le_app_adv_stage_t stage);
+static void le_app_adv_stop_stages(void);
+static void le_app_adv_account_stage(void);
+static void le_app_adv_schedule(void);
+static void le_app_adv_stage_tick(WICED_TIMER_PARAM_TYPE cb_params);
+static uint8_t le_app_adv_recent_connects(void);
+static le_app_log_str_t le_app_adv_stage_log_name(le_app_adv_stage_t stage);
+#ifdef CYBSP_USER_BTN
+static void le_app_adv_btn_handler(void *handler_arg, cyhal_gpio_event_t event);
+static int le_app_adv_wake_serialized(void *p_data);
+static int le_app_adv_print_serialized(void *p_data);
+#endif
+
+/*******************************************************************************
+ *        Function Definitions
+ *******************************************************************************/
+
+/**************************************************************************************************
+ * Function Name: le_app_adv_init
+ ***************************************************************************************************
+ * Summary:
+ *   This function prepares the reconnect window and stage timers with the default
+ *   configuration, and the user button that wakes advertising from the idle stage.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  wiced_result_t: WICED_BT_SUCCESS, or the error of the timer or button initialization
+ *
+ **************************************************************************************************/
+wiced_result_t le_app_adv_init(void)
+{
+    wiced_result_t wiced_result;
+
+    wiced_result = wiced_init_timer(&le_app_adv_window_timer, le_app_adv_window_expired, NULL,
+                                    WICED_MILLI_SECONDS_TIMER);
+    if (WICED_BT_SUCCESS != wiced_result)
+    {
+        return wiced_result;
+    }
+
+    wiced_result = wiced_init_timer(&le_app_adv_stage_timer, le_app_adv_stage_tick, NULL,
+                                    WICED_MILLI_SECONDS_TIMER);
+    if (WICED_BT_SUCCESS != wiced_result)
+    {
+        return wiced_result;
+    }
+
+#ifdef CYBSP_USER_BTN
+    if (CY_RSLT_SUCCESS != cyhal_gpio_init(CYBSP_USER_BTN, CYHAL_GPIO_DIR_INPUT, CYBSP_USER_BTN_DRIVE,
+                                           CYBSP_BTN_OFF))
+    {
+        return WICED_BT_ERROR;
+    }
+    le_app_adv_btn_cb_data.callback = le_app_adv_btn_handler;
+    le_app_adv_btn_cb_data.callback_arg = NULL;
+    cyhal_gpio_register_callback(CYBSP_USER_BTN, &le_app_adv_btn_cb_data);
+    cyhal_gpio_enable_event(CYBSP_USER_BTN, CYHAL_GPIO_IRQ_BOTH, CYHAL_ISR_PRIORITY_DEFAULT, true);
+#endif
+
+    return WICED_BT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_adv_start
+ ***************************************************************************************************
+ * Summary:
+ *   This function restarts the undirected advertising stages, unless the last peer is being
+ *   invited back. The burst stage is used after recent connections, otherwise the fast stage.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  wiced_result_t: Result of wiced_bt_start_advertisements()
+ *
+ **************************************************************************************************/
+wiced_result_t le_app_adv_start(void)
+{
+    if (le_app_adv_directed_active)
+    {
+        return WICED_BT_SUCCESS;
+    }
+
+    LE_APP_METRICS_INC(adv_restarts);
+    LE_APP_TRACE(LE_APP_TRACE_ADV_START, 0);
+    return le_app_adv_enter_stage((le_app_adv_recent_connects() >= le_app_adv_config.burst_min_connects) ?
+                                  LE_APP_ADV_STAGE_BURST : LE_APP_ADV_STAGE_FAST);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_adv_wake
+ ***************************************************************************************************
+ * Summary:
+ *   This function leaves the idle stage and restarts advertising with the burst stage. It must
+ *   run in the stack context; the user button calls it through wiced_app_event_serialize().
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_adv_wake(void)
+{
+    if (le_app_adv_stages_active && (LE_APP_ADV_STAGE_IDLE == le_app_adv_stage))
+    {
+        LE_APP_LOG("Advertising woken\r\n");
+        le_app_adv_enter_stage(LE_APP_ADV_STAGE_BURST);
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_adv_on_disconnect
+ ***************************************************************************************************
+ * Summary:
+ *   This function restarts advertising after a disconnection. When enabled, directed
+ *   advertising to the peer runs for the configured window before undirected advertising.
+ *
+ * Parameters:
+ *   wiced_bt_device_address_t bd_addr   : Address of the disconnected peer
+ *   wiced_bt_ble_address_type_t addr_type : Address type of the disconnected peer
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_adv_on_disconnect(wiced_bt_device_address_t bd_addr, wiced_bt_ble_address_type_t addr_type)
+{
+    memcpy(le_app_adv_last_peer, bd_addr, sizeof(wiced_bt_device_address_t));
+    le_app_adv_last_peer_type = addr_type;
+    le_app_adv_reconnect_pending = WICED_TRUE;
+    cy_rtos_get_time(&le_app_adv_disconnect_time);
+
+    /* Directed advertising would hide the device from every other locator, so it is
+     * only used when no other peer is connected */
+    if (le_app_adv_config.directed_enable && (0 == le_app_conn_count()) &&
+        (WICED_BT_SUCCESS == le_app_adv_start_directed()))
+    {
+        le_app_adv_stop_stages();
+        le_app_adv_directed_active = WICED_TRUE;
+        wiced_start_timer(&le_app_adv_window_timer, le_app_adv_config.directed_window_ms);
+        LE_APP_LOG("Directed advertising to " LE_APP_LOG_BDA_FMT "\r\n", LE_APP_LOG_BDA_ARGS(bd_addr));
+        return;
+    }
+
+    /* Restart the advertising stages if they were paused with every slot in use */
+    if (!le_app_adv_stages_active)
+    {
+        le_app_adv_start();
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_adv_on_connect
+ ***************************************************************************************************
+ * Summary:
+ *   This function pauses the advertising stages and records the connection in the recent
+ *   history. It ends the reconnect window and records the reconnect latency when the last
+ *   disconnected peer comes back.
+ *
+ * Parameters:
+ *   wiced_bt_device_address_t bd_addr   : Address of the connected peer
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_adv_on_connect(wiced_bt_device_address_t bd_addr)
+{
+    le_app_adv_reconnect_stats_t *p_stats;
+    le_app_adv_path_t path;
+    cy_time_t now;
+    uint32_t elapsed_ms;
+    uint8_t bucket = 0;
+
+    cy_rtos_get_time(&now);
+
+    /* The stack stopped advertising for the connection */
+    le_app_adv_stop_stages();
+
+    le_app_adv_history[le_app_adv_history_next] = now;
+    le_app_adv_history_next = (le_app_adv_history_next + 1) % LE_APP_ADV_HISTORY_SIZE;
+    if (LE_APP_ADV_HISTORY_SIZE > le_app_adv_history_count)
+    {
+        le_app_adv_history_count++;
+    }
+
+    path = le_app_adv_directed_active ? LE_APP_ADV_PATH_DIRECTED : LE_APP_ADV_PATH_UNDIRECTED;
+    if (le_app_adv_directed_active)
+    {
+        wiced_stop_timer(&le_app_adv_window_timer);
+        le_app_adv_directed_active = WICED_FALSE;
+    }
+
+    if (!le_app_adv_reconnect_pending ||
+        (0 != memcmp(bd_addr, le_app_adv_last_peer, sizeof(wiced_bt_device_address_t))))
+    {
+        return;
+    }
+    le_app_adv_reconnect_pending = WICED_FALSE;
+
+    elapsed_ms = (uint32_t)(now - le_app_adv_disconnect_time);
+    while (((2u << bucket) <= elapsed_ms) && (bucket < (LE_APP_ADV_LATENCY_BUCKETS - 1)))
+    {
+        bucket++;
+    }
+
+    p_stats = &le_app_adv_stats[path];
+    p_stats->count++;
+    p_stats->total_ms += elapsed_ms;
+    p_stats->buckets[bucket]++;
+    if (elapsed_ms > p_stats->max_ms)
+    {
+        p_stats->max_ms = elapsed_ms;
+    }
+
+    LE_APP_LOG("Reconnected after %lu ms (%s)\r\n", (unsigned long)elapsed_ms,
+               LE_APP_LOG_STR((LE_APP_ADV_PATH_DIRECTED == path) ?
+                              LE_APP_LOG_NAME("directed") : LE_APP_LOG_NAME("undirected")));
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_adv_on_state_changed
+ ***************************************************************************************************
+ * Summary:
+ *   This function follows the advertising state reported by the stack and logs stage
+ *   transitions once the stack applied them. High duty directed advertising is limited by
+ *   the controller, so it is restarted until the window ends.
+ *
+ * Parameters:
+ *   wiced_bt_ble_advert_mode_t mode     : New advertising mode
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_adv_on_state_changed(wiced_bt_ble_advert_mode_t mode)
+{
+    if (le_app_adv_directed_active && (BTM_BLE_ADVERT_OFF == mode) && (0 == le_app_conn_count()))
+    {
+        le_app_adv_start_directed();
+    }
+
+    if (le_app_adv_stages_active && !le_app_adv_stage_logged)
+    {
+        le_app_adv_stage_logged = WICED_TRUE;
+        LE_APP_LOG("Advertising stage %s: %s, about %lu us radio on per second\r\n",
+                   LE_APP_LOG_STR(le_app_adv_stage_log_name(le_app_adv_stage)),
+                   LE_APP_LOG_STR(get_bt_advert_mode_name(mode)),
+                   (unsigned long)le_app_adv_radio_on_rate(le_app_adv_stage));
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_adv_set_config
+ ***************************************************************************************************
+ * Summary:
+ *   This function replaces the advertising policy configuration. It applies from the next
+ *   stage or disconnection.
+ *
+ * Parameters:
+ *   const le_app_adv_config_t *p_config : New configuration
+ *
+ * Return:
+ *  wiced_result_t: WICED_BT_SUCCESS, or WICED_BT_BADARG if directed advertising is enabled
+ *                  with an empty window or a stage advertises longer than the stack allows
+ *
+ **************************************************************************************************/
+wiced_result_t le_app_adv_set_config(const le_app_adv_config_t *p_config)
+{
+    const le_app_adv_stage_config_t *p_stage;
+
+    if (p_config->directed_enable && (0 == p_config->directed_window_ms))
+    {
+        return WICED_BT_BADARG;
+    }
+
+    for (uint8_t stage = 0; stage < LE_APP_ADV_STAGE_COUNT; stage++)
+    {
+        p_stage = &p_config->stages[stage];
+        if ((BTM_BLE_ADVERT_OFF != p_stage->mode) &&
+            ((0 == p_stage->on_ms) || (p_stage->on_ms > p_stage->period_ms) ||
+             (LE_APP_ADV_STACK_TIMEOUT_MS < p_stage->on_ms)))
+        {
+            return WICED_BT_BADARG;
+        }
+    }
+
+    le_app_adv_config = *p_config;
+
+    return WICED_BT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_adv_get_config
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns the advertising policy configuration.
+ *
+ * Parameters:
+ *   le_app_adv_config_t *p_config       : Receives the configuration
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_adv_get_config(le_app_adv_config_t *p_config)
+{
+    *p_config = le_app_adv_config;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_adv_get_reconnect_stats
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns the reconnect latency of one advertising path.
+ *
+ * Parameters:
+ *   le_app_adv_path_t path                  : Advertising path
+ *   le_app_adv_reconnect_stats_t *p_stats   : Receives the statistics
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_adv_get_reconnect_stats(le_app_adv_path_t path, le_app_adv_reconnect_stats_t *p_stats)
+{
+    if (LE_APP_ADV_PATH_COUNT > path)
+    {
+        *p_stats = le_app_adv_stats[path];
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_adv_get_stage_stats
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns the time spent in a stage and its estimated radio on time.
+ *
+ * Parameters:
+ *   le_app_adv_stage_t stage                : Stage
+ *   le_app_adv_stage_stats_t *p_stats       : Receives the statistics
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_adv_get_stage_stats(le_app_adv_stage_t stage, le_app_adv_stage_stats_t *p_stats)
+{
+    if (LE_APP_ADV_STAGE_COUNT > stage)
+    {
+        /* Bring the running stage up to date first */
+        if (le_app_adv_stages_active && (stage == le_app_adv_stage))
+        {
+            le_app_adv_account_stage();
+        }
+        *p_stats = le_app_adv_stage_stats[stage];
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_adv_radio_on_rate
+ ***************************************************************************************************
+ * Summary:
+ *   This function estimates the radio on time of a stage per second, from the advertising
+ *   interval, the duty cycle and the air time of a legacy advertising event on three channels.
+ *   It is an upper bound, as every packet is assumed to carry 31 bytes of data.
+ *
+ * Parameters:
+ *   le_app_adv_stage_t stage            : Stage
+ *
+ * Return:
+ *  uint32_t: Estimated radio on time in microseconds per second
+ *
+ **************************************************************************************************/
+uint32_t le_app_adv_radio_on_rate(le_app_adv_stage_t stage)
+{
+    const le_app_adv_stage_config_t *p_stage = &le_app_adv_config.stages[stage];
+    uint32_t interval_us;
+    uint32_t rate;
+
+    switch (p_stage->mode)
+    {
+    case BTM_BLE_ADVERT_UNDIRECTED_HIGH:
+        interval_us = LE_APP_ADV_HIGH_INTERVAL_SLOTS * LE_APP_ADV_SLOT_US;
+        break;
+
+    case BTM_BLE_ADVERT_UNDIRECTED_LOW:
+        interval_us = LE_APP_ADV_LOW_INTERVAL_SLOTS * LE_APP_ADV_SLOT_US;
+        break;
+
+    default:
+        return 0;
+    }
+
+    rate = (uint32_t)(((uint64_t)LE_APP_ADV_EVENT_US * 1000000u) / (interval_us + LE_APP_ADV_DELAY_US));
+    if ((0 != p_stage->period_ms) && (p_stage->on_ms < p_stage->period_ms))
+    {
+        rate = (uint32_t)(((uint64_t)rate * p_stage->on_ms) / p_stage->period_ms);
+    }
+
+    return rate;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_adv_print_stats
+ ***************************************************************************************************
+ * Summary:
+ *   This function prints the reconnect latency of both advertising paths and the time and
+ *   estimated radio use of each stage.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_adv_print_stats(void)
+{
+    static const char *const names[LE_APP_ADV_PATH_COUNT] = { "Directed", "Undirected" };
+    le_app_adv_stage_stats_t stage_stats;
+
+    printf("Reconnect latency in ms\r\n");
+    for (uint8_t path = 0; path < LE_APP_ADV_PATH_COUNT; path++)
+    {
+        le_app_adv_reconnect_stats_t *p_stats = &le_app_adv_stats[path];
+
+        printf("%s: count %lu avg %lu max %lu\r\n  log2 buckets:", names[path],
+               (unsigned long)p_stats->count,
+               (unsigned long)(p_stats->count ? (p_stats->total_ms / p_stats->count) : 0),
+               (unsigned long)p_stats->max_ms);
+        for (uint8_t bucket = 0; bucket < LE_APP_ADV_LATENCY_BUCKETS; bucket++)
+        {
+            printf(" %lu", (unsigned long)p_stats->buckets[bucket]);
+        }
+        printf("\r\n");
+    }
+
+    printf("Advertising stages\r\n");
+    for (uint8_t stage = 0; stage < LE_APP_ADV_STAGE_COUNT; stage++)
+    {
+        le_app_adv_get_stage_stats((le_app_adv_stage_t)stage, &stage_stats);
+        printf("%s: entries %lu time %lu ms radio on %lu ms (%lu us/s)\r\n", le_app_adv_stage_names[stage],
+               (unsigned long)stage_stats.entries, (unsigned long)stage_stats.time_ms,
+               (unsigned long)stage_stats.radio_on_ms,
+               (unsigned long)le_app_adv_radio_on_rate((le_app_adv_stage_t)stage));
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_adv_start_directed
+ ***************************************************************************************************
+ * Summary:
+ *   This function starts high duty directed advertising to the last disconnected peer.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  wiced_result_t: Result of wiced_bt_start_advertisements()
+ *
+ **************************************************************************************************/
+static wiced_result_t le_app_adv_start_directed(void)
+{
+    LE_APP_METRICS_INC(adv_restarts);
+    LE_APP_TRACE(LE_APP_TRACE_ADV_START, 0);
+    return wiced_bt_start_advertisements(BTM_BLE_ADVERT_DIRECTED_HIGH, le_app_adv_last_peer_type,
+                                         le_app_adv_last_peer);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_adv_window_expired
+ ***************************************************************************************************
+ * Summary:
+ *   This function ends the directed advertising window and falls back to the undirected
+ *   advertising stages while connection slots remain free.
+ *
+ * Parameters:
+ *   WICED_TIMER_PARAM_TYPE cb_params    : Unused
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_adv_window_expired(WICED_TIMER_PARAM_TYPE cb_params)
+{
+    le_app_adv_directed_active = WICED_FALSE;
+
+    if (LE_APP_MAX_CONNECTIONS > le_app_conn_count())
+    {
+        LE_APP_LOG("Directed advertising window ended\r\n");
+        le_app_adv_start();
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_adv_enter_stage
+ ***************************************************************************************************
+ * Summary:
+ *   This function switches to a stage, starting its advertising and its timer.
+ *
+ * Parameters:
+ *   le_app_adv_stage_t stage            : Stage to enter
+ *
+ * Return:
+ *  wiced_result_t: Result of wiced_bt_start_advertisements()
+ *
+ **************************************************************************************************/
+static wiced_result_t le_app_adv_enter_stage(le_app_adv_stage_t stage)
+{
+    const le_app_adv_stage_config_t *p_stage = &le_app_adv_config.stages[stage];
+    wiced_result_t wiced_result;
+
+    le_app_adv_stop_stages();
+
+    le_app_adv_stages_active = WICED_TRUE;
+    le_app_adv_stage = stage;
+    cy_rtos_get_time(&le_app_adv_stage_start);
+    le_app_adv_stage_stats[stage].entries++;
+    le_app_adv_stage_on = (BTM_BLE_ADVERT_OFF != p_stage->mode) ? WICED_TRUE : WICED_FALSE;
+
+    /* The transition is logged when the stack reports the new advertising state */
+    le_app_adv_stage_logged = WICED_FALSE;
+    wiced_result = wiced_bt_start_advertisements(p_stage->mode, 0, NULL);
+
+    le_app_adv_schedule();
+
+    return wiced_result;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_adv_stop_stages
+ ***************************************************************************************************
+ * Summary:
+ *   This function leaves the current stage without changing the advertising state.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_adv_stop_stages(void)
+{
+    if (le_app_adv_stages_active)
+    {
+        le_app_adv_account_stage();
+        wiced_stop_timer(&le_app_adv_stage_timer);
+        le_app_adv_stages_active = WICED_FALSE;
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_adv_account_stage
+ ***************************************************************************************************
+ * Summary:
+ *   This function adds the time since the last update to the statistics of the current stage.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_adv_account_stage(void)
+{
+    le_app_adv_stage_stats_t *p_stats = &le_app_adv_stage_stats[le_app_adv_stage];
+    static cy_time_t accounted_until;
+    cy_time_t now;
+    uint32_t elapsed_ms;
+
+    cy_rtos_get_time(&now);
+    if ((int32_t)(accounted_until - le_app_adv_stage_start) < 0)
+    {
+        accounted_until = le_app_adv_stage_start;
+    }
+    elapsed_ms = (uint32_t)(now - accounted_until);
+    accounted_until = now;
+
+    p_stats->time_ms += elapsed_ms;
+    p_stats->radio_on_ms += (uint32_t)(((uint64_t)elapsed_ms * le_app_adv_radio_on_rate(le_app_adv_stage)) / 1000000u);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_adv_schedule
+ ***************************************************************************************************
+ * Summary:
+ *   This function starts the stage timer for the next on/off switch or the end of the stage,
+ *   whichever comes first.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_adv_schedule(void)
+{
+    const le_app_adv_stage_config_t *p_stage = &le_app_adv_config.stages[le_app_adv_stage];
+    uint32_t timeout_ms = UINT32_MAX;
+    uint32_t elapsed_ms;
+    uint32_t in_period_ms;
+    cy_time_t now;
+
+    cy_rtos_get_time(&now);
+    elapsed_ms = (uint32_t)(now - le_app_adv_stage_start);
+
+    if (0 != p_stage->duration_ms)
+    {
+        timeout_ms = (elapsed_ms < p_stage->duration_ms) ? (p_stage->duration_ms - elapsed_ms) : 1u;
+    }
+
+    if ((BTM_BLE_ADVERT_OFF != p_stage->mode) && (p_stage->on_ms < p_stage->period_ms))
+    {
+        in_period_ms = elapsed_ms % p_stage->period_ms;
+        timeout_ms = MIN(timeout_ms, (in_period_ms < p_stage->on_ms) ? (p_stage->on_ms - in_period_ms)
+                                                                     : (p_stage->period_ms - in_period_ms));
+    }
+
+    if (UINT32_MAX != timeout_ms)
+    {
+        wiced_start_timer(&le_app_adv_stage_timer, timeout_ms);
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_adv_stage_tick
+ ***************************************************************************************************
+ * Summary:
+ *   This function moves to the next stage when the current one ends, and otherwise switches
+ *   advertising on or off within the period of a duty cycled stage.
+ *
+ * Parameters:
+ *   WICED_TIMER_PARAM_TYPE cb_params    : Unused
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_adv_stage_tick(WICED_TIMER_PARAM_TYPE cb_params)
+{
+    const le_app_adv_stage_config_t *p_stage = &le_app_adv_config.stages[le_app_adv_stage];
+    wiced_bool_t want_on;
+    uint32_t elapsed_ms;
+    cy_time_t now;
+
+    if (!le_app_adv_stages_active)
+    {
+        return;
+    }
+
+    cy_rtos_get_time(&now);
+    elapsed_ms = (uint32_t)(now - le_app_adv_stage_start);
+
+    if ((0 != p_stage->duration_ms) && (elapsed_ms >= p_stage->duration_ms) &&
+        (LE_APP_ADV_STAGE_IDLE != le_app_adv_stage))
+    {
+        le_app_adv_enter_stage((le_app_adv_stage_t)(le_app_adv_stage + 1));
+        return;
+    }
+
+    if ((BTM_BLE_ADVERT_OFF == p_stage->mode) || (p_stage->on_ms >= p_stage->period_ms))
+    {
+        le_app_adv_schedule();
+        return;
+    }
+
+    want_on = ((elapsed_ms % p_stage->period_ms) < p_stage->on_ms) ? WICED_TRUE : WICED_FALSE;
+    if (want_on != le_app_adv_stage_on)
+    {
+        le_app_adv_stage_on = want_on;
+        wiced_bt_start_advertisements(want_on ? p_stage->mode : BTM_BLE_ADVERT_OFF, 0, NULL);
+    }
+
+    le_app_adv_schedule();
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_adv_recent_connects
+ ***************************************************************************************************
+ * Summary:
+ *   This function counts the connections within the configured history window.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  uint8_t: Number of recent connections
+ *
+ **************************************************************************************************/
+static uint8_t le_app_adv_recent_connects(void)
+{
+    uint8_t recent = 0;
+    cy_time_t now;
+
+    cy_rtos_get_time(&now);
+    for (uint8_t index = 0; index < le_app_adv_history_count; index++)
+    {
+        if ((uint32_t)(now - le_app_adv_history[index]) <= le_app_adv_config.history_window_ms)
+        {
+            recent++;
+        }
+    }
+
+    return recent;
+}
+
+#ifdef CYBSP_USER_BTN
+/**************************************************************************************************
+ * Function Name: le_app_adv_btn_handler
+ ***************************************************************************************************
+ * Summary:
+ *   This interrupt handler hands a user button press over to the stack context, where
+ *   advertising is woken from the idle stage. A release after a long press prints the
+ *   statistics, also from the stack context.
+ *
+ * Parameters:
+ *   void *handler_arg           : Unused
+ *   cyhal_gpio_event_t event    : GPIO event
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_adv_btn_handler(void *handler_arg, cyhal_gpio_event_t event)
+{
+    cy_time_t now;
+
+    cy_rtos_get_time(&now);
+
+    /* Both edges raise the event; the level tells a press from a release */
+    if (CYBSP_BTN_PRESSED == cyhal_gpio_read(CYBSP_USER_BTN))
+    {
+        le_app_adv_btn_press_ms = now;
+        wiced_app_event_serialize(le_app_adv_wake_serialized, NULL);
+    }
+    else if ((now - le_app_adv_btn_press_ms) >= LE_APP_ADV_BTN_LONG_PRESS_MS)
+    {
+        wiced_app_event_serialize(le_app_adv_print_serialized, NULL);
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_adv_wake_serialized
+ ***************************************************************************************************
+ * Summary:
+ *   This function wakes advertising from the stack context.
+ *
+ * Parameters:
+ *   void *p_data                : Unused
+ *
+ * Return:
+ *  int: 0
+ *
+ **************************************************************************************************/
+static int le_app_adv_wake_serialized(void *p_data)
+{
+    le_app_adv_wake();
+
+    return 0;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_adv_print_serialized
+ ***************************************************************************************************
+ * Summary:
+ *   This function prints the statistics from the stack context, which owns most of them.
+ *
+ * Parameters:
+ *   void *p_data                : Unused
+ *
+ * Return:
+ *  int: 0
+ *
+ **************************************************************************************************/
+static int le_app_adv_print_serialized(void *p_data)
+{
+    le_app_print_stats();
+
+    return 0;
+}
+#endif
+
+/**************************************************************************************************
+ * Function Name: le_app_adv_stage_log_name
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns the name of a stage for LE_APP_LOG().
+ *
+ * Parameters:
+ *   le_app_adv_stage_t stage    : Stage
+ *
+ * Return:
+ *  le_app_log_str_t: Name of the stage
+ *
+ **************************************************************************************************/
+static le_app_log_str_t le_app_adv_stage_log_name(le_app_adv_stage_t stage)
+{
+    switch (stage)
+    {
+    case LE_APP_ADV_STAGE_BURST:
+        return LE_APP_LOG_NAME("burst");
+    case LE_APP_ADV_STAGE_FAST:
+        return LE_APP_LOG_NAME("fast");
+    case LE_APP_ADV_STAGE_SLOW:
+        return LE_APP_LOG_NAME("slow");
+    default:
+        return LE_APP_LOG_NAME("idle");
+    }
+}
+
+/* [] END OF FILE */
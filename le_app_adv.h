@@ -0,0 +1,335 @@
+/*******************************************************************************
+* File Name: le_app_adv.h
+*
+* Description:
+*   Header file for the advertising policy. After a disconnection the last
+*   peer is invited back with directed advertising before falling back to undirected.
+*   Undirected advertising steps through burst, fast, slow and idle stages
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef LE_APP_ADV_H_
+#define LE_APP_ADV_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_ble.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Default length of the directed advertising window after a disconnection */
+#define LE_APP_ADV_DIRECTED_WINDOW_MS   (3000u)
+
+/* Number of log2 buckets of the reconnect latency histogram; bucket n counts
+ * reconnects taking [2^n, 2^(n+1)) ms, the last bucket everything longer */
+#define LE_APP_ADV_LATENCY_BUCKETS      (14u)
+
+/* Undirected advertising intervals in 0.625 ms slots. Keep in sync with
+ * HostHighAdvIntervalMax and HostLowAdvIntervalMax in design.cybt */
+#define LE_APP_ADV_HIGH_INTERVAL_SLOTS  (30u)
+#define LE_APP_ADV_LOW_INTERVAL_SLOTS   (1280u)
+
+/* Stack timeout of undirected advertising. Keep in sync with HostHighAdvTimeout and
+ * HostLowAdvTimeout in design.cybt; a stage should restart advertising more often */
+#define LE_APP_ADV_STACK_TIMEOUT_MS     (60000u)
+
+/* Number of recent connections remembered to choose the first stage */
+#define LE_APP_ADV_HISTORY_SIZE         (4u)
+
+/* User button hold time that prints the statistics on release (see le_app_print_stats()) */
+#define LE_APP_ADV_BTN_LONG_PRESS_MS    (2000u)
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+/* Advertising that brought a peer back */
+typedef enum
+{
+    LE_APP_ADV_PATH_DIRECTED,
+    LE_APP_ADV_PATH_UNDIRECTED,
+    LE_APP_ADV_PATH_COUNT
+} le_app_adv_path_t;
+
+/* Undirected advertising stages, in the order they are run */
+typedef enum
+{
+    LE_APP_ADV_STAGE_BURST,         /* High duty, right after a busy period */
+    LE_APP_ADV_STAGE_FAST,          /* Low duty, continuous */
+    LE_APP_ADV_STAGE_SLOW,          /* Low duty, switched on for part of each period */
+    LE_APP_ADV_STAGE_IDLE,          /* Off until woken */
+    LE_APP_ADV_STAGE_COUNT
+} le_app_adv_stage_t;
+
+/* Configuration of one stage */
+typedef struct
+{
+    wiced_bt_ble_advert_mode_t mode;    /* BTM_BLE_ADVERT_UNDIRECTED_HIGH/LOW, or OFF */
+    uint32_t on_ms;                 /* Advertising time in each period */
+    uint32_t period_ms;             /* Period; equal to on_ms for continuous advertising */
+    uint32_t duration_ms;           /* Time before the next stage; 0 stays in the stage */
+} le_app_adv_stage_config_t;
+
+/* Runtime configuration of the advertising policy */
+typedef struct
+{
+    wiced_bool_t directed_enable;   /* Invite the last peer back with directed advertising */
+    uint32_t directed_window_ms;    /* Time spent on directed advertising before undirected */
+    le_app_adv_stage_config_t stages[LE_APP_ADV_STAGE_COUNT];
+    uint32_t history_window_ms;     /* Connections within this time count as recent */
+    uint8_t burst_min_connects;     /* Recent connections needed to start with the burst stage */
+} le_app_adv_config_t;
+
+/* Time spent in a stage and its estimated radio use */
+typedef struct
+{
+    uint32_t entries;
+    uint32_t time_ms;
+    uint32_t radio_on_ms;           /* Estimated radio on time while in the stage */
+} le_app_adv_stage_stats_t;
+
+/* Time from disconnection to reconnection of the same peer */
+typedef struct
+{
+    uint32_t count;
+    uint32_t total_ms;
+    uint32_t max_ms;
+    uint32_t buckets[LE_APP_ADV_LATENCY_BUCKETS];
+} le_app_adv_reconnect_stats_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+
+/**************************************************************************************************
+* Function Name: le_app_adv_init
+***************************************************************************************************
+* Summary:
+*   This function prepares the reconnect window timer with the default configuration.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  wiced_result_t: WICED_BT_SUCCESS, or the error of the timer initialization
+*
+**************************************************************************************************/
+wiced_result_t le_app_adv_init(void);
+
+/**************************************************************************************************
+* Function Name: le_app_adv_start
+***************************************************************************************************
+* Summary:
+*   This function restarts the undirected advertising stages, unless the last peer is being
+*   invited back. The burst stage is used after recent connections, otherwise the fast stage.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  wiced_result_t: Result of wiced_bt_start_advertisements()
+*
+**************************************************************************************************/
+wiced_result_t le_app_adv_start(void);
+
+/**************************************************************************************************
+* Function Name: le_app_adv_wake
+***************************************************************************************************
+* Summary:
+*   This function leaves the idle stage and restarts advertising with the burst stage. It must
+*   run in the stack context; the user button calls it through wiced_app_event_serialize().
+*
+* Parameters:
+*   None
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_adv_wake(void);
+
+/**************************************************************************************************
+* Function Name: le_app_adv_on_disconnect
+***************************************************************************************************
+* Summary:
+*   This function restarts advertising after a disconnection. When enabled, directed
+*   advertising to the peer runs for the configured window before undirected advertising.
+*
+* Parameters:
+*   wiced_bt_device_address_t bd_addr   : Address of the disconnected peer
+*   wiced_bt_ble_address_type_t addr_type : Address type of the disconnected peer
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_adv_on_disconnect(wiced_bt_device_address_t bd_addr, wiced_bt_ble_address_type_t addr_type);
+
+/**************************************************************************************************
+* Function Name: le_app_adv_on_connect
+***************************************************************************************************
+* Summary:
+*   This function pauses the advertising stages and records the connection in the recent
+*   history. It ends the reconnect window and records the reconnect latency when the last
+*   disconnected peer comes back.
+*
+* Parameters:
+*   wiced_bt_device_address_t bd_addr   : Address of the connected peer
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_adv_on_connect(wiced_bt_device_address_t bd_addr);
+
+/**************************************************************************************************
+* Function Name: le_app_adv_on_state_changed
+***************************************************************************************************
+* Summary:
+*   This function follows the advertising state reported by the stack and logs stage
+*   transitions once the stack applied them. High duty directed advertising is limited by
+*   the controller, so it is restarted until the window ends.
+*
+* Parameters:
+*   wiced_bt_ble_advert_mode_t mode     : New advertising mode
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_adv_on_state_changed(wiced_bt_ble_advert_mode_t mode);
+
+/**************************************************************************************************
+* Function Name: le_app_adv_set_config
+***************************************************************************************************
+* Summary:
+*   This function replaces the advertising policy configuration. It applies from the next
+*   stage or disconnection.
+*
+* Parameters:
+*   const le_app_adv_config_t *p_config : New configuration
+*
+* Return:
+*  wiced_result_t: WICED_BT_SUCCESS, or WICED_BT_BADARG if directed advertising is enabled
+*                  with an empty window or a stage advertises longer than the stack allows
+*
+**************************************************************************************************/
+wiced_result_t le_app_adv_set_config(const le_app_adv_config_t *p_config);
+
+/**************************************************************************************************
+* Function Name: le_app_adv_get_config
+***************************************************************************************************
+* Summary:
+*   This function returns the advertising policy configuration.
+*
+* Parameters:
+*   le_app_adv_config_t *p_config       : Receives the configuration
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_adv_get_config(le_app_adv_config_t *p_config);
+
+/**************************************************************************************************
+* Function Name: le_app_adv_get_reconnect_stats
+***************************************************************************************************
+* Summary:
+*   This function returns the reconnect latency of one advertising path.
+*
+* Parameters:
+*   le_app_adv_path_t path                  : Advertising path
+*   le_app_adv_reconnect_stats_t *p_stats   : Receives the statistics
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_adv_get_reconnect_stats(le_app_adv_path_t path, le_app_adv_reconnect_stats_t *p_stats);
+
+/**************************************************************************************************
+* Function Name: le_app_adv_get_stage_stats
+***************************************************************************************************
+* Summary:
+*   This function returns the time spent in a stage and its estimated radio on time.
+*
+* Parameters:
+*   le_app_adv_stage_t stage                : Stage
+*   le_app_adv_stage_stats_t *p_stats       : Receives the statistics
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_adv_get_stage_stats(le_app_adv_stage_t stage, le_app_adv_stage_stats_t *p_stats);
+
+/**************************************************************************************************
+* Function Name: le_app_adv_radio_on_rate
+***************************************************************************************************
+* Summary:
+*   This function estimates the radio on time of a stage per second, from the advertising
+*   interval, the duty cycle and the air time of a legacy advertising event on three channels.
+*   It is an upper bound, as every packet is assumed to carry 31 bytes of data.
+*
+* Parameters:
+*   le_app_adv_stage_t stage            : Stage
+*
+* Return:
+*  uint32_t: Estimated radio on time in microseconds per second
+*
+**************************************************************************************************/
+uint32_t le_app_adv_radio_on_rate(le_app_adv_stage_t stage);
+
+/**************************************************************************************************
+* Function Name: le_app_adv_print_stats
+***************************************************************************************************
+* Summary:
+*   This function prints the reconnect latency of both advertising paths and the time and
+*   estimated radio use of each stage.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_adv_print_stats(void);
+
+#endif /* LE_APP_ADV_H_ */
+
+/* [] END OF FILE */
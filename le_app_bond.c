@@ -0,0 +1,920 @@
+/*******************************************************************************
+ * File Name: le_app_bond.c
+ *
+ * Description:
+ *   Source file for the bonded device store. Link keys are cached in RAM
+ *   for constant time lookup by address and persisted to flash
+ *
+ * Related Document: See Readme.md
+ *
+ *******************************************************************************
+ * Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/*******************************************************************************
+ *        Header Files
+ *******************************************************************************/
+#include "le_app_bond.h"
+#include "le_app_log.h"
+#include "le_app_pm.h"
+#include "le_app_thread.h"
+#include "wiced_timer.h"
+#include "cyhal.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *        Macro Definitions
+ *******************************************************************************/
+/* Marks a valid store in flash; the layout version is in the low byte */
+#define LE_APP_BOND_STORE_MAGIC         (0x424E4402u)
+
+/* Number of copies of the store in flash. Writes alternate between them */
+#define LE_APP_BOND_COPIES              (2u)
+
+/* Flash reserved for each copy: the store rounded up to whole rows */
+#define LE_APP_BOND_COPY_SIZE           (((sizeof(le_app_bond_store_t) + LE_APP_BOND_FLASH_ROW_SIZE - 1u) / \
+                                          LE_APP_BOND_FLASH_ROW_SIZE) * LE_APP_BOND_FLASH_ROW_SIZE)
+
+/*******************************************************************************
+ *        Structures and Enumerations
+ *******************************************************************************/
+/* Bonded peer */
+typedef struct
+{
+    wiced_bt_device_link_keys_t keys;
+    uint8_t db_hash[LE_APP_BOND_DB_HASH_SIZE];  /* Database Hash the peer last knew */
+    uint8_t client_features;        /* Client Supported Features of the peer */
+    uint8_t caching_valid;          /* db_hash and client_features are set */
+    uint8_t in_use;
+    uint32_t last_used;             /* Store sequence number of the last use */
+} le_app_bond_entry_t;
+
+/* Image of the store; kept in RAM and written to flash as a whole */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t size;                  /* sizeof(le_app_bond_store_t) when written */
+    uint32_t generation;            /* Incremented on every flash write; the newest valid copy is loaded */
+    uint32_t sequence;              /* Incremented on every use of a bond */
+    uint32_t local_keys_valid;
+    wiced_bt_local_identity_keys_t local_keys;
+    le_app_bond_entry_t entries[LE_APP_BOND_MAX_DEVICES];
+    uint32_t checksum;              /* FNV-1a of all preceding bytes */
+} le_app_bond_store_t;
+
+/* Connection to encryption times */
+typedef struct
+{
+    uint32_t count;
+    uint32_t total_ms;
+    uint32_t min_ms;
+    uint32_t max_ms;
+} le_app_bond_encrypt_stats_t;
+
+/*******************************************************************************
+ *        Variable Definitions
+ *******************************************************************************/
+/* Owned by the stack context, which changes bonds inside critical sections */
+static le_app_bond_store_t le_app_bond_store;
+
+/* Copy of the store taken by the application thread and written to flash */
+static le_app_bond_store_t le_app_bond_image;
+
+/* Flash region of the copies, placed by tools/le_app_bond_store.ld. It is not part of the
+ * image, so programming the application keeps the bonds */
+static const uint8_t le_app_bond_region[LE_APP_BOND_COPIES][LE_APP_BOND_COPY_SIZE]
+    __attribute__((section(".le_app_bond_store"), aligned(LE_APP_BOND_FLASH_ROW_SIZE), used));
+
+/* Open addressing map from peer address to entry. Each element holds the entry
+ * index plus one, so that zero marks an empty element */
+static uint8_t le_app_bond_map[LE_APP_BOND_MAP_SIZE];
+
+static cyhal_flash_t le_app_bond_flash;
+static uint32_t le_app_bond_copy;           /* Copy that holds the newest valid store */
+static uint32_t le_app_bond_generation;     /* Generation of that copy */
+static uint32_t le_app_bond_sector_size;
+static uint32_t le_app_bond_page_size;
+static uint8_t le_app_bond_erase_value;
+static wiced_bool_t le_app_bond_flash_ready = WICED_FALSE;
+
+/* Page staging buffer; cyhal_flash_program() writes whole, word aligned pages */
+static uint32_t le_app_bond_page[LE_APP_BOND_FLASH_PAGE_MAX / sizeof(uint32_t)];
+
+/* A write is queued on the application thread and has not started yet, or a retry of the
+ * post is pending. Changes made meanwhile go with that write */
+static volatile wiced_bool_t le_app_bond_write_posted = WICED_FALSE;
+
+/* Posts the write again after the application thread queue was full */
+static wiced_timer_t le_app_bond_retry_timer;
+static wiced_bool_t le_app_bond_retry_ready = WICED_FALSE;
+
+/* Indexed by the bonded argument of le_app_bond_record_encryption() */
+static le_app_bond_encrypt_stats_t le_app_bond_encrypt_stats[2];
+
+/*******************************************************************************
+ *        Function Prototypes
+ *******************************************************************************/
+static uint32_t le_app_bond_checksum(const le_app_bond_store_t *p_store);
+static wiced_result_t le_app_bond_read_copy(uint32_t copy, le_app_bond_store_t *p_store);
+static wiced_result_t le_app_bond_schedule_write(void);
+static wiced_result_t le_app_bond_store_write(void);
+static void le_app_bond_retry(WICED_TIMER_PARAM_TYPE cb_params);
+static uint32_t le_app_bond_hash(const uint8_t *bd_addr);
+static void le_app_bond_map_rebuild(void);
+static le_app_bond_entry_t *le_app_bond_find(const uint8_t *bd_addr);
+static le_app_bond_entry_t *le_app_bond_claim(void);
+
+/*******************************************************************************
+ *        Function Definitions
+ *******************************************************************************/
+
+/**************************************************************************************************
+ * Function Name: le_app_bond_init
+ ***************************************************************************************************
+ * Summary:
+ *   This function loads the newest intact copy of the bond store from flash into RAM. Without
+ *   one, the store starts with no bonds. Call it before wiced_bt_stack_init(), as the stack
+ *   asks for the local identity keys while it starts.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  wiced_result_t: WICED_BT_SUCCESS, or WICED_BT_ERROR if the flash cannot be used
+ *
+ **************************************************************************************************/
+wiced_result_t le_app_bond_init(void)
+{
+    cyhal_flash_info_t flash_info;
+    const cyhal_flash_block_info_t *p_block = NULL;
+    uint32_t region_addr = (uint32_t)(uintptr_t)le_app_bond_region;
+    wiced_bool_t found = WICED_FALSE;
+    cy_rslt_t cy_result;
+
+    memset(&le_app_bond_store, 0, sizeof(le_app_bond_store));
+    memset(le_app_bond_map, 0, sizeof(le_app_bond_map));
+
+    cy_result = cyhal_flash_init(&le_app_bond_flash);
+    if (CY_RSLT_SUCCESS != cy_result)
+    {
+        return WICED_BT_ERROR;
+    }
+
+    /* The geometry comes from the flash block that holds the reserved region */
+    cyhal_flash_get_info(&le_app_bond_flash, &flash_info);
+    for (uint8_t block = 0; block < flash_info.block_count; block++)
+    {
+        if ((flash_info.blocks[block].start_address <= region_addr) &&
+            ((region_addr - flash_info.blocks[block].start_address) < flash_info.blocks[block].size))
+        {
+            p_block = &flash_info.blocks[block];
+        }
+    }
+    if ((NULL == p_block) || (0 == p_block->sector_size) || (0 == p_block->page_size) ||
+        (LE_APP_BOND_FLASH_PAGE_MAX < p_block->page_size) ||
+        (0 != (region_addr % p_block->sector_size)) ||
+        (0 != (LE_APP_BOND_COPY_SIZE % p_block->sector_size)) ||
+        (0 != (LE_APP_BOND_COPY_SIZE % p_block->page_size)))
+    {
+        return WICED_BT_ERROR;
+    }
+
+    le_app_bond_sector_size = p_block->sector_size;
+    le_app_bond_page_size = p_block->page_size;
+    le_app_bond_erase_value = p_block->erase_value;
+
+    /* Load the newest intact copy. A reset during a write only tears the copy being written,
+     * and the first write goes to the copy that was not loaded */
+    le_app_bond_copy = LE_APP_BOND_COPIES - 1u;
+    for (uint32_t copy = 0; copy < LE_APP_BOND_COPIES; copy++)
+    {
+        if ((WICED_BT_SUCCESS == le_app_bond_read_copy(copy, &le_app_bond_image)) &&
+            (!found || ((int32_t)(le_app_bond_image.generation - le_app_bond_store.generation) > 0)))
+        {
+            memcpy(&le_app_bond_store, &le_app_bond_image, sizeof(le_app_bond_store));
+            le_app_bond_copy = copy;
+            found = WICED_TRUE;
+        }
+    }
+    le_app_bond_generation = le_app_bond_store.generation;
+
+    le_app_bond_flash_ready = WICED_TRUE;
+    le_app_bond_map_rebuild();
+
+    return WICED_BT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_bond_start
+ ***************************************************************************************************
+ * Summary:
+ *   This function adds every bonded peer to the address resolution database of the stack so
+ *   that peers using resolvable private addresses are recognized, and prepares the retry of
+ *   flash writes. Call it once the stack is enabled.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  wiced_result_t: WICED_BT_SUCCESS, or the error of the timer initialization
+ *
+ **************************************************************************************************/
+wiced_result_t le_app_bond_start(void)
+{
+    wiced_result_t wiced_result;
+
+    wiced_result = wiced_init_timer(&le_app_bond_retry_timer, le_app_bond_retry, NULL,
+                                    WICED_MILLI_SECONDS_TIMER);
+    if (WICED_BT_SUCCESS != wiced_result)
+    {
+        return wiced_result;
+    }
+    le_app_bond_retry_ready = WICED_TRUE;
+
+    for (uint8_t index = 0; index < LE_APP_BOND_MAX_DEVICES; index++)
+    {
+        if (le_app_bond_store.entries[index].in_use)
+        {
+            wiced_bt_dev_add_device_to_address_resolution_db(&le_app_bond_store.entries[index].keys);
+        }
+    }
+
+    return WICED_BT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_bond_save_keys
+ ***************************************************************************************************
+ * Summary:
+ *   This function stores the link keys of a peer and schedules a write of the store to flash.
+ *
+ * Parameters:
+ *   const wiced_bt_device_link_keys_t *p_keys  : Keys from BTM_PAIRED_DEVICE_LINK_KEYS_UPDATE_EVT
+ *
+ * Return:
+ *  wiced_result_t: WICED_BT_SUCCESS, or WICED_BT_ERROR if the write could not be scheduled
+ *
+ **************************************************************************************************/
+wiced_result_t le_app_bond_save_keys(const wiced_bt_device_link_keys_t *p_keys)
+{
+    le_app_bond_entry_t *p_entry = le_app_bond_find(p_keys->bd_addr);
+    wiced_bool_t claimed = WICED_FALSE;
+    uint32_t saved_intr_status;
+
+    if (NULL == p_entry)
+    {
+        p_entry = le_app_bond_claim();
+        claimed = WICED_TRUE;
+    }
+
+    saved_intr_status = cyhal_system_critical_section_enter();
+    if (claimed)
+    {
+        memset(p_entry, 0, sizeof(*p_entry));
+        p_entry->in_use = WICED_TRUE;
+    }
+    memcpy(&p_entry->keys, p_keys, sizeof(p_entry->keys));
+    p_entry->last_used = ++le_app_bond_store.sequence;
+    cyhal_system_critical_section_exit(saved_intr_status);
+
+    if (claimed)
+    {
+        le_app_bond_map_rebuild();
+    }
+
+    LE_APP_LOG("Bond stored for " LE_APP_LOG_BDA_FMT "\r\n", LE_APP_LOG_BDA_ARGS(p_keys->bd_addr));
+
+    return le_app_bond_schedule_write();
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_bond_load_keys
+ ***************************************************************************************************
+ * Summary:
+ *   This function looks up the link keys of the peer whose address is in p_keys.
+ *
+ * Parameters:
+ *   wiced_bt_device_link_keys_t *p_keys : Keys from BTM_PAIRED_DEVICE_LINK_KEYS_REQUEST_EVT;
+ *                                         key_data is filled in when the peer is bonded
+ *
+ * Return:
+ *  wiced_result_t: WICED_BT_SUCCESS if the peer is bonded, otherwise WICED_BT_ERROR
+ *
+ **************************************************************************************************/
+wiced_result_t le_app_bond_load_keys(wiced_bt_device_link_keys_t *p_keys)
+{
+    le_app_bond_entry_t *p_entry = le_app_bond_find(p_keys->bd_addr);
+    uint32_t saved_intr_status;
+
+    if (NULL == p_entry)
+    {
+        return WICED_BT_ERROR;
+    }
+
+    memcpy(&p_keys->key_data, &p_entry->keys.key_data, sizeof(p_keys->key_data));
+
+    /* Only kept in RAM; the order reaches flash with the next write */
+    saved_intr_status = cyhal_system_critical_section_enter();
+    p_entry->last_used = ++le_app_bond_store.sequence;
+    cyhal_system_critical_section_exit(saved_intr_status);
+
+    return WICED_BT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_bond_save_local_keys
+ ***************************************************************************************************
+ * Summary:
+ *   This function stores the local identity keys and schedules a write of the store to flash.
+ *
+ * Parameters:
+ *   const wiced_bt_local_identity_keys_t *p_keys   : Keys from BTM_LOCAL_IDENTITY_KEYS_UPDATE_EVT
+ *
+ * Return:
+ *  wiced_result_t: WICED_BT_SUCCESS, or WICED_BT_ERROR if the write could not be scheduled
+ *
+ **************************************************************************************************/
+wiced_result_t le_app_bond_save_local_keys(const wiced_bt_local_identity_keys_t *p_keys)
+{
+    uint32_t saved_intr_status;
+
+    saved_intr_status = cyhal_system_critical_section_enter();
+    memcpy(&le_app_bond_store.local_keys, p_keys, sizeof(le_app_bond_store.local_keys));
+    le_app_bond_store.local_keys_valid = WICED_TRUE;
+    cyhal_system_critical_section_exit(saved_intr_status);
+
+    return le_app_bond_schedule_write();
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_bond_load_local_keys
+ ***************************************************************************************************
+ * Summary:
+ *   This function copies the stored local identity keys.
+ *
+ * Parameters:
+ *   wiced_bt_local_identity_keys_t *p_keys : Buffer from BTM_LOCAL_IDENTITY_KEYS_REQUEST_EVT
+ *
+ * Return:
+ *  wiced_result_t: WICED_BT_SUCCESS if keys are stored, otherwise WICED_BT_ERROR so that the
+ *                  stack generates new ones
+ *
+ **************************************************************************************************/
+wiced_result_t le_app_bond_load_local_keys(wiced_bt_local_identity_keys_t *p_keys)
+{
+    if (!le_app_bond_store.local_keys_valid)
+    {
+        return WICED_BT_ERROR;
+    }
+
+    memcpy(p_keys, &le_app_bond_store.local_keys, sizeof(*p_keys));
+
+    return WICED_BT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_bond_is_bonded
+ ***************************************************************************************************
+ * Summary:
+ *   This function checks whether a peer is bonded.
+ *
+ * Parameters:
+ *   wiced_bt_device_address_t bd_addr   : Peer address
+ *
+ * Return:
+ *  wiced_bool_t: WICED_TRUE if the peer is bonded
+ *
+ **************************************************************************************************/
+wiced_bool_t le_app_bond_is_bonded(wiced_bt_device_address_t bd_addr)
+{
+    return (NULL != le_app_bond_find(bd_addr)) ? WICED_TRUE : WICED_FALSE;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_bond_get_caching
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns the GATT caching state stored for a bonded peer.
+ *
+ * Parameters:
+ *   wiced_bt_device_address_t bd_addr   : Peer address
+ *   uint8_t *p_db_hash                  : Receives the Database Hash the peer last knew
+ *   uint8_t *p_client_features          : Receives the Client Supported Features of the peer
+ *
+ * Return:
+ *  wiced_bool_t: WICED_TRUE if the peer is bonded and a state was stored
+ *
+ **************************************************************************************************/
+wiced_bool_t le_app_bond_get_caching(wiced_bt_device_address_t bd_addr, uint8_t *p_db_hash,
+                                     uint8_t *p_client_features)
+{
+    le_app_bond_entry_t *p_entry = le_app_bond_find(bd_addr);
+
+    if ((NULL == p_entry) || !p_entry->caching_valid)
+    {
+        return WICED_FALSE;
+    }
+
+    memcpy(p_db_hash, p_entry->db_hash, LE_APP_BOND_DB_HASH_SIZE);
+    *p_client_features = p_entry->client_features;
+
+    return WICED_TRUE;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_bond_set_caching
+ ***************************************************************************************************
+ * Summary:
+ *   This function stores the GATT caching state of a bonded peer. A write of the store to
+ *   flash is only scheduled when the state changed.
+ *
+ * Parameters:
+ *   wiced_bt_device_address_t bd_addr   : Peer address
+ *   const uint8_t *p_db_hash            : Database Hash the peer knows
+ *   uint8_t client_features             : Client Supported Features of the peer
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_bond_set_caching(wiced_bt_device_address_t bd_addr, const uint8_t *p_db_hash,
+                             uint8_t client_features)
+{
+    le_app_bond_entry_t *p_entry = le_app_bond_find(bd_addr);
+    uint32_t saved_intr_status;
+
+    if (NULL == p_entry)
+    {
+        return;
+    }
+
+    if (p_entry->caching_valid && (client_features == p_entry->client_features) &&
+        (0 == memcmp(p_db_hash, p_entry->db_hash, LE_APP_BOND_DB_HASH_SIZE)))
+    {
+        return;
+    }
+
+    saved_intr_status = cyhal_system_critical_section_enter();
+    memcpy(p_entry->db_hash, p_db_hash, LE_APP_BOND_DB_HASH_SIZE);
+    p_entry->client_features = client_features;
+    p_entry->caching_valid = WICED_TRUE;
+    cyhal_system_critical_section_exit(saved_intr_status);
+
+    le_app_bond_schedule_write();
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_bond_record_encryption
+ ***************************************************************************************************
+ * Summary:
+ *   This function records the time from connection to encryption of a link.
+ *
+ * Parameters:
+ *   wiced_bool_t bonded         : WICED_TRUE if the link was encrypted with stored keys,
+ *                                 WICED_FALSE if the peer paired on this connection
+ *   uint32_t elapsed_ms         : Milliseconds from connection to encryption
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_bond_record_encryption(wiced_bool_t bonded, uint32_t elapsed_ms)
+{
+    le_app_bond_encrypt_stats_t *p_stats = &le_app_bond_encrypt_stats[bonded ? 1 : 0];
+
+    if ((0 == p_stats->count) || (elapsed_ms < p_stats->min_ms))
+    {
+        p_stats->min_ms = elapsed_ms;
+    }
+    if (elapsed_ms > p_stats->max_ms)
+    {
+        p_stats->max_ms = elapsed_ms;
+    }
+    p_stats->count++;
+    p_stats->total_ms += elapsed_ms;
+
+    LE_APP_LOG("Encrypted %lu ms after connection (%s)\r\n", (unsigned long)elapsed_ms,
+               LE_APP_LOG_STR(bonded ? LE_APP_LOG_NAME("bonded") : LE_APP_LOG_NAME("paired")));
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_bond_print_stats
+ ***************************************************************************************************
+ * Summary:
+ *   This function prints the connection to encryption times of bonded and unbonded peers.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_bond_print_stats(void)
+{
+    static const char *const names[] = { "Unbonded", "Bonded" };
+
+    printf("Connection to encryption time in ms\r\n");
+    for (uint8_t index = 0; index < 2; index++)
+    {
+        le_app_bond_encrypt_stats_t *p_stats = &le_app_bond_encrypt_stats[index];
+
+        printf("%s: count %lu avg %lu min %lu max %lu\r\n", names[index],
+               (unsigned long)p_stats->count,
+               (unsigned long)(p_stats->count ? (p_stats->total_ms / p_stats->count) : 0),
+               (unsigned long)p_stats->min_ms, (unsigned long)p_stats->max_ms);
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_bond_checksum
+ ***************************************************************************************************
+ * Summary:
+ *   This function computes the FNV-1a checksum of a store image, excluding the checksum field.
+ *
+ * Parameters:
+ *   const le_app_bond_store_t *p_store  : Store image
+ *
+ * Return:
+ *  uint32_t: Checksum
+ *
+ **************************************************************************************************/
+static uint32_t le_app_bond_checksum(const le_app_bond_store_t *p_store)
+{
+    const uint8_t *p_byte = (const uint8_t *)p_store;
+    uint32_t hash = 2166136261u;
+
+    for (size_t index = 0; index < offsetof(le_app_bond_store_t, checksum); index++)
+    {
+        hash = (hash ^ p_byte[index]) * 16777619u;
+    }
+
+    return hash;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_bond_read_copy
+ ***************************************************************************************************
+ * Summary:
+ *   This function reads one copy of the store from flash and checks that it is intact.
+ *
+ * Parameters:
+ *   uint32_t copy                       : Copy to read
+ *   le_app_bond_store_t *p_store        : Receives the copy
+ *
+ * Return:
+ *  wiced_result_t: WICED_BT_SUCCESS, or WICED_BT_ERROR if the copy is erased, from another
+ *                  layout or torn by a reset during a write
+ *
+ **************************************************************************************************/
+static wiced_result_t le_app_bond_read_copy(uint32_t copy, le_app_bond_store_t *p_store)
+{
+    cy_rslt_t cy_result;
+
+    cy_result = cyhal_flash_read(&le_app_bond_flash, (uint32_t)(uintptr_t)le_app_bond_region[copy],
+                                 (uint8_t *)p_store, sizeof(*p_store));
+    if ((CY_RSLT_SUCCESS != cy_result) ||
+        (LE_APP_BOND_STORE_MAGIC != p_store->magic) ||
+        (sizeof(le_app_bond_store_t) != p_store->size) ||
+        (le_app_bond_checksum(p_store) != p_store->checksum))
+    {
+        return WICED_BT_ERROR;
+    }
+
+    return WICED_BT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_bond_schedule_write
+ ***************************************************************************************************
+ * Summary:
+ *   This function asks the application thread to write the store to flash, so that the stack
+ *   context never waits for an erase. Changes made before the write starts go with it.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  wiced_result_t: WICED_BT_SUCCESS if a write is queued or will be retried, otherwise
+ *                  WICED_BT_ERROR; the RAM image stays valid either way
+ *
+ **************************************************************************************************/
+static wiced_result_t le_app_bond_schedule_write(void)
+{
+    if (!le_app_bond_flash_ready)
+    {
+        return WICED_BT_ERROR;
+    }
+
+    if (le_app_bond_write_posted)
+    {
+        return WICED_BT_SUCCESS;
+    }
+
+    /* Set first, as the application thread clears it when the write starts */
+    le_app_bond_write_posted = WICED_TRUE;
+    if (le_app_thread_post(LE_APP_THREAD_PRODUCER_STACK, LE_APP_EVT_BOND_WRITE, 0))
+    {
+        return WICED_BT_SUCCESS;
+    }
+
+    if (!le_app_bond_retry_ready)
+    {
+        le_app_bond_write_posted = WICED_FALSE;
+        return WICED_BT_ERROR;
+    }
+
+    /* Stays set while the retry is pending */
+    wiced_start_timer(&le_app_bond_retry_timer, LE_APP_BOND_WRITE_RETRY_MS);
+
+    return WICED_BT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_bond_retry
+ ***************************************************************************************************
+ * Summary:
+ *   This function schedules the write again after the application thread queue was full or
+ *   the flash write failed.
+ *
+ * Parameters:
+ *   WICED_TIMER_PARAM_TYPE cb_params    : Unused
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_bond_retry(WICED_TIMER_PARAM_TYPE cb_params)
+{
+    le_app_bond_write_posted = WICED_FALSE;
+    le_app_bond_schedule_write();
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_bond_flush
+ ***************************************************************************************************
+ * Summary:
+ *   This function writes the store to flash. It is called on the application thread for
+ *   LE_APP_EVT_BOND_WRITE. A failed write is scheduled again after LE_APP_BOND_WRITE_RETRY_MS.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_bond_flush(void)
+{
+    uint32_t saved_intr_status;
+
+    /* The stack context changes bonds inside critical sections, so the copy is consistent */
+    saved_intr_status = cyhal_system_critical_section_enter();
+    le_app_bond_write_posted = WICED_FALSE;
+    memcpy(&le_app_bond_image, &le_app_bond_store, sizeof(le_app_bond_image));
+    cyhal_system_critical_section_exit(saved_intr_status);
+
+    if (WICED_BT_SUCCESS != le_app_bond_store_write())
+    {
+        LE_APP_LOG("Failed to write the bond store to flash\r\n");
+
+        /* Write again later, also when the store does not change meanwhile */
+        if (le_app_bond_retry_ready)
+        {
+            le_app_bond_write_posted = WICED_TRUE;
+            wiced_start_timer(&le_app_bond_retry_timer, LE_APP_BOND_WRITE_RETRY_MS);
+        }
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_bond_store_write
+ ***************************************************************************************************
+ * Summary:
+ *   This function writes the copy taken by le_app_bond_flush() to the flash copy that does
+ *   not hold the newest store, with the next generation. The newest store stays intact until
+ *   the write is complete.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  wiced_result_t: WICED_BT_SUCCESS, or WICED_BT_ERROR if the flash write failed; the next
+ *                  write then goes to the same copy
+ *
+ **************************************************************************************************/
+static wiced_result_t le_app_bond_store_write(void)
+{
+    const uint8_t *p_image = (const uint8_t *)&le_app_bond_image;
+    uint32_t copy = (le_app_bond_copy + 1u) % LE_APP_BOND_COPIES;
+    uint32_t copy_addr = (uint32_t)(uintptr_t)le_app_bond_region[copy];
+    wiced_result_t result = WICED_BT_SUCCESS;
+    uint32_t offset;
+    uint32_t chunk;
+
+    le_app_bond_image.magic = LE_APP_BOND_STORE_MAGIC;
+    le_app_bond_image.size = sizeof(le_app_bond_store_t);
+    le_app_bond_image.generation = le_app_bond_generation + 1u;
+    le_app_bond_image.checksum = le_app_bond_checksum(&le_app_bond_image);
+
+    /* Stay out of deep sleep until the image is complete */
+    le_app_pm_lock(LE_APP_PM_LOCK_FLASH);
+
+    for (offset = 0; (offset < LE_APP_BOND_COPY_SIZE) && (WICED_BT_SUCCESS == result);
+         offset += le_app_bond_sector_size)
+    {
+        if (CY_RSLT_SUCCESS != cyhal_flash_erase(&le_app_bond_flash, copy_addr + offset))
+        {
+            result = WICED_BT_ERROR;
+        }
+    }
+
+    for (offset = 0; (offset < sizeof(le_app_bond_store_t)) && (WICED_BT_SUCCESS == result);
+         offset += le_app_bond_page_size)
+    {
+        chunk = MIN(le_app_bond_page_size, sizeof(le_app_bond_store_t) - offset);
+        memset(le_app_bond_page, le_app_bond_erase_value, le_app_bond_page_size);
+        memcpy(le_app_bond_page, &p_image[offset], chunk);
+
+        if (CY_RSLT_SUCCESS != cyhal_flash_program(&le_app_bond_flash, copy_addr + offset,
+                                                   le_app_bond_page))
+        {
+            result = WICED_BT_ERROR;
+        }
+    }
+
+    le_app_pm_unlock(LE_APP_PM_LOCK_FLASH);
+
+    if (WICED_BT_SUCCESS == result)
+    {
+        le_app_bond_generation = le_app_bond_image.generation;
+        le_app_bond_copy = copy;
+    }
+
+    return result;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_bond_hash
+ ***************************************************************************************************
+ * Summary:
+ *   This function hashes a peer address to a bucket of the address map.
+ *
+ * Parameters:
+ *   const uint8_t *bd_addr      : Peer address
+ *
+ * Return:
+ *  uint32_t: Bucket index
+ *
+ **************************************************************************************************/
+static uint32_t le_app_bond_hash(const uint8_t *bd_addr)
+{
+    uint32_t hash = 2166136261u;
+
+    for (uint8_t index = 0; index < BD_ADDR_LEN; index++)
+    {
+        hash = (hash ^ bd_addr[index]) * 16777619u;
+    }
+
+    return hash & (LE_APP_BOND_MAP_SIZE - 1);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_bond_map_rebuild
+ ***************************************************************************************************
+ * Summary:
+ *   This function rebuilds the address map from the store. Bonds only change on pairing, so
+ *   the map is rebuilt rather than supporting removal.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_bond_map_rebuild(void)
+{
+    uint32_t bucket;
+
+    memset(le_app_bond_map, 0, sizeof(le_app_bond_map));
+
+    for (uint8_t index = 0; index < LE_APP_BOND_MAX_DEVICES; index++)
+    {
+        if (!le_app_bond_store.entries[index].in_use)
+        {
+            continue;
+        }
+
+        bucket = le_app_bond_hash(le_app_bond_store.entries[index].keys.bd_addr);
+        while (0 != le_app_bond_map[bucket])
+        {
+            bucket = (bucket + 1) & (LE_APP_BOND_MAP_SIZE - 1);
+        }
+        le_app_bond_map[bucket] = index + 1;
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_bond_find
+ ***************************************************************************************************
+ * Summary:
+ *   This function looks up the bond of a peer through the address map.
+ *
+ * Parameters:
+ *   const uint8_t *bd_addr      : Peer address
+ *
+ * Return:
+ *  le_app_bond_entry_t *: Bond of the peer, or NULL if the peer is not bonded
+ *
+ **************************************************************************************************/
+static le_app_bond_entry_t *le_app_bond_find(const uint8_t *bd_addr)
+{
+    uint32_t bucket = le_app_bond_hash(bd_addr);
+    le_app_bond_entry_t *p_entry;
+
+    /* The map is never full, so an empty bucket always ends the probe */
+    while (0 != le_app_bond_map[bucket])
+    {
+        p_entry = &le_app_bond_store.entries[le_app_bond_map[bucket] - 1];
+        if (0 == memcmp(p_entry->keys.bd_addr, bd_addr, BD_ADDR_LEN))
+        {
+            return p_entry;
+        }
+        bucket = (bucket + 1) & (LE_APP_BOND_MAP_SIZE - 1);
+    }
+
+    return NULL;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_bond_claim
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns a free entry, or replaces the least recently used bond when the
+ *   store is full. The replaced peer is also removed from the stack.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  le_app_bond_entry_t *: Entry to fill in
+ *
+ **************************************************************************************************/
+static le_app_bond_entry_t *le_app_bond_claim(void)
+{
+    le_app_bond_entry_t *p_oldest = &le_app_bond_store.entries[0];
+
+    for (uint8_t index = 0; index < LE_APP_BOND_MAX_DEVICES; index++)
+    {
+        le_app_bond_entry_t *p_entry = &le_app_bond_store.entries[index];
+
+        if (!p_entry->in_use)
+        {
+            return p_entry;
+        }
+        if (p_entry->last_used < p_oldest->last_used)
+        {
+            p_oldest = p_entry;
+        }
+    }
+
+    LE_APP_LOG("Bond store full, replacing " LE_APP_LOG_BDA_FMT "\r\n", LE_APP_LOG_BDA_ARGS(p_oldest->keys.bd_addr));
+    wiced_bt_dev_remove_device_from_address_resolution_db(&p_oldest->keys);
+    wiced_bt_dev_delete_bonded_device(p_oldest->keys.bd_addr);
+
+    return p_oldest;
+}
+
+/* [] END OF FILE */
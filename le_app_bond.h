@@ -0,0 +1,276 @@
+/*******************************************************************************
+* File Name: le_app_bond.h
+*
+* Description:
+*   Header file for the bonded device store. Link keys are cached in RAM
+*   for constant time lookup by address and persisted to flash
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef LE_APP_BOND_H_
+#define LE_APP_BOND_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_dev.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Number of bonded peers kept. The least recently used bond is replaced when full */
+#define LE_APP_BOND_MAX_DEVICES         (8u)
+
+/* Size of the address hash map. Must be a power of two larger than LE_APP_BOND_MAX_DEVICES */
+#define LE_APP_BOND_MAP_SIZE            (16u)
+
+/* Largest flash program page supported by the store */
+#define LE_APP_BOND_FLASH_PAGE_MAX      (512u)
+
+/* Each copy of the store starts on and fills whole rows of this size. Must be a multiple of
+ * the flash sector size and match the alignment in tools/le_app_bond_store.ld */
+#define LE_APP_BOND_FLASH_ROW_SIZE      (512u)
+
+/* Delay before a flash write is scheduled again when the application queue is full or the
+ * write failed */
+#define LE_APP_BOND_WRITE_RETRY_MS      (10u)
+
+/* Size of the GATT Database Hash kept per bond */
+#define LE_APP_BOND_DB_HASH_SIZE        (16u)
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+
+/**************************************************************************************************
+* Function Name: le_app_bond_init
+***************************************************************************************************
+* Summary:
+*   This function loads the newest intact copy of the bond store from flash into RAM. With no
+*   intact copy the store starts with no bonds. Call it before wiced_bt_stack_init(), as the
+*   stack asks for the local identity keys while it starts.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  wiced_result_t: WICED_BT_SUCCESS, or WICED_BT_ERROR if the flash cannot be used
+*
+**************************************************************************************************/
+wiced_result_t le_app_bond_init(void);
+
+/**************************************************************************************************
+* Function Name: le_app_bond_start
+***************************************************************************************************
+* Summary:
+*   This function adds every bonded peer to the address resolution database of the stack so
+*   that peers using resolvable private addresses are recognized, and allows flash writes to
+*   be retried. Call it once the stack is enabled.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  wiced_result_t: WICED_BT_SUCCESS, or the error of the retry timer
+*
+**************************************************************************************************/
+wiced_result_t le_app_bond_start(void);
+
+/**************************************************************************************************
+* Function Name: le_app_bond_flush
+***************************************************************************************************
+* Summary:
+*   This function writes the bond store to flash. The application thread calls it for
+*   LE_APP_EVT_BOND_WRITE; the erase does not block the stack.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_bond_flush(void);
+
+/**************************************************************************************************
+* Function Name: le_app_bond_save_keys
+***************************************************************************************************
+* Summary:
+*   This function stores the link keys of a peer and schedules a write of the store to flash.
+*
+* Parameters:
+*   const wiced_bt_device_link_keys_t *p_keys  : Keys from BTM_PAIRED_DEVICE_LINK_KEYS_UPDATE_EVT
+*
+* Return:
+*  wiced_result_t: WICED_BT_SUCCESS, or WICED_BT_ERROR if no write could be scheduled
+*
+**************************************************************************************************/
+wiced_result_t le_app_bond_save_keys(const wiced_bt_device_link_keys_t *p_keys);
+
+/**************************************************************************************************
+* Function Name: le_app_bond_load_keys
+***************************************************************************************************
+* Summary:
+*   This function looks up the link keys of the peer whose address is in p_keys.
+*
+* Parameters:
+*   wiced_bt_device_link_keys_t *p_keys : Keys from BTM_PAIRED_DEVICE_LINK_KEYS_REQUEST_EVT;
+*                                         key_data is filled in when the peer is bonded
+*
+* Return:
+*  wiced_result_t: WICED_BT_SUCCESS if the peer is bonded, otherwise WICED_BT_ERROR
+*
+**************************************************************************************************/
+wiced_result_t le_app_bond_load_keys(wiced_bt_device_link_keys_t *p_keys);
+
+/**************************************************************************************************
+* Function Name: le_app_bond_save_local_keys
+***************************************************************************************************
+* Summary:
+*   This function stores the local identity keys and schedules a write of the store to flash.
+*
+* Parameters:
+*   const wiced_bt_local_identity_keys_t *p_keys   : Keys from BTM_LOCAL_IDENTITY_KEYS_UPDATE_EVT
+*
+* Return:
+*  wiced_result_t: WICED_BT_SUCCESS, or WICED_BT_ERROR if no write could be scheduled
+*
+**************************************************************************************************/
+wiced_result_t le_app_bond_save_local_keys(const wiced_bt_local_identity_keys_t *p_keys);
+
+/**************************************************************************************************
+* Function Name: le_app_bond_load_local_keys
+***************************************************************************************************
+* Summary:
+*   This function copies the stored local identity keys.
+*
+* Parameters:
+*   wiced_bt_local_identity_keys_t *p_keys : Buffer from BTM_LOCAL_IDENTITY_KEYS_REQUEST_EVT
+*
+* Return:
+*  wiced_result_t: WICED_BT_SUCCESS if keys are stored, otherwise WICED_BT_ERROR so that the
+*                  stack generates new ones
+*
+**************************************************************************************************/
+wiced_result_t le_app_bond_load_local_keys(wiced_bt_local_identity_keys_t *p_keys);
+
+/**************************************************************************************************
+* Function Name: le_app_bond_is_bonded
+***************************************************************************************************
+* Summary:
+*   This function checks whether a peer is bonded.
+*
+* Parameters:
+*   wiced_bt_device_address_t bd_addr   : Peer address
+*
+* Return:
+*  wiced_bool_t: WICED_TRUE if the peer is bonded
+*
+**************************************************************************************************/
+wiced_bool_t le_app_bond_is_bonded(wiced_bt_device_address_t bd_addr);
+
+/**************************************************************************************************
+* Function Name: le_app_bond_get_caching
+***************************************************************************************************
+* Summary:
+*   This function returns the GATT caching state stored for a bonded peer.
+*
+* Parameters:
+*   wiced_bt_device_address_t bd_addr   : Peer address
+*   uint8_t *p_db_hash                  : Receives the Database Hash the peer last knew
+*   uint8_t *p_client_features          : Receives the Client Supported Features of the peer
+*
+* Return:
+*  wiced_bool_t: WICED_TRUE if the peer is bonded and a state was stored
+*
+**************************************************************************************************/
+wiced_bool_t le_app_bond_get_caching(wiced_bt_device_address_t bd_addr, uint8_t *p_db_hash,
+                                     uint8_t *p_client_features);
+
+/**************************************************************************************************
+* Function Name: le_app_bond_set_caching
+***************************************************************************************************
+* Summary:
+*   This function stores the GATT caching state of a bonded peer. The store is only written
+*   to flash when the state changed.
+*
+* Parameters:
+*   wiced_bt_device_address_t bd_addr   : Peer address
+*   const uint8_t *p_db_hash            : Database Hash the peer knows
+*   uint8_t client_features             : Client Supported Features of the peer
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_bond_set_caching(wiced_bt_device_address_t bd_addr, const uint8_t *p_db_hash,
+                             uint8_t client_features);
+
+/**************************************************************************************************
+* Function Name: le_app_bond_record_encryption
+***************************************************************************************************
+* Summary:
+*   This function records the time from connection to encryption of a link.
+*
+* Parameters:
+*   wiced_bool_t bonded         : WICED_TRUE if the link was encrypted with stored keys,
+*                                 WICED_FALSE if the peer paired on this connection
+*   uint32_t elapsed_ms         : Milliseconds from connection to encryption
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_bond_record_encryption(wiced_bool_t bonded, uint32_t elapsed_ms);
+
+/**************************************************************************************************
+* Function Name: le_app_bond_print_stats
+***************************************************************************************************
+* Summary:
+*   This function prints the connection to encryption times of bonded and unbonded peers.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_bond_print_stats(void);
+
+#endif /* LE_APP_BOND_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,338 @@
+/*******************************************************************************
+ * File Name: le_app_caching.c
+ *
+ * Description:
+ *   Source file for GATT Robust Caching: the Database Hash and Client
+ *   Supported Features characteristics and the per-client change-aware state
+ *
+ * Related Document: See Readme.md
+ *
+ *******************************************************************************
+ * Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/*******************************************************************************
+ *        Header Files
+ *******************************************************************************/
+#include "le_app_caching.h"
+#include "le_app_gatts.h"
+#include "le_app_conn.h"
+#include "le_app_log.h"
+#include "le_app_bond.h"
+#include <string.h>
+#include "GeneratedSource/cycfg_gatt_db.h"
+
+/*******************************************************************************
+ *        Function Prototypes
+ *******************************************************************************/
+static wiced_bt_gatt_status_t le_app_client_features_read(uint16_t conn_id, uint16_t attr_handle,
+                                                          uint16_t offset);
+static wiced_bt_gatt_status_t le_app_client_features_check(uint16_t conn_id, uint16_t attr_handle,
+                                                           uint16_t offset, const uint8_t *p_val,
+                                                           uint16_t len);
+static wiced_bt_gatt_status_t le_app_client_features_write(uint16_t conn_id, uint16_t attr_handle,
+                                                           uint16_t offset, const uint8_t *p_val,
+                                                           uint16_t len);
+static wiced_bool_t le_app_caching_reads_hash(wiced_bt_gatt_attribute_request_t *p_attr_req);
+static void le_app_caching_save(le_app_conn_t *p_conn);
+
+/*******************************************************************************
+ *        Function Definitions
+ *******************************************************************************/
+
+/**************************************************************************************************
+ * Function Name: le_app_caching_init
+ ***************************************************************************************************
+ * Summary:
+ *   This function registers the callbacks of the Client Supported Features and Database Hash
+ *   characteristics. The hash itself is written by wiced_bt_gatt_db_init().
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: See possible status codes in wiced_bt_gatt_status_e in wiced_bt_gatt.h
+ *
+ **************************************************************************************************/
+wiced_bt_gatt_status_t le_app_caching_init(void)
+{
+    return le_app_gatts_register_handle(HDLC_GATT_CLIENT_SUPPORTED_FEATURES_VALUE,
+                                        le_app_client_features_read,
+                                        le_app_client_features_check,
+                                        le_app_client_features_write);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_caching_check_request
+ ***************************************************************************************************
+ * Summary:
+ *   This function applies the change-aware rules of Robust Caching to an attribute request
+ *   before it is dispatched. A change-unaware client that enabled Robust Caching gets a
+ *   Database Out Of Sync error, and its commands are ignored, until it reads the Database Hash
+ *   or sends another request after the error.
+ *
+ * Parameters:
+ *   wiced_bt_gatt_attribute_request_t *p_attr_req  : Attribute request
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_SUCCESS if the request may be processed, otherwise
+ *                          WICED_BT_GATT_DATABASE_OUT_OF_SYNC with the error already sent
+ *
+ **************************************************************************************************/
+wiced_bt_gatt_status_t le_app_caching_check_request(wiced_bt_gatt_attribute_request_t *p_attr_req)
+{
+    le_app_conn_t *p_conn = le_app_conn_find(p_attr_req->conn_id);
+
+    if ((NULL == p_conn) || p_conn->change_aware ||
+        (0 == (p_conn->client_features & LE_APP_CLIENT_FEATURE_ROBUST_CACHING)))
+    {
+        return WICED_BT_GATT_SUCCESS;
+    }
+
+    switch (p_attr_req->opcode)
+    {
+    case GATT_REQ_MTU:
+    case GATT_HANDLE_VALUE_CONF:
+        /* Not attribute accesses; always allowed */
+        return WICED_BT_GATT_SUCCESS;
+
+    case GATT_CMD_WRITE:
+    case GATT_CMD_SIGNED_WRITE:
+        /* Commands from a change-unaware client are ignored */
+        return WICED_BT_GATT_DATABASE_OUT_OF_SYNC;
+
+    default:
+        break;
+    }
+
+    /* Reading the hash lets the client compare it with its cache, and a request after the
+     * out of sync error shows the client has seen it; either makes the client change-aware */
+    if (p_conn->out_of_sync_sent || le_app_caching_reads_hash(p_attr_req))
+    {
+        p_conn->change_aware = WICED_TRUE;
+        LE_APP_LOG("conn_id %d is change-aware\r\n", p_conn->conn_id);
+        le_app_caching_save(p_conn);
+        return WICED_BT_GATT_SUCCESS;
+    }
+
+    p_conn->out_of_sync_sent = WICED_TRUE;
+    le_app_gatts_send_error_rsp(p_attr_req->conn_id, p_attr_req->opcode, 0,
+                                WICED_BT_GATT_DATABASE_OUT_OF_SYNC);
+    return WICED_BT_GATT_DATABASE_OUT_OF_SYNC;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_caching_link_encrypted
+ ***************************************************************************************************
+ * Summary:
+ *   This function restores the caching state of a bonded peer once its link is encrypted. The
+ *   peer is change-unaware if the database changed since it last knew it.
+ *
+ * Parameters:
+ *   le_app_conn_t *p_conn       : Context of the encrypted connection
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_caching_link_encrypted(le_app_conn_t *p_conn)
+{
+    uint8_t db_hash[LE_APP_BOND_DB_HASH_SIZE];
+    uint8_t client_features;
+
+    if (!le_app_bond_get_caching(p_conn->bd_addr, db_hash, &client_features))
+    {
+        /* New bond, or a bond made before its state was saved */
+        le_app_caching_save(p_conn);
+        return;
+    }
+
+    /* Client Supported Features of a bonded client persist across connections */
+    p_conn->client_features |= client_features;
+
+    if (0 != memcmp(db_hash, app_gatt_database_hash, LE_APP_BOND_DB_HASH_SIZE))
+    {
+        p_conn->change_aware = WICED_FALSE;
+        p_conn->out_of_sync_sent = WICED_FALSE;
+        LE_APP_LOG("conn_id %d is change-unaware\r\n", p_conn->conn_id);
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_caching_save
+ ***************************************************************************************************
+ * Summary:
+ *   This function stores the caching state of a change-aware peer with its bond. The state of
+ *   a change-unaware peer is left alone so that it stays unaware across reconnections.
+ *
+ * Parameters:
+ *   le_app_conn_t *p_conn       : Context of the connection
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_caching_save(le_app_conn_t *p_conn)
+{
+    if (p_conn->encrypted && p_conn->change_aware)
+    {
+        le_app_bond_set_caching(p_conn->bd_addr, app_gatt_database_hash, p_conn->client_features);
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_caching_reads_hash
+ ***************************************************************************************************
+ * Summary:
+ *   This function checks whether a request reads the Database Hash characteristic.
+ *
+ * Parameters:
+ *   wiced_bt_gatt_attribute_request_t *p_attr_req  : Attribute request
+ *
+ * Return:
+ *  wiced_bool_t: WICED_TRUE for a Read of the hash, or a Read By Type of the hash UUID
+ *
+ **************************************************************************************************/
+static wiced_bool_t le_app_caching_reads_hash(wiced_bt_gatt_attribute_request_t *p_attr_req)
+{
+    wiced_bt_gatt_read_by_type_t *p_read_by_type = &p_attr_req->data.read_by_type;
+
+    if (GATT_REQ_READ == p_attr_req->opcode)
+    {
+        return (HDLC_GATT_DATABASE_HASH_VALUE == p_attr_req->data.read_req.handle) ? WICED_TRUE : WICED_FALSE;
+    }
+
+    if (GATT_REQ_READ_BY_TYPE == p_attr_req->opcode)
+    {
+        return ((LEN_UUID_16 == p_read_by_type->uuid.len) &&
+                (LE_APP_UUID_DATABASE_HASH == p_read_by_type->uuid.uu.uuid16)) ? WICED_TRUE : WICED_FALSE;
+    }
+
+    return WICED_FALSE;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_client_features_read
+ ***************************************************************************************************
+ * Summary:
+ *   This function loads the features of the reading client into the Client Supported Features
+ *   characteristic, which is kept per connection.
+ *
+ * Parameters:
+ *   uint16_t conn_id            : Connection ID of the reader
+ *   uint16_t attr_handle        : HDLC_GATT_CLIENT_SUPPORTED_FEATURES_VALUE
+ *   uint16_t offset             : Offset of the read
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_SUCCESS
+ *
+ **************************************************************************************************/
+static wiced_bt_gatt_status_t le_app_client_features_read(uint16_t conn_id, uint16_t attr_handle,
+                                                          uint16_t offset)
+{
+    le_app_conn_t *p_conn = le_app_conn_find(conn_id);
+
+    app_gatt_client_supported_features[0] = (NULL != p_conn) ? p_conn->client_features : 0;
+
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_client_features_check
+ ***************************************************************************************************
+ * Summary:
+ *   This function checks the features a client writes. A client cannot disable a feature
+ *   it has enabled.
+ *
+ * Parameters:
+ *   uint16_t conn_id            : Connection ID of the writer
+ *   uint16_t attr_handle        : HDLC_GATT_CLIENT_SUPPORTED_FEATURES_VALUE
+ *   uint16_t offset             : Offset of the value
+ *   const uint8_t *p_val        : Features to write
+ *   uint16_t len                : Length of the value
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_VALUE_NOT_ALLOWED if a feature would be disabled
+ *
+ **************************************************************************************************/
+static wiced_bt_gatt_status_t le_app_client_features_check(uint16_t conn_id, uint16_t attr_handle,
+                                                           uint16_t offset, const uint8_t *p_val,
+                                                           uint16_t len)
+{
+    le_app_conn_t *p_conn = le_app_conn_find(conn_id);
+
+    if ((0 != offset) || (0 == len) || (NULL == p_conn))
+    {
+        return WICED_BT_GATT_INVALID_ATTR_LEN;
+    }
+
+    if (p_conn->client_features & ~(p_val[0] & LE_APP_CLIENT_FEATURES_SUPPORTED))
+    {
+        return WICED_BT_GATT_VALUE_NOT_ALLOWED;
+    }
+
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_client_features_write
+ ***************************************************************************************************
+ * Summary:
+ *   This function stores the features enabled by a client, checked by
+ *   le_app_client_features_check(). Bits this server does not support are dropped.
+ *
+ * Parameters:
+ *   uint16_t conn_id            : Connection ID of the writer
+ *   uint16_t attr_handle        : HDLC_GATT_CLIENT_SUPPORTED_FEATURES_VALUE
+ *   uint16_t offset             : Offset of the value
+ *   const uint8_t *p_val        : Features written
+ *   uint16_t len                : Length of the value
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_HANDLED, as the value is kept per connection
+ *
+ **************************************************************************************************/
+static wiced_bt_gatt_status_t le_app_client_features_write(uint16_t conn_id, uint16_t attr_handle,
+                                                           uint16_t offset, const uint8_t *p_val,
+                                                           uint16_t len)
+{
+    le_app_conn_t *p_conn = le_app_conn_find(conn_id);
+    uint8_t features = p_val[0] & LE_APP_CLIENT_FEATURES_SUPPORTED;
+
+    p_conn->client_features = features;
+    LE_APP_LOG("conn_id %d client features 0x%x\r\n", conn_id, features);
+    le_app_caching_save(p_conn);
+
+    return WICED_BT_GATT_HANDLED;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,121 @@
+/*******************************************************************************
+* File Name: le_app_caching.h
+*
+* Description:
+*   Header file for GATT Robust Caching: the Database Hash and Client
+*   Supported Features characteristics and the per-client change-aware state
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef LE_APP_CACHING_H_
+#define LE_APP_CACHING_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_gatt.h"
+#include "le_app_conn.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Robust Caching bit of the Client Supported Features characteristic */
+#define LE_APP_CLIENT_FEATURE_ROBUST_CACHING    (0x01u)
+
+/* Client Supported Features bits understood by this server */
+#define LE_APP_CLIENT_FEATURES_SUPPORTED        (LE_APP_CLIENT_FEATURE_ROBUST_CACHING)
+
+/* 16-bit UUID of the Database Hash characteristic */
+#define LE_APP_UUID_DATABASE_HASH               (0x2B2Au)
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+
+/**************************************************************************************************
+* Function Name: le_app_caching_init
+***************************************************************************************************
+* Summary:
+*   This function registers the callbacks of the Client Supported Features and Database Hash
+*   characteristics. The hash itself is written by wiced_bt_gatt_db_init().
+*
+* Parameters:
+*   None
+*
+* Return:
+*  wiced_bt_gatt_status_t: See possible status codes in wiced_bt_gatt_status_e in wiced_bt_gatt.h
+*
+**************************************************************************************************/
+wiced_bt_gatt_status_t le_app_caching_init(void);
+
+/**************************************************************************************************
+* Function Name: le_app_caching_check_request
+***************************************************************************************************
+* Summary:
+*   This function applies the change-aware rules of Robust Caching to an attribute request
+*   before it is dispatched. A change-unaware client that enabled Robust Caching gets a
+*   Database Out Of Sync error, and its commands are ignored, until it reads the Database Hash
+*   or sends another request after the error.
+*
+* Parameters:
+*   wiced_bt_gatt_attribute_request_t *p_attr_req  : Attribute request
+*
+* Return:
+*  wiced_bt_gatt_status_t: WICED_BT_GATT_SUCCESS if the request may be processed, otherwise
+*                          WICED_BT_GATT_DATABASE_OUT_OF_SYNC with the error already sent
+*
+**************************************************************************************************/
+wiced_bt_gatt_status_t le_app_caching_check_request(wiced_bt_gatt_attribute_request_t *p_attr_req);
+
+/**************************************************************************************************
+* Function Name: le_app_caching_link_encrypted
+***************************************************************************************************
+* Summary:
+*   This function restores the caching state of a bonded peer once its link is encrypted. The
+*   peer is change-unaware if the database changed since it last knew it.
+*
+* Parameters:
+*   le_app_conn_t *p_conn       : Context of the encrypted connection
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_caching_link_encrypted(le_app_conn_t *p_conn);
+
+#endif /* LE_APP_CACHING_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,395 @@
+/*******************************************************************************
+ * File Name: le_app_conn.c
+ *
+ * Description:
+ *   Source file for the per-connection context table
+ *
+ * Related Document: See Readme.md
+ *
+ *******************************************************************************
+ * Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/*******************************************************************************
+ *        Header Files
+ *******************************************************************************/
+#include "le_app_conn.h"
+#include <string.h>
+
+/*******************************************************************************
+ *        Variable Definitions
+ *******************************************************************************/
+static le_app_conn_t le_app_conn_table[LE_APP_MAX_CONNECTIONS];
+
+/* Open addressing map from conn_id to slot. Each entry holds the slot index
+ * plus one, so that zero marks an empty entry */
+static uint8_t le_app_conn_map[LE_APP_CONN_MAP_SIZE];
+
+static uint32_t le_app_conn_active;
+
+/*******************************************************************************
+ *        Function Prototypes
+ *******************************************************************************/
+static void le_app_conn_map_insert(uint16_t conn_id, uint8_t slot);
+static void le_app_conn_map_rebuild(void);
+
+/*******************************************************************************
+ *        Function Definitions
+ *******************************************************************************/
+
+/**************************************************************************************************
+ * Function Name: le_app_conn_alloc
+ ***************************************************************************************************
+ * Summary:
+ *   This function claims a free context for a new connection.
+ *
+ * Parameters:
+ *   uint16_t conn_id                    : Connection ID, must not be 0
+ *   wiced_bt_device_address_t bd_addr   : Peer address
+ *
+ * Return:
+ *  le_app_conn_t *: Context of the connection, or NULL if every slot is in use
+ *
+ **************************************************************************************************/
+le_app_conn_t *le_app_conn_alloc(uint16_t conn_id, wiced_bt_device_address_t bd_addr)
+{
+    le_app_conn_t *p_conn = le_app_conn_find(conn_id);
+
+    if (NULL != p_conn)
+    {
+        return p_conn;
+    }
+
+    for (uint8_t slot = 0; slot < LE_APP_MAX_CONNECTIONS; slot++)
+    {
+        p_conn = &le_app_conn_table[slot];
+        if (0 == p_conn->conn_id)
+        {
+            memset(p_conn, 0, sizeof(*p_conn));
+            p_conn->conn_id = conn_id;
+            p_conn->mtu = GATT_DEF_BLE_MTU_SIZE;
+            /* The database never changes while connected, so a new peer without a bond
+             * starts change-aware */
+            p_conn->change_aware = WICED_TRUE;
+            memcpy(p_conn->bd_addr, bd_addr, sizeof(wiced_bt_device_address_t));
+
+            le_app_conn_map_insert(conn_id, slot);
+            le_app_conn_active++;
+            return p_conn;
+        }
+    }
+
+    return NULL;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_conn_free
+ ***************************************************************************************************
+ * Summary:
+ *   This function releases the context of a connection.
+ *
+ * Parameters:
+ *   uint16_t conn_id            : Connection ID
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_conn_free(uint16_t conn_id)
+{
+    le_app_conn_t *p_conn = le_app_conn_find(conn_id);
+
+    if (NULL == p_conn)
+    {
+        return;
+    }
+
+    p_conn->conn_id = 0;
+    le_app_conn_active--;
+
+    /* Removing from an open addressing map would break probe chains; the map
+     * is tiny, so it is rebuilt from the remaining contexts instead */
+    le_app_conn_map_rebuild();
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_conn_find
+ ***************************************************************************************************
+ * Summary:
+ *   This function looks up the context of a connection in constant time.
+ *
+ * Parameters:
+ *   uint16_t conn_id            : Connection ID
+ *
+ * Return:
+ *  le_app_conn_t *: Context of the connection, or NULL if the connection is unknown
+ *
+ **************************************************************************************************/
+le_app_conn_t *le_app_conn_find(uint16_t conn_id)
+{
+    uint32_t pos = conn_id & (LE_APP_CONN_MAP_SIZE - 1);
+
+    if (0 == conn_id)
+    {
+        return NULL;
+    }
+
+    /* The map is never full, so the probe always reaches an empty entry */
+    while (0 != le_app_conn_map[pos])
+    {
+        le_app_conn_t *p_conn = &le_app_conn_table[le_app_conn_map[pos] - 1];
+
+        if (conn_id == p_conn->conn_id)
+        {
+            return p_conn;
+        }
+        pos = (pos + 1) & (LE_APP_CONN_MAP_SIZE - 1);
+    }
+
+    return NULL;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_conn_find_by_addr
+ ***************************************************************************************************
+ * Summary:
+ *   This function looks up the context of a connection by peer address.
+ *
+ * Parameters:
+ *   wiced_bt_device_address_t bd_addr   : Peer address
+ *
+ * Return:
+ *  le_app_conn_t *: Context of the connection, or NULL if no connection has this peer
+ *
+ **************************************************************************************************/
+le_app_conn_t *le_app_conn_find_by_addr(wiced_bt_device_address_t bd_addr)
+{
+    for (uint32_t slot = 0; slot < LE_APP_MAX_CONNECTIONS; slot++)
+    {
+        le_app_conn_t *p_conn = &le_app_conn_table[slot];
+
+        if ((0 != p_conn->conn_id) &&
+            (0 == memcmp(p_conn->bd_addr, bd_addr, sizeof(wiced_bt_device_address_t))))
+        {
+            return p_conn;
+        }
+    }
+
+    return NULL;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_conn_get
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns the context in a slot of the table, used to iterate over connections.
+ *
+ * Parameters:
+ *   uint32_t index              : Slot index, less than LE_APP_MAX_CONNECTIONS
+ *
+ * Return:
+ *  le_app_conn_t *: Context in the slot, or NULL if the slot is free
+ *
+ **************************************************************************************************/
+le_app_conn_t *le_app_conn_get(uint32_t index)
+{
+    if ((LE_APP_MAX_CONNECTIONS <= index) || (0 == le_app_conn_table[index].conn_id))
+    {
+        return NULL;
+    }
+
+    return &le_app_conn_table[index];
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_conn_count
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns the number of active connections.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  uint32_t: Number of contexts in use
+ *
+ **************************************************************************************************/
+uint32_t le_app_conn_count(void)
+{
+    return le_app_conn_active;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_conn_max_alert_level
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns the highest IAS alert level written by any connected peer.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  uint8_t: Highest alert level, 0 if there is no connection
+ *
+ **************************************************************************************************/
+uint8_t le_app_conn_max_alert_level(void)
+{
+    uint8_t level = 0;
+
+    for (uint32_t slot = 0; slot < LE_APP_MAX_CONNECTIONS; slot++)
+    {
+        if ((0 != le_app_conn_table[slot].conn_id) && (le_app_conn_table[slot].alert_level > level))
+        {
+            level = le_app_conn_table[slot].alert_level;
+        }
+    }
+
+    return level;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_conn_set_cccd
+ ***************************************************************************************************
+ * Summary:
+ *   This function stores a client characteristic configuration written by the peer.
+ *
+ * Parameters:
+ *   le_app_conn_t *p_conn       : Connection context
+ *   uint16_t handle             : CCCD handle
+ *   uint16_t value              : Descriptor value
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_INSUF_RESOURCE if LE_APP_CONN_MAX_CCCD descriptors are
+ *                          already tracked, WICED_BT_GATT_SUCCESS otherwise
+ *
+ **************************************************************************************************/
+wiced_bt_gatt_status_t le_app_conn_set_cccd(le_app_conn_t *p_conn, uint16_t handle, uint16_t value)
+{
+    le_app_conn_cccd_t *p_cccd = le_app_conn_get_cccd(p_conn, handle);
+
+    for (uint32_t i = 0; (NULL == p_cccd) && (i < LE_APP_CONN_MAX_CCCD); i++)
+    {
+        if (0 == p_conn->cccd[i].handle)
+        {
+            p_cccd = &p_conn->cccd[i];
+            p_cccd->handle = handle;
+        }
+    }
+
+    if (NULL == p_cccd)
+    {
+        return WICED_BT_GATT_INSUF_RESOURCE;
+    }
+
+    p_cccd->value = value;
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_conn_get_cccd
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns the client characteristic configuration entry of the peer.
+ *
+ * Parameters:
+ *   le_app_conn_t *p_conn       : Connection context
+ *   uint16_t handle             : CCCD handle
+ *
+ * Return:
+ *  le_app_conn_cccd_t *: Descriptor entry, or NULL if the peer has not written it
+ *
+ **************************************************************************************************/
+le_app_conn_cccd_t *le_app_conn_get_cccd(le_app_conn_t *p_conn, uint16_t handle)
+{
+    for (uint32_t i = 0; i < LE_APP_CONN_MAX_CCCD; i++)
+    {
+        if (handle == p_conn->cccd[i].handle)
+        {
+            return &p_conn->cccd[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_conn_map_insert
+ ***************************************************************************************************
+ * Summary:
+ *   This function adds a conn_id to slot mapping, probing linearly from the hashed position.
+ *
+ * Parameters:
+ *   uint16_t conn_id            : Connection ID
+ *   uint8_t slot                : Slot index in le_app_conn_table
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_conn_map_insert(uint16_t conn_id, uint8_t slot)
+{
+    uint32_t pos = conn_id & (LE_APP_CONN_MAP_SIZE - 1);
+
+    while (0 != le_app_conn_map[pos])
+    {
+        pos = (pos + 1) & (LE_APP_CONN_MAP_SIZE - 1);
+    }
+    le_app_conn_map[pos] = slot + 1;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_conn_map_rebuild
+ ***************************************************************************************************
+ * Summary:
+ *   This function rebuilds the conn_id map from the contexts in use.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_conn_map_rebuild(void)
+{
+    memset(le_app_conn_map, 0, sizeof(le_app_conn_map));
+
+    for (uint8_t slot = 0; slot < LE_APP_MAX_CONNECTIONS; slot++)
+    {
+        if (0 != le_app_conn_table[slot].conn_id)
+        {
+            le_app_conn_map_insert(le_app_conn_table[slot].conn_id, slot);
+        }
+    }
+}
+
+/* [] END OF FILE */
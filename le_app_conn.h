@@ -0,0 +1,291 @@
+/*******************************************************************************
+* File Name: le_app_conn.h
+*
+* Description:
+*   Header file for the per-connection context table
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef LE_APP_CONN_H_
+#define LE_APP_CONN_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_dev.h"
+#include "wiced_bt_gatt.h"
+#include "le_app_phy.h"
+#include "le_app_conn_params.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Maximum number of simultaneous connections. Keep in sync with
+ * MaxClientsConnections in design.cybt */
+#define LE_APP_MAX_CONNECTIONS          (4u)
+
+/* Number of client characteristic configuration descriptors tracked per connection */
+#define LE_APP_CONN_MAX_CCCD            (4u)
+
+/* Size of the conn_id hash map. Must be a power of two larger than LE_APP_MAX_CONNECTIONS */
+#define LE_APP_CONN_MAP_SIZE            (8u)
+
+/* Bytes of prepared write data queued per connection; enough for one attribute of
+ * the MaxAttrLength configured in design.cybt */
+#define LE_APP_PREP_WRITE_ARENA_SIZE    (512u)
+
+/* Number of prepared write requests queued per connection */
+#define LE_APP_PREP_WRITE_MAX_ENTRIES   (16u)
+
+/* Number of distinct handles with a notification or indication queued per connection */
+#define LE_APP_NOTIFY_QUEUE_SIZE        (8u)
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+/* Client characteristic configuration written by the peer of a connection */
+typedef struct
+{
+    uint16_t handle;                /* CCCD handle, 0 when the entry is unused */
+    uint16_t value;                 /* GATT_CLIENT_CONFIG_NOTIFICATION / GATT_CLIENT_CONFIG_INDICATION bits */
+} le_app_conn_cccd_t;
+
+/* Prepared write request; the value is stored in the connection arena */
+typedef struct
+{
+    uint16_t handle;
+    uint16_t offset;                /* Offset of the value within the attribute */
+    uint16_t len;
+    uint16_t arena_offset;          /* Offset of the value within prep_write_arena */
+} le_app_prep_write_t;
+
+/* Per-connection context */
+typedef struct
+{
+    uint16_t conn_id;               /* Connection ID, 0 when the slot is free */
+    wiced_bt_device_address_t bd_addr;
+    uint16_t mtu;                   /* Agreed ATT MTU */
+    uint8_t alert_level;            /* IAS alert level written by this peer */
+    uint8_t client_features;        /* Client Supported Features written by this peer */
+    wiced_bool_t change_aware;      /* Robust Caching: the peer knows the current database */
+    wiced_bool_t out_of_sync_sent;  /* Robust Caching: Database Out Of Sync was sent to the peer */
+    wiced_bool_t paired;            /* The peer paired on this connection */
+    wiced_bool_t encrypted;         /* The link has been encrypted */
+    uint32_t connect_time_ms;       /* RTOS time of the connection, for the time to encryption */
+    le_app_conn_cccd_t cccd[LE_APP_CONN_MAX_CCCD];
+
+    /* Connection parameters from the last BTM_BLE_CONNECTION_PARAM_UPDATE */
+    uint16_t conn_interval;
+    uint16_t conn_latency;
+    uint16_t supervision_timeout;
+
+    /* PHY from the last BTM_BLE_PHY_UPDATE_EVT and the RSSI based decision */
+    uint8_t tx_phy;
+    uint8_t rx_phy;
+    le_app_phy_state_t phy_state;
+
+    /* Connection parameter policy */
+    le_app_conn_params_state_t params_state;
+
+    /* Prepared write queue. Values are appended to the arena in arrival order,
+     * so cancelling only resets the two counts */
+    le_app_prep_write_t prep_writes[LE_APP_PREP_WRITE_MAX_ENTRIES];
+    uint8_t prep_write_count;
+    uint16_t prep_write_used;
+    uint8_t prep_write_arena[LE_APP_PREP_WRITE_ARENA_SIZE];
+
+    /* Notification queue. A handle is queued at most once and its value is read
+     * when it is sent, so repeated updates collapse to the latest value */
+    uint16_t notify_queue[LE_APP_NOTIFY_QUEUE_SIZE];
+    uint8_t notify_count;
+    uint8_t notify_in_flight;       /* Buffers handed to the stack and not yet transmitted */
+    wiced_bool_t indication_pending;    /* Indication sent and not yet confirmed */
+
+    /* Counters */
+    uint32_t gatt_requests;         /* Attribute requests received */
+    uint32_t writes;                /* Successful attribute writes */
+    uint32_t notifications;         /* Notifications and indications sent */
+    uint32_t notify_coalesced;      /* Updates merged into an already queued handle */
+    uint32_t notify_failures;       /* Values the stack refused to send */
+} le_app_conn_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+
+/**************************************************************************************************
+* Function Name: le_app_conn_alloc
+***************************************************************************************************
+* Summary:
+*   This function claims a free context for a new connection.
+*
+* Parameters:
+*   uint16_t conn_id                    : Connection ID, must not be 0
+*   wiced_bt_device_address_t bd_addr   : Peer address
+*
+* Return:
+*  le_app_conn_t *: Context of the connection, or NULL if every slot is in use
+*
+**************************************************************************************************/
+le_app_conn_t *le_app_conn_alloc(uint16_t conn_id, wiced_bt_device_address_t bd_addr);
+
+/**************************************************************************************************
+* Function Name: le_app_conn_free
+***************************************************************************************************
+* Summary:
+*   This function releases the context of a connection.
+*
+* Parameters:
+*   uint16_t conn_id            : Connection ID
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_conn_free(uint16_t conn_id);
+
+/**************************************************************************************************
+* Function Name: le_app_conn_find
+***************************************************************************************************
+* Summary:
+*   This function looks up the context of a connection in constant time.
+*
+* Parameters:
+*   uint16_t conn_id            : Connection ID
+*
+* Return:
+*  le_app_conn_t *: Context of the connection, or NULL if the connection is unknown
+*
+**************************************************************************************************/
+le_app_conn_t *le_app_conn_find(uint16_t conn_id);
+
+/**************************************************************************************************
+* Function Name: le_app_conn_find_by_addr
+***************************************************************************************************
+* Summary:
+*   This function looks up the context of a connection by peer address.
+*
+* Parameters:
+*   wiced_bt_device_address_t bd_addr   : Peer address
+*
+* Return:
+*  le_app_conn_t *: Context of the connection, or NULL if no connection has this peer
+*
+**************************************************************************************************/
+le_app_conn_t *le_app_conn_find_by_addr(wiced_bt_device_address_t bd_addr);
+
+/**************************************************************************************************
+* Function Name: le_app_conn_get
+***************************************************************************************************
+* Summary:
+*   This function returns the context in a slot of the table, used to iterate over connections.
+*
+* Parameters:
+*   uint32_t index              : Slot index, less than LE_APP_MAX_CONNECTIONS
+*
+* Return:
+*  le_app_conn_t *: Context in the slot, or NULL if the slot is free
+*
+**************************************************************************************************/
+le_app_conn_t *le_app_conn_get(uint32_t index);
+
+/**************************************************************************************************
+* Function Name: le_app_conn_count
+***************************************************************************************************
+* Summary:
+*   This function returns the number of active connections.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  uint32_t: Number of contexts in use
+*
+**************************************************************************************************/
+uint32_t le_app_conn_count(void);
+
+/**************************************************************************************************
+* Function Name: le_app_conn_max_alert_level
+***************************************************************************************************
+* Summary:
+*   This function returns the highest IAS alert level written by any connected peer.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  uint8_t: Highest alert level, 0 if there is no connection
+*
+**************************************************************************************************/
+uint8_t le_app_conn_max_alert_level(void);
+
+/**************************************************************************************************
+* Function Name: le_app_conn_set_cccd
+***************************************************************************************************
+* Summary:
+*   This function stores a client characteristic configuration written by the peer.
+*
+* Parameters:
+*   le_app_conn_t *p_conn       : Connection context
+*   uint16_t handle             : CCCD handle
+*   uint16_t value              : Descriptor value
+*
+* Return:
+*  wiced_bt_gatt_status_t: WICED_BT_GATT_INSUF_RESOURCE if LE_APP_CONN_MAX_CCCD descriptors are
+*                          already tracked, WICED_BT_GATT_SUCCESS otherwise
+*
+**************************************************************************************************/
+wiced_bt_gatt_status_t le_app_conn_set_cccd(le_app_conn_t *p_conn, uint16_t handle, uint16_t value);
+
+/**************************************************************************************************
+* Function Name: le_app_conn_get_cccd
+***************************************************************************************************
+* Summary:
+*   This function returns the client characteristic configuration entry of the peer.
+*
+* Parameters:
+*   le_app_conn_t *p_conn       : Connection context
+*   uint16_t handle             : CCCD handle
+*
+* Return:
+*  le_app_conn_cccd_t *: Descriptor entry, or NULL if the peer has not written it
+*
+**************************************************************************************************/
+le_app_conn_cccd_t *le_app_conn_get_cccd(le_app_conn_t *p_conn, uint16_t handle);
+
+#endif /* LE_APP_CONN_H_ */
+
+/* [] END OF FILE */
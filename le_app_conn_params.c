@@ -0,0 +1,490 @@
+/*******************************************************************************
+ * File Name: le_app_conn_params.c
+ *
+ * Description:
+ *   Source file for the connection parameter policy. A short interval is used
+ *   after connection and during an alert, a long interval with peripheral latency otherwise
+ *
+ * Related Document: See Readme.md
+ *
+ *******************************************************************************
+ * Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/*******************************************************************************
+ *        Header Files
+ *******************************************************************************/
+#include "le_app_conn_params.h"
+#include "le_app_conn.h"
+#include "le_app_log.h"
+#include "le_app_user_interface.h"
+#include "wiced_timer.h"
+#include "cyabs_rtos.h"
+
+/*******************************************************************************
+ *        Structures and Enumerations
+ *******************************************************************************/
+/* Parameters requested for a set. Intervals are in 1.25 ms units, the
+ * supervision timeout in 10 ms units */
+typedef struct
+{
+    uint16_t min_interval;
+    uint16_t max_interval;
+    uint16_t latency;
+    uint16_t timeout;
+} le_app_conn_params_t;
+
+/*******************************************************************************
+ *        Variable Definitions
+ *******************************************************************************/
+static const le_app_conn_params_t le_app_conn_params_sets[LE_APP_CONN_PARAMS_OTHER] =
+{
+    /* 15-30 ms, no latency, 5 s timeout */
+    [LE_APP_CONN_PARAMS_FAST] = { 12u, 24u, 0u, 500u },
+    /* 500-600 ms, 4 skipped events, 8 s timeout; above (1 + latency) * interval * 2 */
+    [LE_APP_CONN_PARAMS_IDLE] = { 400u, 480u, 4u, 800u },
+};
+
+static le_app_conn_params_stats_t le_app_conn_params_stats;
+
+/* Fires at the earliest discovery period end or retry of all connections */
+static wiced_timer_t le_app_conn_params_timer;
+
+/*******************************************************************************
+ *        Function Prototypes
+ *******************************************************************************/
+static void le_app_conn_params_apply(le_app_conn_t *p_conn, uint32_t now);
+static void le_app_conn_params_request(le_app_conn_t *p_conn, uint32_t now);
+static void le_app_conn_params_account(le_app_conn_t *p_conn, uint32_t now);
+static void le_app_conn_params_schedule(uint32_t now);
+static void le_app_conn_params_tick(WICED_TIMER_PARAM_TYPE cb_params);
+
+/*******************************************************************************
+ *        Function Definitions
+ *******************************************************************************/
+
+/**************************************************************************************************
+ * Function Name: le_app_conn_params_init
+ ***************************************************************************************************
+ * Summary:
+ *   This function prepares the timer of the discovery period and the retries.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  wiced_result_t: WICED_BT_SUCCESS, or the error of the timer initialization
+ *
+ **************************************************************************************************/
+wiced_result_t le_app_conn_params_init(void)
+{
+    return wiced_init_timer(&le_app_conn_params_timer, le_app_conn_params_tick, NULL,
+                            WICED_MILLI_SECONDS_TIMER);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_conn_params_on_connect
+ ***************************************************************************************************
+ * Summary:
+ *   This function starts the discovery period of a new connection with the fast parameters.
+ *
+ * Parameters:
+ *   uint16_t conn_id            : Connection ID
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_conn_params_on_connect(uint16_t conn_id)
+{
+    le_app_conn_t *p_conn = le_app_conn_find(conn_id);
+    le_app_conn_params_state_t *p_state;
+    cy_time_t now;
+
+    if (NULL == p_conn)
+    {
+        return;
+    }
+
+    cy_rtos_get_time(&now);
+    p_state = &p_conn->params_state;
+    p_state->target = LE_APP_CONN_PARAMS_OTHER;
+    p_state->current = LE_APP_CONN_PARAMS_OTHER;
+    p_state->current_since = now;
+    p_state->discovery_end = now + LE_APP_CONN_PARAMS_DISCOVERY_MS;
+
+    le_app_conn_params_apply(p_conn, now);
+    le_app_conn_params_schedule(now);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_conn_params_on_disconnect
+ ***************************************************************************************************
+ * Summary:
+ *   This function accounts the time of a connection that is going away. Call it before the
+ *   connection context is released.
+ *
+ * Parameters:
+ *   uint16_t conn_id            : Connection ID
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_conn_params_on_disconnect(uint16_t conn_id)
+{
+    le_app_conn_t *p_conn = le_app_conn_find(conn_id);
+    cy_time_t now;
+
+    if (NULL != p_conn)
+    {
+        cy_rtos_get_time(&now);
+        le_app_conn_params_account(p_conn, now);
+        p_conn->params_state.retry_pending = WICED_FALSE;
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_conn_params_on_update
+ ***************************************************************************************************
+ * Summary:
+ *   This function handles BTM_BLE_CONNECTION_PARAM_UPDATE. The time spent in the previous set is
+ *   accounted, and a rejected request is retried with backoff.
+ *
+ * Parameters:
+ *   wiced_bt_ble_connection_param_update_t *p_update : Connection parameter update event data
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_conn_params_on_update(wiced_bt_ble_connection_param_update_t *p_update)
+{
+    le_app_conn_t *p_conn = le_app_conn_find_by_addr(p_update->bd_addr);
+    le_app_conn_params_state_t *p_state;
+    const le_app_conn_params_t *p_set;
+    uint32_t backoff_ms;
+    cy_time_t now;
+
+    if (NULL == p_conn)
+    {
+        return;
+    }
+
+    cy_rtos_get_time(&now);
+    p_state = &p_conn->params_state;
+
+    if (0 != p_update->status)
+    {
+        /* Rejected; the parameters in use did not change */
+        le_app_conn_params_stats.rejections++;
+        if (LE_APP_CONN_PARAMS_MAX_RETRIES <= ++p_state->retries)
+        {
+            le_app_conn_params_stats.give_ups++;
+            LE_APP_LOG("conn_id %d: connection parameters rejected, giving up\r\n", p_conn->conn_id);
+            return;
+        }
+
+        backoff_ms = LE_APP_CONN_PARAMS_BACKOFF_MS << (p_state->retries - 1);
+        p_state->retry_pending = WICED_TRUE;
+        p_state->retry_time = now + MIN(backoff_ms, LE_APP_CONN_PARAMS_BACKOFF_MAX_MS);
+        le_app_conn_params_schedule(now);
+        return;
+    }
+
+    le_app_conn_params_account(p_conn, now);
+
+    /* The central may pick any interval in the requested range, or its own parameters */
+    p_state->current = LE_APP_CONN_PARAMS_OTHER;
+    for (uint8_t set = 0; set < LE_APP_CONN_PARAMS_OTHER; set++)
+    {
+        p_set = &le_app_conn_params_sets[set];
+        if ((p_update->conn_interval >= p_set->min_interval) && (p_update->conn_interval <= p_set->max_interval) &&
+            (p_update->conn_latency == p_set->latency))
+        {
+            p_state->current = set;
+            break;
+        }
+    }
+
+    if (p_state->current == p_state->target)
+    {
+        p_state->retries = 0;
+        p_state->retry_pending = WICED_FALSE;
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_conn_params_on_alert
+ ***************************************************************************************************
+ * Summary:
+ *   This function applies the policy after the alert level of a connection changed.
+ *
+ * Parameters:
+ *   uint16_t conn_id            : Connection ID
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_conn_params_on_alert(uint16_t conn_id)
+{
+    le_app_conn_t *p_conn = le_app_conn_find(conn_id);
+    cy_time_t now;
+
+    if (NULL != p_conn)
+    {
+        cy_rtos_get_time(&now);
+        le_app_conn_params_apply(p_conn, now);
+        le_app_conn_params_schedule(now);
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_conn_params_get_stats
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns the policy counters and the time spent in each set, including the
+ *   running time of open connections.
+ *
+ * Parameters:
+ *   le_app_conn_params_stats_t *p_stats : Receives the statistics
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_conn_params_get_stats(le_app_conn_params_stats_t *p_stats)
+{
+    le_app_conn_t *p_conn;
+    cy_time_t now;
+
+    cy_rtos_get_time(&now);
+    for (uint32_t index = 0; index < LE_APP_MAX_CONNECTIONS; index++)
+    {
+        p_conn = le_app_conn_get(index);
+        if (NULL != p_conn)
+        {
+            le_app_conn_params_account(p_conn, now);
+        }
+    }
+
+    *p_stats = le_app_conn_params_stats;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_conn_params_apply
+ ***************************************************************************************************
+ * Summary:
+ *   This function picks the set a connection should use: fast during the discovery period
+ *   or an alert, idle otherwise. A new target is requested at once.
+ *
+ * Parameters:
+ *   le_app_conn_t *p_conn       : Context of the connection
+ *   uint32_t now                : Current RTOS time
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_conn_params_apply(le_app_conn_t *p_conn, uint32_t now)
+{
+    le_app_conn_params_state_t *p_state = &p_conn->params_state;
+    uint8_t target;
+
+    if ((IAS_ALERT_LEVEL_LOW != p_conn->alert_level) || ((int32_t)(p_state->discovery_end - now) > 0))
+    {
+        target = LE_APP_CONN_PARAMS_FAST;
+    }
+    else
+    {
+        target = LE_APP_CONN_PARAMS_IDLE;
+    }
+
+    if (target != p_state->target)
+    {
+        p_state->target = target;
+        p_state->retries = 0;
+        p_state->retry_pending = WICED_FALSE;
+        if (target != p_state->current)
+        {
+            le_app_conn_params_request(p_conn, now);
+        }
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_conn_params_request
+ ***************************************************************************************************
+ * Summary:
+ *   This function sends the connection parameter update request of the target set. If the
+ *   stack cannot send it, it is retried after the backoff delay.
+ *
+ * Parameters:
+ *   le_app_conn_t *p_conn       : Context of the connection
+ *   uint32_t now                : Current RTOS time
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_conn_params_request(le_app_conn_t *p_conn, uint32_t now)
+{
+    le_app_conn_params_state_t *p_state = &p_conn->params_state;
+    const le_app_conn_params_t *p_set = &le_app_conn_params_sets[p_state->target];
+
+    p_state->retry_pending = WICED_FALSE;
+    le_app_conn_params_stats.requests++;
+
+    if (!wiced_bt_l2cap_update_ble_conn_params(p_conn->bd_addr, p_set->min_interval, p_set->max_interval,
+                                               p_set->latency, p_set->timeout))
+    {
+        p_state->retry_pending = WICED_TRUE;
+        p_state->retry_time = now + LE_APP_CONN_PARAMS_BACKOFF_MS;
+    }
+
+    LE_APP_LOG("conn_id %d: requesting %s connection parameters\r\n", p_conn->conn_id,
+               LE_APP_LOG_STR((LE_APP_CONN_PARAMS_FAST == p_state->target) ?
+                              LE_APP_LOG_NAME("fast") : LE_APP_LOG_NAME("idle")));
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_conn_params_account
+ ***************************************************************************************************
+ * Summary:
+ *   This function adds the time since the last accounting to the current set of a connection.
+ *
+ * Parameters:
+ *   le_app_conn_t *p_conn       : Context of the connection
+ *   uint32_t now                : Current RTOS time
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_conn_params_account(le_app_conn_t *p_conn, uint32_t now)
+{
+    le_app_conn_params_state_t *p_state = &p_conn->params_state;
+
+    le_app_conn_params_stats.time_ms[p_state->current] += now - p_state->current_since;
+    p_state->current_since = now;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_conn_params_schedule
+ ***************************************************************************************************
+ * Summary:
+ *   This function starts the timer for the earliest pending discovery period end or retry.
+ *
+ * Parameters:
+ *   uint32_t now                : Current RTOS time
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_conn_params_schedule(uint32_t now)
+{
+    le_app_conn_params_state_t *p_state;
+    le_app_conn_t *p_conn;
+    int32_t earliest = INT32_MAX;
+    int32_t remaining;
+
+    for (uint32_t index = 0; index < LE_APP_MAX_CONNECTIONS; index++)
+    {
+        p_conn = le_app_conn_get(index);
+        if (NULL == p_conn)
+        {
+            continue;
+        }
+
+        p_state = &p_conn->params_state;
+        remaining = (int32_t)(p_state->discovery_end - now);
+        if ((remaining > 0) && (remaining < earliest))
+        {
+            earliest = remaining;
+        }
+        if (p_state->retry_pending)
+        {
+            remaining = MAX((int32_t)(p_state->retry_time - now), 1);
+            earliest = MIN(earliest, remaining);
+        }
+    }
+
+    wiced_stop_timer(&le_app_conn_params_timer);
+    if (INT32_MAX != earliest)
+    {
+        wiced_start_timer(&le_app_conn_params_timer, (uint32_t)earliest);
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_conn_params_tick
+ ***************************************************************************************************
+ * Summary:
+ *   This function ends discovery periods and sends due retries.
+ *
+ * Parameters:
+ *   WICED_TIMER_PARAM_TYPE cb_params    : Unused
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_conn_params_tick(WICED_TIMER_PARAM_TYPE cb_params)
+{
+    le_app_conn_params_state_t *p_state;
+    le_app_conn_t *p_conn;
+    cy_time_t now;
+
+    cy_rtos_get_time(&now);
+
+    for (uint32_t index = 0; index < LE_APP_MAX_CONNECTIONS; index++)
+    {
+        p_conn = le_app_conn_get(index);
+        if (NULL == p_conn)
+        {
+            continue;
+        }
+
+        p_state = &p_conn->params_state;
+        le_app_conn_params_apply(p_conn, now);
+        if (p_state->retry_pending && ((int32_t)(p_state->retry_time - now) <= 0))
+        {
+            le_app_conn_params_request(p_conn, now);
+        }
+    }
+
+    le_app_conn_params_schedule(now);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,196 @@
+/*******************************************************************************
+* File Name: le_app_conn_params.h
+*
+* Description:
+*   Header file for the connection parameter policy. A short interval is used
+*   after connection and during an alert, a long interval with peripheral latency otherwise
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef LE_APP_CONN_PARAMS_H_
+#define LE_APP_CONN_PARAMS_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_dev.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Time after connection during which the client is expected to discover the database */
+#define LE_APP_CONN_PARAMS_DISCOVERY_MS     (10000u)
+
+/* Delay before retrying a rejected request; doubled on every rejection */
+#define LE_APP_CONN_PARAMS_BACKOFF_MS       (1000u)
+#define LE_APP_CONN_PARAMS_BACKOFF_MAX_MS   (30000u)
+
+/* Rejections of the same parameter set before the request is given up */
+#define LE_APP_CONN_PARAMS_MAX_RETRIES      (5u)
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+/* Connection parameter sets */
+typedef enum
+{
+    LE_APP_CONN_PARAMS_FAST,        /* Short interval, for discovery and alerts */
+    LE_APP_CONN_PARAMS_IDLE,        /* Long interval with peripheral latency */
+    LE_APP_CONN_PARAMS_OTHER,       /* Chosen by the central */
+    LE_APP_CONN_PARAMS_COUNT
+} le_app_conn_params_set_t;
+
+/* Policy state of one connection */
+typedef struct
+{
+    uint8_t target;                 /* Set the policy asks for */
+    uint8_t current;                /* Set matching the parameters in use */
+    uint8_t retries;                /* Rejections of the target so far */
+    wiced_bool_t retry_pending;     /* retry_time holds the time of the next request */
+    uint32_t retry_time;
+    uint32_t discovery_end;         /* RTOS time at which the discovery period ends */
+    uint32_t current_since;         /* RTOS time at which current was last accounted */
+} le_app_conn_params_state_t;
+
+/* Policy counters and time spent in each set, summed over connections */
+typedef struct
+{
+    uint32_t requests;
+    uint32_t rejections;
+    uint32_t give_ups;
+    uint32_t time_ms[LE_APP_CONN_PARAMS_COUNT];
+} le_app_conn_params_stats_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+
+/**************************************************************************************************
+* Function Name: le_app_conn_params_init
+***************************************************************************************************
+* Summary:
+*   This function prepares the timer of the discovery period and the retries.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  wiced_result_t: WICED_BT_SUCCESS, or the error of the timer initialization
+*
+**************************************************************************************************/
+wiced_result_t le_app_conn_params_init(void);
+
+/**************************************************************************************************
+* Function Name: le_app_conn_params_on_connect
+***************************************************************************************************
+* Summary:
+*   This function starts the discovery period of a new connection with the fast parameters.
+*
+* Parameters:
+*   uint16_t conn_id            : Connection ID
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_conn_params_on_connect(uint16_t conn_id);
+
+/**************************************************************************************************
+* Function Name: le_app_conn_params_on_disconnect
+***************************************************************************************************
+* Summary:
+*   This function accounts the time of a connection that is going away. Call it before the
+*   connection context is released.
+*
+* Parameters:
+*   uint16_t conn_id            : Connection ID
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_conn_params_on_disconnect(uint16_t conn_id);
+
+/**************************************************************************************************
+* Function Name: le_app_conn_params_on_update
+***************************************************************************************************
+* Summary:
+*   This function handles BTM_BLE_CONNECTION_PARAM_UPDATE. The time spent in the previous set is
+*   accounted, and a rejected request is retried with backoff.
+*
+* Parameters:
+*   wiced_bt_ble_connection_param_update_t *p_update : Connection parameter update event data
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_conn_params_on_update(wiced_bt_ble_connection_param_update_t *p_update);
+
+/**************************************************************************************************
+* Function Name: le_app_conn_params_on_alert
+***************************************************************************************************
+* Summary:
+*   This function applies the policy after the alert level of a connection changed.
+*
+* Parameters:
+*   uint16_t conn_id            : Connection ID
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_conn_params_on_alert(uint16_t conn_id);
+
+/**************************************************************************************************
+* Function Name: le_app_conn_params_get_stats
+***************************************************************************************************
+* Summary:
+*   This function returns the policy counters and the time spent in each set, including the
+*   running time of open connections.
+*
+* Parameters:
+*   le_app_conn_params_stats_t *p_stats : Receives the statistics
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_conn_params_get_stats(le_app_conn_params_stats_t *p_stats);
+
+#endif /* LE_APP_CONN_PARAMS_H_ */
+
+/* [] END OF FILE */
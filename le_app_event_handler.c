@@ -43,16 +43,59 @@
  *        Header Files
  *******************************************************************************/
 #include "le_app_event_handler.h"
+#include "le_app_throughput.h"
+#include "le_app_metrics.h"
+#include "le_app_latency.h"
+#include "le_app_trace.h"
+#include "le_app_evt_rec.h"
+#include "le_app_caching.h"
+#include "le_app_bond.h"
+#include "le_app_adv.h"
+#include "le_app_phy.h"
+#include "le_app_conn_params.h"
+#include "le_app_notify.h"
+#include "le_app_thread.h"
+#include "le_app_led.h"
+#include "le_app_pm.h"
+#include "wiced_timer.h"
+#include "cyabs_rtos.h"
 /*******************************************************************************
  *        Variable Definitions
  *******************************************************************************/
-static uint16_t bt_connection_id = 0;
-app_bt_adv_conn_mode_t app_bt_adv_conn_state = APP_BT_ADV_OFF_CONN_OFF;
-extern cyhal_pwm_t adv_led_pwm;
+static wiced_bool_t bt_advertising = WICED_FALSE;
+/* Current state, and the last state the application thread accepted */
+static app_bt_adv_conn_mode_t le_app_adv_conn_state = APP_BT_ADV_OFF_CONN_OFF;
+static app_bt_adv_conn_mode_t le_app_adv_conn_posted = APP_BT_ADV_OFF_CONN_OFF;
+/* Last alert level the application thread accepted */
+static uint8_t le_app_alert_level_posted = 0;
+/* Posts the state and alert level again after the application thread queue was full */
+static wiced_timer_t le_app_state_retry_timer;
+
+/* Services added after the generated GATT database, in order of their handles */
+static const le_app_gatts_service_t *const le_app_gatt_services[] =
+{
+#if LE_APP_THROUGHPUT_ENABLE
+    &le_app_throughput_service,
+#endif
+#if LE_APP_METRICS_ENABLE
+    &le_app_metrics_service,
+#endif
+    NULL
+};
+
 /*******************************************************************************
  *        Function Prototypes
  *******************************************************************************/
 static void le_app_init(void);
+static void le_app_update_adv_conn_state(void);
+static void le_app_update_alert_level(void);
+static void le_app_state_retry(WICED_TIMER_PARAM_TYPE cb_params);
+static wiced_bt_gatt_status_t le_app_ias_alert_level_check(uint16_t conn_id, uint16_t attr_handle,
+                                                           uint16_t offset, const uint8_t *p_val,
+                                                           uint16_t len);
+static wiced_bt_gatt_status_t le_app_ias_alert_level_write(uint16_t conn_id, uint16_t attr_handle,
+                                                           uint16_t offset, const uint8_t *p_val,
+                                                           uint16_t len);
 
 /*******************************************************************************
  *        Function Definitions
@@ -76,9 +119,15 @@ static void le_app_init(void);
 wiced_result_t le_app_management_callback(wiced_bt_management_evt_t event,
                                           wiced_bt_management_evt_data_t *p_event_data)
 {
+    LE_APP_LATENCY_START(latency_start);
     wiced_result_t wiced_result = WICED_BT_ERROR;
     wiced_bt_device_address_t bda = {0};
     wiced_bt_ble_advert_mode_t *p_adv_mode = NULL;
+    wiced_bt_dev_ble_io_caps_req_t *p_io_caps = NULL;
+    le_app_conn_t *p_conn = NULL;
+    cy_time_t now_ms = 0;
+
+    LE_APP_EVT_REC_MGMT(event, p_event_data);
 
     switch (event)
     {
@@ -91,71 +140,161 @@ wiced_result_t le_app_management_callback(wiced_bt_management_evt_t event,
             if (WICED_BT_SUCCESS == wiced_result)
             {
                 wiced_bt_dev_read_local_addr(bda);
-                printf("Local Bluetooth Address: ");
-                print_bd_address(bda);
+                LE_APP_LOG("Local Bluetooth Address: " LE_APP_LOG_BDA_FMT " \r\n", LE_APP_LOG_BDA_ARGS(bda));
 
                 /* Perform application-specific initialization */
                 le_app_init();
             }
             else
             {
-                printf("failed to set local Bluetooth address\r\n");
+                LE_APP_LOG("failed to set local Bluetooth address\r\n");
             }
         }
         else
         {
-            printf(" Failed to start Bluetooth \r\n");
+            LE_APP_LOG(" Failed to start Bluetooth \r\n");
+        }
+
+        break;
+
+    case BTM_PAIRING_IO_CAPABILITIES_BLE_REQUEST_EVT:
+        /* The Find Me Target has no display or keyboard; bond with Just Works */
+        p_io_caps = &p_event_data->pairing_io_capabilities_ble_request;
+        p_io_caps->local_io_cap = BTM_IO_CAPABILITIES_NONE;
+        p_io_caps->oob_data = BTM_OOB_NONE;
+        p_io_caps->auth_req = BTM_LE_AUTH_REQ_SC_BOND;
+        p_io_caps->max_key_size = BTM_LE_KEY_SIZE_MAX;
+        p_io_caps->init_keys = BTM_LE_KEY_PENC | BTM_LE_KEY_PID;
+        p_io_caps->resp_keys = BTM_LE_KEY_PENC | BTM_LE_KEY_PID;
+        wiced_result = WICED_BT_SUCCESS;
+        break;
+
+    case BTM_SECURITY_REQUEST_EVT:
+        wiced_bt_ble_security_grant(p_event_data->security_request.bd_addr, WICED_BT_SUCCESS);
+        wiced_result = WICED_BT_SUCCESS;
+        break;
+
+    case BTM_PAIRING_COMPLETE_EVT:
+        LE_APP_LOG("Pairing complete: BDA " LE_APP_LOG_BDA_PACKED_FMT " reason %d\r\n",
+                   LE_APP_LOG_BDA_PACKED_ARGS(p_event_data->pairing_complete.bd_addr),
+                   p_event_data->pairing_complete.pairing_complete_info.ble.reason);
+        p_conn = le_app_conn_find_by_addr(p_event_data->pairing_complete.bd_addr);
+        if ((NULL != p_conn) && (WICED_BT_SMP_RES_SUCCESS == p_event_data->pairing_complete.pairing_complete_info.ble.reason))
+        {
+            p_conn->paired = WICED_TRUE;
         }
+        wiced_result = WICED_BT_SUCCESS;
+        break;
+
+    case BTM_ENCRYPTION_STATUS_EVT:
+        LE_APP_LOG("Encryption status: BDA " LE_APP_LOG_BDA_PACKED_FMT " result %d\r\n",
+                   LE_APP_LOG_BDA_PACKED_ARGS(p_event_data->encryption_status.bd_addr),
+                   p_event_data->encryption_status.result);
+        p_conn = le_app_conn_find_by_addr(p_event_data->encryption_status.bd_addr);
+        if ((NULL != p_conn) && !p_conn->encrypted && (WICED_BT_SUCCESS == p_event_data->encryption_status.result))
+        {
+            p_conn->encrypted = WICED_TRUE;
+            cy_rtos_get_time(&now_ms);
+            le_app_bond_record_encryption(p_conn->paired ? WICED_FALSE : WICED_TRUE,
+                                          (uint32_t)(now_ms - p_conn->connect_time_ms));
+            le_app_caching_link_encrypted(p_conn);
+        }
+        wiced_result = WICED_BT_SUCCESS;
+        break;
+
+    case BTM_PAIRED_DEVICE_LINK_KEYS_UPDATE_EVT:
+        /* Keep the bond even if no flash write can be scheduled; it then lasts until reset */
+        if (WICED_BT_SUCCESS != le_app_bond_save_keys(&p_event_data->paired_device_link_keys_update))
+        {
+            LE_APP_LOG("Failed to schedule the bond write to flash\r\n");
+        }
+        wiced_result = WICED_BT_SUCCESS;
+        break;
+
+    case BTM_PAIRED_DEVICE_LINK_KEYS_REQUEST_EVT:
+        /* An error makes the stack pair again */
+        wiced_result = le_app_bond_load_keys(&p_event_data->paired_device_link_keys_request);
+        break;
+
+    case BTM_LOCAL_IDENTITY_KEYS_UPDATE_EVT:
+        if (WICED_BT_SUCCESS != le_app_bond_save_local_keys(&p_event_data->local_identity_keys_update))
+        {
+            LE_APP_LOG("Failed to schedule the local identity keys write to flash\r\n");
+        }
+        wiced_result = WICED_BT_SUCCESS;
+        break;
 
+    case BTM_LOCAL_IDENTITY_KEYS_REQUEST_EVT:
+        /* An error makes the stack generate new keys */
+        wiced_result = le_app_bond_load_local_keys(&p_event_data->local_identity_keys_request);
         break;
 
     case BTM_BLE_ADVERT_STATE_CHANGED_EVT:
         /* Advertisement State Changed */
         p_adv_mode = &p_event_data->ble_advert_state_changed;
-        printf("Advertisement State Change: %s\r\n", get_bt_advert_mode_name(*p_adv_mode));
+        LE_APP_LOG("Advertisement State Change: %s\r\n", LE_APP_LOG_STR(get_bt_advert_mode_name(*p_adv_mode)));
 
         if (BTM_BLE_ADVERT_OFF == *p_adv_mode)
         {
             /* Advertisement Stopped */
-            printf("Advertisement stopped\r\n");
-
-            /* Check connection status after advertisement stops */
-            if (0 == bt_connection_id)
-            {
-                app_bt_adv_conn_state = APP_BT_ADV_OFF_CONN_OFF;
-            }
-            else
-            {
-                app_bt_adv_conn_state = APP_BT_ADV_OFF_CONN_ON;
-            }
+            LE_APP_LOG("Advertisement stopped\r\n");
+            bt_advertising = WICED_FALSE;
         }
         else
         {
             /* Advertisement Started */
-            printf("Advertisement started\r\n");
-            app_bt_adv_conn_state = APP_BT_ADV_ON_CONN_OFF;
+            LE_APP_LOG("Advertisement started\r\n");
+            bt_advertising = WICED_TRUE;
         }
-#ifdef CYBSP_USER_LED2
-        /* Update Advertisement LED to reflect the updated state */
-        adv_led_update();
-#endif
+        le_app_adv_on_state_changed(*p_adv_mode);
+        le_app_update_adv_conn_state();
+        wiced_result = WICED_BT_SUCCESS;
+        break;
+
+    case BTM_BLE_DATA_LENGTH_UPDATE_EVENT:
+        LE_APP_LOG("Data length update: Max TX Octets: %d, Max TX Time: %d, Max RX Octets: %d, Max RX Time: %d\r\n",
+                   p_event_data->ble_data_length_update_event.max_tx_octets,
+                   p_event_data->ble_data_length_update_event.max_tx_time,
+                   p_event_data->ble_data_length_update_event.max_rx_octets,
+                   p_event_data->ble_data_length_update_event.max_rx_time);
+        wiced_result = WICED_BT_SUCCESS;
+        break;
+
+    case BTM_BLE_PHY_UPDATE_EVT:
+        le_app_phy_on_update(&p_event_data->ble_phy_update_event);
         wiced_result = WICED_BT_SUCCESS;
         break;
 
     case BTM_BLE_CONNECTION_PARAM_UPDATE:
-        printf("Connection parameter update status:%d, Connection Interval: %d, Connection Latency: %d, Connection Timeout: %d\r\n",
-               p_event_data->ble_connection_param_update.status,
-               p_event_data->ble_connection_param_update.conn_interval,
-               p_event_data->ble_connection_param_update.conn_latency,
-               p_event_data->ble_connection_param_update.supervision_timeout);
+        p_conn = le_app_conn_find_by_addr(p_event_data->ble_connection_param_update.bd_addr);
+        if ((NULL != p_conn) && (0 == p_event_data->ble_connection_param_update.status))
+        {
+            p_conn->conn_interval = p_event_data->ble_connection_param_update.conn_interval;
+            p_conn->conn_latency = p_event_data->ble_connection_param_update.conn_latency;
+            p_conn->supervision_timeout = p_event_data->ble_connection_param_update.supervision_timeout;
+        }
+        le_app_conn_params_on_update(&p_event_data->ble_connection_param_update);
+        LE_APP_LOG("Connection parameter update status:%d, Connection Interval: %d, Connection Latency: %d, Connection Timeout: %d\r\n",
+                   p_event_data->ble_connection_param_update.status,
+                   p_event_data->ble_connection_param_update.conn_interval,
+                   p_event_data->ble_connection_param_update.conn_latency,
+                   p_event_data->ble_connection_param_update.supervision_timeout);
+        wiced_result = WICED_BT_SUCCESS;
+        break;
+
+    case BTM_LPM_STATE_LOW_POWER:
+        /* The controller sleeps on its own between radio events; count it for the power stats */
+        le_app_pm_on_controller_low_power();
         wiced_result = WICED_BT_SUCCESS;
         break;
 
     default:
-        printf("Unhandled Bluetooth Management Event: 0x%x %s\r\n", event, get_btm_event_name(event));
+        LE_APP_LOG("Unhandled Bluetooth Management Event: 0x%x %s\r\n", event, LE_APP_LOG_STR(get_btm_event_name(event)));
         break;
     }
 
+    LE_APP_LATENCY_RECORD(LE_APP_LATENCY_MGMT_EVT, event, latency_start);
+
     return wiced_result;
 }
 
@@ -183,33 +322,28 @@ static void le_app_init(void)
     printf("**Discover device with \"Find Me Target\" name*\r\n");
     printf("***********************************************\r\n\r\n");
     cy_rslt_t cy_result;
-#ifdef CYBSP_USER_LED1
-    /* Initialize the PWM used for IAS alert level LED */
-    cyhal_clock_t clock_temp = {CYHAL_CLOCK_BLOCK_CPU, 0, false};
-    cy_result = cyhal_pwm_init_adv(&ias_led_pwm, CYBSP_USER_LED1, NC, CYHAL_PWM_RIGHT_ALIGN, true, 0u, true, &clock_temp);
-    /* PWM init failed. Stop program execution */
+
+    /* Initialize the LED pins and the pattern timer. CYBSP_USER_LED2 is only present on some
+     * kits. For those kits, it is used to indicate advertising/connection status */
+    cy_result = le_app_led_init();
+    /* LED init failed. Stop program execution */
     if (CY_RSLT_SUCCESS != cy_result)
     {
         cy_rslt_decode_t result_temp;
         result_temp.raw = cy_result;
 
-        printf("IAS LED PWM Initialization has failed! %x %x %x \r\n", result_temp.code, result_temp.type, result_temp.module);
+        printf("LED Initialization has failed! %x %x %x \r\n", result_temp.code, result_temp.type, result_temp.module);
         CY_ASSERT(0);
     }
-#endif
-    /* CYBSP_USER_LED2 is only present on some kits. For those kits,it is used to indicate advertising/connection status */
-#ifdef CYBSP_USER_LED2
-    /* Initialize the PWM used for Advertising LED */
-    cy_result = cyhal_pwm_init_adv(&adv_led_pwm, CYBSP_USER_LED2, NC, CYHAL_PWM_RIGHT_ALIGN, true, 0u, true, &clock_temp);
-    /* PWM init failed. Stop program execution */
-    if (CY_RSLT_SUCCESS != cy_result)
+
+    /* Allow locators to bond, and let bonded locators using private addresses reconnect */
+    wiced_bt_set_pairable_mode(WICED_TRUE, WICED_FALSE);
+    wiced_result = le_app_bond_start();
+    if (WICED_BT_SUCCESS != wiced_result)
     {
-        printf("Advertisement LED PWM Initialization has failed! \r\n");
+        LE_APP_LOG("Bond store start failed! %d \r\n", wiced_result);
         CY_ASSERT(0);
     }
-#endif
-
-    wiced_bt_set_pairable_mode(FALSE, FALSE);
 
     /* Set Advertisement Data */
     wiced_result = wiced_bt_ble_set_raw_advertisement_data(CY_BT_ADV_PACKET_DATA_SIZE, cy_bt_adv_packet_data);
@@ -219,25 +353,109 @@ static void le_app_init(void)
         CY_ASSERT(0);
     }
 
+    /* Prepare the GATT response buffer pool before the stack can request buffers */
+    app_buffer_pool_init();
+
     /* Register with BT stack to receive GATT callback */
     gatt_status = wiced_bt_gatt_register(le_app_gatt_event_callback);
-    printf("GATT event Handler registration status: %s \r\n", get_bt_gatt_status_name(gatt_status));
+    LE_APP_LOG("GATT event Handler registration status: %s \r\n", LE_APP_LOG_STR(get_bt_gatt_status_name(gatt_status)));
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+        CY_ASSERT(0);
+    }
+
+    /* Initialize GATT Database with the optional services, and build the handle index used
+     * for GATT attribute lookups */
+    gatt_status = le_app_gatts_init(le_app_gatt_services);
+    LE_APP_LOG("GATT database initialization status: %s \r\n", LE_APP_LOG_STR(get_bt_gatt_status_name(gatt_status)));
     if (WICED_BT_GATT_SUCCESS != gatt_status)
     {
         CY_ASSERT(0);
     }
 
-    /* Initialize GATT Database */
-    gatt_status = wiced_bt_gatt_db_init(gatt_database, gatt_database_len, NULL);
-    printf("GATT database initialization status: %s \r\n", get_bt_gatt_status_name(gatt_status));
+    /* Keep the Client Supported Features per connection for Robust Caching */
+    gatt_status = le_app_caching_init();
+    LE_APP_LOG("Robust Caching initialization status: %s \r\n", LE_APP_LOG_STR(get_bt_gatt_status_name(gatt_status)));
     if (WICED_BT_GATT_SUCCESS != gatt_status)
     {
         CY_ASSERT(0);
     }
 
+    /* Update the IAS LED when a client writes the alert level */
+    gatt_status = le_app_gatts_register_handle(HDLC_IAS_ALERT_LEVEL_VALUE, NULL,
+                                               le_app_ias_alert_level_check,
+                                               le_app_ias_alert_level_write);
+    LE_APP_LOG("IAS alert level registration status: %s \r\n", LE_APP_LOG_STR(get_bt_gatt_status_name(gatt_status)));
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+        CY_ASSERT(0);
+    }
+
+#if LE_APP_THROUGHPUT_ENABLE
+    /* Register the throughput test attributes and its notification source */
+    gatt_status = le_app_throughput_init();
+    LE_APP_LOG("Throughput service initialization status: %s \r\n", LE_APP_LOG_STR(get_bt_gatt_status_name(gatt_status)));
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+        CY_ASSERT(0);
+    }
+#endif
+
+#if LE_APP_METRICS_ENABLE
+    /* Register the metrics snapshot */
+    gatt_status = le_app_metrics_init();
+    LE_APP_LOG("Metrics service initialization status: %s \r\n", LE_APP_LOG_STR(get_bt_gatt_status_name(gatt_status)));
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+        CY_ASSERT(0);
+    }
+#endif
+
+    /* Prepare the retry of adv/conn states and alert levels the application thread could not
+     * queue */
+    wiced_result = wiced_init_timer(&le_app_state_retry_timer, le_app_state_retry, NULL,
+                                    WICED_MILLI_SECONDS_TIMER);
+    if (WICED_BT_SUCCESS != wiced_result)
+    {
+        LE_APP_LOG("State retry timer initialization failed! \r\n");
+        CY_ASSERT(0);
+    }
+
+    /* Prepare the retry of notification queues the stack refused */
+    wiced_result = le_app_notify_init();
+    if (WICED_BT_SUCCESS != wiced_result)
+    {
+        LE_APP_LOG("Notification retry timer initialization failed! \r\n");
+        CY_ASSERT(0);
+    }
+
+    /* Prepare the RSSI polling of the PHY policy */
+    wiced_result = le_app_phy_init();
+    if (WICED_BT_SUCCESS != wiced_result)
+    {
+        LE_APP_LOG("PHY policy initialization failed! \r\n");
+        CY_ASSERT(0);
+    }
+
+    /* Prepare the timer of the connection parameter policy */
+    wiced_result = le_app_conn_params_init();
+    if (WICED_BT_SUCCESS != wiced_result)
+    {
+        LE_APP_LOG("Connection parameter policy initialization failed! \r\n");
+        CY_ASSERT(0);
+    }
+
+    /* Prepare the reconnect policy that invites a disconnected peer back */
+    wiced_result = le_app_adv_init();
+    if (WICED_BT_SUCCESS != wiced_result)
+    {
+        LE_APP_LOG("Advertising policy initialization failed! \r\n");
+        CY_ASSERT(0);
+    }
+
     /* Start Undirected LE Advertisements on device startup.
      * The corresponding parameters are contained in 'app_bt_cfg.c' */
-    wiced_result = wiced_bt_start_advertisements(BTM_BLE_ADVERT_UNDIRECTED_HIGH, 0, NULL);
+    wiced_result = le_app_adv_start();
     /* Failed to start advertisement. Stop program execution */
     if (WICED_BT_SUCCESS != wiced_result)
     {
@@ -262,50 +480,344 @@ static void le_app_init(void)
 wiced_bt_gatt_status_t le_app_connect_handler(wiced_bt_gatt_connection_status_t *p_conn_status)
 {
     wiced_bt_gatt_status_t gatt_status = WICED_BT_GATT_ERROR;
+    le_app_conn_t *p_conn = NULL;
 
     if (NULL != p_conn_status)
     {
         if (p_conn_status->connected)
         {
             /* Device has connected */
-            printf("Connected : BDA ");
-            print_bd_address(p_conn_status->bd_addr);
-            printf("Connection ID '%d' \r\n", p_conn_status->conn_id);
+            LE_APP_LOG("Connected : BDA " LE_APP_LOG_BDA_FMT " \r\n", LE_APP_LOG_BDA_ARGS(p_conn_status->bd_addr));
+            LE_APP_LOG("Connection ID '%d' \r\n", p_conn_status->conn_id);
+            LE_APP_METRICS_INC(connects);
+            LE_APP_TRACE(LE_APP_TRACE_CONNECT, p_conn_status->conn_id);
 
-            /* Store the connection ID */
-            bt_connection_id = p_conn_status->conn_id;
+            /* Claim a context for the connection; the ATT MTU starts at the default */
+            p_conn = le_app_conn_alloc(p_conn_status->conn_id, p_conn_status->bd_addr);
+            if (NULL == p_conn)
+            {
+                LE_APP_LOG("No free connection context for Connection ID '%d'\r\n", p_conn_status->conn_id);
+            }
+            else
+            {
+                cy_rtos_get_time(&p_conn->connect_time_ms);
+
+                /* Move to LE 2M PHY and watch the RSSI for a move to LE Coded */
+                le_app_phy_on_connect(p_conn->conn_id);
+
+                /* Short interval while the client discovers the database */
+                le_app_conn_params_on_connect(p_conn->conn_id);
+            }
+
+            /* Ends the reconnect window if this is the peer that just disconnected */
+            le_app_adv_on_connect(p_conn_status->bd_addr);
+
+            /* Keep advertising while connection slots remain free */
+            if (LE_APP_MAX_CONNECTIONS > le_app_conn_count())
+            {
+                le_app_adv_start();
+            }
 
             /* Update the adv/conn state */
-            app_bt_adv_conn_state = APP_BT_ADV_OFF_CONN_ON;
+            le_app_update_adv_conn_state();
         }
         else
         {
             /* Device has disconnected */
-            printf("Disconnected : BDA ");
-            print_bd_address(p_conn_status->bd_addr);
-            printf("Connection ID '%d', Reason '%s'\r\n", p_conn_status->conn_id, get_bt_gatt_disconn_reason_name(p_conn_status->reason));
+            LE_APP_LOG("Disconnected : BDA " LE_APP_LOG_BDA_FMT " \r\n", LE_APP_LOG_BDA_ARGS(p_conn_status->bd_addr));
+            LE_APP_LOG("Connection ID '%d', Reason '%s'\r\n", p_conn_status->conn_id,
+                       LE_APP_LOG_STR(get_bt_gatt_disconn_reason_name(p_conn_status->reason)));
+#if LE_APP_METRICS_ENABLE
+            le_app_metrics_on_disconnect(p_conn_status->reason);
+#endif
+#if LE_APP_TRACE_ENABLE
+            le_app_trace_on_disconnect(p_conn_status->conn_id);
+#endif
+#if LE_APP_THROUGHPUT_ENABLE
+            le_app_throughput_on_disconnect(p_conn_status->conn_id);
+#endif
 
-            /* Set the connection id to zero to indicate disconnected state */
-            bt_connection_id = 0;
+            /* Release the connection context */
+            le_app_conn_params_on_disconnect(p_conn_status->conn_id);
+            le_app_conn_free(p_conn_status->conn_id);
+            le_app_phy_on_disconnect();
 
-            /* Restart the advertisements */
-            wiced_bt_start_advertisements(BTM_BLE_ADVERT_UNDIRECTED_HIGH, 0, NULL);
+            /* Invite the peer back with directed advertising, then advertise to everyone */
+            le_app_adv_on_disconnect(p_conn_status->bd_addr, p_conn_status->addr_type);
 
             /* Update the adv/conn state */
-            app_bt_adv_conn_state = APP_BT_ADV_ON_CONN_OFF;
-#ifdef CYBSP_USER_LED1
-            /* Turn Off the IAS LED on a disconnection */
-            ias_led_update();
-#endif
+            le_app_update_adv_conn_state();
+
+            /* The alert level of the disconnected peer no longer applies */
+            app_ias_alert_level[0] = le_app_conn_max_alert_level();
+            le_app_update_alert_level();
         }
-#ifdef CYBSP_USER_LED2
-        /* Update Advertisement LED to reflect the updated state */
-        adv_led_update();
-#endif
         gatt_status = WICED_BT_GATT_SUCCESS;
     }
 
     return gatt_status;
 }
 
+/**************************************************************************************************
+ * Function Name: le_app_get_conn_mtu
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns the ATT MTU agreed with the peer of the given connection.
+ *
+ * Parameters:
+ *   uint16_t conn_id            : Connection ID
+ *
+ * Return:
+ *  uint16_t: Agreed ATT MTU, or CY_BT_MTU_SIZE if no MTU exchange has taken place
+ *
+ **************************************************************************************************/
+uint16_t le_app_get_conn_mtu(uint16_t conn_id)
+{
+    le_app_conn_t *p_conn = le_app_conn_find(conn_id);
+
+    return (NULL != p_conn) ? p_conn->mtu : CY_BT_MTU_SIZE;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_set_conn_mtu
+ ***************************************************************************************************
+ * Summary:
+ *   This function records the ATT MTU agreed with the peer and requests an LL data length that
+ *   carries a full ATT PDU in a single link layer packet.
+ *
+ * Parameters:
+ *   uint16_t conn_id            : Connection ID
+ *   uint16_t mtu                : Agreed ATT MTU
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_set_conn_mtu(uint16_t conn_id, uint16_t mtu)
+{
+    uint16_t tx_octets;
+    wiced_result_t wiced_result;
+    le_app_conn_t *p_conn = le_app_conn_find(conn_id);
+
+    if (NULL == p_conn)
+    {
+        return;
+    }
+
+    p_conn->mtu = MAX(mtu, CY_BT_MTU_SIZE);
+    LE_APP_LOG("Connection ID '%d' ATT MTU: %d\r\n", conn_id, p_conn->mtu);
+    LE_APP_TRACE(LE_APP_TRACE_MTU, conn_id);
+
+    /* Request an LL payload large enough for a full ATT PDU plus the L2CAP header */
+    tx_octets = MIN(p_conn->mtu + LE_APP_L2CAP_HDR_SIZE, LE_APP_MAX_LL_TX_OCTETS);
+    wiced_result = wiced_bt_ble_set_data_packet_length(p_conn->bd_addr, tx_octets, LE_APP_LL_TX_TIME_1M(tx_octets));
+    if (WICED_BT_SUCCESS != wiced_result)
+    {
+        LE_APP_LOG("Data length update request failed: 0x%x\r\n", wiced_result);
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_print_stats
+ ***************************************************************************************************
+ * Summary:
+ *   This function prints the statistics of every module that is built in. It is called from the
+ *   Bluetooth stack context on a long press of the user button.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_print_stats(void)
+{
+#if LE_APP_LATENCY_ENABLE
+    le_app_latency_print();
+#endif
+#if LE_APP_TRACE_ENABLE
+    le_app_trace_print();
+#endif
+    le_app_adv_print_stats();
+    le_app_bond_print_stats();
+    le_app_pm_print_stats();
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_update_adv_conn_state
+ ***************************************************************************************************
+ * Summary:
+ *   This function derives the adv/conn state from the advertising state and the number of
+ *   active connections, and hands a change to the application thread, which updates the LEDs.
+ *   If the application thread queue is full, the state is posted again from a timer.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_update_adv_conn_state(void)
+{
+    app_bt_adv_conn_mode_t state;
+
+    if (0 == le_app_conn_count())
+    {
+        state = bt_advertising ? APP_BT_ADV_ON_CONN_OFF : APP_BT_ADV_OFF_CONN_OFF;
+    }
+    else
+    {
+        state = bt_advertising ? APP_BT_ADV_ON_CONN_ON : APP_BT_ADV_OFF_CONN_ON;
+    }
+
+    /* The state is only taken as posted once the application thread queue accepted it */
+    if (state != le_app_adv_conn_posted)
+    {
+        if (le_app_thread_post(LE_APP_THREAD_PRODUCER_STACK, LE_APP_EVT_ADV_CONN_STATE, state))
+        {
+            le_app_adv_conn_posted = state;
+        }
+        else
+        {
+            wiced_start_timer(&le_app_state_retry_timer, LE_APP_STATE_RETRY_MS);
+        }
+    }
+
+    if (state != le_app_adv_conn_state)
+    {
+        le_app_adv_conn_state = state;
+#if LE_APP_METRICS_ENABLE
+        le_app_metrics_set_adv_conn_state(state);
+#endif
+
+        /* Split the power state times by what the radio is doing */
+        le_app_pm_set_radio((0 != le_app_conn_count()) ? LE_APP_PM_RADIO_CONNECTED :
+                            (bt_advertising ? LE_APP_PM_RADIO_ADVERTISING : LE_APP_PM_RADIO_IDLE));
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_update_alert_level
+ ***************************************************************************************************
+ * Summary:
+ *   This function hands a change of the highest IAS alert level to the application thread,
+ *   which updates the IAS LED. If the application thread queue is full, the level is posted
+ *   again from a timer.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_update_alert_level(void)
+{
+    uint8_t level = app_ias_alert_level[0];
+
+    /* The level is only taken as posted once the application thread queue accepted it */
+    if (level != le_app_alert_level_posted)
+    {
+        if (le_app_thread_post(LE_APP_THREAD_PRODUCER_STACK, LE_APP_EVT_ALERT_LEVEL, level))
+        {
+            le_app_alert_level_posted = level;
+        }
+        else
+        {
+            wiced_start_timer(&le_app_state_retry_timer, LE_APP_STATE_RETRY_MS);
+        }
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_state_retry
+ ***************************************************************************************************
+ * Summary:
+ *   This function posts the adv/conn state and the alert level again after the application
+ *   thread queue was full.
+ *
+ * Parameters:
+ *   WICED_TIMER_PARAM_TYPE cb_params    : Unused
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_state_retry(WICED_TIMER_PARAM_TYPE cb_params)
+{
+    le_app_update_adv_conn_state();
+    le_app_update_alert_level();
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_ias_alert_level_check
+ ***************************************************************************************************
+ * Summary:
+ *   This function checks a value before it is written to the IAS Alert Level characteristic.
+ *
+ * Parameters:
+ *   uint16_t conn_id            : Connection ID of the writer
+ *   uint16_t attr_handle        : HDLC_IAS_ALERT_LEVEL_VALUE
+ *   uint16_t offset             : Offset of the value
+ *   const uint8_t *p_val        : Alert level to write
+ *   uint16_t len                : Length of the value
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_INVALID_ATTR_LEN unless a single alert level is written
+ *
+ **************************************************************************************************/
+static wiced_bt_gatt_status_t le_app_ias_alert_level_check(uint16_t conn_id, uint16_t attr_handle,
+                                                           uint16_t offset, const uint8_t *p_val,
+                                                           uint16_t len)
+{
+    if ((0 != offset) || (sizeof(app_ias_alert_level[0]) != len))
+    {
+        return WICED_BT_GATT_INVALID_ATTR_LEN;
+    }
+
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_ias_alert_level_write
+ ***************************************************************************************************
+ * Summary:
+ *   This function handles a write to the IAS Alert Level characteristic. Each peer has its own
+ *   alert level; the database value and the LED show the highest one.
+ *
+ * Parameters:
+ *   uint16_t conn_id            : Connection ID of the writer
+ *   uint16_t attr_handle        : HDLC_IAS_ALERT_LEVEL_VALUE
+ *   uint16_t offset             : Offset of the value
+ *   const uint8_t *p_val        : Alert level written
+ *   uint16_t len                : Length of the value
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_HANDLED, as the value is stored here
+ *
+ **************************************************************************************************/
+static wiced_bt_gatt_status_t le_app_ias_alert_level_write(uint16_t conn_id, uint16_t attr_handle,
+                                                           uint16_t offset, const uint8_t *p_val,
+                                                           uint16_t len)
+{
+    le_app_conn_t *p_conn = le_app_conn_find(conn_id);
+
+    LE_APP_TRACE(LE_APP_TRACE_SET_VALUE, conn_id);
+
+    if (NULL != p_conn)
+    {
+        p_conn->alert_level = p_val[0];
+
+        /* Respond quickly while the alert is active, save power once it is cleared */
+        le_app_conn_params_on_alert(conn_id);
+    }
+    app_ias_alert_level[0] = le_app_conn_max_alert_level();
+    LE_APP_LOG("Alert Level = %d\r\n", app_ias_alert_level[0]);
+    le_app_update_alert_level();
+
+    return WICED_BT_GATT_HANDLED;
+}
+
 /* [] END OF FILE */
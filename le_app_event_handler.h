@@ -50,15 +50,27 @@
 #include "le_app_gatts.h"
 #include "le_app_user_interface.h"
 #include "le_app_utils.h"
+#include "le_app_log.h"
+#include "le_app_conn.h"
 
 /*******************************************************************************
 *        Macro Definitions
 *******************************************************************************/
+/* Largest LL data PDU payload and its transmit time on the LE 1M PHY */
+#define LE_APP_MAX_LL_TX_OCTETS         (251)
+#define LE_APP_LL_TX_TIME_1M(octets)    (((octets) + 14) * 8)
+
+/* L2CAP basic header length added to every ATT PDU */
+#define LE_APP_L2CAP_HDR_SIZE           (4)
+
+/* Delay before an adv/conn state or alert level that did not fit in the application
+ * thread queue is posted again */
+#define LE_APP_STATE_RETRY_MS           (10u)
 
 /*******************************************************************************
 *        External Variable Declarations
 *******************************************************************************/
-extern cyhal_pwm_t ias_led_pwm;
+
 /*******************************************************************************
 *        Function Prototypes
 *******************************************************************************/
@@ -96,4 +108,52 @@ wiced_result_t le_app_management_callback(wiced_bt_management_evt_t event,
 **************************************************************************************************/
 wiced_bt_gatt_status_t le_app_connect_handler(wiced_bt_gatt_connection_status_t *p_conn_status);
 
+/**************************************************************************************************
+* Function Name: le_app_get_conn_mtu
+***************************************************************************************************
+* Summary:
+*   This function returns the ATT MTU agreed with the peer of the given connection.
+*
+* Parameters:
+*   uint16_t conn_id            : Connection ID
+*
+* Return:
+*  uint16_t: Agreed ATT MTU, or CY_BT_MTU_SIZE if no MTU exchange has taken place
+*
+**************************************************************************************************/
+uint16_t le_app_get_conn_mtu(uint16_t conn_id);
+
+/**************************************************************************************************
+* Function Name: le_app_set_conn_mtu
+***************************************************************************************************
+* Summary:
+*   This function records the ATT MTU agreed with the peer and requests an LL data length that
+*   carries a full ATT PDU in a single link layer packet.
+*
+* Parameters:
+*   uint16_t conn_id            : Connection ID
+*   uint16_t mtu                : Agreed ATT MTU
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_set_conn_mtu(uint16_t conn_id, uint16_t mtu);
+
+/**************************************************************************************************
+* Function Name: le_app_print_stats
+***************************************************************************************************
+* Summary:
+*   This function prints the statistics of every module that is built in. It is called from the
+*   Bluetooth stack context on a long press of the user button.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_print_stats(void);
+
 #endif /* LE_APP_EVENT_HANDLER_H_ */
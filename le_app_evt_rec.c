@@ -0,0 +1,534 @@
+/*******************************************************************************
+ * File Name: le_app_evt_rec.c
+ *
+ * Description:
+ *   This file contains the event recorder. Records are appended to a fixed buffer
+ *   from the Bluetooth stack context and published with a release store, so the
+ *   dump can read them from any thread without a lock.
+ *
+ * Related Document: See Readme.md
+ *
+ *******************************************************************************
+ * Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/*******************************************************************************
+ *        Header Files
+ *******************************************************************************/
+#include "le_app_evt_rec.h"
+
+#if LE_APP_EVT_REC_ENABLE
+
+#include "cyabs_rtos.h"
+#include "cyhal.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *        Macro Definitions
+ *******************************************************************************/
+/* Bytes printed per line by le_app_evt_rec_dump() */
+#define LE_APP_EVT_REC_DUMP_LINE        (32u)
+
+/*******************************************************************************
+ *        Variable Definitions
+ *******************************************************************************/
+static uint8_t le_app_evt_rec_buf[LE_APP_EVT_REC_BUF_SIZE];
+
+/* Bytes of complete records. Written with release order by the stack context only */
+static atomic_uint le_app_evt_rec_used;
+
+/* Events that did not fit in the buffer */
+static atomic_uint le_app_evt_rec_dropped;
+
+/* Record being written. Only the Bluetooth stack context uses these */
+static uint32_t le_app_evt_rec_pos;
+static bool le_app_evt_rec_overflow;
+
+/*******************************************************************************
+ *        Function Prototypes
+ *******************************************************************************/
+static void le_app_evt_rec_begin(void);
+static void le_app_evt_rec_end(uint8_t event, le_app_evt_rec_kind_t kind, uint32_t time_ms, uint32_t cycles);
+static void le_app_evt_rec_put(const void *p_data, uint32_t len);
+static void le_app_evt_rec_put8(uint8_t value);
+static void le_app_evt_rec_put16(uint16_t value);
+static void le_app_evt_rec_put32(uint32_t value);
+static void le_app_evt_rec_put_le(uint8_t *p_dst, uint32_t value, uint32_t len);
+
+/*******************************************************************************
+ *        Function Definitions
+ *******************************************************************************/
+
+/**************************************************************************************************
+ * Function Name: le_app_evt_rec_init
+ ***************************************************************************************************
+ * Summary:
+ *   This function starts the DWT cycle counter and empties the trace. It must be called before
+ *   the Bluetooth stack is initialized.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_evt_rec_init(void)
+{
+    atomic_store_explicit(&le_app_evt_rec_used, 0, memory_order_relaxed);
+    atomic_store_explicit(&le_app_evt_rec_dropped, 0, memory_order_relaxed);
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_evt_rec_mgmt
+ ***************************************************************************************************
+ * Summary:
+ *   This function records a management event. It is called through LE_APP_EVT_REC_MGMT() from
+ *   the Bluetooth stack context.
+ *
+ * Parameters:
+ *   wiced_bt_management_evt_t event             : Management event
+ *   wiced_bt_management_evt_data_t *p_event_data: Event data
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_evt_rec_mgmt(wiced_bt_management_evt_t event, const wiced_bt_management_evt_data_t *p_event_data)
+{
+    le_app_evt_rec_kind_t kind = LE_APP_EVT_REC_MGMT_OTHER;
+    uint32_t cycles = DWT->CYCCNT;
+    cy_time_t now_ms = 0;
+
+    cy_rtos_get_time(&now_ms);
+    le_app_evt_rec_begin();
+
+    switch (event)
+    {
+    case BTM_ENABLED_EVT:
+        kind = LE_APP_EVT_REC_MGMT_ENABLED;
+        le_app_evt_rec_put32(p_event_data->enabled.status);
+        break;
+
+    case BTM_BLE_ADVERT_STATE_CHANGED_EVT:
+        kind = LE_APP_EVT_REC_MGMT_ADVERT_STATE;
+        le_app_evt_rec_put8(p_event_data->ble_advert_state_changed);
+        break;
+
+    case BTM_BLE_CONNECTION_PARAM_UPDATE:
+        kind = LE_APP_EVT_REC_MGMT_CONN_PARAM_UPDATE;
+        le_app_evt_rec_put8(p_event_data->ble_connection_param_update.status);
+        le_app_evt_rec_put(p_event_data->ble_connection_param_update.bd_addr, sizeof(wiced_bt_device_address_t));
+        le_app_evt_rec_put16(p_event_data->ble_connection_param_update.conn_interval);
+        le_app_evt_rec_put16(p_event_data->ble_connection_param_update.conn_latency);
+        le_app_evt_rec_put16(p_event_data->ble_connection_param_update.supervision_timeout);
+        break;
+
+    case BTM_BLE_PHY_UPDATE_EVT:
+        kind = LE_APP_EVT_REC_MGMT_PHY_UPDATE;
+        le_app_evt_rec_put8(p_event_data->ble_phy_update_event.status);
+        le_app_evt_rec_put(p_event_data->ble_phy_update_event.bd_address, sizeof(wiced_bt_device_address_t));
+        le_app_evt_rec_put8(p_event_data->ble_phy_update_event.tx_phy);
+        le_app_evt_rec_put8(p_event_data->ble_phy_update_event.rx_phy);
+        break;
+
+    case BTM_BLE_DATA_LENGTH_UPDATE_EVENT:
+        kind = LE_APP_EVT_REC_MGMT_DATA_LENGTH_UPDATE;
+        le_app_evt_rec_put(p_event_data->ble_data_length_update_event.bd_address, sizeof(wiced_bt_device_address_t));
+        le_app_evt_rec_put16(p_event_data->ble_data_length_update_event.max_tx_octets);
+        le_app_evt_rec_put16(p_event_data->ble_data_length_update_event.max_tx_time);
+        le_app_evt_rec_put16(p_event_data->ble_data_length_update_event.max_rx_octets);
+        le_app_evt_rec_put16(p_event_data->ble_data_length_update_event.max_rx_time);
+        break;
+
+    case BTM_PAIRING_COMPLETE_EVT:
+        kind = LE_APP_EVT_REC_MGMT_PAIRING_COMPLETE;
+        le_app_evt_rec_put(p_event_data->pairing_complete.bd_addr, sizeof(wiced_bt_device_address_t));
+        le_app_evt_rec_put8(p_event_data->pairing_complete.pairing_complete_info.ble.reason);
+        break;
+
+    case BTM_ENCRYPTION_STATUS_EVT:
+        kind = LE_APP_EVT_REC_MGMT_ENCRYPTION_STATUS;
+        le_app_evt_rec_put(p_event_data->encryption_status.bd_addr, sizeof(wiced_bt_device_address_t));
+        le_app_evt_rec_put32(p_event_data->encryption_status.result);
+        break;
+
+    case BTM_SECURITY_REQUEST_EVT:
+        kind = LE_APP_EVT_REC_MGMT_BD_ADDR;
+        le_app_evt_rec_put(p_event_data->security_request.bd_addr, sizeof(wiced_bt_device_address_t));
+        break;
+
+    case BTM_PAIRING_IO_CAPABILITIES_BLE_REQUEST_EVT:
+        kind = LE_APP_EVT_REC_MGMT_BD_ADDR;
+        le_app_evt_rec_put(p_event_data->pairing_io_capabilities_ble_request.bd_addr,
+                           sizeof(wiced_bt_device_address_t));
+        break;
+
+    /* Keys would leave the device with the trace; only the event is kept */
+    case BTM_PAIRED_DEVICE_LINK_KEYS_UPDATE_EVT:
+    case BTM_PAIRED_DEVICE_LINK_KEYS_REQUEST_EVT:
+    case BTM_LOCAL_IDENTITY_KEYS_UPDATE_EVT:
+    case BTM_LOCAL_IDENTITY_KEYS_REQUEST_EVT:
+        kind = LE_APP_EVT_REC_MGMT_KEYS;
+        break;
+
+    default:
+        break;
+    }
+
+    le_app_evt_rec_end((uint8_t)event, kind, now_ms, cycles);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_evt_rec_gatt
+ ***************************************************************************************************
+ * Summary:
+ *   This function records a GATT event, with the value bytes of attribute requests. It is called
+ *   through LE_APP_EVT_REC_GATT() from the Bluetooth stack context.
+ *
+ * Parameters:
+ *   wiced_bt_gatt_evt_t event                   : GATT event
+ *   wiced_bt_gatt_event_data_t *p_event_data    : Event data
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_evt_rec_gatt(wiced_bt_gatt_evt_t event, const wiced_bt_gatt_event_data_t *p_event_data)
+{
+    const wiced_bt_gatt_connection_status_t *p_status = &p_event_data->connection_status;
+    const wiced_bt_gatt_attribute_request_t *p_attr_req = &p_event_data->attribute_request;
+    const wiced_bt_uuid_t *p_uuid = &p_attr_req->data.read_by_type.uuid;
+    le_app_evt_rec_kind_t kind = LE_APP_EVT_REC_GATT_OTHER;
+    uint32_t cycles = DWT->CYCCNT;
+    cy_time_t now_ms = 0;
+
+    cy_rtos_get_time(&now_ms);
+    le_app_evt_rec_begin();
+
+    switch (event)
+    {
+    case GATT_CONNECTION_STATUS_EVT:
+        kind = LE_APP_EVT_REC_GATT_CONNECTION_STATUS;
+        le_app_evt_rec_put16(p_status->conn_id);
+        le_app_evt_rec_put8(p_status->connected);
+        le_app_evt_rec_put16(p_status->reason);
+        le_app_evt_rec_put8(p_status->addr_type);
+        le_app_evt_rec_put8(p_status->transport);
+        le_app_evt_rec_put8(p_status->link_role);
+        le_app_evt_rec_put(p_status->bd_addr, sizeof(wiced_bt_device_address_t));
+        break;
+
+    case GATT_ATTRIBUTE_REQUEST_EVT:
+        kind = LE_APP_EVT_REC_GATT_ATTRIBUTE_REQUEST;
+        le_app_evt_rec_put16(p_attr_req->conn_id);
+        le_app_evt_rec_put8(p_attr_req->opcode);
+        le_app_evt_rec_put16(p_attr_req->len_requested);
+
+        /* The fields each opcode handler reads, including the bytes behind the pointers */
+        switch (p_attr_req->opcode)
+        {
+        case GATT_REQ_READ:
+        case GATT_REQ_READ_BLOB:
+            le_app_evt_rec_put16(p_attr_req->data.read_req.handle);
+            le_app_evt_rec_put16(p_attr_req->data.read_req.offset);
+            break;
+
+        case GATT_REQ_READ_BY_TYPE:
+            le_app_evt_rec_put16(p_attr_req->data.read_by_type.s_handle);
+            le_app_evt_rec_put16(p_attr_req->data.read_by_type.e_handle);
+            le_app_evt_rec_put16(p_uuid->len);
+            le_app_evt_rec_put(&p_uuid->uu, (p_uuid->len <= sizeof(p_uuid->uu)) ? p_uuid->len : 0);
+            break;
+
+        case GATT_REQ_READ_MULTI:
+        case GATT_REQ_READ_MULTI_VAR_LENGTH:
+            le_app_evt_rec_put16(p_attr_req->data.read_multiple_req.num_handles);
+            le_app_evt_rec_put(p_attr_req->data.read_multiple_req.p_handle_stream,
+                               p_attr_req->data.read_multiple_req.num_handles * sizeof(uint16_t));
+            break;
+
+        case GATT_REQ_WRITE:
+        case GATT_CMD_WRITE:
+        case GATT_REQ_PREPARE_WRITE:
+            le_app_evt_rec_put16(p_attr_req->data.write_req.handle);
+            le_app_evt_rec_put16(p_attr_req->data.write_req.offset);
+            le_app_evt_rec_put16(p_attr_req->data.write_req.val_len);
+            le_app_evt_rec_put(p_attr_req->data.write_req.p_val, p_attr_req->data.write_req.val_len);
+            break;
+
+        case GATT_REQ_EXECUTE_WRITE:
+            le_app_evt_rec_put8(p_attr_req->data.exec_write_req.exec_write);
+            break;
+
+        case GATT_REQ_MTU:
+            le_app_evt_rec_put16(p_attr_req->data.remote_mtu);
+            break;
+
+        default:
+            break;
+        }
+        break;
+
+    case GATT_GET_RESPONSE_BUFFER_EVT:
+        kind = LE_APP_EVT_REC_GATT_BUFFER_REQUEST;
+        le_app_evt_rec_put16(p_event_data->buffer_request.len_requested);
+        break;
+
+    default:
+        break;
+    }
+
+    le_app_evt_rec_end((uint8_t)event, kind, now_ms, cycles);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_evt_rec_dump
+ ***************************************************************************************************
+ * Summary:
+ *   This function prints the trace as lines of hex bytes starting with '@', file header first.
+ *   tools/le_app_evt_rec.py turns the console output back into the binary trace. Recording
+ *   continues while the trace is printed.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_evt_rec_dump(void)
+{
+    uint8_t file_hdr[LE_APP_EVT_REC_FILE_HDR_SIZE] = { 'L', 'E', 'E', 'R', LE_APP_EVT_REC_VERSION };
+    uint32_t used = atomic_load_explicit(&le_app_evt_rec_used, memory_order_acquire);
+
+    le_app_evt_rec_put_le(&file_hdr[8], SystemCoreClock, sizeof(uint32_t));
+    le_app_evt_rec_put_le(&file_hdr[12], atomic_load_explicit(&le_app_evt_rec_dropped, memory_order_relaxed),
+                          sizeof(uint32_t));
+
+    printf("Event record, %lu bytes\r\n@", (unsigned long)used);
+    for (uint32_t i = 0; i < LE_APP_EVT_REC_FILE_HDR_SIZE; i++)
+    {
+        printf("%02x", file_hdr[i]);
+    }
+    printf("\r\n");
+
+    /* Bytes below used are complete and never written again */
+    for (uint32_t i = 0; i < used; i++)
+    {
+        if (0 == (i % LE_APP_EVT_REC_DUMP_LINE))
+        {
+            printf("@");
+        }
+        printf("%02x", le_app_evt_rec_buf[i]);
+        if (((LE_APP_EVT_REC_DUMP_LINE - 1) == (i % LE_APP_EVT_REC_DUMP_LINE)) || ((used - 1) == i))
+        {
+            printf("\r\n");
+        }
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_evt_rec_begin
+ ***************************************************************************************************
+ * Summary:
+ *   This function starts a record after the last complete one, leaving room for its header.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_evt_rec_begin(void)
+{
+    le_app_evt_rec_pos = atomic_load_explicit(&le_app_evt_rec_used, memory_order_relaxed) +
+                         LE_APP_EVT_REC_HDR_SIZE;
+    le_app_evt_rec_overflow = (LE_APP_EVT_REC_BUF_SIZE < le_app_evt_rec_pos);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_evt_rec_end
+ ***************************************************************************************************
+ * Summary:
+ *   This function writes the header of the record and publishes it, or counts the event as
+ *   dropped if the record did not fit.
+ *
+ * Parameters:
+ *   uint8_t event                       : Management or GATT event code
+ *   le_app_evt_rec_kind_t kind          : Payload layout
+ *   uint32_t time_ms                    : RTOS time when the event was delivered
+ *   uint32_t cycles                     : DWT->CYCCNT when the event was delivered
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_evt_rec_end(uint8_t event, le_app_evt_rec_kind_t kind, uint32_t time_ms, uint32_t cycles)
+{
+    uint32_t used = atomic_load_explicit(&le_app_evt_rec_used, memory_order_relaxed);
+    uint8_t *p_hdr = &le_app_evt_rec_buf[used];
+
+    if (le_app_evt_rec_overflow)
+    {
+        atomic_fetch_add_explicit(&le_app_evt_rec_dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    p_hdr[0] = event;
+    p_hdr[1] = (uint8_t)kind;
+    le_app_evt_rec_put_le(&p_hdr[2], le_app_evt_rec_pos - used - LE_APP_EVT_REC_HDR_SIZE, sizeof(uint16_t));
+    le_app_evt_rec_put_le(&p_hdr[4], time_ms, sizeof(uint32_t));
+    le_app_evt_rec_put_le(&p_hdr[8], cycles, sizeof(uint32_t));
+
+    atomic_store_explicit(&le_app_evt_rec_used, le_app_evt_rec_pos, memory_order_release);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_evt_rec_put
+ ***************************************************************************************************
+ * Summary:
+ *   This function appends bytes to the record being written, or marks it as not fitting.
+ *
+ * Parameters:
+ *   const void *p_data                  : Bytes to append
+ *   uint32_t len                        : Number of bytes
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_evt_rec_put(const void *p_data, uint32_t len)
+{
+    if (le_app_evt_rec_overflow || ((LE_APP_EVT_REC_BUF_SIZE - le_app_evt_rec_pos) < len))
+    {
+        le_app_evt_rec_overflow = true;
+        return;
+    }
+
+    memcpy(&le_app_evt_rec_buf[le_app_evt_rec_pos], p_data, len);
+    le_app_evt_rec_pos += len;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_evt_rec_put8
+ ***************************************************************************************************
+ * Summary:
+ *   This function appends one byte to the record being written.
+ *
+ * Parameters:
+ *   uint8_t value                       : Byte to append
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_evt_rec_put8(uint8_t value)
+{
+    le_app_evt_rec_put(&value, sizeof(value));
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_evt_rec_put16
+ ***************************************************************************************************
+ * Summary:
+ *   This function appends a 16-bit little endian value to the record being written.
+ *
+ * Parameters:
+ *   uint16_t value                      : Value to append
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_evt_rec_put16(uint16_t value)
+{
+    uint8_t bytes[sizeof(uint16_t)];
+
+    le_app_evt_rec_put_le(bytes, value, sizeof(bytes));
+    le_app_evt_rec_put(bytes, sizeof(bytes));
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_evt_rec_put32
+ ***************************************************************************************************
+ * Summary:
+ *   This function appends a 32-bit little endian value to the record being written.
+ *
+ * Parameters:
+ *   uint32_t value                      : Value to append
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_evt_rec_put32(uint32_t value)
+{
+    uint8_t bytes[sizeof(uint32_t)];
+
+    le_app_evt_rec_put_le(bytes, value, sizeof(bytes));
+    le_app_evt_rec_put(bytes, sizeof(bytes));
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_evt_rec_put_le
+ ***************************************************************************************************
+ * Summary:
+ *   This function stores a value as little endian bytes.
+ *
+ * Parameters:
+ *   uint8_t *p_dst                      : Destination
+ *   uint32_t value                      : Value to store
+ *   uint32_t len                        : Number of bytes, at most 4
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_evt_rec_put_le(uint8_t *p_dst, uint32_t value, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++)
+    {
+        p_dst[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+#endif /* LE_APP_EVT_REC_ENABLE */
+
+/* [] END OF FILE */
@@ -0,0 +1,185 @@
+/*******************************************************************************
+* File Name: le_app_evt_rec.h
+*
+* Description:
+*   This file contains the event recorder, which captures the management and GATT
+*   events delivered by the Bluetooth stack into a compact binary trace.
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef LE_APP_EVT_REC_H_
+#define LE_APP_EVT_REC_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include <stdint.h>
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Set to 1 to record the stack events. Set from the Makefile with EVENT_RECORD=1 */
+#ifndef LE_APP_EVT_REC_ENABLE
+#define LE_APP_EVT_REC_ENABLE           (0)
+#endif
+
+/* Size of the trace buffer. Recording stops when it is full, so the trace always starts
+ * with the first event after boot */
+#define LE_APP_EVT_REC_BUF_SIZE         (8192u)
+
+/* Trace layout version in the file header. Bump it when a record layout changes */
+#define LE_APP_EVT_REC_VERSION          (1u)
+
+/* Bytes of the file header: "LEER", version, three reserved bytes, SystemCoreClock and the
+ * number of dropped events, both 32-bit little endian */
+#define LE_APP_EVT_REC_FILE_HDR_SIZE    (16u)
+
+/* Bytes of the record header: event, kind, payload length (16-bit), RTOS time in ms and
+ * DWT->CYCCNT (32-bit), all little endian */
+#define LE_APP_EVT_REC_HDR_SIZE         (12u)
+
+#if LE_APP_EVT_REC_ENABLE
+/* Record an event at the start of le_app_management_callback() and le_app_gatt_event_callback() */
+#define LE_APP_EVT_REC_MGMT(event, p_event_data)    le_app_evt_rec_mgmt((event), (p_event_data))
+#define LE_APP_EVT_REC_GATT(event, p_event_data)    le_app_evt_rec_gatt((event), (p_event_data))
+#else
+#define LE_APP_EVT_REC_MGMT(event, p_event_data)
+#define LE_APP_EVT_REC_GATT(event, p_event_data)
+#endif
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+/* Payload layout of a record. Only the fields the application handles are kept; the layouts
+ * are listed in tools/le_app_evt_rec.py */
+typedef enum
+{
+    LE_APP_EVT_REC_MGMT_OTHER,              /* No payload */
+    LE_APP_EVT_REC_MGMT_ENABLED,
+    LE_APP_EVT_REC_MGMT_ADVERT_STATE,
+    LE_APP_EVT_REC_MGMT_CONN_PARAM_UPDATE,
+    LE_APP_EVT_REC_MGMT_PHY_UPDATE,
+    LE_APP_EVT_REC_MGMT_DATA_LENGTH_UPDATE,
+    LE_APP_EVT_REC_MGMT_PAIRING_COMPLETE,
+    LE_APP_EVT_REC_MGMT_ENCRYPTION_STATUS,
+    LE_APP_EVT_REC_MGMT_BD_ADDR,            /* Security and IO capabilities requests */
+    LE_APP_EVT_REC_MGMT_KEYS,               /* Key events; no payload, keys are not recorded */
+    LE_APP_EVT_REC_GATT_OTHER,              /* No payload */
+    LE_APP_EVT_REC_GATT_CONNECTION_STATUS,
+    LE_APP_EVT_REC_GATT_ATTRIBUTE_REQUEST,
+    LE_APP_EVT_REC_GATT_BUFFER_REQUEST,
+    LE_APP_EVT_REC_KIND_COUNT
+} le_app_evt_rec_kind_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+#if LE_APP_EVT_REC_ENABLE
+#include "wiced_bt_dev.h"
+#include "wiced_bt_gatt.h"
+
+/**************************************************************************************************
+* Function Name: le_app_evt_rec_init
+***************************************************************************************************
+* Summary:
+*   This function starts the DWT cycle counter and empties the trace. It must be called before
+*   the Bluetooth stack is initialized.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_evt_rec_init(void);
+
+/**************************************************************************************************
+* Function Name: le_app_evt_rec_mgmt
+***************************************************************************************************
+* Summary:
+*   This function records a management event. It is called through LE_APP_EVT_REC_MGMT() from
+*   the Bluetooth stack context.
+*
+* Parameters:
+*   wiced_bt_management_evt_t event             : Management event
+*   wiced_bt_management_evt_data_t *p_event_data: Event data
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_evt_rec_mgmt(wiced_bt_management_evt_t event, const wiced_bt_management_evt_data_t *p_event_data);
+
+/**************************************************************************************************
+* Function Name: le_app_evt_rec_gatt
+***************************************************************************************************
+* Summary:
+*   This function records a GATT event, with the value bytes of attribute requests. It is called
+*   through LE_APP_EVT_REC_GATT() from the Bluetooth stack context.
+*
+* Parameters:
+*   wiced_bt_gatt_evt_t event                   : GATT event
+*   wiced_bt_gatt_event_data_t *p_event_data    : Event data
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_evt_rec_gatt(wiced_bt_gatt_evt_t event, const wiced_bt_gatt_event_data_t *p_event_data);
+
+/**************************************************************************************************
+* Function Name: le_app_evt_rec_dump
+***************************************************************************************************
+* Summary:
+*   This function prints the trace as lines of hex bytes starting with '@', file header first.
+*   tools/le_app_evt_rec.py turns the console output back into the binary trace. Recording
+*   continues while the trace is printed.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_evt_rec_dump(void);
+
+#endif /* LE_APP_EVT_REC_ENABLE */
+
+#endif /* LE_APP_EVT_REC_H_ */
+
+/* [] END OF FILE */
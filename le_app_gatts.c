@@ -44,34 +44,316 @@
 #include "le_app_gatts.h"
 #include "le_app_event_handler.h"
 #include "le_app_utils.h"
+#include "le_app_notify.h"
+#include "le_app_latency.h"
+#include "le_app_caching.h"
+#include "le_app_metrics.h"
+#include "le_app_trace.h"
+#include "le_app_evt_rec.h"
+#include <stdlib.h>
+
+/*******************************************************************************
+ *        Macro Definitions
+ *******************************************************************************/
+/* Size of the opcode dispatch table; GATT_CMD_WRITE is the largest opcode handled */
+#define LE_APP_GATT_OPCODE_TABLE_SIZE   (GATT_CMD_WRITE + 1)
+
+/*******************************************************************************
+ *        Structures and Enumerations
+ *******************************************************************************/
+/* Handler of one attribute request opcode */
+typedef wiced_bt_gatt_status_t (*le_app_opcode_handler_t)(wiced_bt_gatt_attribute_request_t *p_attr_req);
+
+/* Callbacks registered for an attribute handle */
+typedef struct
+{
+    le_app_gatts_read_cb_t p_read_cb;
+    le_app_gatts_check_cb_t p_check_cb;
+    le_app_gatts_write_cb_t p_write_cb;
+} le_app_handle_cbs_t;
 
 /*******************************************************************************
  *        Variable Definitions
  *******************************************************************************/
+/* Number of entries in the handle indexes below: the highest handle with a value or a CCCD
+ * plus one. Zero until le_app_gatts_init() has run */
+static uint16_t le_app_handle_count;
+
+/* Handle to lookup table entry map, over app_gatt_db_ext_attr_tbl and the tables of the added
+ * services. NULL marks a handle that is not in any table */
+static gatt_db_lookup_table_t **le_app_handle_index;
+
+/* Bitmap of the handles that are client characteristic configuration descriptors.
+ * Their values are kept per connection instead of in the lookup table */
+static uint32_t *le_app_cccd_handles;
+
+/* Value read by a client that has not written a CCCD yet */
+static uint16_t le_app_cccd_default_value = 0;
+
+/* Callbacks registered with le_app_gatts_register_handle(), and a handle to slot map.
+ * Each map entry holds the slot index plus one, so that zero marks a handle without callbacks */
+static le_app_handle_cbs_t le_app_handle_cbs[LE_APP_GATTS_MAX_HANDLE_CBS];
+static uint8_t *le_app_handle_cb_index;
+static uint32_t le_app_handle_cb_count;
+
 /*******************************************************************************
  *        Function Prototypes
  *******************************************************************************/
+static wiced_bt_gatt_status_t le_app_gatts_db_init(const le_app_gatts_service_t *const *pp_services);
 static wiced_bt_gatt_status_t le_app_server_handler(wiced_bt_gatt_attribute_request_t *p_attr_req);
-static wiced_bt_gatt_status_t le_app_read_handler(uint16_t conn_id,
-                                                  wiced_bt_gatt_opcode_t opcode,
-                                                  wiced_bt_gatt_read_t *p_read_req,
-                                                  uint16_t len_req);
-static wiced_bt_gatt_status_t le_app_write_handler(uint16_t conn_id,
-                                                   wiced_bt_gatt_opcode_t opcode,
-                                                   wiced_bt_gatt_write_req_t *p_write_req,
-                                                   uint16_t len_req);
-static wiced_bt_gatt_status_t le_app_gatt_req_read_by_type_handler(uint16_t conn_id,
-                                                                   wiced_bt_gatt_opcode_t opcode,
-                                                                   wiced_bt_gatt_read_by_type_t *p_read_req,
-                                                                   uint16_t len_requested);
-static wiced_bt_gatt_status_t le_app_set_value(uint16_t attr_handle,
+static wiced_bt_gatt_status_t le_app_read_handler(wiced_bt_gatt_attribute_request_t *p_attr_req);
+static wiced_bt_gatt_status_t le_app_write_handler(wiced_bt_gatt_attribute_request_t *p_attr_req);
+static wiced_bt_gatt_status_t le_app_gatt_req_read_by_type_handler(wiced_bt_gatt_attribute_request_t *p_attr_req);
+static wiced_bt_gatt_status_t le_app_read_multiple_handler(wiced_bt_gatt_attribute_request_t *p_attr_req);
+static wiced_bt_gatt_status_t le_app_prepare_write_handler(wiced_bt_gatt_attribute_request_t *p_attr_req);
+static wiced_bt_gatt_status_t le_app_execute_write_handler(wiced_bt_gatt_attribute_request_t *p_attr_req);
+static wiced_bt_gatt_status_t le_app_mtu_handler(wiced_bt_gatt_attribute_request_t *p_attr_req);
+static wiced_bt_gatt_status_t le_app_notif_handler(wiced_bt_gatt_attribute_request_t *p_attr_req);
+static wiced_bt_gatt_status_t le_app_conf_handler(wiced_bt_gatt_attribute_request_t *p_attr_req);
+static wiced_bt_gatt_status_t le_app_check_value(uint16_t conn_id,
+                                                 uint16_t attr_handle,
+                                                 uint16_t offset,
+                                                 const uint8_t *p_val,
+                                                 uint16_t len);
+static wiced_bt_gatt_status_t le_app_set_value(uint16_t conn_id,
+                                               uint16_t attr_handle,
+                                               uint16_t offset,
                                                uint8_t *p_val,
                                                uint16_t len);
 static gatt_db_lookup_table_t *le_app_find_by_handle(uint16_t handle);
+static le_app_handle_cbs_t *le_app_find_cbs(uint16_t handle);
+static wiced_bool_t le_app_is_cccd(uint16_t handle);
+
+/*******************************************************************************
+ *        Constant Definitions
+ *******************************************************************************/
+/* Attribute request handlers indexed by opcode. Opcodes without a handler are rejected */
+static const le_app_opcode_handler_t le_app_opcode_handlers[LE_APP_GATT_OPCODE_TABLE_SIZE] =
+{
+    [GATT_REQ_MTU]                      = le_app_mtu_handler,
+    [GATT_REQ_READ_BY_TYPE]             = le_app_gatt_req_read_by_type_handler,
+    [GATT_REQ_READ]                     = le_app_read_handler,
+    [GATT_REQ_READ_BLOB]                = le_app_read_handler,
+    [GATT_REQ_READ_MULTI]               = le_app_read_multiple_handler,
+    [GATT_REQ_WRITE]                    = le_app_write_handler,
+    [GATT_REQ_PREPARE_WRITE]            = le_app_prepare_write_handler,
+    [GATT_REQ_EXECUTE_WRITE]            = le_app_execute_write_handler,
+    [GATT_HANDLE_VALUE_NOTIF]           = le_app_notif_handler,
+    [GATT_HANDLE_VALUE_CONF]            = le_app_conf_handler,
+    [GATT_REQ_READ_MULTI_VAR_LENGTH]    = le_app_read_multiple_handler,
+    [GATT_CMD_WRITE]                    = le_app_write_handler,
+};
+
 /*******************************************************************************
  *        Function Definitions
  *******************************************************************************/
 
+/**************************************************************************************************
+ * Function Name: le_app_gatts_init
+ ***************************************************************************************************
+ * Summary:
+ *   This function registers the GATT database with the stack: the generated database followed
+ *   by the services of the modules that are built in. It then builds the handle index used by
+ *   the GATT server handlers to look up attributes in constant time. The index is sized from
+ *   the highest handle and allocated once.
+ *
+ * Parameters:
+ *   const le_app_gatts_service_t *const *pp_services : NULL terminated list of services to add
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_NO_RESOURCES if the database or the index cannot be
+ *                          allocated, the status of wiced_bt_gatt_db_init() otherwise
+ *
+ **************************************************************************************************/
+wiced_bt_gatt_status_t le_app_gatts_init(const le_app_gatts_service_t *const *pp_services)
+{
+    wiced_bt_uuid_t cccd_uuid = {.len = LEN_UUID_16, .uu.uuid16 = GATT_UUID_CHAR_CLIENT_CONFIG};
+    wiced_bt_gatt_status_t gatt_status;
+    const le_app_gatts_service_t *p_service;
+    uint16_t handle = 1;
+    uint16_t max_handle = 0;
+    uint8_t *p_mem;
+
+    if (NULL != le_app_handle_index)
+    {
+        return WICED_BT_GATT_SUCCESS;
+    }
+
+    gatt_status = le_app_gatts_db_init(pp_services);
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+        return gatt_status;
+    }
+
+    /* Size the index for the highest value handle and the highest CCCD */
+    for (uint16_t i = 0; i < app_gatt_db_ext_attr_tbl_size; i++)
+    {
+        if (max_handle < app_gatt_db_ext_attr_tbl[i].handle)
+        {
+            max_handle = app_gatt_db_ext_attr_tbl[i].handle;
+        }
+    }
+    for (uint32_t s = 0; NULL != (p_service = pp_services[s]); s++)
+    {
+        for (uint16_t i = 0; i < p_service->num_attrs; i++)
+        {
+            if (max_handle < p_service->p_attrs[i].handle)
+            {
+                max_handle = p_service->p_attrs[i].handle;
+            }
+        }
+    }
+    while (0 != (handle = wiced_bt_gatt_find_handle_by_type(handle, LE_APP_GATTS_LAST_HANDLE, &cccd_uuid)))
+    {
+        if (max_handle < handle)
+        {
+            max_handle = handle;
+        }
+        if (LE_APP_GATTS_LAST_HANDLE == handle++)
+        {
+            break;
+        }
+    }
+
+    /* One zeroed block holds the CCCD bitmap, the lookup table index and the callback index,
+     * in order of alignment */
+    p_mem = calloc(1, (((max_handle / 32u) + 1u) * sizeof(uint32_t)) +
+                      ((max_handle + 1u) * (sizeof(gatt_db_lookup_table_t *) + sizeof(uint8_t))));
+    if (NULL == p_mem)
+    {
+        printf("Failed to allocate the index of %u GATT handles\r\n", max_handle + 1u);
+        return WICED_BT_GATT_NO_RESOURCES;
+    }
+    le_app_cccd_handles = (uint32_t *)p_mem;
+    le_app_handle_index = (gatt_db_lookup_table_t **)&le_app_cccd_handles[(max_handle / 32u) + 1u];
+    le_app_handle_cb_index = (uint8_t *)&le_app_handle_index[max_handle + 1u];
+
+    for (uint16_t i = 0; i < app_gatt_db_ext_attr_tbl_size; i++)
+    {
+        le_app_handle_index[app_gatt_db_ext_attr_tbl[i].handle] = &app_gatt_db_ext_attr_tbl[i];
+    }
+    for (uint32_t s = 0; NULL != (p_service = pp_services[s]); s++)
+    {
+        for (uint16_t i = 0; i < p_service->num_attrs; i++)
+        {
+            le_app_handle_index[p_service->p_attrs[i].handle] = &p_service->p_attrs[i];
+        }
+    }
+
+    /* Mark every CCCD in the database */
+    handle = 1;
+    while (0 != (handle = wiced_bt_gatt_find_handle_by_type(handle, max_handle, &cccd_uuid)))
+    {
+        le_app_cccd_handles[handle / 32] |= (1u << (handle % 32));
+        if (max_handle == handle++)
+        {
+            break;
+        }
+    }
+
+    /* Published last: the lookups below treat a zero count as an empty index */
+    le_app_handle_count = max_handle + 1u;
+
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_gatts_db_init
+ ***************************************************************************************************
+ * Summary:
+ *   This function registers the generated GATT database with the stack. If services are added,
+ *   the database and the services are copied into one allocated block, which the stack keeps.
+ *
+ * Parameters:
+ *   const le_app_gatts_service_t *const *pp_services : NULL terminated list of services to add
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_NO_RESOURCES if the database cannot be allocated,
+ *                          the status of wiced_bt_gatt_db_init() otherwise
+ *
+ **************************************************************************************************/
+static wiced_bt_gatt_status_t le_app_gatts_db_init(const le_app_gatts_service_t *const *pp_services)
+{
+    const uint8_t *p_db = gatt_database;
+    uint32_t db_len = gatt_database_len;
+    uint8_t *p_combined;
+
+    for (uint32_t s = 0; NULL != pp_services[s]; s++)
+    {
+        db_len += pp_services[s]->db_len;
+    }
+
+    if (gatt_database_len != db_len)
+    {
+        p_combined = malloc(db_len);
+        if (NULL == p_combined)
+        {
+            printf("Failed to allocate a GATT database of %u bytes\r\n", (unsigned int)db_len);
+            return WICED_BT_GATT_NO_RESOURCES;
+        }
+
+        memcpy(p_combined, gatt_database, gatt_database_len);
+        db_len = gatt_database_len;
+        for (uint32_t s = 0; NULL != pp_services[s]; s++)
+        {
+            memcpy(&p_combined[db_len], pp_services[s]->p_db, pp_services[s]->db_len);
+            db_len += pp_services[s]->db_len;
+        }
+        p_db = p_combined;
+    }
+
+    /* The stack computes the Database Hash over every service into the characteristic value */
+    return wiced_bt_gatt_db_init(p_db, db_len, app_gatt_database_hash);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_gatts_register_handle
+ ***************************************************************************************************
+ * Summary:
+ *   This function attaches read and write callbacks to an attribute handle. The callbacks are
+ *   found through a handle index, so the cost of a request does not grow with registrations.
+ *
+ * Parameters:
+ *   uint16_t attr_handle                : Handle in app_gatt_db_ext_attr_tbl
+ *   le_app_gatts_read_cb_t p_read_cb    : Called before the value is read, may be NULL
+ *   le_app_gatts_check_cb_t p_check_cb  : Called to validate a value before it is written, may be NULL
+ *   le_app_gatts_write_cb_t p_write_cb  : Called before the value is stored, may be NULL
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_INVALID_HANDLE if the handle is not in the lookup table,
+ *                          WICED_BT_GATT_NO_RESOURCES if LE_APP_GATTS_MAX_HANDLE_CBS are in use
+ *
+ **************************************************************************************************/
+wiced_bt_gatt_status_t le_app_gatts_register_handle(uint16_t attr_handle,
+                                                    le_app_gatts_read_cb_t p_read_cb,
+                                                    le_app_gatts_check_cb_t p_check_cb,
+                                                    le_app_gatts_write_cb_t p_write_cb)
+{
+    le_app_handle_cbs_t *p_cbs;
+
+    if (NULL == le_app_find_by_handle(attr_handle))
+    {
+        return WICED_BT_GATT_INVALID_HANDLE;
+    }
+
+    p_cbs = le_app_find_cbs(attr_handle);
+    if (NULL == p_cbs)
+    {
+        if (LE_APP_GATTS_MAX_HANDLE_CBS <= le_app_handle_cb_count)
+        {
+            return WICED_BT_GATT_NO_RESOURCES;
+        }
+        p_cbs = &le_app_handle_cbs[le_app_handle_cb_count++];
+        le_app_handle_cb_index[attr_handle] = (uint8_t)le_app_handle_cb_count;
+    }
+
+    p_cbs->p_read_cb = p_read_cb;
+    p_cbs->p_check_cb = p_check_cb;
+    p_cbs->p_write_cb = p_write_cb;
+
+    return WICED_BT_GATT_SUCCESS;
+}
+
 /**************************************************************************************************
  * Function Name: le_app_gatt_event_callback
  ***************************************************************************************************
@@ -89,8 +371,12 @@ static gatt_db_lookup_table_t *le_app_find_by_handle(uint16_t handle);
 wiced_bt_gatt_status_t le_app_gatt_event_callback(wiced_bt_gatt_evt_t event,
                                                   wiced_bt_gatt_event_data_t *p_event_data)
 {
+    LE_APP_LATENCY_START(latency_start);
     wiced_bt_gatt_status_t gatt_status = WICED_BT_GATT_ERROR;
     wiced_bt_gatt_attribute_request_t *p_attr_req = &p_event_data->attribute_request;
+
+    LE_APP_EVT_REC_GATT(event, p_event_data);
+
     /* Call the appropriate callback function based on the GATT event type, and pass the relevant event
      * parameters to the callback function */
     switch (event)
@@ -107,7 +393,9 @@ wiced_bt_gatt_status_t le_app_gatt_event_callback(wiced_bt_gatt_evt_t event,
         p_event_data->buffer_request.buffer.p_app_rsp_buffer =
             app_alloc_buffer(p_event_data->buffer_request.len_requested);
         p_event_data->buffer_request.buffer.p_app_ctxt = (void *)app_free_buffer;
-        gatt_status = WICED_BT_GATT_SUCCESS;
+        /* The pool fails cleanly when exhausted; report it to the stack */
+        gatt_status = (NULL != p_event_data->buffer_request.buffer.p_app_rsp_buffer) ?
+                      WICED_BT_GATT_SUCCESS : WICED_BT_GATT_INSUF_RESOURCE;
         break;
 
     case GATT_APP_BUFFER_TRANSMITTED_EVT: /* GATT buffer transmitted event,  check \ref wiced_bt_gatt_buffer_transmitted_t*/
@@ -118,15 +406,36 @@ wiced_bt_gatt_status_t le_app_gatt_event_callback(wiced_bt_gatt_evt_t event,
         if (pfn_free)
             pfn_free(p_event_data->buffer_xmitted.p_app_data);
 
+        /* Any returned block, including a response buffer, may unblock a notification queue */
+        le_app_notify_resume();
+
         gatt_status = WICED_BT_GATT_SUCCESS;
     }
     break;
 
+    case GATT_CONGESTION_EVT:
+        /* The stack refuses notifications while a link is congested */
+        if (!p_event_data->congestion.congested)
+        {
+            le_app_notify_resume();
+        }
+        gatt_status = WICED_BT_GATT_SUCCESS;
+        break;
+
     default:
         gatt_status = WICED_BT_GATT_SUCCESS;
         break;
     }
 
+    if (GATT_ATTRIBUTE_REQUEST_EVT == event)
+    {
+        LE_APP_LATENCY_RECORD(LE_APP_LATENCY_GATT_OPCODE, p_attr_req->opcode, latency_start);
+    }
+    else
+    {
+        LE_APP_LATENCY_RECORD(LE_APP_LATENCY_GATT_EVT, event, latency_start);
+    }
+
     return gatt_status;
 }
 
@@ -134,7 +443,8 @@ wiced_bt_gatt_status_t le_app_gatt_event_callback(wiced_bt_gatt_evt_t event,
  * Function Name: le_app_server_handler
  ***************************************************************************************************
  * Summary:
- *   This function handles GATT server events from the BT stack.
+ *   This function handles GATT server events from the BT stack by dispatching them through
+ *   le_app_opcode_handlers.
  *
  * Parameters:
  *  p_attr_req     Pointer to LE GATT connection status
@@ -145,46 +455,106 @@ wiced_bt_gatt_status_t le_app_gatt_event_callback(wiced_bt_gatt_evt_t event,
  **************************************************************************************************/
 static wiced_bt_gatt_status_t le_app_server_handler(wiced_bt_gatt_attribute_request_t *p_attr_req)
 {
-    wiced_bt_gatt_status_t gatt_status = WICED_BT_GATT_ERROR;
-    switch (p_attr_req->opcode)
-    {
-    case GATT_REQ_READ:
-    case GATT_REQ_READ_BLOB:
-        /* Attribute read request */
-        gatt_status = le_app_read_handler(p_attr_req->conn_id, p_attr_req->opcode,
-                                          &p_attr_req->data.read_req,
-                                          p_attr_req->len_requested);
-        break;
-    case GATT_REQ_WRITE:
-    case GATT_CMD_WRITE:
-        /* Attribute write request */
-        gatt_status = le_app_write_handler(p_attr_req->conn_id, p_attr_req->opcode,
-                                           &p_attr_req->data.write_req,
-                                           p_attr_req->len_requested);
+    le_app_conn_t *p_conn = le_app_conn_find(p_attr_req->conn_id);
+    le_app_opcode_handler_t p_handler = NULL;
+    wiced_bt_gatt_status_t gatt_status;
 
-        break;
-    case GATT_REQ_MTU:
-        gatt_status = wiced_bt_gatt_server_send_mtu_rsp(p_attr_req->conn_id,
-                                                        p_attr_req->data.remote_mtu,
-                                                        CY_BT_MTU_SIZE);
-        break;
-    case GATT_HANDLE_VALUE_NOTIF:
-        gatt_status = WICED_BT_GATT_SUCCESS;
-        printf("Notification send complete\r\n");
-        break;
-    case GATT_REQ_READ_BY_TYPE:
-        gatt_status = le_app_gatt_req_read_by_type_handler(p_attr_req->conn_id, p_attr_req->opcode,
-                                                           &p_attr_req->data.read_by_type, p_attr_req->len_requested);
-        break;
+    if (NULL != p_conn)
+    {
+        p_conn->gatt_requests++;
+    }
+    LE_APP_METRICS_INC_GATT_REQUEST(p_attr_req->opcode);
 
-    default:
-        printf("ERROR: Unhandled GATT Connection Request case: %d\r\n", p_attr_req->opcode);
-        break;
+    /* Hold back requests from a client whose attribute cache may be stale */
+    gatt_status = le_app_caching_check_request(p_attr_req);
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+        return gatt_status;
+    }
+
+    if (LE_APP_GATT_OPCODE_TABLE_SIZE > p_attr_req->opcode)
+    {
+        p_handler = le_app_opcode_handlers[p_attr_req->opcode];
+    }
+
+    if (NULL == p_handler)
+    {
+        LE_APP_LOG("ERROR: Unhandled GATT Connection Request case: %d\r\n", p_attr_req->opcode);
+        return WICED_BT_GATT_ERROR;
+    }
+
+    return p_handler(p_attr_req);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_mtu_handler
+ ***************************************************************************************************
+ * Summary:
+ *   This function handles the Exchange MTU Request. The agreed MTU is the smaller of the client
+ *   MTU and the local maximum.
+ *
+ * Parameters:
+ *  @param p_attr_req    Pointer to the attribute request
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: See possible status codes in wiced_bt_gatt_status_e in wiced_bt_gatt.h
+ *
+ **************************************************************************************************/
+static wiced_bt_gatt_status_t le_app_mtu_handler(wiced_bt_gatt_attribute_request_t *p_attr_req)
+{
+    wiced_bt_gatt_status_t gatt_status;
+
+    gatt_status = wiced_bt_gatt_server_send_mtu_rsp(p_attr_req->conn_id,
+                                                    p_attr_req->data.remote_mtu,
+                                                    LE_APP_GATT_MAX_MTU_SIZE);
+    if (WICED_BT_GATT_SUCCESS == gatt_status)
+    {
+        le_app_set_conn_mtu(p_attr_req->conn_id,
+                            MIN(p_attr_req->data.remote_mtu, LE_APP_GATT_MAX_MTU_SIZE));
     }
 
     return gatt_status;
 }
 
+/**************************************************************************************************
+ * Function Name: le_app_notif_handler
+ ***************************************************************************************************
+ * Summary:
+ *   This function handles the completion of a notification.
+ *
+ * Parameters:
+ *  @param p_attr_req    Pointer to the attribute request
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_SUCCESS
+ *
+ **************************************************************************************************/
+static wiced_bt_gatt_status_t le_app_notif_handler(wiced_bt_gatt_attribute_request_t *p_attr_req)
+{
+    LE_APP_LOG("Notification send complete\r\n");
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_conf_handler
+ ***************************************************************************************************
+ * Summary:
+ *   This function handles the Handle Value Confirmation of an indication, after which the next
+ *   indication of the connection may be sent.
+ *
+ * Parameters:
+ *  @param p_attr_req    Pointer to the attribute request
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_SUCCESS
+ *
+ **************************************************************************************************/
+static wiced_bt_gatt_status_t le_app_conf_handler(wiced_bt_gatt_attribute_request_t *p_attr_req)
+{
+    le_app_notify_confirmed(p_attr_req->conn_id);
+    return WICED_BT_GATT_SUCCESS;
+}
+
 /**************************************************************************************************
  * Function Name: le_app_write_handler
  ***************************************************************************************************
@@ -192,29 +562,30 @@ static wiced_bt_gatt_status_t le_app_server_handler(wiced_bt_gatt_attribute_requ
  *   This function handles Write Requests received from the client device
  *
  * Parameters:
- *  @param conn_id       Connection ID
- *  @param opcode        LE GATT request type opcode
- *  @param p_write_req   Pointer to LE GATT write request
- *  @param len_req       length of data requested
+ *  @param p_attr_req    Pointer to the attribute request
  *
  * Return:
  *  wiced_bt_gatt_status_t: See possible status codes in wiced_bt_gatt_status_e in wiced_bt_gatt.h
  *
  **************************************************************************************************/
-static wiced_bt_gatt_status_t le_app_write_handler(uint16_t conn_id,
-                                                   wiced_bt_gatt_opcode_t opcode,
-                                                   wiced_bt_gatt_write_req_t *p_write_req,
-                                                   uint16_t len_req)
+static wiced_bt_gatt_status_t le_app_write_handler(wiced_bt_gatt_attribute_request_t *p_attr_req)
 {
+    uint16_t conn_id = p_attr_req->conn_id;
+    wiced_bt_gatt_opcode_t opcode = p_attr_req->opcode;
+    wiced_bt_gatt_write_req_t *p_write_req = &p_attr_req->data.write_req;
     wiced_bt_gatt_status_t gatt_status = WICED_BT_GATT_INVALID_HANDLE;
 
+    LE_APP_TRACE_WRITE(conn_id, p_write_req->handle);
+
     /* Attempt to perform the Write Request */
-    gatt_status = le_app_set_value(p_write_req->handle,
+    gatt_status = le_app_set_value(conn_id,
+                                   p_write_req->handle,
+                                   0,
                                    p_write_req->p_val,
                                    p_write_req->val_len);
     if (WICED_BT_GATT_SUCCESS != gatt_status)
     {
-        printf("WARNING: GATT set attr status 0x%x\r\n", gatt_status);
+        LE_APP_LOG("WARNING: GATT set attr status 0x%x\r\n", gatt_status);
     }
     else
     {
@@ -224,6 +595,165 @@ static wiced_bt_gatt_status_t le_app_write_handler(uint16_t conn_id,
     return (gatt_status);
 }
 
+/**************************************************************************************************
+ * Function Name: le_app_prepare_write_handler
+ ***************************************************************************************************
+ * Summary:
+ *   This function queues a Prepare Write Request in the arena of the connection. The value is
+ *   only checked against the attribute when the queue is executed.
+ *
+ * Parameters:
+ *  @param p_attr_req    Pointer to the attribute request
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: See possible status codes in wiced_bt_gatt_status_e in wiced_bt_gatt.h
+ *
+ **************************************************************************************************/
+static wiced_bt_gatt_status_t le_app_prepare_write_handler(wiced_bt_gatt_attribute_request_t *p_attr_req)
+{
+    uint16_t conn_id = p_attr_req->conn_id;
+    wiced_bt_gatt_opcode_t opcode = p_attr_req->opcode;
+    wiced_bt_gatt_write_req_t *p_write_req = &p_attr_req->data.write_req;
+    le_app_conn_t *p_conn = le_app_conn_find(conn_id);
+    le_app_prep_write_t *p_prep;
+
+    if (NULL == p_conn)
+    {
+        le_app_gatts_send_error_rsp(conn_id, opcode, p_write_req->handle, WICED_BT_GATT_ERR_UNLIKELY);
+        return WICED_BT_GATT_ERR_UNLIKELY;
+    }
+
+    if (!le_app_is_cccd(p_write_req->handle) && (NULL == le_app_find_by_handle(p_write_req->handle)))
+    {
+        le_app_gatts_send_error_rsp(conn_id, opcode, p_write_req->handle, WICED_BT_GATT_INVALID_HANDLE);
+        return WICED_BT_GATT_INVALID_HANDLE;
+    }
+
+    if ((LE_APP_PREP_WRITE_MAX_ENTRIES <= p_conn->prep_write_count) ||
+        ((LE_APP_PREP_WRITE_ARENA_SIZE - p_conn->prep_write_used) < p_write_req->val_len))
+    {
+        le_app_gatts_send_error_rsp(conn_id, opcode, p_write_req->handle, WICED_BT_GATT_PREPARE_Q_FULL);
+        return WICED_BT_GATT_PREPARE_Q_FULL;
+    }
+
+    p_prep = &p_conn->prep_writes[p_conn->prep_write_count++];
+    p_prep->handle = p_write_req->handle;
+    p_prep->offset = p_write_req->offset;
+    p_prep->len = p_write_req->val_len;
+    p_prep->arena_offset = p_conn->prep_write_used;
+    memcpy(&p_conn->prep_write_arena[p_prep->arena_offset], p_write_req->p_val, p_prep->len);
+    p_conn->prep_write_used += p_prep->len;
+
+    LE_APP_TRACE_WRITE(conn_id, p_prep->handle);
+
+    /* Echo the request; the arena copy stays valid until the queue is executed or cancelled */
+    return wiced_bt_gatt_server_send_prepare_write_rsp(conn_id, opcode, p_prep->handle, p_prep->offset, p_prep->len,
+                                                       &p_conn->prep_write_arena[p_prep->arena_offset], NULL);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_execute_write_handler
+ ***************************************************************************************************
+ * Summary:
+ *   This function executes or cancels the prepared write queue of the connection. Consecutive
+ *   requests for the same handle form one write; their values are contiguous in the arena. Every
+ *   write is checked, by the check callback of its attribute if there is one, before any is
+ *   applied, so the queue is committed atomically.
+ *
+ * Parameters:
+ *  @param p_attr_req    Pointer to the attribute request
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: See possible status codes in wiced_bt_gatt_status_e in wiced_bt_gatt.h
+ *
+ **************************************************************************************************/
+static wiced_bt_gatt_status_t le_app_execute_write_handler(wiced_bt_gatt_attribute_request_t *p_attr_req)
+{
+    uint16_t conn_id = p_attr_req->conn_id;
+    wiced_bt_gatt_opcode_t opcode = p_attr_req->opcode;
+    wiced_bt_gatt_exec_flag_t exec_write = p_attr_req->data.exec_write_req.exec_write;
+    wiced_bt_gatt_status_t gatt_status = WICED_BT_GATT_SUCCESS;
+    le_app_conn_t *p_conn = le_app_conn_find(conn_id);
+    le_app_prep_write_t *p_prep;
+    uint16_t error_handle = 0;
+    uint32_t first;
+    uint32_t last;
+    uint16_t len;
+
+    if (NULL == p_conn)
+    {
+        le_app_gatts_send_error_rsp(conn_id, opcode, 0, WICED_BT_GATT_ERR_UNLIKELY);
+        return WICED_BT_GATT_ERR_UNLIKELY;
+    }
+
+    if (GATT_PREPARE_WRITE_EXEC == exec_write)
+    {
+        /* First pass: check every write without applying any */
+        for (first = 0; (first < p_conn->prep_write_count) && (WICED_BT_GATT_SUCCESS == gatt_status); first = last)
+        {
+            p_prep = &p_conn->prep_writes[first];
+            len = p_prep->len;
+            for (last = first + 1; (last < p_conn->prep_write_count) &&
+                                   (p_conn->prep_writes[last].handle == p_prep->handle); last++)
+            {
+                /* Segments of one write must follow each other without gaps */
+                if (p_conn->prep_writes[last].offset != (p_prep->offset + len))
+                {
+                    gatt_status = WICED_BT_GATT_INVALID_OFFSET;
+                    break;
+                }
+                len += p_conn->prep_writes[last].len;
+            }
+
+            /* A handle may only be written once per queue */
+            for (uint32_t i = 0; (WICED_BT_GATT_SUCCESS == gatt_status) && (i < first); i++)
+            {
+                if (p_conn->prep_writes[i].handle == p_prep->handle)
+                {
+                    gatt_status = WICED_BT_GATT_ERR_UNLIKELY;
+                }
+            }
+
+            if (WICED_BT_GATT_SUCCESS == gatt_status)
+            {
+                gatt_status = le_app_check_value(conn_id, p_prep->handle, p_prep->offset,
+                                                 &p_conn->prep_write_arena[p_prep->arena_offset], len);
+            }
+            error_handle = p_prep->handle;
+        }
+
+        /* Second pass: apply the writes. Every value passed the checks of its attribute, so a
+         * failure here is a runtime error of a write callback and is reported to the client */
+        for (first = 0; (first < p_conn->prep_write_count) && (WICED_BT_GATT_SUCCESS == gatt_status); first = last)
+        {
+            p_prep = &p_conn->prep_writes[first];
+            len = p_prep->len;
+            for (last = first + 1; (last < p_conn->prep_write_count) &&
+                                   (p_conn->prep_writes[last].handle == p_prep->handle); last++)
+            {
+                len += p_conn->prep_writes[last].len;
+            }
+
+            gatt_status = le_app_set_value(conn_id, p_prep->handle, p_prep->offset,
+                                           &p_conn->prep_write_arena[p_prep->arena_offset], len);
+            error_handle = p_prep->handle;
+        }
+    }
+
+    /* The queue is released whether it was executed, cancelled or rejected */
+    p_conn->prep_write_count = 0;
+    p_conn->prep_write_used = 0;
+
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+        LE_APP_LOG("WARNING: Execute write failed on handle 0x%x status 0x%x\r\n", error_handle, gatt_status);
+        le_app_gatts_send_error_rsp(conn_id, opcode, error_handle, gatt_status);
+        return gatt_status;
+    }
+
+    return wiced_bt_gatt_server_send_execute_write_rsp(conn_id, opcode);
+}
+
 /**************************************************************************************************
  * Function Name: le_app_read_handler
  ***************************************************************************************************
@@ -231,42 +761,41 @@ static wiced_bt_gatt_status_t le_app_write_handler(uint16_t conn_id,
  *   This function handles Read Requests received from the client device
  *
  * Parameters:
- * @param conn_id       Connection ID
- * @param opcode        LE GATT request type opcode
- * @param p_read_req    Pointer to read request containing the handle to read
- * @param len_req       length of data requested
+ * @param p_attr_req    Pointer to the attribute request
  *
  * Return:
  *  wiced_bt_gatt_status_t: See possible status codes in wiced_bt_gatt_status_e in wiced_bt_gatt.h
  *
  **************************************************************************************************/
-static wiced_bt_gatt_status_t le_app_read_handler(uint16_t conn_id,
-                                                  wiced_bt_gatt_opcode_t opcode,
-                                                  wiced_bt_gatt_read_t *p_read_req,
-                                                  uint16_t len_req)
+static wiced_bt_gatt_status_t le_app_read_handler(wiced_bt_gatt_attribute_request_t *p_attr_req)
 {
+    uint16_t conn_id = p_attr_req->conn_id;
+    wiced_bt_gatt_opcode_t opcode = p_attr_req->opcode;
+    wiced_bt_gatt_read_t *p_read_req = &p_attr_req->data.read_req;
+    uint16_t len_req = p_attr_req->len_requested;
 
-    gatt_db_lookup_table_t *puAttribute;
-    int attr_len_to_copy;
+    wiced_bt_gatt_status_t gatt_status;
+    uint16_t attr_len_to_copy;
+    uint8_t *p_val;
     uint8_t *from;
     int to_send;
 
-    puAttribute = le_app_find_by_handle(p_read_req->handle);
-    if (NULL == puAttribute)
+    gatt_status = le_app_get_value(conn_id, p_read_req->handle, p_read_req->offset, &p_val,
+                                   &attr_len_to_copy);
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
     {
-        wiced_bt_gatt_server_send_error_rsp(conn_id, opcode, p_read_req->handle,
-                                            WICED_BT_GATT_INVALID_HANDLE);
-        return WICED_BT_GATT_INVALID_HANDLE;
+        le_app_gatts_send_error_rsp(conn_id, opcode, p_read_req->handle, gatt_status);
+        return gatt_status;
     }
-    attr_len_to_copy = puAttribute->cur_len;
-    if (p_read_req->offset >= puAttribute->cur_len)
+    if (p_read_req->offset >= attr_len_to_copy)
     {
-        wiced_bt_gatt_server_send_error_rsp(conn_id, opcode, p_read_req->handle,
-                                            WICED_BT_GATT_INVALID_OFFSET);
+        le_app_gatts_send_error_rsp(conn_id, opcode, p_read_req->handle,
+                                    WICED_BT_GATT_INVALID_OFFSET);
         return WICED_BT_GATT_INVALID_OFFSET;
     }
-    to_send = MIN(len_req, attr_len_to_copy - p_read_req->offset);
-    from = ((uint8_t *)puAttribute->p_data) + p_read_req->offset;
+    /* A read response carries at most MTU - 1 bytes of the value */
+    to_send = MIN(MIN(len_req, le_app_get_conn_mtu(conn_id) - 1), attr_len_to_copy - p_read_req->offset);
+    from = p_val + p_read_req->offset;
     return wiced_bt_gatt_server_send_read_handle_rsp(conn_id, opcode, to_send, from, NULL); /* No need for context, as buff not allocated */
     ;
 }
@@ -278,29 +807,33 @@ static wiced_bt_gatt_status_t le_app_read_handler(uint16_t conn_id,
  * Function Description:
  * @brief  Process read-by-type request from peer device
  *
- * @param conn_id       Connection ID
- * @param opcode        LE GATT request type opcode
- * @param p_read_req    Pointer to read request containing the handle to read
- * @param len_requested length of data requested
+ * @param p_attr_req    Pointer to the attribute request
  *
  * @return wiced_bt_gatt_status_t  LE GATT status
  */
-static wiced_bt_gatt_status_t le_app_gatt_req_read_by_type_handler(uint16_t conn_id,
-                                                                   wiced_bt_gatt_opcode_t opcode,
-                                                                   wiced_bt_gatt_read_by_type_t *p_read_req,
-                                                                   uint16_t len_requested)
+static wiced_bt_gatt_status_t le_app_gatt_req_read_by_type_handler(wiced_bt_gatt_attribute_request_t *p_attr_req)
 {
-    gatt_db_lookup_table_t *puAttribute;
+    uint16_t conn_id = p_attr_req->conn_id;
+    wiced_bt_gatt_opcode_t opcode = p_attr_req->opcode;
+    wiced_bt_gatt_read_by_type_t *p_read_req = &p_attr_req->data.read_by_type;
+    uint16_t len_requested = p_attr_req->len_requested;
+    wiced_bt_gatt_status_t gatt_status;
     uint16_t last_handle = 0;
     uint16_t attr_handle = p_read_req->s_handle;
-    uint8_t *p_rsp = app_alloc_buffer(len_requested);
+    uint16_t attr_len;
+    uint8_t *p_val;
+    uint8_t *p_rsp;
     uint8_t pair_len = 0;
     int used_len = 0;
 
+    /* The attribute data list of a read-by-type response is at most MTU - 2 bytes */
+    len_requested = MIN(len_requested, le_app_get_conn_mtu(conn_id) - 2);
+    p_rsp = app_alloc_buffer(len_requested);
+
     if (NULL == p_rsp)
     {
-        printf("No memory, len_requested: %d!!\r\n", len_requested);
-        wiced_bt_gatt_server_send_error_rsp(conn_id, opcode, attr_handle, WICED_BT_GATT_INSUF_RESOURCE);
+        LE_APP_LOG("No memory, len_requested: %d!!\r\n", len_requested);
+        le_app_gatts_send_error_rsp(conn_id, opcode, attr_handle, WICED_BT_GATT_INSUF_RESOURCE);
         return WICED_BT_GATT_INSUF_RESOURCE;
     }
 
@@ -313,18 +846,25 @@ static wiced_bt_gatt_status_t le_app_gatt_req_read_by_type_handler(uint16_t conn
         if (0 == attr_handle)
             break;
 
-        if (NULL == (puAttribute = le_app_find_by_handle(attr_handle)))
+        gatt_status = le_app_get_value(conn_id, attr_handle, 0, &p_val, &attr_len);
+        if (WICED_BT_GATT_INVALID_HANDLE == gatt_status)
         {
-            printf("found type but no attribute for %d \r\n", last_handle);
-            wiced_bt_gatt_server_send_error_rsp(conn_id, opcode, p_read_req->s_handle,
-                                                WICED_BT_GATT_ERR_UNLIKELY);
+            LE_APP_LOG("found type but no attribute for %d \r\n", last_handle);
+            le_app_gatts_send_error_rsp(conn_id, opcode, p_read_req->s_handle,
+                                        WICED_BT_GATT_ERR_UNLIKELY);
             app_free_buffer(p_rsp);
             return WICED_BT_GATT_INVALID_HANDLE;
         }
+        if (WICED_BT_GATT_SUCCESS != gatt_status)
+        {
+            le_app_gatts_send_error_rsp(conn_id, opcode, attr_handle, gatt_status);
+            app_free_buffer(p_rsp);
+            return gatt_status;
+        }
 
         {
             int filled = wiced_bt_gatt_put_read_by_type_rsp_in_stream(p_rsp + used_len, len_requested - used_len, &pair_len,
-                                                                      attr_handle, puAttribute->cur_len, puAttribute->p_data);
+                                                                      attr_handle, attr_len, p_val);
             if (0 == filled)
             {
                 break;
@@ -338,9 +878,9 @@ static wiced_bt_gatt_status_t le_app_gatt_req_read_by_type_handler(uint16_t conn
 
     if (0 == used_len)
     {
-        printf("attr not found  start_handle: 0x%04x  end_handle: 0x%04x  Type: 0x%04x\r\n",
-               p_read_req->s_handle, p_read_req->e_handle, p_read_req->uuid.uu.uuid16);
-        wiced_bt_gatt_server_send_error_rsp(conn_id, opcode, p_read_req->s_handle, WICED_BT_GATT_INVALID_HANDLE);
+        LE_APP_LOG("attr not found  start_handle: 0x%04x  end_handle: 0x%04x  Type: 0x%04x\r\n",
+                   p_read_req->s_handle, p_read_req->e_handle, p_read_req->uuid.uu.uuid16);
+        le_app_gatts_send_error_rsp(conn_id, opcode, p_read_req->s_handle, WICED_BT_GATT_INVALID_HANDLE);
         app_free_buffer(p_rsp);
         return WICED_BT_GATT_INVALID_HANDLE;
     }
@@ -349,6 +889,133 @@ static wiced_bt_gatt_status_t le_app_gatt_req_read_by_type_handler(uint16_t conn
     return wiced_bt_gatt_server_send_read_by_type_rsp(conn_id, opcode, pair_len, used_len, p_rsp, (void *)app_free_buffer);
 }
 
+/**************************************************************************************************
+ * Function Name: le_app_read_multiple_handler
+ ***************************************************************************************************
+ * Summary:
+ *   This function handles Read Multiple and Read Multiple Variable Length requests. The values of
+ *   all requested handles are packed into a single pooled response buffer.
+ *
+ * Parameters:
+ * @param p_attr_req    Pointer to the attribute request
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: See possible status codes in wiced_bt_gatt_status_e in wiced_bt_gatt.h
+ *
+ **************************************************************************************************/
+static wiced_bt_gatt_status_t le_app_read_multiple_handler(wiced_bt_gatt_attribute_request_t *p_attr_req)
+{
+    uint16_t conn_id = p_attr_req->conn_id;
+    wiced_bt_gatt_opcode_t opcode = p_attr_req->opcode;
+    wiced_bt_gatt_read_multiple_req_t *p_read_req = &p_attr_req->data.read_multiple_req;
+    uint16_t len_requested = p_attr_req->len_requested;
+    wiced_bt_gatt_status_t gatt_status;
+    uint16_t handle = wiced_bt_gatt_get_handle_from_stream(p_read_req->p_handle_stream, 0);
+    uint16_t attr_len;
+    uint8_t *p_val;
+    uint8_t *p_rsp;
+    int used_len = 0;
+
+    /* The set of values in a read multiple response is at most MTU - 1 bytes */
+    len_requested = MIN(len_requested, le_app_get_conn_mtu(conn_id) - 1);
+    p_rsp = app_alloc_buffer(len_requested);
+
+    if (NULL == p_rsp)
+    {
+        LE_APP_LOG("No memory, len_requested: %d!!\r\n", len_requested);
+        le_app_gatts_send_error_rsp(conn_id, opcode, handle, WICED_BT_GATT_INSUF_RESOURCE);
+        return WICED_BT_GATT_INSUF_RESOURCE;
+    }
+
+    for (int i = 0; i < p_read_req->num_handles; i++)
+    {
+        handle = wiced_bt_gatt_get_handle_from_stream(p_read_req->p_handle_stream, i);
+
+        /* The whole request fails on the first handle that cannot be read */
+        gatt_status = le_app_get_value(conn_id, handle, 0, &p_val, &attr_len);
+        if (WICED_BT_GATT_SUCCESS != gatt_status)
+        {
+            le_app_gatts_send_error_rsp(conn_id, opcode, handle, gatt_status);
+            app_free_buffer(p_rsp);
+            return gatt_status;
+        }
+
+        {
+            int filled = wiced_bt_gatt_put_read_multi_rsp_in_stream(opcode, p_rsp + used_len, len_requested - used_len,
+                                                                    handle, attr_len, p_val);
+            /* The response is full; the remaining values are truncated as the specification allows */
+            if (0 == filled)
+            {
+                break;
+            }
+            used_len += filled;
+        }
+    }
+
+    return wiced_bt_gatt_server_send_read_multiple_rsp(conn_id, opcode, used_len, p_rsp, (void *)app_free_buffer);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_check_value
+ ***************************************************************************************************
+ * Summary:
+ *   This function checks whether a value can be written to an attribute at the given offset,
+ *   using the check callback registered for the attribute if there is one. Nothing is written.
+ *
+ * Parameters:
+ * @param conn_id      Connection ID of the writer
+ * @param attr_handle  GATT attribute handle
+ * @param offset       Offset of the value within the attribute
+ * @param p_val        Value to check
+ * @param len          length of the value
+ *
+ * Return:
+ *   wiced_bt_gatt_status_t: WICED_BT_GATT_SUCCESS if le_app_set_value() would accept the value
+ *
+ **************************************************************************************************/
+static wiced_bt_gatt_status_t le_app_check_value(uint16_t conn_id,
+                                                 uint16_t attr_handle,
+                                                 uint16_t offset,
+                                                 const uint8_t *p_val,
+                                                 uint16_t len)
+{
+    gatt_db_lookup_table_t *puAttribute;
+    le_app_handle_cbs_t *p_cbs;
+
+    /* A CCCD is always written as a whole */
+    if (le_app_is_cccd(attr_handle))
+    {
+        return ((0 == offset) && (sizeof(uint16_t) == len)) ? WICED_BT_GATT_SUCCESS : WICED_BT_GATT_INVALID_ATTR_LEN;
+    }
+
+    puAttribute = le_app_find_by_handle(attr_handle);
+    if (NULL == puAttribute)
+    {
+        /* The write operation is not performed for handles outside the lookup table */
+        return WICED_BT_GATT_WRITE_NOT_PERMIT;
+    }
+
+    p_cbs = le_app_find_cbs(attr_handle);
+    if ((NULL != p_cbs) && (NULL != p_cbs->p_check_cb))
+    {
+        return p_cbs->p_check_cb(conn_id, attr_handle, offset, p_val, len);
+    }
+
+    /* The value may extend the current value but not leave a hole in it */
+    if (offset > puAttribute->cur_len)
+    {
+        return WICED_BT_GATT_INVALID_OFFSET;
+    }
+
+    /* Check if the buffer has space to store the data */
+    if (puAttribute->max_len < (offset + len))
+    {
+        return WICED_BT_GATT_INVALID_ATTR_LEN;
+    }
+
+    return WICED_BT_GATT_SUCCESS;
+}
+
 /**************************************************************************************************
  * Function Name: le_app_set_value
  ***************************************************************************************************
@@ -358,7 +1025,10 @@ static wiced_bt_gatt_status_t le_app_gatt_req_read_by_type_handler(uint16_t conn
  *   whose starting address is passed as one of the function parameters
  *
  * Parameters:
+ * @param conn_id      Connection ID of the writer
  * @param attr_handle  GATT attribute handle
+ * @param offset       Offset of the value within the attribute; the attribute is truncated
+ *                     after the written value
  * @param p_val        Pointer to LE GATT write request value
  * @param len          length of GATT write request
  *
@@ -367,83 +1037,192 @@ static wiced_bt_gatt_status_t le_app_gatt_req_read_by_type_handler(uint16_t conn
  *   wiced_bt_gatt_status_t: See possible status codes in wiced_bt_gatt_status_e in wiced_bt_gatt.h
  *
  **************************************************************************************************/
-static wiced_bt_gatt_status_t le_app_set_value(uint16_t attr_handle,
+static wiced_bt_gatt_status_t le_app_set_value(uint16_t conn_id,
+                                               uint16_t attr_handle,
+                                               uint16_t offset,
                                                uint8_t *p_val,
                                                uint16_t len)
 {
-    wiced_bool_t isHandleInTable = WICED_FALSE;
-    wiced_bool_t validLen = WICED_FALSE;
-    wiced_bt_gatt_status_t gatt_status = WICED_BT_GATT_INVALID_HANDLE;
-    /* Check for a matching handle entry */
-    for (int i = 0; i < app_gatt_db_ext_attr_tbl_size; i++)
+    gatt_db_lookup_table_t *puAttribute;
+    le_app_handle_cbs_t *p_cbs;
+    wiced_bt_gatt_status_t gatt_status;
+    le_app_conn_t *p_conn = le_app_conn_find(conn_id);
+
+    gatt_status = le_app_check_value(conn_id, attr_handle, offset, p_val, len);
+    if (WICED_BT_GATT_WRITE_NOT_PERMIT == gatt_status)
+    {
+        /* TODO: Add code to write value for handles not contained within generated lookup table.
+         * This is a custom logic that depends on the application, and is not used in the
+         * current application. */
+        LE_APP_LOG("Write Request to Invalid Handle: 0x%x\r\n", attr_handle);
+        return gatt_status;
+    }
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+        /* Value to write does not meet size constraints */
+        return gatt_status;
+    }
+
+    /* CCCD values are kept per connection */
+    if (le_app_is_cccd(attr_handle))
     {
-        if (app_gatt_db_ext_attr_tbl[i].handle == attr_handle)
+        if (NULL == p_conn)
         {
-            /* Detected a matching handle in external lookup table */
-            isHandleInTable = WICED_TRUE;
+            return WICED_BT_GATT_ERR_UNLIKELY;
+        }
+        return le_app_conn_set_cccd(p_conn, attr_handle, (uint16_t)(p_val[0] | (p_val[1] << 8)));
+    }
 
-            /* Check if the buffer has space to store the data */
-            validLen = (app_gatt_db_ext_attr_tbl[i].max_len >= len);
+    /* Run the action registered for this attribute. It may reject the value, or take
+     * it over, in which case the value is not stored */
+    p_cbs = le_app_find_cbs(attr_handle);
+    if ((NULL != p_cbs) && (NULL != p_cbs->p_write_cb))
+    {
+        gatt_status = p_cbs->p_write_cb(conn_id, attr_handle, offset, p_val, len);
+    }
 
-            if (validLen)
-            {
-                /* Value fits within the supplied buffer; copy over the value */
-                app_gatt_db_ext_attr_tbl[i].cur_len = len;
-                memcpy(app_gatt_db_ext_attr_tbl[i].p_data, p_val, len);
-                gatt_status = WICED_BT_GATT_SUCCESS;
+    if (WICED_BT_GATT_SUCCESS == gatt_status)
+    {
+        /* A check callback may accept values that the write callback does not store,
+         * so the length is checked again before the value is copied */
+        puAttribute = le_app_find_by_handle(attr_handle);
+        if (puAttribute->max_len < (offset + len))
+        {
+            return WICED_BT_GATT_INVALID_ATTR_LEN;
+        }
+        puAttribute->cur_len = offset + len;
+        memcpy(puAttribute->p_data + offset, p_val, len);
+    }
+    else if (WICED_BT_GATT_HANDLED == gatt_status)
+    {
+        gatt_status = WICED_BT_GATT_SUCCESS;
+    }
+    else
+    {
+        return gatt_status;
+    }
 
-                /* Add code for any action required when this attribute is written.
-                 * In this case, we update the IAS led based on the IAS alert
-                 * level characteristic value */
+    if (NULL != p_conn)
+    {
+        p_conn->writes++;
+    }
 
-                switch (attr_handle)
-                {
-                case HDLC_IAS_ALERT_LEVEL_VALUE:
-                    printf("Alert Level = %d\r\n", app_ias_alert_level[0]);
-#ifdef CYBSP_USER_LED1
-                    ias_led_update();
-#endif
-                    break;
+    return gatt_status;
+}
 
-                /* The application is not going to change its GATT DB,
-                 * So this case is not handled */
-                case HDLD_GATT_SERVICE_CHANGED_CLIENT_CHAR_CONFIG:
-                    break;
-                }
-            }
-            else
-            {
-                /* Value to write does not meet size constraints */
-                gatt_status = WICED_BT_GATT_INVALID_ATTR_LEN;
-            }
-            break;
+/**************************************************************************************************
+ * Function Name: le_app_get_value
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns the value of an attribute as seen by the given connection. CCCD values
+ *   come from the connection context, all other values from the GATT lookup table.
+ *
+ * Parameters:
+ * @param conn_id      Connection ID of the reader
+ * @param attr_handle  GATT attribute handle
+ * @param offset       Offset of the read, zero unless the client reads a long value
+ * @param pp_val       Receives a pointer to the value, valid until the attribute is written
+ * @param p_len        Receives the current length of the value
+ *
+ * Return:
+ *   wiced_bt_gatt_status_t: WICED_BT_GATT_INVALID_HANDLE if the handle is unknown,
+ *                           WICED_BT_GATT_SUCCESS otherwise
+ *
+ **************************************************************************************************/
+wiced_bt_gatt_status_t le_app_get_value(uint16_t conn_id,
+                                        uint16_t attr_handle,
+                                        uint16_t offset,
+                                        uint8_t **pp_val,
+                                        uint16_t *p_len)
+{
+    gatt_db_lookup_table_t *puAttribute;
+    le_app_handle_cbs_t *p_cbs;
+    wiced_bt_gatt_status_t gatt_status;
+    le_app_conn_t *p_conn;
+    le_app_conn_cccd_t *p_cccd = NULL;
+
+    /* CCCD values are kept per connection */
+    if (le_app_is_cccd(attr_handle))
+    {
+        p_conn = le_app_conn_find(conn_id);
+        if (NULL != p_conn)
+        {
+            p_cccd = le_app_conn_get_cccd(p_conn, attr_handle);
         }
+        *pp_val = (uint8_t *)((NULL != p_cccd) ? &p_cccd->value : &le_app_cccd_default_value);
+        *p_len = sizeof(uint16_t);
+        return WICED_BT_GATT_SUCCESS;
     }
 
-    if (!isHandleInTable)
+    puAttribute = le_app_find_by_handle(attr_handle);
+    if (NULL == puAttribute)
     {
-        /* TODO: Add code to read value for handles not contained within generated lookup table.
-         * This is a custom logic that depends on the application, and is not used in the
-         * current application. If the value for the current handle is successfully written in the
-         * below code snippet, then set the result using:
-         * res = WICED_BT_GATT_SUCCESS; */
-        switch (attr_handle)
+        return WICED_BT_GATT_INVALID_HANDLE;
+    }
+
+    /* Let the owner of the attribute refresh or refuse the value */
+    p_cbs = le_app_find_cbs(attr_handle);
+    if ((NULL != p_cbs) && (NULL != p_cbs->p_read_cb))
+    {
+        gatt_status = p_cbs->p_read_cb(conn_id, attr_handle, offset);
+        if (WICED_BT_GATT_SUCCESS != gatt_status)
         {
-        default:
-            /* The write operation was not performed for the indicated handle */
-            printf("Write Request to Invalid Handle: 0x%x\r\n", attr_handle);
-            gatt_status = WICED_BT_GATT_WRITE_NOT_PERMIT;
-            break;
+            return gatt_status;
         }
     }
 
-    return gatt_status;
+    *pp_val = puAttribute->p_data;
+    *p_len = puAttribute->cur_len;
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_gatts_send_error_rsp
+ ***************************************************************************************************
+ * Summary:
+ *   This function sends an Error Response to an attribute request and counts it in the metrics.
+ *
+ * Parameters:
+ * @param conn_id      Connection ID of the requester
+ * @param opcode       Opcode of the failed request
+ * @param attr_handle  Handle that caused the error, or 0
+ * @param status       Error code
+ *
+ * Return:
+ *   wiced_bt_gatt_status_t: Result of wiced_bt_gatt_server_send_error_rsp()
+ *
+ **************************************************************************************************/
+wiced_bt_gatt_status_t le_app_gatts_send_error_rsp(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                                                   uint16_t attr_handle, wiced_bt_gatt_status_t status)
+{
+    LE_APP_METRICS_INC(error_responses);
+    return wiced_bt_gatt_server_send_error_rsp(conn_id, opcode, attr_handle, status);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_get_cccd_handle
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns the client characteristic configuration descriptor of a
+ *   characteristic. The generated database places the CCCD directly after the value.
+ *
+ * Parameters:
+ * @param attr_handle  Handle of the characteristic value
+ *
+ * Return:
+ *   uint16_t: Handle of the CCCD, or 0 if the characteristic cannot notify or indicate
+ *
+ **************************************************************************************************/
+uint16_t le_app_get_cccd_handle(uint16_t attr_handle)
+{
+    return le_app_is_cccd(attr_handle + 1) ? (uint16_t)(attr_handle + 1) : 0;
 }
 
 /*******************************************************************************
  * Function Name : le_app_find_by_handle
  * *****************************************************************************
- * Summary : @brief  Find attribute description by handle
+ * Summary : @brief  Find attribute description by handle using the handle index
+ *           built in le_app_gatts_init()
  *
  * @param handle    handle to look up
  *
@@ -451,16 +1230,50 @@ static wiced_bt_gatt_status_t le_app_set_value(uint16_t attr_handle,
  ******************************************************************************/
 static gatt_db_lookup_table_t *le_app_find_by_handle(uint16_t handle)
 {
-    int i;
+    if (le_app_handle_count <= handle)
+    {
+        return NULL;
+    }
+
+    return le_app_handle_index[handle];
+}
+/*******************************************************************************
+ * Function Name : le_app_find_cbs
+ * *****************************************************************************
+ * Summary : @brief  Find the callbacks registered for a handle
+ *
+ * @param handle    handle to look up
+ *
+ * @return le_app_handle_cbs_t   pointer to the callbacks, or NULL if none are registered
+ ******************************************************************************/
+static le_app_handle_cbs_t *le_app_find_cbs(uint16_t handle)
+{
+    if ((le_app_handle_count <= handle) || (0 == le_app_handle_cb_index[handle]))
+    {
+        return NULL;
+    }
 
-    for (i = 0; i < app_gatt_db_ext_attr_tbl_size; i++)
+    return &le_app_handle_cbs[le_app_handle_cb_index[handle] - 1];
+}
+
+/*******************************************************************************
+ * Function Name : le_app_is_cccd
+ * *****************************************************************************
+ * Summary : @brief  Check whether a handle is a client characteristic configuration
+ *           descriptor
+ *
+ * @param handle    handle to check
+ *
+ * @return wiced_bool_t   WICED_TRUE if the handle is a CCCD
+ ******************************************************************************/
+static wiced_bool_t le_app_is_cccd(uint16_t handle)
+{
+    if (le_app_handle_count <= handle)
     {
-        if (handle == app_gatt_db_ext_attr_tbl[i].handle)
-        {
-            return (&app_gatt_db_ext_attr_tbl[i]);
-        }
+        return WICED_FALSE;
     }
 
-    return NULL;
+    return (0 != (le_app_cccd_handles[handle / 32] & (1u << (handle % 32)))) ? WICED_TRUE : WICED_FALSE;
 }
+
 /* [] END OF FILE */
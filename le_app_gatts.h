@@ -38,10 +38,15 @@
 * of such system or application assumes all risk of such use and in doing
 * so agrees to indemnify Cypress against all liability.
 *******************************************************************************/
+
+#ifndef LE_APP_GATTS_H_
+#define LE_APP_GATTS_H_
+
 /*******************************************************************************
 *        Header Files
 *******************************************************************************/
 #include "wiced_bt_gatt.h"
+#include "GeneratedSource/cycfg_gatt_db.h"
 #include "stdint.h"
 #include "cy_retarget_io.h"
 /*******************************************************************************
@@ -49,6 +54,50 @@
 *******************************************************************************/
 #define CY_BT_MTU_SIZE          (23)
 
+/* Largest ATT MTU offered to the client in the MTU exchange. Must not exceed
+ * the MTU size configured in design.cybt */
+#define LE_APP_GATT_MAX_MTU_SIZE    (512)
+
+/* Number of attribute handles that can have callbacks registered */
+#define LE_APP_GATTS_MAX_HANDLE_CBS (8u)
+
+/* Highest attribute handle */
+#define LE_APP_GATTS_LAST_HANDLE    (0xFFFFu)
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+/* Called before the value of an attribute is read, to refresh it. Any status other than
+ * WICED_BT_GATT_SUCCESS is returned to the client instead of the value. The offset is non-zero
+ * for the Read Blob requests of a long read, which should see the value read at offset zero */
+typedef wiced_bt_gatt_status_t (*le_app_gatts_read_cb_t)(uint16_t conn_id, uint16_t attr_handle,
+                                                         uint16_t offset);
+
+/* Called with a value before it is written, and for every write of a prepared write queue before
+ * any of them is applied. It must not act on the value. Any status other than WICED_BT_GATT_SUCCESS
+ * rejects the write. When registered, it replaces the length checks against the lookup table */
+typedef wiced_bt_gatt_status_t (*le_app_gatts_check_cb_t)(uint16_t conn_id, uint16_t attr_handle,
+                                                          uint16_t offset, const uint8_t *p_val,
+                                                          uint16_t len);
+
+/* Called with a value that passed the checks, before it is stored. WICED_BT_GATT_SUCCESS stores
+ * the value, WICED_BT_GATT_HANDLED accepts it without storing it, and any other status rejects
+ * the write. Values are validated by the check callback; a rejection here cannot undo the earlier
+ * writes of an executed prepared write queue */
+typedef wiced_bt_gatt_status_t (*le_app_gatts_write_cb_t)(uint16_t conn_id, uint16_t attr_handle,
+                                                          uint16_t offset, const uint8_t *p_val,
+                                                          uint16_t len);
+
+/* A service that a module adds to the generated GATT database when it is built in. Its handles
+ * must follow those of design.cybt and of the services before it in the list */
+typedef struct
+{
+    const uint8_t *p_db;                /* Attributes, built with the macros of wiced_bt_gatt.h */
+    uint16_t db_len;                    /* Size of p_db in bytes */
+    gatt_db_lookup_table_t *p_attrs;    /* Values read and written through the GATT server */
+    uint16_t num_attrs;                 /* Number of entries in p_attrs */
+} le_app_gatts_service_t;
+
 /*******************************************************************************
 *        External Variable Declarations
 *******************************************************************************/
@@ -74,4 +123,108 @@
 wiced_bt_gatt_status_t le_app_gatt_event_callback(wiced_bt_gatt_evt_t event,
                                                          wiced_bt_gatt_event_data_t *p_event_data);
 
+/**************************************************************************************************
+* Function Name: le_app_gatts_init
+***************************************************************************************************
+* Summary:
+*   This function registers the GATT database with the stack: the generated database followed
+*   by the services of the modules that are built in. It then builds the handle index used by
+*   the GATT server handlers to look up attributes in constant time.
+*
+* Parameters:
+*   const le_app_gatts_service_t *const *pp_services : NULL terminated list of services to add
+*
+* Return:
+*  wiced_bt_gatt_status_t: WICED_BT_GATT_NO_RESOURCES if the database or the index cannot be
+*                          allocated, the status of wiced_bt_gatt_db_init() otherwise
+*
+**************************************************************************************************/
+wiced_bt_gatt_status_t le_app_gatts_init(const le_app_gatts_service_t *const *pp_services);
+
+/**************************************************************************************************
+* Function Name: le_app_gatts_register_handle
+***************************************************************************************************
+* Summary:
+*   This function attaches read and write callbacks to an attribute handle, so that a module can
+*   act on its attributes without changes to the GATT server.
+*
+* Parameters:
+*   uint16_t attr_handle                : Handle in app_gatt_db_ext_attr_tbl
+*   le_app_gatts_read_cb_t p_read_cb    : Called before the value is read, may be NULL
+*   le_app_gatts_check_cb_t p_check_cb  : Called to validate a value before it is written, may be NULL
+*   le_app_gatts_write_cb_t p_write_cb  : Called before the value is stored, may be NULL
+*
+* Return:
+*  wiced_bt_gatt_status_t: WICED_BT_GATT_INVALID_HANDLE if the handle is not in the lookup table,
+*                          WICED_BT_GATT_NO_RESOURCES if LE_APP_GATTS_MAX_HANDLE_CBS are in use
+*
+**************************************************************************************************/
+wiced_bt_gatt_status_t le_app_gatts_register_handle(uint16_t attr_handle,
+                                                    le_app_gatts_read_cb_t p_read_cb,
+                                                    le_app_gatts_check_cb_t p_check_cb,
+                                                    le_app_gatts_write_cb_t p_write_cb);
+
+/**************************************************************************************************
+* Function Name: le_app_get_value
+***************************************************************************************************
+* Summary:
+*   This function returns the value of an attribute as seen by the given connection. CCCD values
+*   come from the connection context, all other values from the GATT lookup table.
+*
+* Parameters:
+*   uint16_t conn_id            : Connection ID of the reader
+*   uint16_t attr_handle        : GATT attribute handle
+*   uint16_t offset             : Offset of the read, zero unless the client reads a long value
+*   uint8_t **pp_val            : Receives a pointer to the value, valid until the attribute is written
+*   uint16_t *p_len             : Receives the current length of the value
+*
+* Return:
+*  wiced_bt_gatt_status_t: WICED_BT_GATT_INVALID_HANDLE if the handle is unknown,
+*                          WICED_BT_GATT_SUCCESS otherwise
+*
+**************************************************************************************************/
+wiced_bt_gatt_status_t le_app_get_value(uint16_t conn_id,
+                                        uint16_t attr_handle,
+                                        uint16_t offset,
+                                        uint8_t **pp_val,
+                                        uint16_t *p_len);
+
+/**************************************************************************************************
+* Function Name: le_app_gatts_send_error_rsp
+***************************************************************************************************
+* Summary:
+*   This function sends an Error Response to an attribute request and counts it in the metrics.
+*   All error responses of the application go through here.
+*
+* Parameters:
+*   uint16_t conn_id                : Connection ID of the requester
+*   wiced_bt_gatt_opcode_t opcode   : Opcode of the failed request
+*   uint16_t attr_handle            : Handle that caused the error, or 0
+*   wiced_bt_gatt_status_t status   : Error code
+*
+* Return:
+*  wiced_bt_gatt_status_t: Result of wiced_bt_gatt_server_send_error_rsp()
+*
+**************************************************************************************************/
+wiced_bt_gatt_status_t le_app_gatts_send_error_rsp(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                                                   uint16_t attr_handle, wiced_bt_gatt_status_t status);
+
+/**************************************************************************************************
+* Function Name: le_app_get_cccd_handle
+***************************************************************************************************
+* Summary:
+*   This function returns the client characteristic configuration descriptor of a
+*   characteristic. The generated database places the CCCD directly after the value.
+*
+* Parameters:
+*   uint16_t attr_handle        : Handle of the characteristic value
+*
+* Return:
+*  uint16_t: Handle of the CCCD, or 0 if the characteristic cannot notify or indicate
+*
+**************************************************************************************************/
+uint16_t le_app_get_cccd_handle(uint16_t attr_handle);
+
+#endif /* LE_APP_GATTS_H_ */
+
 /* [] END OF FILE */
@@ -0,0 +1,254 @@
+/*******************************************************************************
+ * File Name: le_app_latency.c
+ *
+ * Description:
+ *   Source file for the GATT and management event latency histograms.
+ *   Durations are measured with the DWT cycle counter.
+ *
+ * Related Document: See Readme.md
+ *
+ *******************************************************************************
+ * Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/*******************************************************************************
+ *        Header Files
+ *******************************************************************************/
+#include "le_app_latency.h"
+
+#if LE_APP_LATENCY_ENABLE
+
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *        Variable Definitions
+ *******************************************************************************/
+static le_app_latency_hist_t le_app_latency_gatt_evt[LE_APP_LATENCY_GATT_EVT_SLOTS];
+static le_app_latency_hist_t le_app_latency_opcode[LE_APP_LATENCY_OPCODE_SLOTS];
+static le_app_latency_hist_t le_app_latency_mgmt_evt[LE_APP_LATENCY_MGMT_EVT_SLOTS];
+static le_app_latency_hist_t le_app_latency_log[LE_APP_LATENCY_LOG_SLOTS];
+
+static const char *const le_app_latency_kind_names[LE_APP_LATENCY_KIND_COUNT] =
+{
+    [LE_APP_LATENCY_GATT_EVT]       = "GATT event",
+    [LE_APP_LATENCY_GATT_OPCODE]    = "GATT opcode",
+    [LE_APP_LATENCY_MGMT_EVT]       = "Management event",
+    [LE_APP_LATENCY_LOG]            = "Log",
+};
+
+/*******************************************************************************
+ *        Function Prototypes
+ *******************************************************************************/
+static le_app_latency_hist_t *le_app_latency_find(le_app_latency_kind_t kind, uint32_t index);
+
+/*******************************************************************************
+ *        Function Definitions
+ *******************************************************************************/
+
+/**************************************************************************************************
+ * Function Name: le_app_latency_init
+ ***************************************************************************************************
+ * Summary:
+ *   This function starts the DWT cycle counter and clears the histograms.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_latency_init(void)
+{
+    memset(le_app_latency_gatt_evt, 0, sizeof(le_app_latency_gatt_evt));
+    memset(le_app_latency_opcode, 0, sizeof(le_app_latency_opcode));
+    memset(le_app_latency_mgmt_evt, 0, sizeof(le_app_latency_mgmt_evt));
+    memset(le_app_latency_log, 0, sizeof(le_app_latency_log));
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_latency_record
+ ***************************************************************************************************
+ * Summary:
+ *   This function adds the cycles elapsed since start to a histogram. It is called through
+ *   LE_APP_LATENCY_RECORD() from the Bluetooth stack context, and for LE_APP_LATENCY_LOG from
+ *   every thread that logs, so the histogram is updated inside a critical section.
+ *
+ * Parameters:
+ *   le_app_latency_kind_t kind  : Kind of event
+ *   uint32_t index              : Event code or opcode
+ *   uint32_t start              : DWT->CYCCNT at the start of the event
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_latency_record(le_app_latency_kind_t kind, uint32_t index, uint32_t start)
+{
+    /* Unsigned subtraction handles a counter wrap during the event */
+    uint32_t cycles = DWT->CYCCNT - start;
+    le_app_latency_hist_t *p_hist = le_app_latency_find(kind, index);
+    uint32_t bucket = (0 == cycles) ? 0 : (31u - __CLZ(cycles));
+    uint32_t saved_intr_status;
+
+    if (LE_APP_LATENCY_BUCKETS <= bucket)
+    {
+        bucket = LE_APP_LATENCY_BUCKETS - 1;
+    }
+
+    saved_intr_status = cyhal_system_critical_section_enter();
+
+    p_hist->count++;
+    p_hist->total_cycles += cycles;
+    p_hist->buckets[bucket]++;
+    if (cycles > p_hist->max_cycles)
+    {
+        p_hist->max_cycles = cycles;
+    }
+
+    cyhal_system_critical_section_exit(saved_intr_status);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_latency_get
+ ***************************************************************************************************
+ * Summary:
+ *   This function copies one histogram.
+ *
+ * Parameters:
+ *   le_app_latency_kind_t kind  : Kind of event
+ *   uint32_t index              : Event code or opcode
+ *   le_app_latency_hist_t *p_hist: Destination of the histogram
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_latency_get(le_app_latency_kind_t kind, uint32_t index, le_app_latency_hist_t *p_hist)
+{
+    uint32_t saved_intr_status = cyhal_system_critical_section_enter();
+
+    *p_hist = *le_app_latency_find(kind, index);
+
+    cyhal_system_critical_section_exit(saved_intr_status);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_latency_print
+ ***************************************************************************************************
+ * Summary:
+ *   This function prints every histogram that has samples, in cycles.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_latency_print(void)
+{
+    static const uint32_t slots[LE_APP_LATENCY_KIND_COUNT] =
+    {
+        [LE_APP_LATENCY_GATT_EVT]       = LE_APP_LATENCY_GATT_EVT_SLOTS,
+        [LE_APP_LATENCY_GATT_OPCODE]    = LE_APP_LATENCY_OPCODE_SLOTS,
+        [LE_APP_LATENCY_MGMT_EVT]       = LE_APP_LATENCY_MGMT_EVT_SLOTS,
+        [LE_APP_LATENCY_LOG]            = LE_APP_LATENCY_LOG_SLOTS,
+    };
+    le_app_latency_hist_t hist;
+
+    printf("Latency in cycles (SystemCoreClock %lu Hz)\r\n", (unsigned long)SystemCoreClock);
+
+    for (uint32_t kind = 0; kind < LE_APP_LATENCY_KIND_COUNT; kind++)
+    {
+        for (uint32_t index = 0; index < slots[kind]; index++)
+        {
+            le_app_latency_get((le_app_latency_kind_t)kind, index, &hist);
+            if (0 == hist.count)
+            {
+                continue;
+            }
+
+            printf("%s 0x%02lx: count %lu avg %lu max %lu\r\n  log2 buckets:",
+                   le_app_latency_kind_names[kind], (unsigned long)index, (unsigned long)hist.count,
+                   (unsigned long)(hist.total_cycles / hist.count), (unsigned long)hist.max_cycles);
+            for (uint32_t bucket = 0; bucket < LE_APP_LATENCY_BUCKETS; bucket++)
+            {
+                printf(" %lu", (unsigned long)hist.buckets[bucket]);
+            }
+            printf("\r\n");
+        }
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_latency_find
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns the histogram of an event. Indices beyond the table share its last
+ *   histogram.
+ *
+ * Parameters:
+ *   le_app_latency_kind_t kind  : Kind of event
+ *   uint32_t index              : Event code or opcode
+ *
+ * Return:
+ *  le_app_latency_hist_t *: Histogram of the event
+ *
+ **************************************************************************************************/
+static le_app_latency_hist_t *le_app_latency_find(le_app_latency_kind_t kind, uint32_t index)
+{
+    switch (kind)
+    {
+    case LE_APP_LATENCY_GATT_EVT:
+        return &le_app_latency_gatt_evt[(index < LE_APP_LATENCY_GATT_EVT_SLOTS) ?
+                                        index : (LE_APP_LATENCY_GATT_EVT_SLOTS - 1)];
+    case LE_APP_LATENCY_GATT_OPCODE:
+        return &le_app_latency_opcode[(index < LE_APP_LATENCY_OPCODE_SLOTS) ?
+                                      index : (LE_APP_LATENCY_OPCODE_SLOTS - 1)];
+    case LE_APP_LATENCY_LOG:
+        return &le_app_latency_log[(index < LE_APP_LATENCY_LOG_SLOTS) ?
+                                   index : (LE_APP_LATENCY_LOG_SLOTS - 1)];
+    default:
+        return &le_app_latency_mgmt_evt[(index < LE_APP_LATENCY_MGMT_EVT_SLOTS) ?
+                                        index : (LE_APP_LATENCY_MGMT_EVT_SLOTS - 1)];
+    }
+}
+
+#endif /* LE_APP_LATENCY_ENABLE */
+
+/* [] END OF FILE */
@@ -0,0 +1,184 @@
+/*******************************************************************************
+* File Name: le_app_latency.h
+*
+* Description:
+*   Header file for the GATT and management event latency histograms
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef LE_APP_LATENCY_H_
+#define LE_APP_LATENCY_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include <stdint.h>
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Set to 1 to record event latencies. Set from the Makefile with LATENCY_STATS=1 */
+#ifndef LE_APP_LATENCY_ENABLE
+#define LE_APP_LATENCY_ENABLE           (0)
+#endif
+
+/* Number of log2 buckets per histogram. Bucket n counts durations of 2^n to
+ * 2^(n+1) - 1 cycles; the last bucket also counts everything longer */
+#define LE_APP_LATENCY_BUCKETS          (20u)
+
+/* Histograms per kind. Indices at or above the count share the last histogram;
+ * for attribute opcodes this is GATT_CMD_WRITE and GATT_CMD_SIGNED_WRITE */
+#define LE_APP_LATENCY_GATT_EVT_SLOTS   (16u)
+#define LE_APP_LATENCY_OPCODE_SLOTS     (0x22u)
+#define LE_APP_LATENCY_MGMT_EVT_SLOTS   (48u)
+#define LE_APP_LATENCY_LOG_SLOTS        (2u)
+
+#if LE_APP_LATENCY_ENABLE
+#include "cyhal.h"
+
+/* Declares a local holding the cycle count at the start of an event */
+#define LE_APP_LATENCY_START(start)                 uint32_t start = DWT->CYCCNT
+
+/* Adds the cycles since start to the histogram of the given kind and index */
+#define LE_APP_LATENCY_RECORD(kind, index, start)   le_app_latency_record((kind), (index), (start))
+#else
+#define LE_APP_LATENCY_START(start)
+#define LE_APP_LATENCY_RECORD(kind, index, start)
+#endif
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+typedef enum
+{
+    LE_APP_LATENCY_GATT_EVT,        /* GATT events other than attribute requests, by wiced_bt_gatt_evt_t */
+    LE_APP_LATENCY_GATT_OPCODE,     /* Attribute requests, by wiced_bt_gatt_opcode_t */
+    LE_APP_LATENCY_MGMT_EVT,        /* Management events, by wiced_bt_management_evt_t */
+    LE_APP_LATENCY_LOG,             /* Log calls, by le_app_latency_log_t */
+    LE_APP_LATENCY_KIND_COUNT
+} le_app_latency_kind_t;
+
+/* Indices of LE_APP_LATENCY_LOG */
+typedef enum
+{
+    LE_APP_LATENCY_LOG_WRITE,       /* LE_APP_LOG() at the call site */
+    LE_APP_LATENCY_LOG_EMIT,        /* Formatting or encoding and printing an entry in the log thread */
+} le_app_latency_log_t;
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t max_cycles;
+    uint64_t total_cycles;
+    uint32_t buckets[LE_APP_LATENCY_BUCKETS];
+} le_app_latency_hist_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+#if LE_APP_LATENCY_ENABLE
+
+/**************************************************************************************************
+* Function Name: le_app_latency_init
+***************************************************************************************************
+* Summary:
+*   This function starts the DWT cycle counter and clears the histograms.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_latency_init(void);
+
+/**************************************************************************************************
+* Function Name: le_app_latency_record
+***************************************************************************************************
+* Summary:
+*   This function adds the cycles elapsed since start to a histogram. It is called through
+*   LE_APP_LATENCY_RECORD() from the Bluetooth stack context, and for LE_APP_LATENCY_LOG from
+*   every thread that logs, so the histogram is updated inside a critical section.
+*
+* Parameters:
+*   le_app_latency_kind_t kind  : Kind of event
+*   uint32_t index              : Event code or opcode
+*   uint32_t start              : DWT->CYCCNT at the start of the event
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_latency_record(le_app_latency_kind_t kind, uint32_t index, uint32_t start);
+
+/**************************************************************************************************
+* Function Name: le_app_latency_get
+***************************************************************************************************
+* Summary:
+*   This function copies one histogram.
+*
+* Parameters:
+*   le_app_latency_kind_t kind  : Kind of event
+*   uint32_t index              : Event code or opcode
+*   le_app_latency_hist_t *p_hist: Destination of the histogram
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_latency_get(le_app_latency_kind_t kind, uint32_t index, le_app_latency_hist_t *p_hist);
+
+/**************************************************************************************************
+* Function Name: le_app_latency_print
+***************************************************************************************************
+* Summary:
+*   This function prints every histogram that has samples, in cycles.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_latency_print(void);
+
+#endif /* LE_APP_LATENCY_ENABLE */
+
+#endif /* LE_APP_LATENCY_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,386 @@
+/*******************************************************************************
+ * File Name: le_app_led.c
+ *
+ * Description:
+ *   Source file for the LED pattern engine
+ *
+ * Related Document: See Readme.md
+ *
+ *******************************************************************************
+ * Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/*******************************************************************************
+ *        Header Files
+ *******************************************************************************/
+#include "le_app_led.h"
+#include "le_app_thread.h"
+#include "cyhal.h"
+#include "cybsp.h"
+#include "cyabs_rtos.h"
+
+/*******************************************************************************
+ *        Macro Definitions
+ *******************************************************************************/
+/* Pin levels that light the LEDs. The IAS LED is active low and the advertising LED active
+ * high, as the duty cycles of the former PWM driver show */
+#define LE_APP_LED_IAS_ON_LEVEL         (false)
+#define LE_APP_LED_ADV_ON_LEVEL         (true)
+
+/*******************************************************************************
+ *        Variable Definitions
+ *******************************************************************************/
+static const le_app_led_step_t le_app_led_steps_off[] =
+{
+    { 0u, 0u },
+};
+
+static const le_app_led_step_t le_app_led_steps_on[] =
+{
+    { 0u, 1u },
+};
+
+static const le_app_led_step_t le_app_led_steps_blink[] =
+{
+    { LE_APP_LED_BLINK_STEP_MS, 1u },
+    { LE_APP_LED_BLINK_STEP_MS, 0u },
+};
+
+static const le_app_led_pattern_t le_app_led_patterns[LE_APP_LED_PATTERN_COUNT] =
+{
+    [LE_APP_LED_PATTERN_OFF]    = { le_app_led_steps_off, 1u, 0u },
+    [LE_APP_LED_PATTERN_ON]     = { le_app_led_steps_on, 1u, 0u },
+    [LE_APP_LED_PATTERN_BLINK]  = { le_app_led_steps_blink, 2u, 2u * LE_APP_LED_BLINK_STEP_MS },
+};
+
+static le_app_led_channel_t le_app_led_channels[LE_APP_LED_COUNT];
+
+/* Level last written to each LED, so pins are only written on a change */
+static bool le_app_led_output_on[LE_APP_LED_COUNT];
+
+static cy_timer_t le_app_led_timer;
+
+static le_app_led_stats_t le_app_led_stats;
+
+/*******************************************************************************
+ *        Function Prototypes
+ *******************************************************************************/
+static void le_app_led_write(le_app_led_id_t led, bool on);
+static void le_app_led_timer_cb(cy_timer_callback_arg_t arg);
+
+/*******************************************************************************
+ *        Function Definitions
+ *******************************************************************************/
+
+/**************************************************************************************************
+ * Function Name: le_app_led_engine_set
+ ***************************************************************************************************
+ * Summary:
+ *   This function starts a pattern on a channel at its first step. It does not touch any
+ *   hardware, so the sequencing can be run against a fake clock.
+ *
+ * Parameters:
+ *   le_app_led_channel_t *p_channel     : Channel
+ *   le_app_led_pattern_id_t pattern     : Pattern to start
+ *   uint32_t now_ms                     : Current time
+ *
+ * Return:
+ *  bool: false if the pattern was already active and nothing changed
+ *
+ **************************************************************************************************/
+bool le_app_led_engine_set(le_app_led_channel_t *p_channel, le_app_led_pattern_id_t pattern, uint32_t now_ms)
+{
+    if (pattern == p_channel->pattern)
+    {
+        return false;
+    }
+
+    p_channel->pattern = pattern;
+    p_channel->step = 0;
+    p_channel->on = (0 != le_app_led_patterns[pattern].p_steps[0].on);
+    p_channel->step_start_ms = now_ms;
+
+    return true;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_led_engine_advance
+ ***************************************************************************************************
+ * Summary:
+ *   This function moves a channel to the step that is current at now_ms. Whole periods that
+ *   passed, for example while the thread was blocked, are skipped at once.
+ *
+ * Parameters:
+ *   le_app_led_channel_t *p_channel     : Channel
+ *   uint32_t now_ms                     : Current time
+ *
+ * Return:
+ *  uint32_t: Time in ms until the next step, or LE_APP_LED_NO_DEADLINE
+ *
+ **************************************************************************************************/
+uint32_t le_app_led_engine_advance(le_app_led_channel_t *p_channel, uint32_t now_ms)
+{
+    const le_app_led_pattern_t *p_pattern = &le_app_led_patterns[p_channel->pattern];
+    uint32_t duration;
+    uint32_t elapsed;
+
+    while (1)
+    {
+        duration = p_pattern->p_steps[p_channel->step].duration_ms;
+        if (0 == duration)
+        {
+            return LE_APP_LED_NO_DEADLINE;
+        }
+
+        elapsed = now_ms - p_channel->step_start_ms;
+        if (elapsed < duration)
+        {
+            return duration - elapsed;
+        }
+
+        if ((0 == p_channel->step) && (elapsed >= p_pattern->period_ms))
+        {
+            p_channel->step_start_ms += (elapsed / p_pattern->period_ms) * p_pattern->period_ms;
+            continue;
+        }
+
+        p_channel->step_start_ms += duration;
+        p_channel->step = (uint8_t)((p_channel->step + 1) % p_pattern->num_steps);
+        p_channel->on = (0 != p_pattern->p_steps[p_channel->step].on);
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_led_init
+ ***************************************************************************************************
+ * Summary:
+ *   This function configures the LED pins as outputs, turns the LEDs off and creates the
+ *   sequencing timer.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS, or the result of the failed HAL or RTOS call
+ *
+ **************************************************************************************************/
+cy_rslt_t le_app_led_init(void)
+{
+    cy_rslt_t cy_result = CY_RSLT_SUCCESS;
+
+#ifdef CYBSP_USER_LED1
+    cy_result = cyhal_gpio_init(CYBSP_USER_LED1, CYHAL_GPIO_DIR_OUTPUT, CYHAL_GPIO_DRIVE_STRONG,
+                                !LE_APP_LED_IAS_ON_LEVEL);
+    if (CY_RSLT_SUCCESS != cy_result)
+    {
+        return cy_result;
+    }
+#endif
+    /* CYBSP_USER_LED2 is only present on some kits */
+#ifdef CYBSP_USER_LED2
+    cy_result = cyhal_gpio_init(CYBSP_USER_LED2, CYHAL_GPIO_DIR_OUTPUT, CYHAL_GPIO_DRIVE_STRONG,
+                                !LE_APP_LED_ADV_ON_LEVEL);
+    if (CY_RSLT_SUCCESS != cy_result)
+    {
+        return cy_result;
+    }
+#endif
+
+    for (uint32_t led = 0; led < LE_APP_LED_COUNT; led++)
+    {
+        le_app_led_channels[led].pattern = LE_APP_LED_PATTERN_OFF;
+        le_app_led_channels[led].step = 0;
+        le_app_led_channels[led].on = false;
+        le_app_led_output_on[led] = false;
+    }
+
+    return cy_rtos_timer_init(&le_app_led_timer, CY_TIMER_TYPE_ONCE, le_app_led_timer_cb, NULL);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_led_set
+ ***************************************************************************************************
+ * Summary:
+ *   This function shows a pattern on an LED. Requests for the active pattern are ignored.
+ *   Call it from the application thread only.
+ *
+ * Parameters:
+ *   le_app_led_id_t led                 : LED
+ *   le_app_led_pattern_id_t pattern     : Pattern
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_led_set(le_app_led_id_t led, le_app_led_pattern_id_t pattern)
+{
+    cy_time_t now;
+
+    le_app_led_stats.requests++;
+
+    cy_rtos_get_time(&now);
+    if (!le_app_led_engine_set(&le_app_led_channels[led], pattern, now))
+    {
+        le_app_led_stats.skipped++;
+        return;
+    }
+
+    le_app_led_tick();
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_led_tick
+ ***************************************************************************************************
+ * Summary:
+ *   This function advances every LED, writes the pins that changed and restarts the timer for
+ *   the earliest next step. Call it from the application thread only.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_led_tick(void)
+{
+    uint32_t next_ms = LE_APP_LED_NO_DEADLINE;
+    uint32_t delay_ms;
+    cy_time_t now;
+
+    cy_rtos_get_time(&now);
+
+    for (uint32_t led = 0; led < LE_APP_LED_COUNT; led++)
+    {
+        delay_ms = le_app_led_engine_advance(&le_app_led_channels[led], now);
+        if (delay_ms < next_ms)
+        {
+            next_ms = delay_ms;
+        }
+
+        if (le_app_led_channels[led].on != le_app_led_output_on[led])
+        {
+            le_app_led_write((le_app_led_id_t)led, le_app_led_channels[led].on);
+        }
+    }
+
+    /* A stale expiry after the restart only causes an extra tick that changes nothing */
+    cy_rtos_timer_stop(&le_app_led_timer);
+    if (LE_APP_LED_NO_DEADLINE != next_ms)
+    {
+        cy_rtos_timer_start(&le_app_led_timer, next_ms);
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_led_get_stats
+ ***************************************************************************************************
+ * Summary:
+ *   This function copies the LED engine counters.
+ *
+ * Parameters:
+ *   le_app_led_stats_t *p_stats         : Copy of the counters
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_led_get_stats(le_app_led_stats_t *p_stats)
+{
+    *p_stats = le_app_led_stats;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_led_write
+ ***************************************************************************************************
+ * Summary:
+ *   This function drives an LED pin, taking the polarity of the LED into account.
+ *
+ * Parameters:
+ *   le_app_led_id_t led         : LED
+ *   bool on                     : true to light the LED
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_led_write(le_app_led_id_t led, bool on)
+{
+    le_app_led_output_on[led] = on;
+
+    switch (led)
+    {
+#ifdef CYBSP_USER_LED1
+    case LE_APP_LED_IAS:
+        cyhal_gpio_write(CYBSP_USER_LED1, on ? LE_APP_LED_IAS_ON_LEVEL : !LE_APP_LED_IAS_ON_LEVEL);
+        le_app_led_stats.writes++;
+        break;
+#endif
+#ifdef CYBSP_USER_LED2
+    case LE_APP_LED_ADV:
+        cyhal_gpio_write(CYBSP_USER_LED2, on ? LE_APP_LED_ADV_ON_LEVEL : !LE_APP_LED_ADV_ON_LEVEL);
+        le_app_led_stats.writes++;
+        break;
+#endif
+    default:
+        /* The LED is not present on this kit */
+        break;
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_led_timer_cb
+ ***************************************************************************************************
+ * Summary:
+ *   This function runs in the RTOS timer context when the next step is due and hands the tick
+ *   to the application thread. If its queue is full, the timer is restarted so that the chain
+ *   of steps does not end.
+ *
+ * Parameters:
+ *   cy_timer_callback_arg_t arg : Unused
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_led_timer_cb(cy_timer_callback_arg_t arg)
+{
+    (void)arg;
+
+    le_app_led_stats.ticks++;
+    if (!le_app_thread_post(LE_APP_THREAD_PRODUCER_TIMER, LE_APP_EVT_LED_TICK, 0))
+    {
+        cy_rtos_timer_start(&le_app_led_timer, LE_APP_LED_TICK_RETRY_MS);
+    }
+}
+
+/* [] END OF FILE */
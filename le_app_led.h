@@ -0,0 +1,219 @@
+/*******************************************************************************
+* File Name: le_app_led.h
+*
+* Description:
+*   Header file for the LED pattern engine. Patterns are constant step tables
+*   and every LED is sequenced from one one-shot timer
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef LE_APP_LED_H_
+#define LE_APP_LED_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_result.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Returned by le_app_led_engine_advance() when the current step lasts forever */
+#define LE_APP_LED_NO_DEADLINE          (UINT32_MAX)
+
+/* Half period of the blinking pattern; 2 Hz like the former PWM blinking */
+#define LE_APP_LED_BLINK_STEP_MS        (250u)
+
+/* Delay before a tick that did not fit in the application thread queue is tried again */
+#define LE_APP_LED_TICK_RETRY_MS        (10u)
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+typedef enum
+{
+    LE_APP_LED_IAS,                 /* CYBSP_USER_LED1, IAS alert level */
+    LE_APP_LED_ADV,                 /* CYBSP_USER_LED2, advertising and connection state */
+    LE_APP_LED_COUNT
+} le_app_led_id_t;
+
+typedef enum
+{
+    LE_APP_LED_PATTERN_OFF,
+    LE_APP_LED_PATTERN_ON,
+    LE_APP_LED_PATTERN_BLINK,
+    LE_APP_LED_PATTERN_COUNT
+} le_app_led_pattern_id_t;
+
+/* One step of a pattern. A duration of 0 holds the step until the pattern changes */
+typedef struct
+{
+    uint16_t duration_ms;
+    uint8_t on;
+} le_app_led_step_t;
+
+/* A pattern repeats its steps until it is replaced */
+typedef struct
+{
+    const le_app_led_step_t *p_steps;
+    uint8_t num_steps;
+    uint16_t period_ms;             /* Sum of the step durations */
+} le_app_led_pattern_t;
+
+/* Sequencing state of one LED */
+typedef struct
+{
+    le_app_led_pattern_id_t pattern;
+    uint8_t step;
+    bool on;
+    uint32_t step_start_ms;
+} le_app_led_channel_t;
+
+typedef struct
+{
+    uint32_t requests;              /* le_app_led_set() calls */
+    uint32_t skipped;               /* Requests for the pattern already active */
+    uint32_t ticks;                 /* Timer expiries */
+    uint32_t writes;                /* GPIO writes */
+} le_app_led_stats_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+
+/**************************************************************************************************
+* Function Name: le_app_led_engine_set
+***************************************************************************************************
+* Summary:
+*   This function starts a pattern on a channel at its first step. It does not touch any
+*   hardware, so the sequencing can be run against a fake clock.
+*
+* Parameters:
+*   le_app_led_channel_t *p_channel     : Channel
+*   le_app_led_pattern_id_t pattern     : Pattern to start
+*   uint32_t now_ms                     : Current time
+*
+* Return:
+*  bool: false if the pattern was already active and nothing changed
+*
+**************************************************************************************************/
+bool le_app_led_engine_set(le_app_led_channel_t *p_channel, le_app_led_pattern_id_t pattern, uint32_t now_ms);
+
+/**************************************************************************************************
+* Function Name: le_app_led_engine_advance
+***************************************************************************************************
+* Summary:
+*   This function moves a channel to the step that is current at now_ms.
+*
+* Parameters:
+*   le_app_led_channel_t *p_channel     : Channel
+*   uint32_t now_ms                     : Current time
+*
+* Return:
+*  uint32_t: Time in ms until the next step, or LE_APP_LED_NO_DEADLINE
+*
+**************************************************************************************************/
+uint32_t le_app_led_engine_advance(le_app_led_channel_t *p_channel, uint32_t now_ms);
+
+/**************************************************************************************************
+* Function Name: le_app_led_init
+***************************************************************************************************
+* Summary:
+*   This function configures the LED pins as outputs, turns the LEDs off and creates the
+*   sequencing timer.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  cy_rslt_t: CY_RSLT_SUCCESS, or the result of the failed HAL or RTOS call
+*
+**************************************************************************************************/
+cy_rslt_t le_app_led_init(void);
+
+/**************************************************************************************************
+* Function Name: le_app_led_set
+***************************************************************************************************
+* Summary:
+*   This function shows a pattern on an LED. Requests for the active pattern are ignored.
+*   Call it from the application thread only.
+*
+* Parameters:
+*   le_app_led_id_t led                 : LED
+*   le_app_led_pattern_id_t pattern     : Pattern
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_led_set(le_app_led_id_t led, le_app_led_pattern_id_t pattern);
+
+/**************************************************************************************************
+* Function Name: le_app_led_tick
+***************************************************************************************************
+* Summary:
+*   This function advances every LED, writes the pins that changed and restarts the timer for
+*   the earliest next step. Call it from the application thread only.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_led_tick(void);
+
+/**************************************************************************************************
+* Function Name: le_app_led_get_stats
+***************************************************************************************************
+* Summary:
+*   This function copies the LED engine counters.
+*
+* Parameters:
+*   le_app_led_stats_t *p_stats         : Copy of the counters
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_led_get_stats(le_app_led_stats_t *p_stats);
+
+#endif /* LE_APP_LED_H_ */
+
+/* [] END OF FILE */
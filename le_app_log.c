@@ -0,0 +1,344 @@
+/*******************************************************************************
+ * File Name: le_app_log.c
+ *
+ * Description:
+ *   Source file for the deferred application log. In tokenized mode each
+ *   entry is printed as "$" followed by the base64 encoded token and arguments
+ *
+ * Related Document: See Readme.md
+ *
+ *******************************************************************************
+ * Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/*******************************************************************************
+ *        Header Files
+ *******************************************************************************/
+#include "le_app_log.h"
+#include "le_app_latency.h"
+#include "le_app_pm.h"
+#include <stdio.h>
+#include <stdatomic.h>
+#include "cyabs_rtos.h"
+
+/*******************************************************************************
+ *        Macro Definitions
+ *******************************************************************************/
+/* Token and arguments of the longest entry, each argument as an unsigned LEB128 number */
+#define LE_APP_LOG_FRAME_MAX            (4u + (LE_APP_LOG_MAX_ARGS * 5u))
+#define LE_APP_LOG_BASE64_MAX           (((LE_APP_LOG_FRAME_MAX + 2u) / 3u) * 4u)
+
+/*******************************************************************************
+ *        Structures and Enumerations
+ *******************************************************************************/
+typedef struct
+{
+    /* Sequence number published by the producer once the entry is complete.
+     * Slot i holds a complete entry for write index w when seq == w + 1 */
+    atomic_uint seq;
+    le_app_log_str_t fmt;
+    uint32_t num_args;
+    uint32_t args[LE_APP_LOG_MAX_ARGS];
+} le_app_log_entry_t;
+
+/*******************************************************************************
+ *        Variable Definitions
+ *******************************************************************************/
+static le_app_log_entry_t le_app_log_ring[LE_APP_LOG_RING_SIZE];
+
+/* Free running indices; the ring position is the index modulo LE_APP_LOG_RING_SIZE */
+static atomic_uint le_app_log_write_idx;
+static atomic_uint le_app_log_read_idx;
+
+static atomic_uint le_app_log_dropped;
+
+/* Set by the producer that adds an entry to an empty ring; the log thread blocks on it */
+static cy_semaphore_t le_app_log_sem;
+
+static cy_thread_t le_app_log_thread;
+/* ThreadX requires an 8 byte aligned stack */
+static uint64_t le_app_log_thread_stack[LE_APP_LOG_THREAD_STACK_SIZE / sizeof(uint64_t)];
+
+/*******************************************************************************
+ *        Function Prototypes
+ *******************************************************************************/
+static void le_app_log_thread_entry(cy_thread_arg_t arg);
+static void le_app_log_emit(const le_app_log_entry_t *p_entry);
+
+/*******************************************************************************
+ *        Function Definitions
+ *******************************************************************************/
+
+/**************************************************************************************************
+ * Function Name: le_app_log_init
+ ***************************************************************************************************
+ * Summary:
+ *   This function creates the low priority thread that drains the log ring.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS if the log thread was created
+ *
+ **************************************************************************************************/
+cy_rslt_t le_app_log_init(void)
+{
+    cy_rslt_t cy_result;
+
+    cy_result = cy_rtos_semaphore_init(&le_app_log_sem, LE_APP_LOG_RING_SIZE, 0);
+    if (CY_RSLT_SUCCESS != cy_result)
+    {
+        return cy_result;
+    }
+
+    return cy_rtos_thread_create(&le_app_log_thread, le_app_log_thread_entry, "le_app_log",
+                                 le_app_log_thread_stack, sizeof(le_app_log_thread_stack),
+                                 CY_RTOS_PRIORITY_LOW, NULL);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_log_write
+ ***************************************************************************************************
+ * Summary:
+ *   This function records a log entry in the ring. Producers claim a slot by advancing the write
+ *   index with a compare-and-swap, fill it, and then publish it through the slot sequence number,
+ *   so several threads can log concurrently without a lock. Only the entry that makes the ring
+ *   non-empty wakes the log thread.
+ *
+ * Parameters:
+ *   le_app_log_str_t fmt       : printf format string from LE_APP_LOG_NAME()
+ *   uint32_t num_args          : Number of arguments, at most LE_APP_LOG_MAX_ARGS
+ *   const uint32_t *p_args     : Arguments of the format string
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_log_write(le_app_log_str_t fmt, uint32_t num_args, const uint32_t *p_args)
+{
+    LE_APP_LATENCY_START(latency_start);
+    le_app_log_entry_t *p_entry;
+    unsigned int write_idx = atomic_load_explicit(&le_app_log_write_idx, memory_order_relaxed);
+    unsigned int read_idx;
+
+    do
+    {
+        read_idx = atomic_load_explicit(&le_app_log_read_idx, memory_order_acquire);
+        if ((write_idx - read_idx) >= LE_APP_LOG_RING_SIZE)
+        {
+            /* Ring is full; drop the entry rather than block the caller */
+            atomic_fetch_add_explicit(&le_app_log_dropped, 1, memory_order_relaxed);
+            return;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&le_app_log_write_idx, &write_idx, write_idx + 1,
+                                                    memory_order_relaxed, memory_order_relaxed));
+
+    p_entry = &le_app_log_ring[write_idx & (LE_APP_LOG_RING_SIZE - 1)];
+    p_entry->fmt = fmt;
+    p_entry->num_args = (num_args < LE_APP_LOG_MAX_ARGS) ? num_args : LE_APP_LOG_MAX_ARGS;
+    for (uint32_t i = 0; i < p_entry->num_args; i++)
+    {
+        p_entry->args[i] = p_args[i];
+    }
+
+    atomic_store_explicit(&p_entry->seq, write_idx + 1, memory_order_release);
+
+    if (write_idx == read_idx)
+    {
+        cy_rtos_semaphore_set(&le_app_log_sem);
+    }
+
+    LE_APP_LATENCY_RECORD(LE_APP_LATENCY_LOG, LE_APP_LATENCY_LOG_WRITE, latency_start);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_log_get_dropped
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns the number of entries dropped because the ring was full.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  uint32_t: Number of dropped entries since boot
+ *
+ **************************************************************************************************/
+uint32_t le_app_log_get_dropped(void)
+{
+    return atomic_load_explicit(&le_app_log_dropped, memory_order_relaxed);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_log_thread_entry
+ ***************************************************************************************************
+ * Summary:
+ *   This is the log thread. It formats and prints every published entry in order. It blocks
+ *   while the ring is empty, so it does not wake the system when nothing is logged, and holds
+ *   the log wake lock while it prints.
+ *
+ * Parameters:
+ *   cy_thread_arg_t arg : Unused
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_log_thread_entry(cy_thread_arg_t arg)
+{
+    le_app_log_entry_t entry = {0};
+    unsigned int read_idx = 0;
+    uint32_t reported_drops = 0;
+    uint32_t drops;
+
+    (void)arg;
+
+    while (1)
+    {
+        if (read_idx == atomic_load_explicit(&le_app_log_write_idx, memory_order_acquire))
+        {
+            cy_rtos_semaphore_get(&le_app_log_sem, CY_RTOS_NEVER_TIMEOUT);
+        }
+
+        le_app_pm_lock(LE_APP_PM_LOCK_LOG);
+
+        while (1)
+        {
+            le_app_log_entry_t *p_entry = &le_app_log_ring[read_idx & (LE_APP_LOG_RING_SIZE - 1)];
+
+            /* Stop at the first slot that has not been published yet */
+            if (atomic_load_explicit(&p_entry->seq, memory_order_acquire) != (read_idx + 1))
+            {
+                break;
+            }
+
+            entry.fmt = p_entry->fmt;
+            entry.num_args = p_entry->num_args;
+            for (uint32_t i = 0; i < LE_APP_LOG_MAX_ARGS; i++)
+            {
+                entry.args[i] = (i < entry.num_args) ? p_entry->args[i] : 0;
+            }
+
+            /* Release the slot before the slow formatting step */
+            read_idx++;
+            atomic_store_explicit(&le_app_log_read_idx, read_idx, memory_order_release);
+
+            le_app_log_emit(&entry);
+        }
+
+        drops = le_app_log_get_dropped();
+        if (drops != reported_drops)
+        {
+            entry.fmt = LE_APP_LOG_NAME("Log ring full, %u entries dropped\r\n");
+            entry.num_args = 1;
+            entry.args[0] = drops - reported_drops;
+            le_app_log_emit(&entry);
+            reported_drops = drops;
+        }
+
+        le_app_pm_unlock(LE_APP_PM_LOCK_LOG);
+
+        /* A slot that is claimed but not yet published does not signal again */
+        if (read_idx != atomic_load_explicit(&le_app_log_write_idx, memory_order_acquire))
+        {
+            cy_rtos_delay_milliseconds(LE_APP_LOG_PUBLISH_WAIT_MS);
+        }
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_log_emit
+ ***************************************************************************************************
+ * Summary:
+ *   This function prints one entry. In tokenized mode the token and the arguments are printed
+ *   as a base64 line for tools/le_app_detokenize.py, otherwise the entry is formatted.
+ *
+ * Parameters:
+ *   const le_app_log_entry_t *p_entry  : Entry to print
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_log_emit(const le_app_log_entry_t *p_entry)
+{
+    LE_APP_LATENCY_START(latency_start);
+#if LE_APP_LOG_TOKENIZED
+    static const char base64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    uint8_t frame[LE_APP_LOG_FRAME_MAX + 2];
+    char line[LE_APP_LOG_BASE64_MAX + 1];
+    uint32_t frame_len = 0;
+    uint32_t line_len = 0;
+    uint32_t value;
+
+    frame[frame_len++] = (uint8_t)p_entry->fmt;
+    frame[frame_len++] = (uint8_t)(p_entry->fmt >> 8);
+    frame[frame_len++] = (uint8_t)(p_entry->fmt >> 16);
+    frame[frame_len++] = (uint8_t)(p_entry->fmt >> 24);
+
+    for (uint32_t i = 0; i < p_entry->num_args; i++)
+    {
+        value = p_entry->args[i];
+        while (value >= 0x80)
+        {
+            frame[frame_len++] = (uint8_t)(value | 0x80);
+            value >>= 7;
+        }
+        frame[frame_len++] = (uint8_t)value;
+    }
+
+    /* Zero pad to whole groups of three bytes */
+    frame[frame_len] = 0;
+    frame[frame_len + 1] = 0;
+    for (uint32_t i = 0; i < frame_len; i += 3)
+    {
+        value = ((uint32_t)frame[i] << 16) | ((uint32_t)frame[i + 1] << 8) | frame[i + 2];
+        line[line_len++] = base64[(value >> 18) & 0x3F];
+        line[line_len++] = base64[(value >> 12) & 0x3F];
+        line[line_len++] = ((i + 1) < frame_len) ? base64[(value >> 6) & 0x3F] : '=';
+        line[line_len++] = ((i + 2) < frame_len) ? base64[value & 0x3F] : '=';
+    }
+    line[line_len] = '\0';
+
+    printf("$%s\r\n", line);
+#else
+    /* Arguments are 32-bit words, passed as pointer sized integers so that "%s"
+     * conversions also work in the 64-bit host build; on the target both are 32 bits */
+    printf(p_entry->fmt, (uintptr_t)p_entry->args[0], (uintptr_t)p_entry->args[1],
+           (uintptr_t)p_entry->args[2], (uintptr_t)p_entry->args[3],
+           (uintptr_t)p_entry->args[4], (uintptr_t)p_entry->args[5]);
+#endif
+    LE_APP_LATENCY_RECORD(LE_APP_LATENCY_LOG, LE_APP_LATENCY_LOG_EMIT, latency_start);
+}
+
+/* [] END OF FILE */
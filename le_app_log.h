@@ -0,0 +1,190 @@
+/*******************************************************************************
+* File Name: le_app_log.h
+*
+* Description:
+*   Header file for the deferred application log. Call sites record a format
+*   string and its arguments into a lock-free ring; a low priority thread
+*   formats and prints them. With LE_APP_LOG_TOKENIZED the format strings are
+*   replaced by 32-bit tokens and decoded on the host.
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef LE_APP_LOG_H_
+#define LE_APP_LOG_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include <stdint.h>
+#include "cy_result.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Number of entries in the log ring. Must be a power of two */
+#define LE_APP_LOG_RING_SIZE            (64u)
+
+/* Maximum number of arguments recorded with a log entry */
+#define LE_APP_LOG_MAX_ARGS             (6u)
+
+/* Time the log thread waits for a claimed entry to be published */
+#define LE_APP_LOG_PUBLISH_WAIT_MS      (1u)
+
+/* Stack size of the log thread in bytes */
+#define LE_APP_LOG_THREAD_STACK_SIZE    (2048u)
+
+/* Set to 1 to log tokens instead of format strings. Set from the Makefile with TOKENIZED_LOG=1 */
+#ifndef LE_APP_LOG_TOKENIZED
+#define LE_APP_LOG_TOKENIZED            (0)
+#endif
+
+#if LE_APP_LOG_TOKENIZED
+#include "le_app_log_token.h"
+
+/* Records a string literal in the .le_app_log_fmt section, which is kept in the
+ * ELF file but not in flash (tools/le_app_log_tokens.ld), and yields its token */
+#define LE_APP_LOG_NAME(str)                                                     \
+    __extension__({                                                             \
+        static const char le_app_log_name_[]                                    \
+            __attribute__((section(".le_app_log_fmt"), used)) = str;            \
+        (le_app_log_str_t)LE_APP_LOG_TOKEN(str);                                \
+    })
+
+/* Converts a loggable string for a "%s" conversion; the host prints the string of the token */
+#define LE_APP_LOG_STR(str)             ((uint32_t)(str))
+#else
+/* Yields a loggable string. str must be a string literal */
+#define LE_APP_LOG_NAME(str)            ((le_app_log_str_t)(str))
+
+/* Converts a loggable string for a "%s" conversion. Only strings that stay
+ * valid until the entry is printed, such as literals, may be logged */
+#define LE_APP_LOG_STR(str)             ((uint32_t)(uintptr_t)(str))
+#endif
+
+/* Format and arguments for logging a Bluetooth device address */
+#define LE_APP_LOG_BDA_FMT              "%02X:%02X:%02X:%02X:%02X:%02X"
+#define LE_APP_LOG_BDA_ARGS(bda)        (bda)[0], (bda)[1], (bda)[2], (bda)[3], (bda)[4], (bda)[5]
+
+/* Format and arguments for logging a Bluetooth device address as two arguments,
+ * for entries that need the remaining arguments for other values */
+#define LE_APP_LOG_BDA_PACKED_FMT       "%04X%08X"
+#define LE_APP_LOG_BDA_PACKED_ARGS(bda)                                          \
+    (((uint32_t)(bda)[0] << 8) | (uint32_t)(bda)[1]),                           \
+    (((uint32_t)(bda)[2] << 24) | ((uint32_t)(bda)[3] << 16) |                  \
+     ((uint32_t)(bda)[4] << 8) | (uint32_t)(bda)[5])
+
+/* Counts up to 12 arguments, so that calls with more than LE_APP_LOG_MAX_ARGS can be rejected */
+#define LE_APP_LOG_NUM_ARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, N, ...)   N
+#define LE_APP_LOG_NUM_ARGS(...)                                                 \
+    LE_APP_LOG_NUM_ARGS_(0, ##__VA_ARGS__, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+
+/* Fails the build if a log entry has more arguments than it can record */
+#define LE_APP_LOG_CHECK_NUM_ARGS(num_args)                                      \
+    ((void)sizeof(struct { _Static_assert((num_args) <= LE_APP_LOG_MAX_ARGS,   \
+                           "LE_APP_LOG() takes at most LE_APP_LOG_MAX_ARGS arguments"); char unused_; }))
+
+/* Records a log entry without formatting it. p_fmt must be a string literal,
+ * and every argument must fit in 32 bits; wrap strings with LE_APP_LOG_STR() */
+#define LE_APP_LOG(p_fmt, ...)                                                   \
+    (LE_APP_LOG_CHECK_NUM_ARGS(LE_APP_LOG_NUM_ARGS(__VA_ARGS__)),               \
+     le_app_log_write(LE_APP_LOG_NAME(p_fmt), LE_APP_LOG_NUM_ARGS(__VA_ARGS__), \
+                      (const uint32_t []){ 0, ##__VA_ARGS__ } + 1))
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+/* A string that can be logged: the string itself, or its token in tokenized mode */
+#if LE_APP_LOG_TOKENIZED
+typedef uint32_t le_app_log_str_t;
+#else
+typedef const char *le_app_log_str_t;
+#endif
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+
+/**************************************************************************************************
+* Function Name: le_app_log_init
+***************************************************************************************************
+* Summary:
+*   This function creates the low priority thread that drains the log ring.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  cy_rslt_t: CY_RSLT_SUCCESS if the log thread was created
+*
+**************************************************************************************************/
+cy_rslt_t le_app_log_init(void);
+
+/**************************************************************************************************
+* Function Name: le_app_log_write
+***************************************************************************************************
+* Summary:
+*   This function records a log entry in the ring. It never blocks; the entry is dropped and
+*   counted if the ring is full. Use the LE_APP_LOG() macro instead of calling it directly.
+*
+* Parameters:
+*   le_app_log_str_t fmt       : printf format string from LE_APP_LOG_NAME()
+*   uint32_t num_args          : Number of arguments, at most LE_APP_LOG_MAX_ARGS
+*   const uint32_t *p_args     : Arguments of the format string
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_log_write(le_app_log_str_t fmt, uint32_t num_args, const uint32_t *p_args);
+
+/**************************************************************************************************
+* Function Name: le_app_log_get_dropped
+***************************************************************************************************
+* Summary:
+*   This function returns the number of entries dropped because the ring was full.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  uint32_t: Number of dropped entries since boot
+*
+**************************************************************************************************/
+uint32_t le_app_log_get_dropped(void);
+
+#endif /* LE_APP_LOG_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,117 @@
+/* Generated by tools/le_app_detokenize.py --header. Do not edit.
+ *
+ * LE_APP_LOG_TOKEN(str) is the 65599 hash of a string literal, seeded with its
+ * length and taken over its first 96 characters. The compiler folds it into a
+ * constant, so no string is needed on the device to compute it. */
+#ifndef LE_APP_LOG_TOKEN_H_
+#define LE_APP_LOG_TOKEN_H_
+
+#include <stdint.h>
+
+#define LE_APP_LOG_TOKEN_HASH_LENGTH    (96u)
+
+#define LE_APP_LOG_TOKEN_CHAR(str, index) \
+    ((uint32_t)(uint8_t)((sizeof(str) > (index)) ? (str)[index] : 0))
+
+/* str must be a string literal */
+#define LE_APP_LOG_TOKEN(str) ((uint32_t)(sizeof(str "") - 1u + \
+    0x0001003fu * LE_APP_LOG_TOKEN_CHAR(str, 0u) + \
+    0x007e0f81u * LE_APP_LOG_TOKEN_CHAR(str, 1u) + \
+    0x2e86d0bfu * LE_APP_LOG_TOKEN_CHAR(str, 2u) + \
+    0x43ec5f01u * LE_APP_LOG_TOKEN_CHAR(str, 3u) + \
+    0x162c613fu * LE_APP_LOG_TOKEN_CHAR(str, 4u) + \
+    0xd62aee81u * LE_APP_LOG_TOKEN_CHAR(str, 5u) + \
+    0xa311b1bfu * LE_APP_LOG_TOKEN_CHAR(str, 6u) + \
+    0xd319be01u * LE_APP_LOG_TOKEN_CHAR(str, 7u) + \
+    0xb156c23fu * LE_APP_LOG_TOKEN_CHAR(str, 8u) + \
+    0x6698cd81u * LE_APP_LOG_TOKEN_CHAR(str, 9u) + \
+    0x0d1b92bfu * LE_APP_LOG_TOKEN_CHAR(str, 10u) + \
+    0xcc881d01u * LE_APP_LOG_TOKEN_CHAR(str, 11u) + \
+    0x7280233fu * LE_APP_LOG_TOKEN_CHAR(str, 12u) + \
+    0x50c7ac81u * LE_APP_LOG_TOKEN_CHAR(str, 13u) + \
+    0x8da473bfu * LE_APP_LOG_TOKEN_CHAR(str, 14u) + \
+    0x4f377c01u * LE_APP_LOG_TOKEN_CHAR(str, 15u) + \
+    0xfaa8843fu * LE_APP_LOG_TOKEN_CHAR(str, 16u) + \
+    0x33b78b81u * LE_APP_LOG_TOKEN_CHAR(str, 17u) + \
+    0x45ac54bfu * LE_APP_LOG_TOKEN_CHAR(str, 18u) + \
+    0x7a27db01u * LE_APP_LOG_TOKEN_CHAR(str, 19u) + \
+    0xeacfe53fu * LE_APP_LOG_TOKEN_CHAR(str, 20u) + \
+    0xae686a81u * LE_APP_LOG_TOKEN_CHAR(str, 21u) + \
+    0x563335bfu * LE_APP_LOG_TOKEN_CHAR(str, 22u) + \
+    0x6c593a01u * LE_APP_LOG_TOKEN_CHAR(str, 23u) + \
+    0xe3f6463fu * LE_APP_LOG_TOKEN_CHAR(str, 24u) + \
+    0x5fda4981u * LE_APP_LOG_TOKEN_CHAR(str, 25u) + \
+    0xe03916bfu * LE_APP_LOG_TOKEN_CHAR(str, 26u) + \
+    0x44cb9901u * LE_APP_LOG_TOKEN_CHAR(str, 27u) + \
+    0x871ba73fu * LE_APP_LOG_TOKEN_CHAR(str, 28u) + \
+    0xe70d2881u * LE_APP_LOG_TOKEN_CHAR(str, 29u) + \
+    0x04bdf7bfu * LE_APP_LOG_TOKEN_CHAR(str, 30u) + \
+    0x227ef801u * LE_APP_LOG_TOKEN_CHAR(str, 31u) + \
+    0x7540083fu * LE_APP_LOG_TOKEN_CHAR(str, 32u) + \
+    0xe3010781u * LE_APP_LOG_TOKEN_CHAR(str, 33u) + \
+    0xe4c1d8bfu * LE_APP_LOG_TOKEN_CHAR(str, 34u) + \
+    0x24735701u * LE_APP_LOG_TOKEN_CHAR(str, 35u) + \
+    0x4f63693fu * LE_APP_LOG_TOKEN_CHAR(str, 36u) + \
+    0xf2b5e681u * LE_APP_LOG_TOKEN_CHAR(str, 37u) + \
+    0xa144b9bfu * LE_APP_LOG_TOKEN_CHAR(str, 38u) + \
+    0x69a8b601u * LE_APP_LOG_TOKEN_CHAR(str, 39u) + \
+    0xb685ca3fu * LE_APP_LOG_TOKEN_CHAR(str, 40u) + \
+    0xb52bc581u * LE_APP_LOG_TOKEN_CHAR(str, 41u) + \
+    0x5b469abfu * LE_APP_LOG_TOKEN_CHAR(str, 42u) + \
+    0x111f1501u * LE_APP_LOG_TOKEN_CHAR(str, 43u) + \
+    0x4ba72b3fu * LE_APP_LOG_TOKEN_CHAR(str, 44u) + \
+    0xc962a481u * LE_APP_LOG_TOKEN_CHAR(str, 45u) + \
+    0x33c77bbfu * LE_APP_LOG_TOKEN_CHAR(str, 46u) + \
+    0x39d67401u * LE_APP_LOG_TOKEN_CHAR(str, 47u) + \
+    0xafc78c3fu * LE_APP_LOG_TOKEN_CHAR(str, 48u) + \
+    0xce5a8381u * LE_APP_LOG_TOKEN_CHAR(str, 49u) + \
+    0x4bc75cbfu * LE_APP_LOG_TOKEN_CHAR(str, 50u) + \
+    0x02ced301u * LE_APP_LOG_TOKEN_CHAR(str, 51u) + \
+    0x83e6ed3fu * LE_APP_LOG_TOKEN_CHAR(str, 52u) + \
+    0x63136281u * LE_APP_LOG_TOKEN_CHAR(str, 53u) + \
+    0xc4463dbfu * LE_APP_LOG_TOKEN_CHAR(str, 54u) + \
+    0x8b083201u * LE_APP_LOG_TOKEN_CHAR(str, 55u) + \
+    0x69054e3fu * LE_APP_LOG_TOKEN_CHAR(str, 56u) + \
+    0x268d4181u * LE_APP_LOG_TOKEN_CHAR(str, 57u) + \
+    0xbe441ebfu * LE_APP_LOG_TOKEN_CHAR(str, 58u) + \
+    0xf1829101u * LE_APP_LOG_TOKEN_CHAR(str, 59u) + \
+    0x0022af3fu * LE_APP_LOG_TOKEN_CHAR(str, 60u) + \
+    0xb7c82081u * LE_APP_LOG_TOKEN_CHAR(str, 61u) + \
+    0x5ac0ffbfu * LE_APP_LOG_TOKEN_CHAR(str, 62u) + \
+    0x553df001u * LE_APP_LOG_TOKEN_CHAR(str, 63u) + \
+    0xea3f103fu * LE_APP_LOG_TOKEN_CHAR(str, 64u) + \
+    0xb5c3ff81u * LE_APP_LOG_TOKEN_CHAR(str, 65u) + \
+    0xbabce0bfu * LE_APP_LOG_TOKEN_CHAR(str, 66u) + \
+    0xd53a4f01u * LE_APP_LOG_TOKEN_CHAR(str, 67u) + \
+    0xc85a713fu * LE_APP_LOG_TOKEN_CHAR(str, 68u) + \
+    0xbf80de81u * LE_APP_LOG_TOKEN_CHAR(str, 69u) + \
+    0xff37c1bfu * LE_APP_LOG_TOKEN_CHAR(str, 70u) + \
+    0x9077ae01u * LE_APP_LOG_TOKEN_CHAR(str, 71u) + \
+    0x3b74d23fu * LE_APP_LOG_TOKEN_CHAR(str, 72u) + \
+    0x73febd81u * LE_APP_LOG_TOKEN_CHAR(str, 73u) + \
+    0x4931a2bfu * LE_APP_LOG_TOKEN_CHAR(str, 74u) + \
+    0xa5f60d01u * LE_APP_LOG_TOKEN_CHAR(str, 75u) + \
+    0xe48e333fu * LE_APP_LOG_TOKEN_CHAR(str, 76u) + \
+    0x723d9c81u * LE_APP_LOG_TOKEN_CHAR(str, 77u) + \
+    0xb9aa83bfu * LE_APP_LOG_TOKEN_CHAR(str, 78u) + \
+    0x34b56c01u * LE_APP_LOG_TOKEN_CHAR(str, 79u) + \
+    0x64a6943fu * LE_APP_LOG_TOKEN_CHAR(str, 80u) + \
+    0x593d7b81u * LE_APP_LOG_TOKEN_CHAR(str, 81u) + \
+    0x71a264bfu * LE_APP_LOG_TOKEN_CHAR(str, 82u) + \
+    0x5bb5cb01u * LE_APP_LOG_TOKEN_CHAR(str, 83u) + \
+    0x5cbdf53fu * LE_APP_LOG_TOKEN_CHAR(str, 84u) + \
+    0xc7fe5a81u * LE_APP_LOG_TOKEN_CHAR(str, 85u) + \
+    0x921945bfu * LE_APP_LOG_TOKEN_CHAR(str, 86u) + \
+    0x39f72a01u * LE_APP_LOG_TOKEN_CHAR(str, 87u) + \
+    0x6dd4563fu * LE_APP_LOG_TOKEN_CHAR(str, 88u) + \
+    0x5d803981u * LE_APP_LOG_TOKEN_CHAR(str, 89u) + \
+    0x3c0f26bfu * LE_APP_LOG_TOKEN_CHAR(str, 90u) + \
+    0xee798901u * LE_APP_LOG_TOKEN_CHAR(str, 91u) + \
+    0x38e9b73fu * LE_APP_LOG_TOKEN_CHAR(str, 92u) + \
+    0xb8c31881u * LE_APP_LOG_TOKEN_CHAR(str, 93u) + \
+    0x908407bfu * LE_APP_LOG_TOKEN_CHAR(str, 94u) + \
+    0x983ce801u * LE_APP_LOG_TOKEN_CHAR(str, 95u)))
+
+#endif /* LE_APP_LOG_TOKEN_H_ */
+
+/* [] END OF FILE */
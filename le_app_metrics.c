@@ -0,0 +1,349 @@
+/*******************************************************************************
+ * File Name: le_app_metrics.c
+ *
+ * Description:
+ *   This file contains the optional metrics service. Counters are updated with a
+ *   single relaxed atomic increment and copied into the Snapshot characteristic
+ *   when a client reads it.
+ *
+ * Related Document: See Readme.md
+ *
+ *******************************************************************************
+ * Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/*******************************************************************************
+ *        Header Files
+ *******************************************************************************/
+#include "le_app_metrics.h"
+#include "le_app_gatts.h"
+#include "le_app_utils.h"
+#include "le_app_conn.h"
+#include "cyabs_rtos.h"
+#include <string.h>
+
+/* The service is optional; build with METRICS_SERVICE=1 to add it */
+#if LE_APP_METRICS_ENABLE
+
+/*******************************************************************************
+ *        Variable Definitions
+ *******************************************************************************/
+static const uint8_t le_app_metrics_db[] =
+{
+    PRIMARY_SERVICE_UUID128(HDLS_METRICS, __UUID_SERVICE_METRICS),
+
+    CHARACTERISTIC_UUID128(HDLC_METRICS_SNAPSHOT, HDLC_METRICS_SNAPSHOT_VALUE,
+                           __UUID_CHARACTERISTIC_METRICS_SNAPSHOT,
+                           GATTDB_CHAR_PROP_READ, GATTDB_PERM_READABLE),
+};
+
+static uint8_t le_app_metrics_snapshot_value[sizeof(le_app_metrics_snapshot_t)];
+
+static gatt_db_lookup_table_t le_app_metrics_attrs[] =
+{
+    {HDLC_METRICS_SNAPSHOT_VALUE, sizeof(le_app_metrics_snapshot_value),
+     sizeof(le_app_metrics_snapshot_value), le_app_metrics_snapshot_value},
+};
+
+const le_app_gatts_service_t le_app_metrics_service =
+{
+    .p_db = le_app_metrics_db,
+    .db_len = sizeof(le_app_metrics_db),
+    .p_attrs = le_app_metrics_attrs,
+    .num_attrs = sizeof(le_app_metrics_attrs) / sizeof(le_app_metrics_attrs[0]),
+};
+
+le_app_metrics_counters_t le_app_metrics_counters;
+
+/* Advertising and connection state times. Only the Bluetooth stack context reads or writes these */
+static app_bt_adv_conn_mode_t le_app_metrics_state;
+static cy_time_t le_app_metrics_state_start;
+static uint32_t le_app_metrics_state_ms[LE_APP_METRICS_ADV_CONN_STATES];
+
+/* Connections in the middle of a long read of the snapshot. The snapshot is only refreshed while
+ * no other connection is reading it, so every part of a long read comes from one snapshot */
+static struct
+{
+    wiced_bool_t in_use;
+    uint16_t conn_id;
+    cy_time_t start_ms;
+} le_app_metrics_readers[LE_APP_MAX_CONNECTIONS];
+
+/*******************************************************************************
+ *        Constant Definitions
+ *******************************************************************************/
+/* Request counter of each opcode, matching the handlers of the GATT server */
+const uint8_t le_app_metrics_opcode_slots[LE_APP_METRICS_OPCODE_TABLE_SIZE] =
+{
+    [GATT_REQ_MTU]                      = LE_APP_METRICS_REQ_MTU,
+    [GATT_REQ_READ_BY_TYPE]             = LE_APP_METRICS_REQ_READ_BY_TYPE,
+    [GATT_REQ_READ]                     = LE_APP_METRICS_REQ_READ,
+    [GATT_REQ_READ_BLOB]                = LE_APP_METRICS_REQ_READ,
+    [GATT_REQ_READ_MULTI]               = LE_APP_METRICS_REQ_READ_MULTI,
+    [GATT_REQ_WRITE]                    = LE_APP_METRICS_REQ_WRITE,
+    [GATT_REQ_PREPARE_WRITE]            = LE_APP_METRICS_REQ_PREPARE_WRITE,
+    [GATT_REQ_EXECUTE_WRITE]            = LE_APP_METRICS_REQ_EXECUTE_WRITE,
+    [GATT_HANDLE_VALUE_CONF]            = LE_APP_METRICS_REQ_CONF,
+    [GATT_REQ_READ_MULTI_VAR_LENGTH]    = LE_APP_METRICS_REQ_READ_MULTI,
+    [GATT_CMD_WRITE]                    = LE_APP_METRICS_REQ_WRITE_CMD,
+};
+
+/*******************************************************************************
+ *        Function Prototypes
+ *******************************************************************************/
+static wiced_bt_gatt_status_t le_app_metrics_snapshot_read(uint16_t conn_id, uint16_t attr_handle,
+                                                           uint16_t offset);
+
+/*******************************************************************************
+ *        Function Definitions
+ *******************************************************************************/
+
+/**************************************************************************************************
+ * Function Name: le_app_metrics_init
+ ***************************************************************************************************
+ * Summary:
+ *   This function clears the counters and registers the read callback of the Snapshot
+ *   characteristic.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: See possible status codes in wiced_bt_gatt_status_e in wiced_bt_gatt.h
+ *
+ **************************************************************************************************/
+wiced_bt_gatt_status_t le_app_metrics_init(void)
+{
+    memset(&le_app_metrics_counters, 0, sizeof(le_app_metrics_counters));
+    memset(le_app_metrics_state_ms, 0, sizeof(le_app_metrics_state_ms));
+    memset(le_app_metrics_readers, 0, sizeof(le_app_metrics_readers));
+    le_app_metrics_state = APP_BT_ADV_OFF_CONN_OFF;
+    cy_rtos_get_time(&le_app_metrics_state_start);
+
+    return le_app_gatts_register_handle(HDLC_METRICS_SNAPSHOT_VALUE, le_app_metrics_snapshot_read, NULL, NULL);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_metrics_on_disconnect
+ ***************************************************************************************************
+ * Summary:
+ *   This function counts a disconnection in the group of its reason.
+ *
+ * Parameters:
+ *   wiced_bt_gatt_disconn_reason_t reason : Reason reported by the stack
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_metrics_on_disconnect(wiced_bt_gatt_disconn_reason_t reason)
+{
+    switch ((int)reason)
+    {
+    case GATT_CONN_TERMINATE_PEER_USER:
+        LE_APP_METRICS_INC(disconnects[LE_APP_METRICS_DISCONN_PEER]);
+        break;
+
+    case GATT_CONN_TERMINATE_LOCAL_HOST:
+        LE_APP_METRICS_INC(disconnects[LE_APP_METRICS_DISCONN_LOCAL]);
+        break;
+
+    case GATT_CONN_TIMEOUT:
+    case GATT_CONN_LMP_TIMEOUT:
+        LE_APP_METRICS_INC(disconnects[LE_APP_METRICS_DISCONN_TIMEOUT]);
+        break;
+
+    case GATT_CONN_L2C_FAILURE:
+    case GATT_CONN_FAIL_ESTABLISH:
+    case GATT_CONN_CANCEL:
+        LE_APP_METRICS_INC(disconnects[LE_APP_METRICS_DISCONN_FAILURE]);
+        break;
+
+    default:
+        LE_APP_METRICS_INC(disconnects[LE_APP_METRICS_DISCONN_OTHER]);
+        break;
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_metrics_set_adv_conn_state
+ ***************************************************************************************************
+ * Summary:
+ *   This function adds the time spent in the previous advertising and connection state to its
+ *   total. It must be called from the Bluetooth stack context on every state change.
+ *
+ * Parameters:
+ *   app_bt_adv_conn_mode_t state        : New state
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_metrics_set_adv_conn_state(app_bt_adv_conn_mode_t state)
+{
+    cy_time_t now = 0;
+
+    cy_rtos_get_time(&now);
+    le_app_metrics_state_ms[le_app_metrics_state] += now - le_app_metrics_state_start;
+    le_app_metrics_state = state;
+    le_app_metrics_state_start = now;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_metrics_get_snapshot
+ ***************************************************************************************************
+ * Summary:
+ *   This function fills a snapshot of the counters. It must be called from the Bluetooth stack
+ *   context, which owns the state times.
+ *
+ * Parameters:
+ *   le_app_metrics_snapshot_t *p_snapshot : Destination of the snapshot
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_metrics_get_snapshot(le_app_metrics_snapshot_t *p_snapshot)
+{
+    app_buffer_pool_stats_t pool_stats;
+    cy_time_t now = 0;
+    uint32_t i;
+
+    cy_rtos_get_time(&now);
+    app_buffer_pool_get_stats(&pool_stats);
+
+    p_snapshot->version = LE_APP_METRICS_VERSION;
+    p_snapshot->size = sizeof(le_app_metrics_snapshot_t);
+    p_snapshot->uptime_ms = now;
+
+    for (i = 0; i < LE_APP_METRICS_REQ_COUNT; i++)
+    {
+        p_snapshot->gatt_requests[i] = atomic_load_explicit(&le_app_metrics_counters.gatt_requests[i],
+                                                            memory_order_relaxed);
+    }
+    p_snapshot->error_responses = atomic_load_explicit(&le_app_metrics_counters.error_responses,
+                                                       memory_order_relaxed);
+    p_snapshot->buffer_alloc_failures = pool_stats.alloc_failures;
+    p_snapshot->buffer_high_water = pool_stats.high_water;
+    p_snapshot->connects = atomic_load_explicit(&le_app_metrics_counters.connects, memory_order_relaxed);
+    for (i = 0; i < LE_APP_METRICS_DISCONN_COUNT; i++)
+    {
+        p_snapshot->disconnects[i] = atomic_load_explicit(&le_app_metrics_counters.disconnects[i],
+                                                          memory_order_relaxed);
+    }
+    p_snapshot->adv_restarts = atomic_load_explicit(&le_app_metrics_counters.adv_restarts,
+                                                    memory_order_relaxed);
+
+    /* The current state has run since its last change */
+    memcpy(p_snapshot->adv_conn_state_ms, le_app_metrics_state_ms, sizeof(le_app_metrics_state_ms));
+    p_snapshot->adv_conn_state_ms[le_app_metrics_state] += now - le_app_metrics_state_start;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_metrics_snapshot_read
+ ***************************************************************************************************
+ * Summary:
+ *   This function takes a snapshot into the Snapshot characteristic before a client reads it.
+ *   The Read Blob requests of a long read leave it alone, and so does a read by one client
+ *   while another is in the middle of a long read, so all parts come from one snapshot.
+ *
+ * Parameters:
+ *   uint16_t conn_id            : Connection ID of the reader
+ *   uint16_t attr_handle        : HDLC_METRICS_SNAPSHOT_VALUE
+ *   uint16_t offset             : Offset of the read
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_SUCCESS
+ *
+ **************************************************************************************************/
+static wiced_bt_gatt_status_t le_app_metrics_snapshot_read(uint16_t conn_id, uint16_t attr_handle,
+                                                           uint16_t offset)
+{
+    le_app_metrics_snapshot_t snapshot;
+    le_app_conn_t *p_conn = le_app_conn_find(conn_id);
+    wiced_bool_t busy = WICED_FALSE;
+    uint32_t slot = LE_APP_MAX_CONNECTIONS;
+    cy_time_t start_ms;
+    cy_time_t now = 0;
+
+    cy_rtos_get_time(&now);
+    start_ms = now;
+
+    for (uint32_t i = 0; i < LE_APP_MAX_CONNECTIONS; i++)
+    {
+        if (!le_app_metrics_readers[i].in_use)
+        {
+            slot = MIN(slot, i);
+        }
+        else if (conn_id == le_app_metrics_readers[i].conn_id)
+        {
+            /* A Read Blob continues the long read; a new read starts over */
+            if (0 != offset)
+            {
+                start_ms = le_app_metrics_readers[i].start_ms;
+            }
+            le_app_metrics_readers[i].in_use = WICED_FALSE;
+            slot = MIN(slot, i);
+        }
+        else if ((now - le_app_metrics_readers[i].start_ms) < LE_APP_METRICS_LONG_READ_MS)
+        {
+            busy = WICED_TRUE;
+        }
+        else
+        {
+            /* Abandoned, or the client disconnected */
+            le_app_metrics_readers[i].in_use = WICED_FALSE;
+            slot = MIN(slot, i);
+        }
+    }
+
+    if ((0 == offset) && !busy)
+    {
+        le_app_metrics_get_snapshot(&snapshot);
+        memcpy(le_app_metrics_snapshot_value, &snapshot, sizeof(snapshot));
+    }
+
+    /* Each response carries up to MTU - 1 bytes; the client reads on while more are left */
+    if ((NULL != p_conn) && (LE_APP_MAX_CONNECTIONS > slot) &&
+        (((uint32_t)offset + p_conn->mtu - 1u) < sizeof(le_app_metrics_snapshot_value)))
+    {
+        le_app_metrics_readers[slot].in_use = WICED_TRUE;
+        le_app_metrics_readers[slot].conn_id = conn_id;
+        le_app_metrics_readers[slot].start_ms = start_ms;
+    }
+
+    return WICED_BT_GATT_SUCCESS;
+}
+
+#endif /* LE_APP_METRICS_ENABLE */
+
+/* [] END OF FILE */
@@ -0,0 +1,246 @@
+/*******************************************************************************
+* File Name: le_app_metrics.h
+*
+* Description:
+*   This file contains the counters and the snapshot layout of the optional
+*   metrics service.
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef LE_APP_METRICS_H_
+#define LE_APP_METRICS_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_gatt.h"
+#include "le_app_gatts.h"
+#include "le_app_user_interface.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Set to 1 to add the metrics service to the GATT database */
+#ifndef LE_APP_METRICS_ENABLE
+#define LE_APP_METRICS_ENABLE               (0)
+#endif
+
+/* Attribute handles of the service, which follows the generated database and the
+ * throughput test service */
+#define HDLS_METRICS                        (0x0110u)
+#define HDLC_METRICS_SNAPSHOT               (0x0111u)
+#define HDLC_METRICS_SNAPSHOT_VALUE         (0x0112u)
+
+/* UUIDs 1c5e01xx-5a2b-4e3f-9d7c-2f1a8b6c4d90, least significant byte first */
+#define __UUID_METRICS(id)  0x90, 0x4D, 0x6C, 0x8B, 0x1A, 0x2F, 0x7C, 0x9D, \
+                            0x3F, 0x4E, 0x2B, 0x5A, (id), 0x01, 0x5E, 0x1C
+#define __UUID_SERVICE_METRICS                  __UUID_METRICS(0x01)
+#define __UUID_CHARACTERISTIC_METRICS_SNAPSHOT  __UUID_METRICS(0x02)
+
+/* Layout version in the Snapshot characteristic. Bump it when the snapshot changes */
+#define LE_APP_METRICS_VERSION              (1u)
+
+/* Size of the opcode to request counter map; GATT_CMD_WRITE is the largest opcode handled */
+#define LE_APP_METRICS_OPCODE_TABLE_SIZE    (GATT_CMD_WRITE + 1)
+
+/* Number of app_bt_adv_conn_mode_t states */
+#define LE_APP_METRICS_ADV_CONN_STATES      (APP_BT_ADV_ON_CONN_ON + 1)
+
+/* A long read of the snapshot that has not finished within this time no longer holds back
+ * the refresh for other clients */
+#define LE_APP_METRICS_LONG_READ_MS         (1000u)
+
+/* The service is optional; build with METRICS_SERVICE=1 to add it, else the hooks compile
+ * to nothing */
+#if LE_APP_METRICS_ENABLE
+#include <stdatomic.h>
+
+/* Adds one to a counter of le_app_metrics_counters. This is the only work done on the hot path */
+#define LE_APP_METRICS_INC(counter) \
+    ((void)atomic_fetch_add_explicit(&le_app_metrics_counters.counter, 1u, memory_order_relaxed))
+
+/* Counts an attribute request by its opcode */
+#define LE_APP_METRICS_INC_GATT_REQUEST(opcode) \
+    LE_APP_METRICS_INC(gatt_requests[(LE_APP_METRICS_OPCODE_TABLE_SIZE > (opcode)) ? \
+                                     le_app_metrics_opcode_slots[(opcode)] : LE_APP_METRICS_REQ_OTHER])
+#else
+#define LE_APP_METRICS_INC(counter)
+#define LE_APP_METRICS_INC_GATT_REQUEST(opcode)
+#endif
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+/* Attribute request counters. Requests that share a handler share a counter */
+typedef enum
+{
+    LE_APP_METRICS_REQ_OTHER,           /* Opcodes without a handler, and notifications */
+    LE_APP_METRICS_REQ_MTU,             /* Exchange MTU */
+    LE_APP_METRICS_REQ_READ,            /* Read and Read Blob */
+    LE_APP_METRICS_REQ_READ_BY_TYPE,    /* Read By Type */
+    LE_APP_METRICS_REQ_READ_MULTI,      /* Read Multiple and Read Multiple Variable Length */
+    LE_APP_METRICS_REQ_WRITE,           /* Write Request */
+    LE_APP_METRICS_REQ_WRITE_CMD,       /* Write Command */
+    LE_APP_METRICS_REQ_PREPARE_WRITE,   /* Prepare Write */
+    LE_APP_METRICS_REQ_EXECUTE_WRITE,   /* Execute Write */
+    LE_APP_METRICS_REQ_CONF,            /* Handle Value Confirmation */
+    LE_APP_METRICS_REQ_COUNT
+} le_app_metrics_req_t;
+
+/* Disconnection reasons, grouped as get_bt_gatt_disconn_reason_name() names them */
+typedef enum
+{
+    LE_APP_METRICS_DISCONN_OTHER,       /* GATT_CONN_UNKNOWN and unlisted reasons */
+    LE_APP_METRICS_DISCONN_PEER,        /* GATT_CONN_TERMINATE_PEER_USER */
+    LE_APP_METRICS_DISCONN_LOCAL,       /* GATT_CONN_TERMINATE_LOCAL_HOST */
+    LE_APP_METRICS_DISCONN_TIMEOUT,     /* GATT_CONN_TIMEOUT and GATT_CONN_LMP_TIMEOUT */
+    LE_APP_METRICS_DISCONN_FAILURE,     /* GATT_CONN_L2C_FAILURE, GATT_CONN_FAIL_ESTABLISH and GATT_CONN_CANCEL */
+    LE_APP_METRICS_DISCONN_COUNT
+} le_app_metrics_disconn_t;
+
+#if LE_APP_METRICS_ENABLE
+/* Counters updated from any context with LE_APP_METRICS_INC() */
+typedef struct
+{
+    atomic_uint gatt_requests[LE_APP_METRICS_REQ_COUNT];
+    atomic_uint error_responses;        /* Error Responses sent by le_app_gatts_send_error_rsp() */
+    atomic_uint connects;
+    atomic_uint disconnects[LE_APP_METRICS_DISCONN_COUNT];
+    atomic_uint adv_restarts;           /* Advertising started by le_app_adv_start() or directed advertising */
+} le_app_metrics_counters_t;
+#endif
+
+/* Value of the Snapshot characteristic. All fields are little endian and 32 bit aligned, so the
+ * struct has no padding */
+typedef struct
+{
+    uint16_t version;                   /* LE_APP_METRICS_VERSION */
+    uint16_t size;                      /* Size of the snapshot in bytes */
+    uint32_t uptime_ms;                 /* Time of the snapshot */
+    uint32_t gatt_requests[LE_APP_METRICS_REQ_COUNT];
+    uint32_t error_responses;
+    uint32_t buffer_alloc_failures;     /* From app_buffer_pool_get_stats() */
+    uint32_t buffer_high_water;         /* From app_buffer_pool_get_stats() */
+    uint32_t connects;
+    uint32_t disconnects[LE_APP_METRICS_DISCONN_COUNT];
+    uint32_t adv_restarts;
+    uint32_t adv_conn_state_ms[LE_APP_METRICS_ADV_CONN_STATES]; /* Time in each app_bt_adv_conn_mode_t */
+} le_app_metrics_snapshot_t;
+
+/*******************************************************************************
+*        External Variable Declarations
+*******************************************************************************/
+#if LE_APP_METRICS_ENABLE
+/* Service added to the GATT database by le_app_gatts_init() */
+extern const le_app_gatts_service_t le_app_metrics_service;
+extern le_app_metrics_counters_t le_app_metrics_counters;
+extern const uint8_t le_app_metrics_opcode_slots[LE_APP_METRICS_OPCODE_TABLE_SIZE];
+#endif
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+#if LE_APP_METRICS_ENABLE
+
+/**************************************************************************************************
+* Function Name: le_app_metrics_init
+***************************************************************************************************
+* Summary:
+*   This function clears the counters and registers the read callback of the Snapshot
+*   characteristic.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  wiced_bt_gatt_status_t: See possible status codes in wiced_bt_gatt_status_e in wiced_bt_gatt.h
+*
+**************************************************************************************************/
+wiced_bt_gatt_status_t le_app_metrics_init(void);
+
+/**************************************************************************************************
+* Function Name: le_app_metrics_on_disconnect
+***************************************************************************************************
+* Summary:
+*   This function counts a disconnection in the group of its reason.
+*
+* Parameters:
+*   wiced_bt_gatt_disconn_reason_t reason : Reason reported by the stack
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_metrics_on_disconnect(wiced_bt_gatt_disconn_reason_t reason);
+
+/**************************************************************************************************
+* Function Name: le_app_metrics_set_adv_conn_state
+***************************************************************************************************
+* Summary:
+*   This function adds the time spent in the previous advertising and connection state to its
+*   total. It must be called from the Bluetooth stack context on every state change.
+*
+* Parameters:
+*   app_bt_adv_conn_mode_t state        : New state
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_metrics_set_adv_conn_state(app_bt_adv_conn_mode_t state);
+
+/**************************************************************************************************
+* Function Name: le_app_metrics_get_snapshot
+***************************************************************************************************
+* Summary:
+*   This function fills a snapshot of the counters. It must be called from the Bluetooth stack
+*   context, which owns the state times. Each counter is read once, so counters that change
+*   while the snapshot is taken may be one event apart.
+*
+* Parameters:
+*   le_app_metrics_snapshot_t *p_snapshot : Destination of the snapshot
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_metrics_get_snapshot(le_app_metrics_snapshot_t *p_snapshot);
+
+#endif /* LE_APP_METRICS_ENABLE */
+
+#endif /* LE_APP_METRICS_H_ */
+
+/* [] END OF FILE */
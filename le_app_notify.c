@@ -0,0 +1,569 @@
+/*******************************************************************************
+ * File Name: le_app_notify.c
+ *
+ * Description:
+ *   Source file for the notification and indication scheduler
+ *
+ * Related Document: See Readme.md
+ *
+ *******************************************************************************
+ * Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/*******************************************************************************
+ *        Header Files
+ *******************************************************************************/
+#include "le_app_notify.h"
+#include "le_app_conn.h"
+#include "le_app_gatts.h"
+#include "le_app_utils.h"
+#include "le_app_log.h"
+#include "wiced_timer.h"
+#include <string.h>
+
+/*******************************************************************************
+ *        Macro Definitions
+ *******************************************************************************/
+/* The connection ID is stored in front of the value in each pool buffer, so the
+ * credit can be returned to the connection when the stack frees the buffer */
+#define LE_APP_NOTIFY_HDR_SIZE          (2u)
+
+/* ATT opcode and handle in front of the value of a notification or indication */
+#define LE_APP_NOTIFY_ATT_HDR_SIZE      (3u)
+
+/* The credits of all connections must leave pool blocks for responses */
+#if ((LE_APP_NOTIFY_CREDITS * LE_APP_MAX_CONNECTIONS) >= APP_BUFFER_POOL_BLOCK_COUNT)
+#error "LE_APP_NOTIFY_CREDITS of every connection must fit in APP_BUFFER_POOL_BLOCK_COUNT"
+#endif
+
+/*******************************************************************************
+ *        Structures and Enumerations
+ *******************************************************************************/
+typedef struct
+{
+    uint16_t attr_handle;           /* 0 when the entry is unused */
+    le_app_notify_fill_t p_fill;
+} le_app_notify_source_t;
+
+/*******************************************************************************
+ *        Variable Definitions
+ *******************************************************************************/
+static le_app_notify_source_t le_app_notify_sources[LE_APP_NOTIFY_MAX_SOURCES];
+
+/* Set while a queue is pumped. A pump or resume requested meanwhile, for example by a fill
+ * function, is marked pending and runs once the pass is done */
+static wiced_bool_t le_app_notify_pumping;
+static wiced_bool_t le_app_notify_resume_pending;
+
+/* Resumes the queues after a send failed with no buffer in flight */
+static wiced_timer_t le_app_notify_retry_timer;
+
+/*******************************************************************************
+ *        Function Prototypes
+ *******************************************************************************/
+static void le_app_notify_pump(le_app_conn_t *p_conn);
+static void le_app_notify_pump_all(void);
+static wiced_bool_t le_app_notify_send(le_app_conn_t *p_conn, uint16_t attr_handle, wiced_bool_t indicate,
+                                       wiced_bool_t *p_more);
+static le_app_notify_fill_t le_app_notify_find_source(uint16_t attr_handle);
+static void le_app_notify_buffer_free(uint8_t *p_val);
+static void le_app_notify_retry(WICED_TIMER_PARAM_TYPE cb_params);
+
+/*******************************************************************************
+ *        Function Definitions
+ *******************************************************************************/
+
+/**************************************************************************************************
+ * Function Name: le_app_notify_init
+ ***************************************************************************************************
+ * Summary:
+ *   This function prepares the timer that resumes a notification queue the stack refused while
+ *   the connection had no buffer in flight.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  wiced_result_t: WICED_BT_SUCCESS, or the error of the timer initialization
+ *
+ **************************************************************************************************/
+wiced_result_t le_app_notify_init(void)
+{
+    return wiced_init_timer(&le_app_notify_retry_timer, le_app_notify_retry, NULL,
+                            WICED_MILLI_SECONDS_TIMER);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_notify_conn
+ ***************************************************************************************************
+ * Summary:
+ *   This function queues the value of a characteristic for one connection. If the handle is
+ *   already queued the update is merged with it, and the latest value is sent. Must be called
+ *   from the Bluetooth stack context.
+ *
+ * Parameters:
+ *   uint16_t conn_id            : Connection ID
+ *   uint16_t attr_handle        : Handle of the characteristic value
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_CCC_CFG_ERR if the peer has not enabled notifications
+ *                          or indications, WICED_BT_GATT_INSUF_RESOURCE if the queue is full
+ *
+ **************************************************************************************************/
+wiced_bt_gatt_status_t le_app_notify_conn(uint16_t conn_id, uint16_t attr_handle)
+{
+    le_app_conn_t *p_conn = le_app_conn_find(conn_id);
+    le_app_conn_cccd_t *p_cccd;
+    uint16_t cccd_handle = le_app_get_cccd_handle(attr_handle);
+
+    if (NULL == p_conn)
+    {
+        return WICED_BT_GATT_INVALID_CONNECTION_ID;
+    }
+
+    if (0 == cccd_handle)
+    {
+        return WICED_BT_GATT_INVALID_HANDLE;
+    }
+
+    p_cccd = le_app_conn_get_cccd(p_conn, cccd_handle);
+    if ((NULL == p_cccd) || (0 == p_cccd->value))
+    {
+        return WICED_BT_GATT_CCC_CFG_ERR;
+    }
+
+    for (uint32_t i = 0; i < p_conn->notify_count; i++)
+    {
+        if (attr_handle == p_conn->notify_queue[i])
+        {
+            p_conn->notify_coalesced++;
+            return WICED_BT_GATT_SUCCESS;
+        }
+    }
+
+    if (LE_APP_NOTIFY_QUEUE_SIZE <= p_conn->notify_count)
+    {
+        LE_APP_LOG("WARNING: Notification queue full, conn_id %d handle 0x%x\r\n", conn_id, attr_handle);
+        return WICED_BT_GATT_INSUF_RESOURCE;
+    }
+
+    p_conn->notify_queue[p_conn->notify_count++] = attr_handle;
+    le_app_notify_pump(p_conn);
+
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_notify_set_source
+ ***************************************************************************************************
+ * Summary:
+ *   This function makes the values of a characteristic come from a fill function instead of the
+ *   GATT database. A queued handle with a source is sent as long as the source has more data.
+ *
+ * Parameters:
+ *   uint16_t attr_handle        : Handle of the characteristic value
+ *   le_app_notify_fill_t p_fill : Fill function, NULL to remove the source
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_NO_RESOURCES if LE_APP_NOTIFY_MAX_SOURCES are in use
+ *
+ **************************************************************************************************/
+wiced_bt_gatt_status_t le_app_notify_set_source(uint16_t attr_handle, le_app_notify_fill_t p_fill)
+{
+    le_app_notify_source_t *p_free = NULL;
+
+    for (uint32_t i = 0; i < LE_APP_NOTIFY_MAX_SOURCES; i++)
+    {
+        if (attr_handle == le_app_notify_sources[i].attr_handle)
+        {
+            p_free = &le_app_notify_sources[i];
+            break;
+        }
+        if ((NULL == p_free) && (0 == le_app_notify_sources[i].attr_handle))
+        {
+            p_free = &le_app_notify_sources[i];
+        }
+    }
+
+    if (NULL == p_free)
+    {
+        return WICED_BT_GATT_NO_RESOURCES;
+    }
+
+    p_free->attr_handle = (NULL != p_fill) ? attr_handle : 0;
+    p_free->p_fill = p_fill;
+
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_notify_confirmed
+ ***************************************************************************************************
+ * Summary:
+ *   This function handles the Handle Value Confirmation of an indication and sends the next
+ *   queued indication of the connection.
+ *
+ * Parameters:
+ *   uint16_t conn_id            : Connection ID
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_notify_confirmed(uint16_t conn_id)
+{
+    le_app_conn_t *p_conn = le_app_conn_find(conn_id);
+
+    if (NULL != p_conn)
+    {
+        p_conn->indication_pending = WICED_FALSE;
+        le_app_notify_pump(p_conn);
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_notify_resume
+ ***************************************************************************************************
+ * Summary:
+ *   This function sends the queued handles that were waiting for a pool buffer or for the stack.
+ *   It is called for every GATT_APP_BUFFER_TRANSMITTED_EVT and when a connection is no longer
+ *   congested.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_notify_resume(void)
+{
+    le_app_notify_pump_all();
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_notify_pump
+ ***************************************************************************************************
+ * Summary:
+ *   This function sends queued handles of a connection while it has credits. Notifications need
+ *   a credit; an indication also waits for the confirmation of the previous one. Handles that
+ *   cannot be sent yet keep their place in the queue, handles whose CCCD was cleared are dropped.
+ *
+ * Parameters:
+ *   le_app_conn_t *p_conn       : Context of the connection
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_notify_pump(le_app_conn_t *p_conn)
+{
+    le_app_conn_cccd_t *p_cccd;
+    uint16_t attr_handle;
+    wiced_bool_t more;
+    wiced_bool_t stalled = WICED_FALSE;
+    uint32_t kept = 0;
+    uint32_t i;
+
+    if (le_app_notify_pumping)
+    {
+        le_app_notify_resume_pending = WICED_TRUE;
+        return;
+    }
+    le_app_notify_pumping = WICED_TRUE;
+
+    for (i = 0; i < p_conn->notify_count; i++)
+    {
+        attr_handle = p_conn->notify_queue[i];
+        p_cccd = le_app_conn_get_cccd(p_conn, le_app_get_cccd_handle(attr_handle));
+
+        if ((NULL == p_cccd) || (0 == p_cccd->value))
+        {
+            continue;
+        }
+
+        if (LE_APP_NOTIFY_CREDITS <= p_conn->notify_in_flight)
+        {
+            /* Out of credits; keep this and all following handles */
+            break;
+        }
+
+        more = WICED_FALSE;
+        if (p_cccd->value & GATT_CLIENT_CONFIG_NOTIFICATION)
+        {
+            /* A streamed handle uses every credit that is left */
+            do
+            {
+                stalled = !le_app_notify_send(p_conn, attr_handle, WICED_FALSE, &more);
+            } while (!stalled && more && (LE_APP_NOTIFY_CREDITS > p_conn->notify_in_flight));
+        }
+        else if (!p_conn->indication_pending)
+        {
+            stalled = !le_app_notify_send(p_conn, attr_handle, WICED_TRUE, &more);
+        }
+        else
+        {
+            more = WICED_TRUE;
+        }
+
+        if (stalled)
+        {
+            /* Without a buffer in flight no transmitted event will resume the queue */
+            if (0 == p_conn->notify_in_flight)
+            {
+                wiced_start_timer(&le_app_notify_retry_timer, LE_APP_NOTIFY_RETRY_MS);
+            }
+            break;
+        }
+        if (more)
+        {
+            p_conn->notify_queue[kept++] = attr_handle;
+        }
+    }
+
+    /* Move the handles that were not reached behind the ones that were kept */
+    for (; i < p_conn->notify_count; i++)
+    {
+        p_conn->notify_queue[kept++] = p_conn->notify_queue[i];
+    }
+    p_conn->notify_count = (uint8_t)kept;
+
+    le_app_notify_pumping = WICED_FALSE;
+
+    if (le_app_notify_resume_pending)
+    {
+        le_app_notify_resume_pending = WICED_FALSE;
+        le_app_notify_pump_all();
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_notify_pump_all
+ ***************************************************************************************************
+ * Summary:
+ *   This function pumps the queue of every connection. A freed pool buffer may unblock any of
+ *   them, not only the one it was sent on.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_notify_pump_all(void)
+{
+    le_app_conn_t *p_conn;
+
+    for (uint32_t i = 0; i < LE_APP_MAX_CONNECTIONS; i++)
+    {
+        p_conn = le_app_conn_get(i);
+        if ((NULL != p_conn) && (0 != p_conn->notify_count))
+        {
+            le_app_notify_pump(p_conn);
+        }
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_notify_send
+ ***************************************************************************************************
+ * Summary:
+ *   This function copies the current value of a characteristic into a pool buffer and hands it
+ *   to the stack as a notification or indication. Values longer than the MTU allows are
+ *   truncated.
+ *
+ * Parameters:
+ *   le_app_conn_t *p_conn       : Context of the connection
+ *   uint16_t attr_handle        : Handle of the characteristic value
+ *   wiced_bool_t indicate       : WICED_TRUE to send an indication
+ *
+ * Return:
+ *  wiced_bool_t: WICED_FALSE if no buffer is available or the stack refused the value
+ *
+ **************************************************************************************************/
+static wiced_bool_t le_app_notify_send(le_app_conn_t *p_conn, uint16_t attr_handle, wiced_bool_t indicate,
+                                       wiced_bool_t *p_more)
+{
+    wiced_bt_gatt_status_t gatt_status;
+    le_app_notify_fill_t p_fill = le_app_notify_find_source(attr_handle);
+    uint16_t max_len;
+    uint8_t *p_val = NULL;
+    uint16_t len = 0;
+    uint8_t *p_buf;
+
+    *p_more = WICED_FALSE;
+
+    max_len = MIN(p_conn->mtu - LE_APP_NOTIFY_ATT_HDR_SIZE, APP_BUFFER_POOL_BLOCK_SIZE - LE_APP_NOTIFY_HDR_SIZE);
+
+    if ((NULL == p_fill) &&
+        (WICED_BT_GATT_SUCCESS != le_app_get_value(p_conn->conn_id, attr_handle, 0, &p_val, &len)))
+    {
+        /* Nothing to send; report success so the handle is dropped */
+        return WICED_TRUE;
+    }
+
+    p_buf = app_alloc_buffer(LE_APP_NOTIFY_HDR_SIZE + ((NULL != p_fill) ? max_len : MIN(len, max_len)));
+    if (NULL == p_buf)
+    {
+        /* Retried through le_app_notify_resume() when a pool buffer is transmitted */
+        return WICED_FALSE;
+    }
+
+    p_buf[0] = (uint8_t)(p_conn->conn_id & 0xFF);
+    p_buf[1] = (uint8_t)(p_conn->conn_id >> 8);
+
+    if (NULL != p_fill)
+    {
+        len = p_fill(p_conn->conn_id, &p_buf[LE_APP_NOTIFY_HDR_SIZE], max_len, p_more);
+        if (0 == len)
+        {
+            /* The stream has ended */
+            app_free_buffer(p_buf);
+            *p_more = WICED_FALSE;
+            return WICED_TRUE;
+        }
+    }
+    else
+    {
+        len = MIN(len, max_len);
+        memcpy(&p_buf[LE_APP_NOTIFY_HDR_SIZE], p_val, len);
+    }
+
+    if (indicate)
+    {
+        gatt_status = wiced_bt_gatt_server_send_indication(p_conn->conn_id, attr_handle, len,
+                                                           &p_buf[LE_APP_NOTIFY_HDR_SIZE],
+                                                           (void *)le_app_notify_buffer_free);
+    }
+    else
+    {
+        gatt_status = wiced_bt_gatt_server_send_notification(p_conn->conn_id, attr_handle, len,
+                                                             &p_buf[LE_APP_NOTIFY_HDR_SIZE],
+                                                             (void *)le_app_notify_buffer_free);
+    }
+
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+        LE_APP_LOG("WARNING: Notification on handle 0x%x failed: 0x%x\r\n", attr_handle, gatt_status);
+        app_free_buffer(p_buf);
+        p_conn->notify_failures++;
+        /* A produced value cannot be put back; keep the stream queued for the next credit */
+        return WICED_FALSE;
+    }
+
+    p_conn->notify_in_flight++;
+    p_conn->notifications++;
+    if (indicate)
+    {
+        p_conn->indication_pending = WICED_TRUE;
+    }
+
+    return WICED_TRUE;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_notify_buffer_free
+ ***************************************************************************************************
+ * Summary:
+ *   This function is called through GATT_APP_BUFFER_TRANSMITTED_EVT when the stack no longer
+ *   needs a notification buffer. It returns the credit to its connection and frees the buffer;
+ *   the event handler then resumes the queues that were waiting for either.
+ *
+ * Parameters:
+ *   uint8_t *p_val              : Value passed to the stack, LE_APP_NOTIFY_HDR_SIZE bytes into
+ *                                 the pool buffer
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_notify_buffer_free(uint8_t *p_val)
+{
+    uint8_t *p_buf = p_val - LE_APP_NOTIFY_HDR_SIZE;
+    uint16_t conn_id = (uint16_t)(p_buf[0] | (p_buf[1] << 8));
+    le_app_conn_t *p_conn = le_app_conn_find(conn_id);
+
+    /* The connection may have closed while the buffer was queued */
+    if ((NULL != p_conn) && (0 != p_conn->notify_in_flight))
+    {
+        p_conn->notify_in_flight--;
+    }
+
+    app_free_buffer(p_buf);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_notify_retry
+ ***************************************************************************************************
+ * Summary:
+ *   This function resumes the queues after a send failed with no buffer in flight.
+ *
+ * Parameters:
+ *   WICED_TIMER_PARAM_TYPE cb_params    : Unused
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_notify_retry(WICED_TIMER_PARAM_TYPE cb_params)
+{
+    le_app_notify_resume();
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_notify_find_source
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns the fill function registered for a characteristic.
+ *
+ * Parameters:
+ *   uint16_t attr_handle        : Handle of the characteristic value
+ *
+ * Return:
+ *  le_app_notify_fill_t: Fill function, or NULL if the value comes from the GATT database
+ *
+ **************************************************************************************************/
+static le_app_notify_fill_t le_app_notify_find_source(uint16_t attr_handle)
+{
+    for (uint32_t i = 0; i < LE_APP_NOTIFY_MAX_SOURCES; i++)
+    {
+        if (attr_handle == le_app_notify_sources[i].attr_handle)
+        {
+            return le_app_notify_sources[i].p_fill;
+        }
+    }
+
+    return NULL;
+}
+
+/* [] END OF FILE */
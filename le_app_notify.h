@@ -0,0 +1,164 @@
+/*******************************************************************************
+* File Name: le_app_notify.h
+*
+* Description:
+*   Header file for the notification and indication scheduler
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef LE_APP_NOTIFY_H_
+#define LE_APP_NOTIFY_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_gatt.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Number of notification buffers a connection may have queued in the stack. A
+ * credit is returned by GATT_APP_BUFFER_TRANSMITTED_EVT */
+#define LE_APP_NOTIFY_CREDITS           (3u)
+
+/* Number of characteristics whose values are produced by a fill function */
+#define LE_APP_NOTIFY_MAX_SOURCES       (2u)
+
+/* Delay before a queue is pumped again when a send failed with no buffer in flight, so that
+ * no GATT_APP_BUFFER_TRANSMITTED_EVT will resume it */
+#define LE_APP_NOTIFY_RETRY_MS          (10u)
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+/* Produces the next value of a streamed characteristic into p_buf and returns its length.
+ * Setting *p_more keeps the handle queued, so the stream continues as credits return.
+ * Returning 0 sends nothing and ends the stream */
+typedef uint16_t (*le_app_notify_fill_t)(uint16_t conn_id, uint8_t *p_buf, uint16_t max_len,
+                                         wiced_bool_t *p_more);
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+
+/**************************************************************************************************
+* Function Name: le_app_notify_init
+***************************************************************************************************
+* Summary:
+*   This function prepares the timer that resumes a notification queue the stack refused while
+*   the connection had no buffer in flight.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  wiced_result_t: WICED_BT_SUCCESS, or the error of the timer initialization
+*
+**************************************************************************************************/
+wiced_result_t le_app_notify_init(void);
+
+/**************************************************************************************************
+* Function Name: le_app_notify_conn
+***************************************************************************************************
+* Summary:
+*   This function queues the value of a characteristic for one connection. If the handle is
+*   already queued the update is merged with it, and the latest value is sent. Must be called
+*   from the Bluetooth stack context.
+*
+* Parameters:
+*   uint16_t conn_id            : Connection ID
+*   uint16_t attr_handle        : Handle of the characteristic value
+*
+* Return:
+*  wiced_bt_gatt_status_t: WICED_BT_GATT_CCC_CFG_ERR if the peer has not enabled notifications
+*                          or indications, WICED_BT_GATT_INSUF_RESOURCE if the queue is full
+*
+**************************************************************************************************/
+wiced_bt_gatt_status_t le_app_notify_conn(uint16_t conn_id, uint16_t attr_handle);
+
+/**************************************************************************************************
+* Function Name: le_app_notify_set_source
+***************************************************************************************************
+* Summary:
+*   This function makes the values of a characteristic come from a fill function instead of the
+*   GATT database. A queued handle with a source is sent as long as the source has more data.
+*
+* Parameters:
+*   uint16_t attr_handle        : Handle of the characteristic value
+*   le_app_notify_fill_t p_fill : Fill function, NULL to remove the source
+*
+* Return:
+*  wiced_bt_gatt_status_t: WICED_BT_GATT_NO_RESOURCES if LE_APP_NOTIFY_MAX_SOURCES are in use
+*
+**************************************************************************************************/
+wiced_bt_gatt_status_t le_app_notify_set_source(uint16_t attr_handle, le_app_notify_fill_t p_fill);
+
+/**************************************************************************************************
+* Function Name: le_app_notify_confirmed
+***************************************************************************************************
+* Summary:
+*   This function handles the Handle Value Confirmation of an indication and sends the next
+*   queued indication of the connection.
+*
+* Parameters:
+*   uint16_t conn_id            : Connection ID
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_notify_confirmed(uint16_t conn_id);
+
+/**************************************************************************************************
+* Function Name: le_app_notify_resume
+***************************************************************************************************
+* Summary:
+*   This function sends the queued handles that were waiting for a pool buffer or for the stack.
+*   It is called for every GATT_APP_BUFFER_TRANSMITTED_EVT and when a connection is no longer
+*   congested. Must be called from the Bluetooth stack context.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_notify_resume(void);
+
+#endif /* LE_APP_NOTIFY_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,435 @@
+/*******************************************************************************
+ * File Name: le_app_phy.c
+ *
+ * Description:
+ *   Source file for the PHY policy. Connections move to LE 2M after they are
+ *   established and to LE Coded when the RSSI of the peer stays low
+ *
+ * Related Document: See Readme.md
+ *
+ *******************************************************************************
+ * Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/*******************************************************************************
+ *        Header Files
+ *******************************************************************************/
+#include "le_app_phy.h"
+#include "le_app_conn.h"
+#include "le_app_log.h"
+#include "wiced_timer.h"
+#include <string.h>
+
+/*******************************************************************************
+ *        Variable Definitions
+ *******************************************************************************/
+static le_app_phy_policy_t le_app_phy_policy =
+{
+    .coded_enter_dbm = LE_APP_PHY_CODED_ENTER_DBM,
+    .coded_exit_dbm = LE_APP_PHY_CODED_EXIT_DBM,
+    .switch_samples = LE_APP_PHY_SWITCH_SAMPLES,
+    .rssi_avg_shift = LE_APP_PHY_RSSI_AVG_SHIFT,
+};
+
+static le_app_phy_stats_t le_app_phy_stats;
+
+/* Polls the RSSI of one connection per period; runs in the stack context */
+static wiced_timer_t le_app_phy_rssi_timer;
+
+/* Slot of the connection whose RSSI is read next */
+static uint8_t le_app_phy_next_slot;
+
+/*******************************************************************************
+ *        Function Prototypes
+ *******************************************************************************/
+static wiced_result_t le_app_phy_request(le_app_conn_t *p_conn, uint8_t phy);
+static void le_app_phy_rssi_tick(WICED_TIMER_PARAM_TYPE cb_params);
+static void le_app_phy_rssi_result(void *p_data);
+
+/*******************************************************************************
+ *        Function Definitions
+ *******************************************************************************/
+
+/**************************************************************************************************
+ * Function Name: le_app_phy_decide
+ ***************************************************************************************************
+ * Summary:
+ *   This function feeds an RSSI sample to the decision state of a connection and returns the
+ *   PHY the connection should use. It has no side effects beyond p_state, so recorded RSSI
+ *   traces can be replayed through it.
+ *
+ * Parameters:
+ *   const le_app_phy_policy_t *p_policy : Thresholds
+ *   le_app_phy_state_t *p_state         : Decision state; zero it, then set target to
+ *                                         LE_APP_PHY_2M, for a new connection
+ *   int8_t rssi                         : RSSI sample in dBm
+ *
+ * Return:
+ *  uint8_t: LE_APP_PHY_2M or LE_APP_PHY_CODED
+ *
+ **************************************************************************************************/
+uint8_t le_app_phy_decide(const le_app_phy_policy_t *p_policy, le_app_phy_state_t *p_state, int8_t rssi)
+{
+    int16_t sample_q4 = (int16_t)(rssi * 16);
+    int16_t avg_dbm;
+    wiced_bool_t beyond;
+
+    if (!p_state->rssi_valid)
+    {
+        p_state->rssi_avg_q4 = sample_q4;
+        p_state->rssi_valid = WICED_TRUE;
+    }
+    else
+    {
+        /* Division rather than a shift keeps the rounding symmetric for negative values */
+        p_state->rssi_avg_q4 += (int16_t)((sample_q4 - p_state->rssi_avg_q4) / (1 << p_policy->rssi_avg_shift));
+    }
+    avg_dbm = p_state->rssi_avg_q4 / 16;
+
+    /* Count the samples that argue for the other PHY; any sample that does not resets it */
+    if (LE_APP_PHY_CODED == p_state->target)
+    {
+        beyond = (avg_dbm > p_policy->coded_exit_dbm) ? WICED_TRUE : WICED_FALSE;
+    }
+    else
+    {
+        beyond = (avg_dbm < p_policy->coded_enter_dbm) ? WICED_TRUE : WICED_FALSE;
+    }
+
+    if (!beyond)
+    {
+        p_state->count = 0;
+    }
+    else if (++p_state->count >= p_policy->switch_samples)
+    {
+        p_state->count = 0;
+        p_state->target = (LE_APP_PHY_CODED == p_state->target) ? LE_APP_PHY_2M : LE_APP_PHY_CODED;
+    }
+
+    return p_state->target;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_phy_init
+ ***************************************************************************************************
+ * Summary:
+ *   This function prepares the RSSI polling timer.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  wiced_result_t: WICED_BT_SUCCESS, or the error of the timer initialization
+ *
+ **************************************************************************************************/
+wiced_result_t le_app_phy_init(void)
+{
+    return wiced_init_timer(&le_app_phy_rssi_timer, le_app_phy_rssi_tick, NULL,
+                            WICED_MILLI_SECONDS_PERIODIC_TIMER);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_phy_on_connect
+ ***************************************************************************************************
+ * Summary:
+ *   This function requests LE 2M PHY for a new connection and starts the RSSI polling.
+ *
+ * Parameters:
+ *   uint16_t conn_id            : Connection ID
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_phy_on_connect(uint16_t conn_id)
+{
+    le_app_conn_t *p_conn = le_app_conn_find(conn_id);
+
+    if (NULL == p_conn)
+    {
+        return;
+    }
+
+    p_conn->tx_phy = LE_APP_PHY_1M;
+    p_conn->rx_phy = LE_APP_PHY_1M;
+    memset(&p_conn->phy_state, 0, sizeof(p_conn->phy_state));
+    p_conn->phy_state.target = LE_APP_PHY_2M;
+
+    /* 2M halves the air time of every packet while the peer is close enough */
+    le_app_phy_request(p_conn, LE_APP_PHY_2M);
+
+    if (!wiced_is_timer_in_use(&le_app_phy_rssi_timer))
+    {
+        wiced_start_timer(&le_app_phy_rssi_timer, LE_APP_PHY_RSSI_PERIOD_MS);
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_phy_on_disconnect
+ ***************************************************************************************************
+ * Summary:
+ *   This function stops the RSSI polling once no connection remains.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_phy_on_disconnect(void)
+{
+    if (0 == le_app_conn_count())
+    {
+        wiced_stop_timer(&le_app_phy_rssi_timer);
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_phy_on_update
+ ***************************************************************************************************
+ * Summary:
+ *   This function records the PHY of a connection from BTM_BLE_PHY_UPDATE_EVT.
+ *
+ * Parameters:
+ *   wiced_bt_ble_phy_update_t *p_update : PHY update event data
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_phy_on_update(wiced_bt_ble_phy_update_t *p_update)
+{
+    le_app_conn_t *p_conn = le_app_conn_find_by_addr(p_update->bd_address);
+
+    LE_APP_LOG("PHY update: BDA " LE_APP_LOG_BDA_PACKED_FMT " status %d TX %d RX %d\r\n",
+               LE_APP_LOG_BDA_PACKED_ARGS(p_update->bd_address), p_update->status,
+               p_update->tx_phy, p_update->rx_phy);
+
+    if (0 != p_update->status)
+    {
+        le_app_phy_stats.update_failures++;
+        return;
+    }
+
+    le_app_phy_stats.updates++;
+    if (NULL != p_conn)
+    {
+        p_conn->tx_phy = p_update->tx_phy;
+        p_conn->rx_phy = p_update->rx_phy;
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_phy_set_policy
+ ***************************************************************************************************
+ * Summary:
+ *   This function replaces the thresholds of the PHY decision.
+ *
+ * Parameters:
+ *   const le_app_phy_policy_t *p_policy : New thresholds
+ *
+ * Return:
+ *  wiced_result_t: WICED_BT_SUCCESS, or WICED_BT_BADARG if the thresholds leave no hysteresis
+ *
+ **************************************************************************************************/
+wiced_result_t le_app_phy_set_policy(const le_app_phy_policy_t *p_policy)
+{
+    if ((p_policy->coded_enter_dbm >= p_policy->coded_exit_dbm) || (0 == p_policy->switch_samples) ||
+        (8 <= p_policy->rssi_avg_shift))
+    {
+        return WICED_BT_BADARG;
+    }
+
+    le_app_phy_policy = *p_policy;
+
+    return WICED_BT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_phy_get_stats
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns the PHY policy counters.
+ *
+ * Parameters:
+ *   le_app_phy_stats_t *p_stats : Receives the counters
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_phy_get_stats(le_app_phy_stats_t *p_stats)
+{
+    *p_stats = le_app_phy_stats;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_phy_request
+ ***************************************************************************************************
+ * Summary:
+ *   This function asks the stack to move a connection to a PHY in both directions.
+ *
+ * Parameters:
+ *   le_app_conn_t *p_conn       : Context of the connection
+ *   uint8_t phy                 : LE_APP_PHY_2M or LE_APP_PHY_CODED
+ *
+ * Return:
+ *  wiced_result_t: Result of wiced_bt_ble_set_phy()
+ *
+ **************************************************************************************************/
+static wiced_result_t le_app_phy_request(le_app_conn_t *p_conn, uint8_t phy)
+{
+    wiced_bt_ble_phy_preferences_t phy_preferences;
+    wiced_result_t wiced_result;
+
+    memcpy(phy_preferences.remote_bd_addr, p_conn->bd_addr, sizeof(wiced_bt_device_address_t));
+    if (LE_APP_PHY_CODED == phy)
+    {
+        /* S=8 coding for the longest range */
+        phy_preferences.tx_phys = BTM_BLE_PREFER_LELR_PHY;
+        phy_preferences.rx_phys = BTM_BLE_PREFER_LELR_PHY;
+        phy_preferences.phy_opts = BTM_BLE_PREFER_CODED_PHY_S8;
+    }
+    else
+    {
+        phy_preferences.tx_phys = BTM_BLE_PREFER_2M_PHY;
+        phy_preferences.rx_phys = BTM_BLE_PREFER_2M_PHY;
+        phy_preferences.phy_opts = BTM_BLE_PREFER_CODED_PHY_NONE;
+    }
+
+    wiced_result = wiced_bt_ble_set_phy(&phy_preferences);
+    if (WICED_BT_SUCCESS == wiced_result)
+    {
+        le_app_phy_stats.requests++;
+    }
+    else
+    {
+        le_app_phy_stats.request_failures++;
+    }
+
+    return wiced_result;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_phy_rssi_tick
+ ***************************************************************************************************
+ * Summary:
+ *   This function reads the RSSI of the next connection. The stack serves one RSSI read at a
+ *   time, so the connections are read in turn.
+ *
+ * Parameters:
+ *   WICED_TIMER_PARAM_TYPE cb_params    : Unused
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_phy_rssi_tick(WICED_TIMER_PARAM_TYPE cb_params)
+{
+    le_app_conn_t *p_conn;
+
+    for (uint8_t tries = 0; tries < LE_APP_MAX_CONNECTIONS; tries++)
+    {
+        p_conn = le_app_conn_get(le_app_phy_next_slot);
+        le_app_phy_next_slot = (le_app_phy_next_slot + 1) % LE_APP_MAX_CONNECTIONS;
+
+        if (NULL != p_conn)
+        {
+            wiced_bt_dev_read_rssi(p_conn->bd_addr, BT_TRANSPORT_LE, le_app_phy_rssi_result);
+            return;
+        }
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_phy_rssi_result
+ ***************************************************************************************************
+ * Summary:
+ *   This function feeds an RSSI sample to the decision of its connection, and requests the
+ *   other PHY when the decision changes.
+ *
+ * Parameters:
+ *   void *p_data                : wiced_bt_dev_rssi_result_t of the read
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_phy_rssi_result(void *p_data)
+{
+    wiced_bt_dev_rssi_result_t *p_result = (wiced_bt_dev_rssi_result_t *)p_data;
+    le_app_conn_t *p_conn;
+    le_app_phy_state_t state;
+    uint8_t previous;
+    uint8_t target;
+
+    if ((NULL == p_result) || (WICED_BT_SUCCESS != p_result->status))
+    {
+        return;
+    }
+
+    p_conn = le_app_conn_find_by_addr(p_result->rem_bda);
+    if (NULL == p_conn)
+    {
+        return;
+    }
+
+    le_app_phy_stats.rssi_reads++;
+    state = p_conn->phy_state;
+    previous = state.target;
+    target = le_app_phy_decide(&le_app_phy_policy, &state, p_result->rssi);
+
+    /* A switch only takes effect once the stack accepted the request. Otherwise the average
+     * is kept and the switch is decided again after the next switch_samples samples */
+    if (target != previous)
+    {
+        LE_APP_LOG("conn_id %d RSSI %d dBm, requesting %s PHY\r\n", p_conn->conn_id, p_result->rssi,
+                   LE_APP_LOG_STR((LE_APP_PHY_CODED == target) ? LE_APP_LOG_NAME("Coded") : LE_APP_LOG_NAME("2M")));
+        if (WICED_BT_SUCCESS != le_app_phy_request(p_conn, target))
+        {
+            state.target = previous;
+        }
+        else if (LE_APP_PHY_CODED == target)
+        {
+            le_app_phy_stats.to_coded++;
+        }
+        else
+        {
+            le_app_phy_stats.to_2m++;
+        }
+    }
+
+    p_conn->phy_state = state;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,221 @@
+/*******************************************************************************
+* File Name: le_app_phy.h
+*
+* Description:
+*   Header file for the PHY policy. Connections move to LE 2M after they are
+*   established and to LE Coded when the RSSI of the peer stays low
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef LE_APP_PHY_H_
+#define LE_APP_PHY_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_dev.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* PHY values reported by BTM_BLE_PHY_UPDATE_EVT */
+#define LE_APP_PHY_1M                   (1u)
+#define LE_APP_PHY_2M                   (2u)
+#define LE_APP_PHY_CODED                (3u)
+
+/* Period of the RSSI reads. One connection is read per period, in turn */
+#define LE_APP_PHY_RSSI_PERIOD_MS       (500u)
+
+/* Default thresholds of the Coded PHY switch, with hysteresis between them */
+#define LE_APP_PHY_CODED_ENTER_DBM      (-85)
+#define LE_APP_PHY_CODED_EXIT_DBM       (-75)
+
+/* Default number of consecutive averaged samples beyond a threshold before switching */
+#define LE_APP_PHY_SWITCH_SAMPLES       (3u)
+
+/* Default weight of a new sample in the RSSI average, as a power of two divisor */
+#define LE_APP_PHY_RSSI_AVG_SHIFT       (2u)
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+/* Thresholds of the PHY decision */
+typedef struct
+{
+    int8_t coded_enter_dbm;         /* Averaged RSSI below which Coded PHY is wanted */
+    int8_t coded_exit_dbm;          /* Averaged RSSI above which 2M PHY is wanted again */
+    uint8_t switch_samples;         /* Consecutive samples needed to change the decision */
+    uint8_t rssi_avg_shift;         /* A new sample moves the average by 1/2^shift of the difference */
+} le_app_phy_policy_t;
+
+/* Decision state of one connection */
+typedef struct
+{
+    int16_t rssi_avg_q4;            /* Averaged RSSI in 1/16 dBm */
+    uint8_t rssi_valid;             /* rssi_avg_q4 holds at least one sample */
+    uint8_t count;                  /* Consecutive samples beyond the threshold of the other PHY */
+    uint8_t target;                 /* LE_APP_PHY_2M or LE_APP_PHY_CODED */
+} le_app_phy_state_t;
+
+/* PHY policy counters */
+typedef struct
+{
+    uint32_t requests;              /* wiced_bt_ble_set_phy() calls accepted by the stack */
+    uint32_t request_failures;      /* wiced_bt_ble_set_phy() calls refused by the stack */
+    uint32_t updates;               /* Successful BTM_BLE_PHY_UPDATE_EVT */
+    uint32_t update_failures;       /* BTM_BLE_PHY_UPDATE_EVT with an error status */
+    uint32_t to_coded;              /* Switches to Coded PHY the stack accepted */
+    uint32_t to_2m;                 /* Switches back to 2M PHY the stack accepted */
+    uint32_t rssi_reads;            /* RSSI samples received */
+} le_app_phy_stats_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+
+/**************************************************************************************************
+* Function Name: le_app_phy_decide
+***************************************************************************************************
+* Summary:
+*   This function feeds an RSSI sample to the decision state of a connection and returns the
+*   PHY the connection should use. It has no side effects beyond p_state, so recorded RSSI
+*   traces can be replayed through it.
+*
+* Parameters:
+*   const le_app_phy_policy_t *p_policy : Thresholds
+*   le_app_phy_state_t *p_state         : Decision state; zero it, then set target to
+*                                         LE_APP_PHY_2M, for a new connection
+*   int8_t rssi                         : RSSI sample in dBm
+*
+* Return:
+*  uint8_t: LE_APP_PHY_2M or LE_APP_PHY_CODED
+*
+**************************************************************************************************/
+uint8_t le_app_phy_decide(const le_app_phy_policy_t *p_policy, le_app_phy_state_t *p_state, int8_t rssi);
+
+/**************************************************************************************************
+* Function Name: le_app_phy_init
+***************************************************************************************************
+* Summary:
+*   This function prepares the RSSI polling timer.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  wiced_result_t: WICED_BT_SUCCESS, or the error of the timer initialization
+*
+**************************************************************************************************/
+wiced_result_t le_app_phy_init(void);
+
+/**************************************************************************************************
+* Function Name: le_app_phy_on_connect
+***************************************************************************************************
+* Summary:
+*   This function requests LE 2M PHY for a new connection and starts the RSSI polling.
+*
+* Parameters:
+*   uint16_t conn_id            : Connection ID
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_phy_on_connect(uint16_t conn_id);
+
+/**************************************************************************************************
+* Function Name: le_app_phy_on_disconnect
+***************************************************************************************************
+* Summary:
+*   This function stops the RSSI polling once no connection remains.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_phy_on_disconnect(void);
+
+/**************************************************************************************************
+* Function Name: le_app_phy_on_update
+***************************************************************************************************
+* Summary:
+*   This function records the PHY of a connection from BTM_BLE_PHY_UPDATE_EVT.
+*
+* Parameters:
+*   wiced_bt_ble_phy_update_t *p_update : PHY update event data
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_phy_on_update(wiced_bt_ble_phy_update_t *p_update);
+
+/**************************************************************************************************
+* Function Name: le_app_phy_set_policy
+***************************************************************************************************
+* Summary:
+*   This function replaces the thresholds of the PHY decision.
+*
+* Parameters:
+*   const le_app_phy_policy_t *p_policy : New thresholds
+*
+* Return:
+*  wiced_result_t: WICED_BT_SUCCESS, or WICED_BT_BADARG if the thresholds leave no hysteresis
+*
+**************************************************************************************************/
+wiced_result_t le_app_phy_set_policy(const le_app_phy_policy_t *p_policy);
+
+/**************************************************************************************************
+* Function Name: le_app_phy_get_stats
+***************************************************************************************************
+* Summary:
+*   This function returns the PHY policy counters.
+*
+* Parameters:
+*   le_app_phy_stats_t *p_stats : Receives the counters
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_phy_get_stats(le_app_phy_stats_t *p_stats);
+
+#endif /* LE_APP_PHY_H_ */
+
+/* [] END OF FILE */
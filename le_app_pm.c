@@ -0,0 +1,468 @@
+/*******************************************************************************
+ * File Name: le_app_pm.c
+ *
+ * Description:
+ *   Source file for the power manager
+ *
+ * Related Document: See Readme.md
+ *
+ *******************************************************************************
+ * Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/*******************************************************************************
+ *        Header Files
+ *******************************************************************************/
+#include "le_app_pm.h"
+#include <stdio.h>
+#include <stdatomic.h>
+#include "cyhal.h"
+#include "cy_retarget_io.h"
+#include "cyabs_rtos.h"
+#if LE_APP_PM_TICKLESS
+#include "tx_api.h"
+#endif
+
+/*******************************************************************************
+ *        Variable Definitions
+ *******************************************************************************/
+static atomic_uint le_app_pm_lock_count[LE_APP_PM_LOCK_COUNT];
+
+static le_app_pm_stats_t le_app_pm_stats;
+
+static le_app_pm_radio_t le_app_pm_radio = LE_APP_PM_RADIO_IDLE;
+
+/* Time at which the current active period started */
+static cy_time_t le_app_pm_active_start;
+
+static bool le_app_pm_locks_cb(cyhal_syspm_callback_state_t state, cyhal_syspm_callback_mode_t mode,
+                               void *callback_arg);
+static bool le_app_pm_uart_cb(cyhal_syspm_callback_state_t state, cyhal_syspm_callback_mode_t mode,
+                              void *callback_arg);
+
+static cyhal_syspm_callback_data_t le_app_pm_locks_cb_data =
+{
+    .callback       = le_app_pm_locks_cb,
+    .states         = CYHAL_SYSPM_CB_CPU_DEEPSLEEP,
+    .ignore_modes   = (cyhal_syspm_callback_mode_t)(CYHAL_SYSPM_BEFORE_TRANSITION | CYHAL_SYSPM_AFTER_TRANSITION),
+    .args           = NULL,
+    .next           = NULL,
+};
+
+static cyhal_syspm_callback_data_t le_app_pm_uart_cb_data =
+{
+    .callback       = le_app_pm_uart_cb,
+    .states         = CYHAL_SYSPM_CB_CPU_DEEPSLEEP,
+    .ignore_modes   = (cyhal_syspm_callback_mode_t)(CYHAL_SYSPM_BEFORE_TRANSITION | CYHAL_SYSPM_AFTER_TRANSITION),
+    .args           = NULL,
+    .next           = NULL,
+};
+
+#if LE_APP_PM_TICKLESS
+/* Wakes the system when the next ThreadX timer is due */
+static cyhal_lptimer_t le_app_pm_lptimer;
+
+/* Ticks slept and not yet added to the RTOS time */
+static unsigned long le_app_pm_slept_ticks;
+#endif
+
+/*******************************************************************************
+ *        Function Prototypes
+ *******************************************************************************/
+static void le_app_pm_account_active(cy_time_t now);
+
+/*******************************************************************************
+ *        Function Definitions
+ *******************************************************************************/
+
+/**************************************************************************************************
+ * Function Name: le_app_pm_init
+ ***************************************************************************************************
+ * Summary:
+ *   This function registers the deep sleep callbacks and, with LE_APP_PM_TICKLESS, prepares
+ *   the low power timer that wakes the system from tickless idle.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS, or the result of the failed HAL call
+ *
+ **************************************************************************************************/
+cy_rslt_t le_app_pm_init(void)
+{
+    cy_rslt_t cy_result = CY_RSLT_SUCCESS;
+
+    cy_rtos_get_time(&le_app_pm_active_start);
+
+    cyhal_syspm_register_callback(&le_app_pm_locks_cb_data);
+    cyhal_syspm_register_callback(&le_app_pm_uart_cb_data);
+
+#if LE_APP_PM_TICKLESS
+    cy_result = cyhal_lptimer_init(&le_app_pm_lptimer);
+#endif
+
+    return cy_result;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_pm_lock
+ ***************************************************************************************************
+ * Summary:
+ *   This function acquires a wake lock. Locks are counted, so every le_app_pm_lock() must be
+ *   paired with le_app_pm_unlock(). It may be called from any thread.
+ *
+ * Parameters:
+ *   le_app_pm_lock_t lock       : Wake lock
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_pm_lock(le_app_pm_lock_t lock)
+{
+    uint32_t saved_intr_status;
+
+    atomic_fetch_add_explicit(&le_app_pm_lock_count[lock], 1, memory_order_acquire);
+
+    /* Locks are taken from any context; the counters are only changed with interrupts off */
+    saved_intr_status = cyhal_system_critical_section_enter();
+    le_app_pm_stats.lock_acquires[lock]++;
+    cyhal_system_critical_section_exit(saved_intr_status);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_pm_unlock
+ ***************************************************************************************************
+ * Summary:
+ *   This function releases a wake lock acquired with le_app_pm_lock().
+ *
+ * Parameters:
+ *   le_app_pm_lock_t lock       : Wake lock
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_pm_unlock(le_app_pm_lock_t lock)
+{
+    atomic_fetch_sub_explicit(&le_app_pm_lock_count[lock], 1, memory_order_release);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_pm_set_radio
+ ***************************************************************************************************
+ * Summary:
+ *   This function sets the radio activity that the following time is counted against. The
+ *   active time so far is counted against the previous activity.
+ *
+ * Parameters:
+ *   le_app_pm_radio_t radio     : Radio activity
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_pm_set_radio(le_app_pm_radio_t radio)
+{
+    uint32_t saved_intr_status;
+    cy_time_t now;
+
+    if (radio == le_app_pm_radio)
+    {
+        return;
+    }
+
+    cy_rtos_get_time(&now);
+    saved_intr_status = cyhal_system_critical_section_enter();
+    le_app_pm_account_active(now);
+    le_app_pm_radio = radio;
+    cyhal_system_critical_section_exit(saved_intr_status);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_pm_on_controller_low_power
+ ***************************************************************************************************
+ * Summary:
+ *   This function counts a BTM_LPM_STATE_LOW_POWER event of the controller.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_pm_on_controller_low_power(void)
+{
+    le_app_pm_stats.controller_low_power++;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_pm_get_stats
+ ***************************************************************************************************
+ * Summary:
+ *   This function copies the power counters, including the active time up to now.
+ *
+ * Parameters:
+ *   le_app_pm_stats_t *p_stats  : Copy of the counters
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_pm_get_stats(le_app_pm_stats_t *p_stats)
+{
+    uint32_t saved_intr_status;
+    cy_time_t now;
+
+    cy_rtos_get_time(&now);
+    saved_intr_status = cyhal_system_critical_section_enter();
+    le_app_pm_account_active(now);
+    *p_stats = le_app_pm_stats;
+    cyhal_system_critical_section_exit(saved_intr_status);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_pm_print_stats
+ ***************************************************************************************************
+ * Summary:
+ *   This function prints the time spent in each power state per radio activity, and the wake
+ *   lock counters.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_pm_print_stats(void)
+{
+    static const char *const radio_names[LE_APP_PM_RADIO_COUNT] = { "idle", "advertising", "connected" };
+    static const char *const lock_names[LE_APP_PM_LOCK_COUNT] = { "log", "flash" };
+    le_app_pm_stats_t stats;
+
+    le_app_pm_get_stats(&stats);
+
+    printf("Power state time in ms (active/sleep/deep sleep)\r\n");
+    for (uint32_t radio = 0; radio < LE_APP_PM_RADIO_COUNT; radio++)
+    {
+        printf("%s: %lu %lu %lu\r\n", radio_names[radio],
+               (unsigned long)stats.time_ms[radio][LE_APP_PM_STATE_ACTIVE],
+               (unsigned long)stats.time_ms[radio][LE_APP_PM_STATE_SLEEP],
+               (unsigned long)stats.time_ms[radio][LE_APP_PM_STATE_DEEPSLEEP]);
+    }
+
+    for (uint32_t lock = 0; lock < LE_APP_PM_LOCK_COUNT; lock++)
+    {
+        printf("Wake lock %s: acquired %lu vetoed %lu\r\n", lock_names[lock],
+               (unsigned long)stats.lock_acquires[lock], (unsigned long)stats.lock_vetoes[lock]);
+    }
+    printf("UART vetoes %lu, controller low power events %lu\r\n",
+           (unsigned long)stats.uart_vetoes, (unsigned long)stats.controller_low_power);
+}
+
+#if LE_APP_PM_TICKLESS
+/**************************************************************************************************
+ * Function Name: le_app_pm_idle
+ ***************************************************************************************************
+ * Summary:
+ *   This function is the TX_LOW_POWER_TIMER_SETUP hook of the ThreadX low power utility. It is
+ *   called with interrupts disabled when no thread is ready, sleeps until the next ThreadX timer
+ *   expires or an interrupt arrives, and keeps the ticks slept for
+ *   le_app_pm_take_slept_ticks(). Deep sleep is only tried for idle periods of at least
+ *   LE_APP_PM_DEEPSLEEP_MIN_MS; the sleep callbacks may still refuse it, and the HAL then
+ *   falls back to CPU sleep.
+ *
+ * Parameters:
+ *   unsigned long ticks         : Ticks until the next ThreadX timer expires (ULONG)
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_pm_idle(unsigned long ticks)
+{
+    uint32_t desired_ms = (uint32_t)(((uint64_t)ticks * 1000u) / TX_TIMER_TICKS_PER_SECOND);
+    uint32_t actual_ms = 0;
+    le_app_pm_state_t state = LE_APP_PM_STATE_SLEEP;
+    cy_rslt_t cy_result;
+    cy_time_t now;
+
+    cy_rtos_get_time(&now);
+    le_app_pm_account_active(now);
+
+    if (desired_ms >= LE_APP_PM_DEEPSLEEP_MIN_MS)
+    {
+        cy_result = cyhal_syspm_tickless_deepsleep(&le_app_pm_lptimer, desired_ms, &actual_ms);
+        if (CY_RSLT_SUCCESS == cy_result)
+        {
+            state = LE_APP_PM_STATE_DEEPSLEEP;
+        }
+        else
+        {
+            cy_result = cyhal_syspm_tickless_sleep(&le_app_pm_lptimer, desired_ms, &actual_ms);
+        }
+    }
+    else
+    {
+        cy_result = cyhal_syspm_tickless_sleep(&le_app_pm_lptimer, desired_ms, &actual_ms);
+    }
+
+    if (CY_RSLT_SUCCESS != cy_result)
+    {
+        actual_ms = 0;
+    }
+
+    le_app_pm_stats.time_ms[le_app_pm_radio][state] += actual_ms;
+    le_app_pm_slept_ticks = (unsigned long)(((uint64_t)actual_ms * TX_TIMER_TICKS_PER_SECOND) / 1000u);
+
+    /* The RTOS time is corrected by the ticks slept once this hook returns */
+    le_app_pm_active_start = now + actual_ms;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_pm_take_slept_ticks
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns the ticks slept since it was last called and clears them. The ThreadX
+ *   low power utility calls it through TX_LOW_POWER_USER_TIMER_ADJUST with interrupts disabled.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  unsigned long: Ticks slept (ULONG)
+ *
+ **************************************************************************************************/
+unsigned long le_app_pm_take_slept_ticks(void)
+{
+    unsigned long ticks = le_app_pm_slept_ticks;
+
+    le_app_pm_slept_ticks = 0;
+
+    return ticks;
+}
+#endif
+
+/**************************************************************************************************
+ * Function Name: le_app_pm_account_active
+ ***************************************************************************************************
+ * Summary:
+ *   This function adds the active time since the last wake up to the current radio activity.
+ *   Callers outside the idle hook hold a critical section.
+ *
+ * Parameters:
+ *   cy_time_t now               : Current time
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_pm_account_active(cy_time_t now)
+{
+    le_app_pm_stats.time_ms[le_app_pm_radio][LE_APP_PM_STATE_ACTIVE] += (uint32_t)(now - le_app_pm_active_start);
+    le_app_pm_active_start = now;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_pm_locks_cb
+ ***************************************************************************************************
+ * Summary:
+ *   This function is the deep sleep callback of the wake locks. It refuses deep sleep while any
+ *   lock is held and counts the refusal against the first held lock.
+ *
+ * Parameters:
+ *   cyhal_syspm_callback_state_t state  : Power state being entered
+ *   cyhal_syspm_callback_mode_t mode    : Phase of the transition
+ *   void *callback_arg                  : Unused
+ *
+ * Return:
+ *  bool: false to refuse deep sleep
+ *
+ **************************************************************************************************/
+static bool le_app_pm_locks_cb(cyhal_syspm_callback_state_t state, cyhal_syspm_callback_mode_t mode,
+                               void *callback_arg)
+{
+    (void)state;
+    (void)callback_arg;
+
+    if (CYHAL_SYSPM_CHECK_READY != mode)
+    {
+        return true;
+    }
+
+    for (uint32_t lock = 0; lock < LE_APP_PM_LOCK_COUNT; lock++)
+    {
+        if (0 != atomic_load_explicit(&le_app_pm_lock_count[lock], memory_order_acquire))
+        {
+            le_app_pm_stats.lock_vetoes[lock]++;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_pm_uart_cb
+ ***************************************************************************************************
+ * Summary:
+ *   This function is the deep sleep callback of the debug UART. It refuses deep sleep while
+ *   retarget-io is still sending, so log output is not cut off.
+ *
+ * Parameters:
+ *   cyhal_syspm_callback_state_t state  : Power state being entered
+ *   cyhal_syspm_callback_mode_t mode    : Phase of the transition
+ *   void *callback_arg                  : Unused
+ *
+ * Return:
+ *  bool: false to refuse deep sleep
+ *
+ **************************************************************************************************/
+static bool le_app_pm_uart_cb(cyhal_syspm_callback_state_t state, cyhal_syspm_callback_mode_t mode,
+                              void *callback_arg)
+{
+    (void)state;
+    (void)callback_arg;
+
+    if ((CYHAL_SYSPM_CHECK_READY == mode) && cyhal_uart_is_tx_active(&cy_retarget_io_uart_obj))
+    {
+        le_app_pm_stats.uart_vetoes++;
+        return false;
+    }
+
+    return true;
+}
+
+/* [] END OF FILE */
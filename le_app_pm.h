@@ -0,0 +1,219 @@
+/*******************************************************************************
+* File Name: le_app_pm.h
+*
+* Description:
+*   Header file for the power manager. Tracks wake locks that veto deep sleep,
+*   enters sleep from the ThreadX tickless idle hooks and counts the time spent
+*   in each power state
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef LE_APP_PM_H_
+#define LE_APP_PM_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include <stdint.h>
+#include "cy_result.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Set to 1 to sleep from the ThreadX tickless idle hooks. Set from the Makefile with LOW_POWER=1 */
+#ifndef LE_APP_PM_TICKLESS
+#define LE_APP_PM_TICKLESS              (0)
+#endif
+
+/* Idle periods shorter than this are spent in CPU sleep, as deep sleep entry and exit cost more */
+#define LE_APP_PM_DEEPSLEEP_MIN_MS      (5u)
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+/* Wake locks. While any is held the system does not enter deep sleep */
+typedef enum
+{
+    LE_APP_PM_LOCK_LOG,             /* Log thread printing entries */
+    LE_APP_PM_LOCK_FLASH,           /* Bond store erase and program */
+    LE_APP_PM_LOCK_COUNT
+} le_app_pm_lock_t;
+
+typedef enum
+{
+    LE_APP_PM_STATE_ACTIVE,
+    LE_APP_PM_STATE_SLEEP,
+    LE_APP_PM_STATE_DEEPSLEEP,
+    LE_APP_PM_STATE_COUNT
+} le_app_pm_state_t;
+
+/* Radio activity that the power state times are split by */
+typedef enum
+{
+    LE_APP_PM_RADIO_IDLE,           /* Neither advertising nor connected */
+    LE_APP_PM_RADIO_ADVERTISING,
+    LE_APP_PM_RADIO_CONNECTED,
+    LE_APP_PM_RADIO_COUNT
+} le_app_pm_radio_t;
+
+typedef struct
+{
+    uint32_t time_ms[LE_APP_PM_RADIO_COUNT][LE_APP_PM_STATE_COUNT];
+    uint32_t lock_acquires[LE_APP_PM_LOCK_COUNT];
+    uint32_t lock_vetoes[LE_APP_PM_LOCK_COUNT];  /* Deep sleep entries refused by each lock */
+    uint32_t uart_vetoes;                        /* Deep sleep entries refused while UART was sending */
+    uint32_t controller_low_power;               /* BTM_LPM_STATE_LOW_POWER events */
+} le_app_pm_stats_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+
+/**************************************************************************************************
+* Function Name: le_app_pm_init
+***************************************************************************************************
+* Summary:
+*   This function registers the deep sleep callbacks and, with LE_APP_PM_TICKLESS, prepares
+*   the low power timer that wakes the system from tickless idle.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  cy_rslt_t: CY_RSLT_SUCCESS, or the result of the failed HAL call
+*
+**************************************************************************************************/
+cy_rslt_t le_app_pm_init(void);
+
+/**************************************************************************************************
+* Function Name: le_app_pm_lock
+***************************************************************************************************
+* Summary:
+*   This function acquires a wake lock. Locks are counted, so every le_app_pm_lock() must be
+*   paired with le_app_pm_unlock(). It may be called from any thread.
+*
+* Parameters:
+*   le_app_pm_lock_t lock       : Wake lock
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_pm_lock(le_app_pm_lock_t lock);
+
+/**************************************************************************************************
+* Function Name: le_app_pm_unlock
+***************************************************************************************************
+* Summary:
+*   This function releases a wake lock acquired with le_app_pm_lock().
+*
+* Parameters:
+*   le_app_pm_lock_t lock       : Wake lock
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_pm_unlock(le_app_pm_lock_t lock);
+
+/**************************************************************************************************
+* Function Name: le_app_pm_set_radio
+***************************************************************************************************
+* Summary:
+*   This function sets the radio activity that the following time is counted against.
+*
+* Parameters:
+*   le_app_pm_radio_t radio     : Radio activity
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_pm_set_radio(le_app_pm_radio_t radio);
+
+/**************************************************************************************************
+* Function Name: le_app_pm_on_controller_low_power
+***************************************************************************************************
+* Summary:
+*   This function counts a BTM_LPM_STATE_LOW_POWER event of the controller.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_pm_on_controller_low_power(void);
+
+/**************************************************************************************************
+* Function Name: le_app_pm_get_stats
+***************************************************************************************************
+* Summary:
+*   This function copies the power counters, including the active time up to now.
+*
+* Parameters:
+*   le_app_pm_stats_t *p_stats  : Copy of the counters
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_pm_get_stats(le_app_pm_stats_t *p_stats);
+
+/**************************************************************************************************
+* Function Name: le_app_pm_print_stats
+***************************************************************************************************
+* Summary:
+*   This function prints the time spent in each power state per radio activity, and the wake
+*   lock counters.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_pm_print_stats(void);
+
+#if LE_APP_PM_TICKLESS
+#include "le_app_pm_hooks.h"
+#endif
+
+#endif /* LE_APP_PM_H_ */
+
+/* [] END OF FILE */
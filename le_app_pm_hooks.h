@@ -0,0 +1,96 @@
+/*******************************************************************************
+* File Name: le_app_pm_hooks.h
+*
+* Description:
+*   Declarations of the ThreadX low power utility hooks of the power manager.
+*   The Makefile includes this header in every C file with LOW_POWER=1, so it
+*   must stay free of other includes
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef LE_APP_PM_HOOKS_H_
+#define LE_APP_PM_HOOKS_H_
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Ticks the ThreadX low power utility adds to the RTOS time when it leaves low power. Each
+ * sleep is only counted once, also when the utility enters low power without a timer set up */
+#define TX_LOW_POWER_USER_TIMER_ADJUST  le_app_pm_take_slept_ticks()
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+
+/**************************************************************************************************
+* Function Name: le_app_pm_idle
+***************************************************************************************************
+* Summary:
+*   This function is the TX_LOW_POWER_TIMER_SETUP hook of the ThreadX low power utility. It is
+*   called with interrupts disabled when no thread is ready, sleeps until the next ThreadX timer
+*   expires or an interrupt arrives, and keeps the ticks slept for
+*   le_app_pm_take_slept_ticks(). Deep sleep is only tried for idle periods of at least
+*   LE_APP_PM_DEEPSLEEP_MIN_MS; the sleep callbacks may still refuse it, and the HAL then
+*   falls back to CPU sleep.
+*
+* Parameters:
+*   unsigned long ticks         : Ticks until the next ThreadX timer expires (ULONG)
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_pm_idle(unsigned long ticks);
+
+/**************************************************************************************************
+* Function Name: le_app_pm_take_slept_ticks
+***************************************************************************************************
+* Summary:
+*   This function returns the ticks slept since it was last called and clears them. The ThreadX
+*   low power utility calls it through TX_LOW_POWER_USER_TIMER_ADJUST with interrupts disabled.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  unsigned long: Ticks slept (ULONG)
+*
+**************************************************************************************************/
+unsigned long le_app_pm_take_slept_ticks(void);
+
+#endif /* LE_APP_PM_HOOKS_H_ */
+
+/* [] END OF FILE */
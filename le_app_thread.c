@@ -0,0 +1,271 @@
+/*******************************************************************************
+ * File Name: le_app_thread.c
+ *
+ * Description:
+ *   Source file for the application thread. Bluetooth stack callbacks post
+ *   compact events to lock-free single producer queues and the thread does the work
+ *
+ * Related Document: See Readme.md
+ *
+ *******************************************************************************
+ * Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/*******************************************************************************
+ *        Header Files
+ *******************************************************************************/
+#include "le_app_thread.h"
+#include "le_app_user_interface.h"
+#include "le_app_led.h"
+#include "le_app_bond.h"
+#include "le_app_log.h"
+#include <stdatomic.h>
+#include "cyabs_rtos.h"
+
+/*******************************************************************************
+ *        Structures and Enumerations
+ *******************************************************************************/
+/* Single producer, single consumer ring. The producer only writes head and the
+ * consumer only writes tail; both are free running and wrap with the ring size */
+typedef struct
+{
+    atomic_uint head;
+    atomic_uint tail;
+    le_app_evt_t ring[LE_APP_THREAD_QUEUE_SIZE];
+} le_app_thread_queue_t;
+
+/*******************************************************************************
+ *        Variable Definitions
+ *******************************************************************************/
+static le_app_thread_queue_t le_app_thread_queues[LE_APP_THREAD_PRODUCER_COUNT];
+
+static atomic_uint le_app_thread_dropped;
+
+/* Counts posted events, so the thread sleeps only when every queue is empty */
+static cy_semaphore_t le_app_thread_sem;
+
+static cy_thread_t le_app_thread;
+/* ThreadX requires an 8 byte aligned stack */
+static uint64_t le_app_thread_stack[LE_APP_THREAD_STACK_SIZE / sizeof(uint64_t)];
+
+/*******************************************************************************
+ *        Function Prototypes
+ *******************************************************************************/
+static void le_app_thread_entry(cy_thread_arg_t arg);
+static void le_app_thread_dispatch(const le_app_evt_t *p_evt);
+
+/*******************************************************************************
+ *        Function Definitions
+ *******************************************************************************/
+
+/**************************************************************************************************
+ * Function Name: le_app_thread_init
+ ***************************************************************************************************
+ * Summary:
+ *   This function creates the application thread and the semaphore that wakes it.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS if the thread was created
+ *
+ **************************************************************************************************/
+cy_rslt_t le_app_thread_init(void)
+{
+    cy_rslt_t cy_result;
+
+    cy_result = cy_rtos_semaphore_init(&le_app_thread_sem,
+                                       LE_APP_THREAD_QUEUE_SIZE * LE_APP_THREAD_PRODUCER_COUNT, 0);
+    if (CY_RSLT_SUCCESS != cy_result)
+    {
+        return cy_result;
+    }
+
+    return cy_rtos_thread_create(&le_app_thread, le_app_thread_entry, "le_app",
+                                 le_app_thread_stack, sizeof(le_app_thread_stack),
+                                 CY_RTOS_PRIORITY_NORMAL, NULL);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_thread_post
+ ***************************************************************************************************
+ * Summary:
+ *   This function queues an event for the application thread and returns at once. Each queue
+ *   must only be posted to from the context of its producer.
+ *
+ * Parameters:
+ *   le_app_thread_producer_t producer   : Producer posting the event
+ *   le_app_evt_type_t type              : Event type
+ *   uint16_t arg                        : Event argument
+ *
+ * Return:
+ *  bool: true if queued, false if the queue was full and the event was dropped
+ *
+ **************************************************************************************************/
+bool le_app_thread_post(le_app_thread_producer_t producer, le_app_evt_type_t type, uint16_t arg)
+{
+    le_app_thread_queue_t *p_queue = &le_app_thread_queues[producer];
+    unsigned int head = atomic_load_explicit(&p_queue->head, memory_order_relaxed);
+    le_app_evt_t *p_evt;
+
+    if ((head - atomic_load_explicit(&p_queue->tail, memory_order_acquire)) >= LE_APP_THREAD_QUEUE_SIZE)
+    {
+        atomic_fetch_add_explicit(&le_app_thread_dropped, 1, memory_order_relaxed);
+        return false;
+    }
+
+    p_evt = &p_queue->ring[head & (LE_APP_THREAD_QUEUE_SIZE - 1)];
+    p_evt->type = (uint16_t)type;
+    p_evt->arg = arg;
+
+    /* Publish the event before the consumer can see the new head */
+    atomic_store_explicit(&p_queue->head, head + 1, memory_order_release);
+    cy_rtos_semaphore_set(&le_app_thread_sem);
+
+    return true;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_thread_get_dropped
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns the number of events dropped because a queue was full.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  uint32_t: Number of dropped events since boot
+ *
+ **************************************************************************************************/
+uint32_t le_app_thread_get_dropped(void)
+{
+    return atomic_load_explicit(&le_app_thread_dropped, memory_order_relaxed);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_thread_entry
+ ***************************************************************************************************
+ * Summary:
+ *   This is the application thread. It sleeps until an event is posted, then drains every
+ *   queue in order.
+ *
+ * Parameters:
+ *   cy_thread_arg_t arg : Unused
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_thread_entry(cy_thread_arg_t arg)
+{
+    le_app_thread_queue_t *p_queue;
+    le_app_evt_t evt;
+    unsigned int tail;
+
+    (void)arg;
+
+    while (1)
+    {
+        cy_rtos_semaphore_get(&le_app_thread_sem, CY_RTOS_NEVER_TIMEOUT);
+
+        for (uint32_t producer = 0; producer < LE_APP_THREAD_PRODUCER_COUNT; producer++)
+        {
+            p_queue = &le_app_thread_queues[producer];
+            tail = atomic_load_explicit(&p_queue->tail, memory_order_relaxed);
+
+            while (tail != atomic_load_explicit(&p_queue->head, memory_order_acquire))
+            {
+                evt = p_queue->ring[tail & (LE_APP_THREAD_QUEUE_SIZE - 1)];
+
+                /* Free the slot before handling the event */
+                tail++;
+                atomic_store_explicit(&p_queue->tail, tail, memory_order_release);
+
+                le_app_thread_dispatch(&evt);
+            }
+        }
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_thread_dispatch
+ ***************************************************************************************************
+ * Summary:
+ *   This function handles one event. The state it updates is only used by this thread.
+ *
+ * Parameters:
+ *   const le_app_evt_t *p_evt   : Event
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_thread_dispatch(const le_app_evt_t *p_evt)
+{
+    switch (p_evt->type)
+    {
+    case LE_APP_EVT_ADV_CONN_STATE:
+        app_bt_adv_conn_state = (app_bt_adv_conn_mode_t)p_evt->arg;
+#ifdef CYBSP_USER_LED2
+        /* Update Advertisement LED to reflect the updated state */
+        adv_led_update();
+#endif
+#ifdef CYBSP_USER_LED1
+        /* The IAS LED turns off once no peer is connected */
+        ias_led_update();
+#endif
+        break;
+
+    case LE_APP_EVT_ALERT_LEVEL:
+        app_bt_alert_level = (uint8_t)p_evt->arg;
+#ifdef CYBSP_USER_LED1
+        ias_led_update();
+#endif
+        break;
+
+    case LE_APP_EVT_LED_TICK:
+        le_app_led_tick();
+        break;
+
+    case LE_APP_EVT_BOND_WRITE:
+        le_app_bond_flush();
+        break;
+
+    default:
+        LE_APP_LOG("Unknown application event %d\r\n", p_evt->type);
+        break;
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,142 @@
+/*******************************************************************************
+* File Name: le_app_thread.h
+*
+* Description:
+*   Header file for the application thread. Bluetooth stack callbacks post
+*   compact events to lock-free single producer queues and the thread does the work
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef LE_APP_THREAD_H_
+#define LE_APP_THREAD_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_result.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Events per producer queue. Must be a power of two */
+#define LE_APP_THREAD_QUEUE_SIZE        (16u)
+
+#define LE_APP_THREAD_STACK_SIZE        (2048u)
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+/* Producers of events. Each has its own queue, so no producer ever contends with another */
+typedef enum
+{
+    LE_APP_THREAD_PRODUCER_STACK,   /* Stack callbacks and stack timers */
+    LE_APP_THREAD_PRODUCER_TIMER,   /* RTOS timer callbacks */
+    LE_APP_THREAD_PRODUCER_COUNT
+} le_app_thread_producer_t;
+
+/* Events handled by the application thread */
+typedef enum
+{
+    LE_APP_EVT_ADV_CONN_STATE,      /* arg: app_bt_adv_conn_mode_t */
+    LE_APP_EVT_ALERT_LEVEL,         /* arg: highest IAS alert level of the connections */
+    LE_APP_EVT_LED_TICK,            /* The next LED pattern step is due */
+    LE_APP_EVT_BOND_WRITE,          /* Write the bond store to flash */
+    LE_APP_EVT_COUNT
+} le_app_evt_type_t;
+
+typedef struct
+{
+    uint16_t type;                  /* le_app_evt_type_t */
+    uint16_t arg;
+} le_app_evt_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+
+/**************************************************************************************************
+* Function Name: le_app_thread_init
+***************************************************************************************************
+* Summary:
+*   This function creates the application thread and the semaphore that wakes it.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  cy_rslt_t: CY_RSLT_SUCCESS if the thread was created
+*
+**************************************************************************************************/
+cy_rslt_t le_app_thread_init(void);
+
+/**************************************************************************************************
+* Function Name: le_app_thread_post
+***************************************************************************************************
+* Summary:
+*   This function queues an event for the application thread and returns at once. Each queue
+*   must only be posted to from the context of its producer.
+*
+* Parameters:
+*   le_app_thread_producer_t producer   : Producer posting the event
+*   le_app_evt_type_t type              : Event type
+*   uint16_t arg                        : Event argument
+*
+* Return:
+*  bool: true if queued, false if the queue was full and the event was dropped
+*
+**************************************************************************************************/
+bool le_app_thread_post(le_app_thread_producer_t producer, le_app_evt_type_t type, uint16_t arg);
+
+/**************************************************************************************************
+* Function Name: le_app_thread_get_dropped
+***************************************************************************************************
+* Summary:
+*   This function returns the number of events dropped because a queue was full.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  uint32_t: Number of dropped events since boot
+*
+**************************************************************************************************/
+uint32_t le_app_thread_get_dropped(void);
+
+#endif /* LE_APP_THREAD_H_ */
+
+/* [] END OF FILE */
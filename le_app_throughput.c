@@ -0,0 +1,491 @@
+/*******************************************************************************
+ * File Name: le_app_throughput.c
+ *
+ * Description:
+ *   Source file for the GATT throughput test service. The Data
+ *   characteristic streams sequence numbered payloads through the notification
+ *   scheduler, the Sink characteristic counts payloads written by the client.
+ *
+ * Related Document: See Readme.md
+ *
+ *******************************************************************************
+ * Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/*******************************************************************************
+ *        Header Files
+ *******************************************************************************/
+#include "le_app_throughput.h"
+#include "le_app_gatts.h"
+#include "le_app_notify.h"
+#include "le_app_conn.h"
+#include "le_app_log.h"
+#include "cyabs_rtos.h"
+#include <string.h>
+
+/* The service is optional; build with THROUGHPUT_SERVICE=1 to add it */
+#if LE_APP_THROUGHPUT_ENABLE
+
+#if (HDLS_THROUGHPUT <= HDLC_IAS_ALERT_LEVEL_VALUE)
+#error "The throughput service handles must follow those of the generated GATT database"
+#endif
+
+/*******************************************************************************
+ *        Variable Definitions
+ *******************************************************************************/
+static const uint8_t le_app_throughput_db[] =
+{
+    PRIMARY_SERVICE_UUID128(HDLS_THROUGHPUT, __UUID_SERVICE_THROUGHPUT),
+
+    CHARACTERISTIC_UUID128_WRITABLE(HDLC_THROUGHPUT_CONTROL, HDLC_THROUGHPUT_CONTROL_VALUE,
+                                    __UUID_CHARACTERISTIC_THROUGHPUT_CONTROL,
+                                    GATTDB_CHAR_PROP_READ | GATTDB_CHAR_PROP_WRITE,
+                                    GATTDB_PERM_READABLE | GATTDB_PERM_WRITE_REQ),
+
+    CHARACTERISTIC_UUID128(HDLC_THROUGHPUT_DATA, HDLC_THROUGHPUT_DATA_VALUE,
+                           __UUID_CHARACTERISTIC_THROUGHPUT_DATA,
+                           GATTDB_CHAR_PROP_NOTIFY, GATTDB_PERM_NONE),
+        CHAR_DESCRIPTOR_UUID16_WRITABLE(HDLD_THROUGHPUT_DATA_CLIENT_CHAR_CONFIG,
+                                        GATT_UUID_CHAR_CLIENT_CONFIG,
+                                        GATTDB_PERM_READABLE | GATTDB_PERM_WRITE_REQ),
+
+    CHARACTERISTIC_UUID128_WRITABLE(HDLC_THROUGHPUT_SINK, HDLC_THROUGHPUT_SINK_VALUE,
+                                    __UUID_CHARACTERISTIC_THROUGHPUT_SINK,
+                                    GATTDB_CHAR_PROP_WRITE_NO_RESPONSE,
+                                    GATTDB_PERM_WRITE_CMD | GATTDB_PERM_VARIABLE_LENGTH),
+
+    CHARACTERISTIC_UUID128(HDLC_THROUGHPUT_RESULTS, HDLC_THROUGHPUT_RESULTS_VALUE,
+                           __UUID_CHARACTERISTIC_THROUGHPUT_RESULTS,
+                           GATTDB_CHAR_PROP_READ, GATTDB_PERM_READABLE),
+};
+
+static uint8_t le_app_throughput_control_value[1];
+static uint8_t le_app_throughput_results_value[sizeof(le_app_throughput_results_t)];
+
+/* The Data characteristic is filled on demand and the Sink payloads are counted, not stored */
+static gatt_db_lookup_table_t le_app_throughput_attrs[] =
+{
+    {HDLC_THROUGHPUT_CONTROL_VALUE, sizeof(le_app_throughput_control_value),
+     sizeof(le_app_throughput_control_value), le_app_throughput_control_value},
+    {HDLC_THROUGHPUT_SINK_VALUE, 0, 0, NULL},
+    {HDLC_THROUGHPUT_RESULTS_VALUE, sizeof(le_app_throughput_results_value),
+     sizeof(le_app_throughput_results_value), le_app_throughput_results_value},
+};
+
+const le_app_gatts_service_t le_app_throughput_service =
+{
+    .p_db = le_app_throughput_db,
+    .db_len = sizeof(le_app_throughput_db),
+    .p_attrs = le_app_throughput_attrs,
+    .num_attrs = sizeof(le_app_throughput_attrs) / sizeof(le_app_throughput_attrs[0]),
+};
+
+static le_app_throughput_results_t le_app_throughput_results;
+
+/* Connection the Data characteristic streams to */
+static uint16_t le_app_throughput_conn_id;
+static wiced_bool_t le_app_throughput_streaming;
+static uint32_t le_app_throughput_tx_seq;
+static cy_time_t le_app_throughput_tx_start;
+static uint32_t le_app_throughput_tx_failures_base;
+
+/* Sequence number expected in the next Sink payload */
+static wiced_bool_t le_app_throughput_rx_active;
+static uint32_t le_app_throughput_rx_seq;
+static cy_time_t le_app_throughput_rx_start;
+
+/*******************************************************************************
+ *        Function Prototypes
+ *******************************************************************************/
+static wiced_bt_gatt_status_t le_app_throughput_control_check(uint16_t conn_id, uint16_t attr_handle,
+                                                              uint16_t offset, const uint8_t *p_val,
+                                                              uint16_t len);
+static wiced_bt_gatt_status_t le_app_throughput_control(uint16_t conn_id, uint16_t attr_handle,
+                                                        uint16_t offset, const uint8_t *p_val,
+                                                        uint16_t len);
+static wiced_bt_gatt_status_t le_app_throughput_sink_check(uint16_t conn_id, uint16_t attr_handle,
+                                                           uint16_t offset, const uint8_t *p_val,
+                                                           uint16_t len);
+static wiced_bt_gatt_status_t le_app_throughput_sink(uint16_t conn_id, uint16_t attr_handle,
+                                                     uint16_t offset, const uint8_t *p_val,
+                                                     uint16_t len);
+static wiced_bt_gatt_status_t le_app_throughput_results_read(uint16_t conn_id, uint16_t attr_handle,
+                                                             uint16_t offset);
+static uint16_t le_app_throughput_fill(uint16_t conn_id, uint8_t *p_buf, uint16_t max_len,
+                                       wiced_bool_t *p_more);
+static void le_app_throughput_publish(void);
+
+/*******************************************************************************
+ *        Function Definitions
+ *******************************************************************************/
+
+/**************************************************************************************************
+ * Function Name: le_app_throughput_init
+ ***************************************************************************************************
+ * Summary:
+ *   This function registers the callbacks of the throughput test attributes and the Data
+ *   characteristic as a streamed notification source.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: See possible status codes in wiced_bt_gatt_status_e in wiced_bt_gatt.h
+ *
+ **************************************************************************************************/
+wiced_bt_gatt_status_t le_app_throughput_init(void)
+{
+    memset(&le_app_throughput_results, 0, sizeof(le_app_throughput_results));
+    le_app_throughput_streaming = WICED_FALSE;
+    le_app_throughput_rx_active = WICED_FALSE;
+
+    if ((WICED_BT_GATT_SUCCESS != le_app_gatts_register_handle(HDLC_THROUGHPUT_CONTROL_VALUE, NULL,
+                                                                le_app_throughput_control_check,
+                                                                le_app_throughput_control)) ||
+        (WICED_BT_GATT_SUCCESS != le_app_gatts_register_handle(HDLC_THROUGHPUT_SINK_VALUE, NULL,
+                                                                le_app_throughput_sink_check,
+                                                                le_app_throughput_sink)) ||
+        (WICED_BT_GATT_SUCCESS != le_app_gatts_register_handle(HDLC_THROUGHPUT_RESULTS_VALUE,
+                                                                le_app_throughput_results_read, NULL, NULL)))
+    {
+        return WICED_BT_GATT_NO_RESOURCES;
+    }
+
+    return le_app_notify_set_source(HDLC_THROUGHPUT_DATA_VALUE, le_app_throughput_fill);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_throughput_on_disconnect
+ ***************************************************************************************************
+ * Summary:
+ *   This function stops the stream when its connection closes, so that a later connection that
+ *   gets the same connection ID is not streamed to.
+ *
+ * Parameters:
+ *   uint16_t conn_id            : Connection ID
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_throughput_on_disconnect(uint16_t conn_id)
+{
+    if (conn_id == le_app_throughput_conn_id)
+    {
+        le_app_throughput_streaming = WICED_FALSE;
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_throughput_control_check
+ ***************************************************************************************************
+ * Summary:
+ *   This function checks a command before it is written to the Control characteristic.
+ *
+ * Parameters:
+ *   uint16_t conn_id            : Connection ID of the writer
+ *   uint16_t attr_handle        : HDLC_THROUGHPUT_CONTROL_VALUE
+ *   uint16_t offset             : Offset of the value
+ *   const uint8_t *p_val        : Value to write
+ *   uint16_t len                : Length of the value
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_CCC_CFG_ERR if a stream is started before the client
+ *                          enabled notifications on the Data characteristic
+ *
+ **************************************************************************************************/
+static wiced_bt_gatt_status_t le_app_throughput_control_check(uint16_t conn_id, uint16_t attr_handle,
+                                                              uint16_t offset, const uint8_t *p_val,
+                                                              uint16_t len)
+{
+    le_app_conn_t *p_conn = le_app_conn_find(conn_id);
+    le_app_conn_cccd_t *p_cccd;
+
+    if ((0 != offset) || (1 != len) || (NULL == p_conn))
+    {
+        return WICED_BT_GATT_INVALID_ATTR_LEN;
+    }
+
+    switch (p_val[0])
+    {
+    case LE_APP_THROUGHPUT_CMD_START:
+        p_cccd = le_app_conn_get_cccd(p_conn, le_app_get_cccd_handle(HDLC_THROUGHPUT_DATA_VALUE));
+        return ((NULL != p_cccd) && (0 != p_cccd->value)) ? WICED_BT_GATT_SUCCESS : WICED_BT_GATT_CCC_CFG_ERR;
+
+    case LE_APP_THROUGHPUT_CMD_STOP:
+    case LE_APP_THROUGHPUT_CMD_RESET:
+        return WICED_BT_GATT_SUCCESS;
+
+    default:
+        return WICED_BT_GATT_VALUE_NOT_ALLOWED;
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_throughput_control
+ ***************************************************************************************************
+ * Summary:
+ *   This function handles a command written to the Control characteristic. The command was
+ *   checked by le_app_throughput_control_check().
+ *
+ * Parameters:
+ *   uint16_t conn_id            : Connection ID of the writer
+ *   uint16_t attr_handle        : HDLC_THROUGHPUT_CONTROL_VALUE
+ *   uint16_t offset             : Offset of the value
+ *   const uint8_t *p_val        : Value written
+ *   uint16_t len                : Length of the value
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: Status of starting the stream, WICED_BT_GATT_SUCCESS otherwise
+ *
+ **************************************************************************************************/
+static wiced_bt_gatt_status_t le_app_throughput_control(uint16_t conn_id, uint16_t attr_handle,
+                                                        uint16_t offset, const uint8_t *p_val,
+                                                        uint16_t len)
+{
+    wiced_bt_gatt_status_t gatt_status = WICED_BT_GATT_SUCCESS;
+    le_app_conn_t *p_conn = le_app_conn_find(conn_id);
+
+    switch (p_val[0])
+    {
+    case LE_APP_THROUGHPUT_CMD_STOP:
+        /* The fill function ends the stream on its next call */
+        le_app_throughput_streaming = WICED_FALSE;
+        break;
+
+    case LE_APP_THROUGHPUT_CMD_START:
+        memset(&le_app_throughput_results.tx, 0, sizeof(le_app_throughput_results.tx));
+        le_app_throughput_tx_seq = 0;
+        le_app_throughput_tx_failures_base = p_conn->notify_failures;
+        cy_rtos_get_time(&le_app_throughput_tx_start);
+        le_app_throughput_conn_id = conn_id;
+        le_app_throughput_streaming = WICED_TRUE;
+
+        gatt_status = le_app_notify_conn(conn_id, HDLC_THROUGHPUT_DATA_VALUE);
+        if (WICED_BT_GATT_SUCCESS != gatt_status)
+        {
+            le_app_throughput_streaming = WICED_FALSE;
+        }
+        break;
+
+    case LE_APP_THROUGHPUT_CMD_RESET:
+        memset(&le_app_throughput_results, 0, sizeof(le_app_throughput_results));
+        le_app_throughput_rx_active = WICED_FALSE;
+        break;
+
+    default:
+        return WICED_BT_GATT_VALUE_NOT_ALLOWED;
+    }
+
+    LE_APP_LOG("Throughput command %d conn_id %d status 0x%x\r\n", p_val[0], conn_id, gatt_status);
+
+    return gatt_status;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_throughput_sink_check
+ ***************************************************************************************************
+ * Summary:
+ *   This function checks a payload written to the Sink characteristic. Any length is accepted,
+ *   as the payload is not stored.
+ *
+ * Parameters:
+ *   uint16_t conn_id            : Connection ID of the writer
+ *   uint16_t attr_handle        : HDLC_THROUGHPUT_SINK_VALUE
+ *   uint16_t offset             : Offset of the payload
+ *   const uint8_t *p_val        : Payload, starting with its sequence number
+ *   uint16_t len                : Length of the payload
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_INVALID_OFFSET unless the payload is written as a whole
+ *
+ **************************************************************************************************/
+static wiced_bt_gatt_status_t le_app_throughput_sink_check(uint16_t conn_id, uint16_t attr_handle,
+                                                           uint16_t offset, const uint8_t *p_val,
+                                                           uint16_t len)
+{
+    return (0 == offset) ? WICED_BT_GATT_SUCCESS : WICED_BT_GATT_INVALID_OFFSET;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_throughput_sink
+ ***************************************************************************************************
+ * Summary:
+ *   This function counts a payload written to the Sink characteristic. The payload is not stored.
+ *
+ * Parameters:
+ *   uint16_t conn_id            : Connection ID of the writer
+ *   uint16_t attr_handle        : HDLC_THROUGHPUT_SINK_VALUE
+ *   uint16_t offset             : Offset of the payload
+ *   const uint8_t *p_val        : Payload, starting with its sequence number
+ *   uint16_t len                : Length of the payload
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_HANDLED, as payloads are not stored
+ *
+ **************************************************************************************************/
+static wiced_bt_gatt_status_t le_app_throughput_sink(uint16_t conn_id, uint16_t attr_handle,
+                                                     uint16_t offset, const uint8_t *p_val,
+                                                     uint16_t len)
+{
+    le_app_throughput_dir_t *p_rx = &le_app_throughput_results.rx;
+    cy_time_t now;
+    uint32_t seq;
+
+    cy_rtos_get_time(&now);
+
+    if (LE_APP_THROUGHPUT_SEQ_SIZE <= len)
+    {
+        seq = (uint32_t)p_val[0] | ((uint32_t)p_val[1] << 8) |
+              ((uint32_t)p_val[2] << 16) | ((uint32_t)p_val[3] << 24);
+
+        if (!le_app_throughput_rx_active)
+        {
+            le_app_throughput_rx_active = WICED_TRUE;
+            le_app_throughput_rx_start = now;
+        }
+        else if (seq > le_app_throughput_rx_seq)
+        {
+            p_rx->drops += seq - le_app_throughput_rx_seq;
+        }
+        /* A lower sequence number means the client restarted its stream; resynchronize */
+        le_app_throughput_rx_seq = seq + 1;
+    }
+
+    p_rx->bytes += len;
+    p_rx->packets++;
+    p_rx->elapsed_ms = (uint32_t)(now - le_app_throughput_rx_start);
+
+    return WICED_BT_GATT_HANDLED;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_throughput_results_read
+ ***************************************************************************************************
+ * Summary:
+ *   This function refreshes the Results characteristic before a client reads it. The Read
+ *   Blob requests of a long read leave it alone, so all parts come from the same results.
+ *
+ * Parameters:
+ *   uint16_t conn_id            : Connection ID of the reader
+ *   uint16_t attr_handle        : HDLC_THROUGHPUT_RESULTS_VALUE
+ *   uint16_t offset             : Offset of the read
+ *
+ * Return:
+ *  wiced_bt_gatt_status_t: WICED_BT_GATT_SUCCESS
+ *
+ **************************************************************************************************/
+static wiced_bt_gatt_status_t le_app_throughput_results_read(uint16_t conn_id, uint16_t attr_handle,
+                                                             uint16_t offset)
+{
+    if (0 == offset)
+    {
+        le_app_throughput_publish();
+    }
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_throughput_fill
+ ***************************************************************************************************
+ * Summary:
+ *   This function produces the next Data payload: the sequence number followed by a byte
+ *   pattern, as long as the MTU allows.
+ *
+ * Parameters:
+ *   uint16_t conn_id            : Connection ID the payload is sent on
+ *   uint8_t *p_buf              : Destination of the payload
+ *   uint16_t max_len            : Largest payload that fits in one notification
+ *   wiced_bool_t *p_more        : Set while the stream is running
+ *
+ * Return:
+ *  uint16_t: Length of the payload, 0 once the stream is stopped
+ *
+ **************************************************************************************************/
+static uint16_t le_app_throughput_fill(uint16_t conn_id, uint8_t *p_buf, uint16_t max_len,
+                                       wiced_bool_t *p_more)
+{
+    le_app_throughput_dir_t *p_tx = &le_app_throughput_results.tx;
+    uint32_t seq;
+    cy_time_t now;
+
+    if (!le_app_throughput_streaming || (conn_id != le_app_throughput_conn_id) ||
+        (LE_APP_THROUGHPUT_SEQ_SIZE > max_len))
+    {
+        return 0;
+    }
+
+    seq = le_app_throughput_tx_seq++;
+    p_buf[0] = (uint8_t)seq;
+    p_buf[1] = (uint8_t)(seq >> 8);
+    p_buf[2] = (uint8_t)(seq >> 16);
+    p_buf[3] = (uint8_t)(seq >> 24);
+    memset(&p_buf[LE_APP_THROUGHPUT_SEQ_SIZE], (uint8_t)seq, max_len - LE_APP_THROUGHPUT_SEQ_SIZE);
+
+    cy_rtos_get_time(&now);
+    p_tx->bytes += max_len;
+    p_tx->packets++;
+    p_tx->elapsed_ms = (uint32_t)(now - le_app_throughput_tx_start);
+
+    *p_more = WICED_TRUE;
+    return max_len;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_throughput_publish
+ ***************************************************************************************************
+ * Summary:
+ *   This function copies the counters to the Results characteristic.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_throughput_publish(void)
+{
+    le_app_conn_t *p_conn = le_app_conn_find(le_app_throughput_conn_id);
+
+    /* Payloads the stack refused are counted by the notification scheduler */
+    if (NULL != p_conn)
+    {
+        le_app_throughput_results.tx.drops = p_conn->notify_failures - le_app_throughput_tx_failures_base;
+    }
+
+    memcpy(le_app_throughput_results_value, &le_app_throughput_results, sizeof(le_app_throughput_results));
+}
+
+#endif /* LE_APP_THROUGHPUT_ENABLE */
+
+/* [] END OF FILE */
@@ -0,0 +1,154 @@
+/*******************************************************************************
+* File Name: le_app_throughput.h
+*
+* Description:
+*   Header file for the GATT throughput test service
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef LE_APP_THROUGHPUT_H_
+#define LE_APP_THROUGHPUT_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_gatt.h"
+#include "le_app_gatts.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Set to 1 to add the throughput test service to the GATT database */
+#ifndef LE_APP_THROUGHPUT_ENABLE
+#define LE_APP_THROUGHPUT_ENABLE        (0)
+#endif
+
+/* Attribute handles of the service, which follows the generated database */
+#define HDLS_THROUGHPUT                             (0x0100u)
+#define HDLC_THROUGHPUT_CONTROL                     (0x0101u)
+#define HDLC_THROUGHPUT_CONTROL_VALUE               (0x0102u)
+#define HDLC_THROUGHPUT_DATA                        (0x0103u)
+#define HDLC_THROUGHPUT_DATA_VALUE                  (0x0104u)
+#define HDLD_THROUGHPUT_DATA_CLIENT_CHAR_CONFIG     (0x0105u)
+#define HDLC_THROUGHPUT_SINK                        (0x0106u)
+#define HDLC_THROUGHPUT_SINK_VALUE                  (0x0107u)
+#define HDLC_THROUGHPUT_RESULTS                     (0x0108u)
+#define HDLC_THROUGHPUT_RESULTS_VALUE               (0x0109u)
+
+/* UUIDs 1c5e00xx-5a2b-4e3f-9d7c-2f1a8b6c4d90, least significant byte first */
+#define __UUID_THROUGHPUT(id)   0x90, 0x4D, 0x6C, 0x8B, 0x1A, 0x2F, 0x7C, 0x9D, \
+                                0x3F, 0x4E, 0x2B, 0x5A, (id), 0x00, 0x5E, 0x1C
+#define __UUID_SERVICE_THROUGHPUT                   __UUID_THROUGHPUT(0x01)
+#define __UUID_CHARACTERISTIC_THROUGHPUT_CONTROL    __UUID_THROUGHPUT(0x02)
+#define __UUID_CHARACTERISTIC_THROUGHPUT_DATA       __UUID_THROUGHPUT(0x03)
+#define __UUID_CHARACTERISTIC_THROUGHPUT_SINK       __UUID_THROUGHPUT(0x04)
+#define __UUID_CHARACTERISTIC_THROUGHPUT_RESULTS    __UUID_THROUGHPUT(0x05)
+
+/* Commands written to the Control characteristic */
+#define LE_APP_THROUGHPUT_CMD_STOP      (0u)    /* Stop streaming and publish the results */
+#define LE_APP_THROUGHPUT_CMD_START     (1u)    /* Reset the TX counters and stream on the Data characteristic */
+#define LE_APP_THROUGHPUT_CMD_RESET     (2u)    /* Reset all counters */
+
+/* Bytes at the start of each Data and Sink payload that carry the little endian
+ * sequence number */
+#define LE_APP_THROUGHPUT_SEQ_SIZE      (4u)
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+/* Counters of one direction. All fields are little endian in the Results characteristic */
+typedef struct
+{
+    uint32_t bytes;                 /* Payload bytes */
+    uint32_t packets;               /* Notifications sent or writes received */
+    uint32_t elapsed_ms;            /* Time from the first to the last packet */
+    uint32_t drops;                 /* TX: payloads the stack refused, RX: sequence number gaps */
+} le_app_throughput_dir_t;
+
+/* Value of the Results characteristic */
+typedef struct
+{
+    le_app_throughput_dir_t tx;
+    le_app_throughput_dir_t rx;
+} le_app_throughput_results_t;
+
+/*******************************************************************************
+*        External Variable Declarations
+*******************************************************************************/
+#if LE_APP_THROUGHPUT_ENABLE
+/* Service added to the GATT database by le_app_gatts_init() */
+extern const le_app_gatts_service_t le_app_throughput_service;
+#endif
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+
+/**************************************************************************************************
+* Function Name: le_app_throughput_init
+***************************************************************************************************
+* Summary:
+*   This function registers the callbacks of the throughput test attributes and the Data
+*   characteristic as a streamed notification source.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  wiced_bt_gatt_status_t: See possible status codes in wiced_bt_gatt_status_e in wiced_bt_gatt.h
+*
+**************************************************************************************************/
+wiced_bt_gatt_status_t le_app_throughput_init(void);
+
+/**************************************************************************************************
+* Function Name: le_app_throughput_on_disconnect
+***************************************************************************************************
+* Summary:
+*   This function stops the stream when its connection closes, so that a later connection that
+*   gets the same connection ID is not streamed to.
+*
+* Parameters:
+*   uint16_t conn_id            : Connection ID
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_throughput_on_disconnect(uint16_t conn_id);
+
+#endif /* LE_APP_THROUGHPUT_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,498 @@
+/*******************************************************************************
+ * File Name: le_app_trace.c
+ *
+ * Description:
+ *   This file contains the connection lifecycle trace. Milestones go into a
+ *   fixed ring, and the time between consecutive milestones of a connection into
+ *   log2 histograms.
+ *
+ * Related Document: See Readme.md
+ *
+ *******************************************************************************
+ * Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/*******************************************************************************
+ *        Header Files
+ *******************************************************************************/
+#include "le_app_trace.h"
+
+#if LE_APP_TRACE_ENABLE
+
+#include "le_app_conn.h"
+#include "le_app_log.h"
+#include "cyabs_rtos.h"
+#include "cyhal.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *        Structures and Enumerations
+ *******************************************************************************/
+/* Milestones of one connection */
+typedef struct
+{
+    bool in_use;
+    uint16_t conn_id;
+    uint8_t seen;                   /* Bit per milestone reached */
+    uint8_t pending;                /* Bit per milestone whose next stage is not measured yet */
+    uint32_t time_ms[LE_APP_TRACE_MILESTONE_COUNT];
+    uint32_t cycles[LE_APP_TRACE_MILESTONE_COUNT];
+    uint32_t stage_us[LE_APP_TRACE_MILESTONE_COUNT];    /* Last latency of each stage */
+} le_app_trace_conn_t;
+
+/*******************************************************************************
+ *        Variable Definitions
+ *******************************************************************************/
+/* Milestone ring. le_app_trace_count counts every record, so the newest one is at
+ * (le_app_trace_count - 1) % LE_APP_TRACE_RING_SIZE */
+static le_app_trace_record_t le_app_trace_ring[LE_APP_TRACE_RING_SIZE];
+static uint32_t le_app_trace_count;
+
+static le_app_trace_conn_t le_app_trace_conns[LE_APP_MAX_CONNECTIONS];
+static le_app_trace_hist_t le_app_trace_hists[LE_APP_TRACE_MILESTONE_COUNT];
+
+/* First advertising start not yet claimed by a connection */
+static bool le_app_trace_adv_valid;
+static uint32_t le_app_trace_adv_time_ms;
+static uint32_t le_app_trace_adv_cycles;
+
+/* Connection whose alert level the next LED change applies */
+static bool le_app_trace_led_pending;
+static uint16_t le_app_trace_led_conn_id;
+
+static const char *const le_app_trace_milestone_names[LE_APP_TRACE_MILESTONE_COUNT] =
+{
+    [LE_APP_TRACE_ADV_START]        = "Advertising start",
+    [LE_APP_TRACE_CONNECT]          = "Connect",
+    [LE_APP_TRACE_MTU]              = "MTU exchange",
+    [LE_APP_TRACE_ALERT_WRITE]      = "Alert level write",
+    [LE_APP_TRACE_SET_VALUE]        = "Set value",
+    [LE_APP_TRACE_LED]              = "LED update",
+};
+
+/*******************************************************************************
+ *        Function Prototypes
+ *******************************************************************************/
+static le_app_trace_conn_t *le_app_trace_find(uint16_t conn_id);
+static uint32_t le_app_trace_elapsed_us(uint32_t start_ms, uint32_t start_cycles,
+                                        uint32_t end_ms, uint32_t end_cycles);
+static void le_app_trace_add(le_app_trace_milestone_t stage, uint32_t us);
+
+/*******************************************************************************
+ *        Function Definitions
+ *******************************************************************************/
+
+/**************************************************************************************************
+ * Function Name: le_app_trace_init
+ ***************************************************************************************************
+ * Summary:
+ *   This function starts the DWT cycle counter and clears the ring and the histograms.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_trace_init(void)
+{
+    memset(le_app_trace_ring, 0, sizeof(le_app_trace_ring));
+    memset(le_app_trace_conns, 0, sizeof(le_app_trace_conns));
+    memset(le_app_trace_hists, 0, sizeof(le_app_trace_hists));
+    le_app_trace_count = 0;
+    le_app_trace_adv_valid = false;
+    le_app_trace_led_pending = false;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_trace_record
+ ***************************************************************************************************
+ * Summary:
+ *   This function adds a milestone to the ring and, when the milestone before it is pending for
+ *   the connection, the stage latency to its histogram. It is called through LE_APP_TRACE()
+ *   from the Bluetooth stack context, and from the application thread for LE_APP_TRACE_LED.
+ *
+ * Parameters:
+ *   le_app_trace_milestone_t milestone  : Milestone reached
+ *   uint16_t conn_id                    : Connection ID
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_trace_record(le_app_trace_milestone_t milestone, uint16_t conn_id)
+{
+    le_app_trace_conn_t *p_trace = NULL;
+    le_app_trace_record_t *p_record;
+    cy_time_t now_ms = 0;
+    uint32_t cycles;
+    uint32_t saved_intr_status;
+    uint32_t us;
+
+    cy_rtos_get_time(&now_ms);
+    cycles = DWT->CYCCNT;
+
+    saved_intr_status = cyhal_system_critical_section_enter();
+
+    switch (milestone)
+    {
+    case LE_APP_TRACE_ADV_START:
+        /* Directed advertising is restarted until the window ends; keep the first start */
+        if (!le_app_trace_adv_valid)
+        {
+            le_app_trace_adv_valid = true;
+            le_app_trace_adv_time_ms = now_ms;
+            le_app_trace_adv_cycles = cycles;
+        }
+        break;
+
+    case LE_APP_TRACE_CONNECT:
+        p_trace = le_app_trace_find(conn_id);
+        for (uint32_t i = 0; (NULL == p_trace) && (i < LE_APP_MAX_CONNECTIONS); i++)
+        {
+            if (!le_app_trace_conns[i].in_use)
+            {
+                p_trace = &le_app_trace_conns[i];
+            }
+        }
+        if (NULL != p_trace)
+        {
+            memset(p_trace, 0, sizeof(*p_trace));
+            /* Stages that are not measured are logged as -1 */
+            memset(p_trace->stage_us, 0xFF, sizeof(p_trace->stage_us));
+            p_trace->in_use = true;
+            p_trace->conn_id = conn_id;
+
+            /* The connection claims the advertising that led to it */
+            if (le_app_trace_adv_valid)
+            {
+                le_app_trace_adv_valid = false;
+                p_trace->time_ms[LE_APP_TRACE_ADV_START] = le_app_trace_adv_time_ms;
+                p_trace->cycles[LE_APP_TRACE_ADV_START] = le_app_trace_adv_cycles;
+                p_trace->seen = p_trace->pending = (1u << LE_APP_TRACE_ADV_START);
+            }
+        }
+        break;
+
+    case LE_APP_TRACE_LED:
+        /* Only LED changes that follow an alert level write are traced */
+        if (le_app_trace_led_pending)
+        {
+            le_app_trace_led_pending = false;
+            conn_id = le_app_trace_led_conn_id;
+            p_trace = le_app_trace_find(conn_id);
+        }
+        break;
+
+    default:
+        p_trace = le_app_trace_find(conn_id);
+        break;
+    }
+
+    if ((LE_APP_TRACE_LED != milestone) || (NULL != p_trace))
+    {
+        p_record = &le_app_trace_ring[le_app_trace_count % LE_APP_TRACE_RING_SIZE];
+        p_record->time_ms = now_ms;
+        p_record->cycles = cycles;
+        p_record->conn_id = conn_id;
+        p_record->milestone = (uint8_t)milestone;
+        le_app_trace_count++;
+    }
+
+    if ((NULL != p_trace) && (LE_APP_TRACE_ADV_START != milestone))
+    {
+        /* Stage from the previous milestone, once per time that milestone was reached */
+        if (0 != (p_trace->pending & (1u << (milestone - 1))))
+        {
+            p_trace->pending &= ~(1u << (milestone - 1));
+            us = le_app_trace_elapsed_us(p_trace->time_ms[milestone - 1], p_trace->cycles[milestone - 1],
+                                         now_ms, cycles);
+            p_trace->stage_us[milestone] = us;
+            le_app_trace_add(milestone, us);
+        }
+
+        /* Advertising to the first LED change is the reconnect and alert time */
+        if ((LE_APP_TRACE_LED == milestone) && (0 == (p_trace->seen & (1u << LE_APP_TRACE_LED))) &&
+            (0 != (p_trace->seen & (1u << LE_APP_TRACE_ADV_START))))
+        {
+            us = le_app_trace_elapsed_us(p_trace->time_ms[LE_APP_TRACE_ADV_START],
+                                         p_trace->cycles[LE_APP_TRACE_ADV_START], now_ms, cycles);
+            p_trace->stage_us[LE_APP_TRACE_STAGE_TOTAL] = us;
+            le_app_trace_add(LE_APP_TRACE_STAGE_TOTAL, us);
+        }
+
+        p_trace->time_ms[milestone] = now_ms;
+        p_trace->cycles[milestone] = cycles;
+        p_trace->seen |= (1u << milestone);
+        p_trace->pending |= (1u << milestone);
+
+        if (LE_APP_TRACE_SET_VALUE == milestone)
+        {
+            le_app_trace_led_pending = true;
+            le_app_trace_led_conn_id = conn_id;
+        }
+    }
+
+    cyhal_system_critical_section_exit(saved_intr_status);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_trace_on_disconnect
+ ***************************************************************************************************
+ * Summary:
+ *   This function logs the stage latencies of a connection and releases its trace slot.
+ *   Stages that were not measured are logged as -1.
+ *
+ * Parameters:
+ *   uint16_t conn_id                    : Connection ID
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_trace_on_disconnect(uint16_t conn_id)
+{
+    uint32_t stage_us[LE_APP_TRACE_MILESTONE_COUNT];
+    le_app_trace_conn_t *p_trace;
+    uint32_t saved_intr_status = cyhal_system_critical_section_enter();
+
+    p_trace = le_app_trace_find(conn_id);
+    if (NULL != p_trace)
+    {
+        memcpy(stage_us, p_trace->stage_us, sizeof(stage_us));
+        p_trace->in_use = false;
+    }
+    if (le_app_trace_led_pending && (conn_id == le_app_trace_led_conn_id))
+    {
+        le_app_trace_led_pending = false;
+    }
+
+    cyhal_system_critical_section_exit(saved_intr_status);
+
+    if (NULL != p_trace)
+    {
+        LE_APP_LOG("Trace conn_id %d us: connect %ld mtu %ld write %ld set %ld led %ld\r\n", conn_id,
+                   stage_us[LE_APP_TRACE_CONNECT], stage_us[LE_APP_TRACE_MTU],
+                   stage_us[LE_APP_TRACE_ALERT_WRITE], stage_us[LE_APP_TRACE_SET_VALUE],
+                   stage_us[LE_APP_TRACE_LED]);
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_trace_get_hist
+ ***************************************************************************************************
+ * Summary:
+ *   This function copies the histogram of one stage.
+ *
+ * Parameters:
+ *   le_app_trace_milestone_t stage      : Milestone that ends the stage, or LE_APP_TRACE_STAGE_TOTAL
+ *   le_app_trace_hist_t *p_hist         : Destination of the histogram
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_trace_get_hist(le_app_trace_milestone_t stage, le_app_trace_hist_t *p_hist)
+{
+    uint32_t saved_intr_status = cyhal_system_critical_section_enter();
+
+    *p_hist = le_app_trace_hists[stage];
+
+    cyhal_system_critical_section_exit(saved_intr_status);
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_trace_print
+ ***************************************************************************************************
+ * Summary:
+ *   This function prints the records in the ring, oldest first, and every stage histogram that
+ *   has samples, in us.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+void le_app_trace_print(void)
+{
+    le_app_trace_record_t record;
+    le_app_trace_hist_t hist;
+    uint32_t saved_intr_status;
+    uint32_t count;
+    uint32_t first;
+
+    saved_intr_status = cyhal_system_critical_section_enter();
+    count = le_app_trace_count;
+    cyhal_system_critical_section_exit(saved_intr_status);
+
+    first = (count > LE_APP_TRACE_RING_SIZE) ? (count - LE_APP_TRACE_RING_SIZE) : 0;
+    printf("Lifecycle trace, %lu records (SystemCoreClock %lu Hz)\r\n", (unsigned long)(count - first),
+           (unsigned long)SystemCoreClock);
+
+    for (uint32_t i = first; i < count; i++)
+    {
+        /* Records newer than the snapshot of the count may overwrite the oldest ones meanwhile */
+        saved_intr_status = cyhal_system_critical_section_enter();
+        record = le_app_trace_ring[i % LE_APP_TRACE_RING_SIZE];
+        cyhal_system_critical_section_exit(saved_intr_status);
+
+        printf("%lu ms %lu cycles conn_id %u: %s\r\n", (unsigned long)record.time_ms,
+               (unsigned long)record.cycles, record.conn_id,
+               le_app_trace_milestone_names[record.milestone]);
+    }
+
+    for (uint32_t stage = 0; stage < LE_APP_TRACE_MILESTONE_COUNT; stage++)
+    {
+        le_app_trace_get_hist((le_app_trace_milestone_t)stage, &hist);
+        if (0 == hist.count)
+        {
+            continue;
+        }
+
+        if (LE_APP_TRACE_STAGE_TOTAL == stage)
+        {
+            printf("Advertising start to first LED update");
+        }
+        else
+        {
+            printf("%s to %s", le_app_trace_milestone_names[stage - 1], le_app_trace_milestone_names[stage]);
+        }
+        printf(": count %lu avg %lu max %lu us\r\n  log2 buckets:", (unsigned long)hist.count,
+               (unsigned long)(hist.total_us / hist.count), (unsigned long)hist.max_us);
+        for (uint32_t bucket = 0; bucket < LE_APP_TRACE_BUCKETS; bucket++)
+        {
+            printf(" %lu", (unsigned long)hist.buckets[bucket]);
+        }
+        printf("\r\n");
+    }
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_trace_find
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns the trace slot of a connection.
+ *
+ * Parameters:
+ *   uint16_t conn_id                    : Connection ID
+ *
+ * Return:
+ *  le_app_trace_conn_t *: Slot of the connection, or NULL if it is not traced
+ *
+ **************************************************************************************************/
+static le_app_trace_conn_t *le_app_trace_find(uint16_t conn_id)
+{
+    for (uint32_t i = 0; i < LE_APP_MAX_CONNECTIONS; i++)
+    {
+        if (le_app_trace_conns[i].in_use && (conn_id == le_app_trace_conns[i].conn_id))
+        {
+            return &le_app_trace_conns[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_trace_elapsed_us
+ ***************************************************************************************************
+ * Summary:
+ *   This function returns the time between two milestones. Short stages use the cycle counter,
+ *   long ones the RTOS time, as the cycle counter wraps within seconds.
+ *
+ * Parameters:
+ *   uint32_t start_ms                   : RTOS time of the first milestone
+ *   uint32_t start_cycles               : DWT->CYCCNT at the first milestone
+ *   uint32_t end_ms                     : RTOS time of the second milestone
+ *   uint32_t end_cycles                 : DWT->CYCCNT at the second milestone
+ *
+ * Return:
+ *  uint32_t: Elapsed time in us
+ *
+ **************************************************************************************************/
+static uint32_t le_app_trace_elapsed_us(uint32_t start_ms, uint32_t start_cycles,
+                                        uint32_t end_ms, uint32_t end_cycles)
+{
+    uint32_t elapsed_ms = end_ms - start_ms;
+
+    if (LE_APP_TRACE_CYCLES_MAX_MS > elapsed_ms)
+    {
+        return (end_cycles - start_cycles) / (SystemCoreClock / 1000000u);
+    }
+
+    return elapsed_ms * 1000u;
+}
+
+/**************************************************************************************************
+ * Function Name: le_app_trace_add
+ ***************************************************************************************************
+ * Summary:
+ *   This function adds a stage latency to its histogram.
+ *
+ * Parameters:
+ *   le_app_trace_milestone_t stage      : Milestone that ends the stage, or LE_APP_TRACE_STAGE_TOTAL
+ *   uint32_t us                         : Latency in us
+ *
+ * Return:
+ *  None
+ *
+ **************************************************************************************************/
+static void le_app_trace_add(le_app_trace_milestone_t stage, uint32_t us)
+{
+    le_app_trace_hist_t *p_hist = &le_app_trace_hists[stage];
+    uint32_t bucket = (0 == us) ? 0 : (31u - __CLZ(us));
+
+    if (LE_APP_TRACE_BUCKETS <= bucket)
+    {
+        bucket = LE_APP_TRACE_BUCKETS - 1;
+    }
+
+    p_hist->count++;
+    p_hist->total_us += us;
+    p_hist->buckets[bucket]++;
+    if (us > p_hist->max_us)
+    {
+        p_hist->max_us = us;
+    }
+}
+
+#endif /* LE_APP_TRACE_ENABLE */
+
+/* [] END OF FILE */
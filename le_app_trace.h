@@ -0,0 +1,218 @@
+/*******************************************************************************
+* File Name: le_app_trace.h
+*
+* Description:
+*   This file contains the connection lifecycle trace, which timestamps the
+*   milestones from advertising to the IAS LED change and keeps per-stage latency
+*   histograms.
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef LE_APP_TRACE_H_
+#define LE_APP_TRACE_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include <stdint.h>
+#include "GeneratedSource/cycfg_gatt_db.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Set to 1 to trace the connection lifecycle. Set from the Makefile with LIFECYCLE_TRACE=1 */
+#ifndef LE_APP_TRACE_ENABLE
+#define LE_APP_TRACE_ENABLE             (0)
+#endif
+
+/* Milestone records kept in the ring. The oldest record is overwritten when it is full */
+#define LE_APP_TRACE_RING_SIZE          (64u)
+
+/* Number of log2 buckets per stage histogram. Bucket n counts latencies of 2^n to
+ * 2^(n+1) - 1 us; the last bucket also counts everything longer */
+#define LE_APP_TRACE_BUCKETS            (24u)
+
+/* Stage latencies shorter than this are measured with the cycle counter, longer ones with the
+ * RTOS time. It must stay below the wrap time of DWT->CYCCNT */
+#define LE_APP_TRACE_CYCLES_MAX_MS      (1000u)
+
+#if LE_APP_TRACE_ENABLE
+/* Records a milestone of a connection. conn_id is ignored for LE_APP_TRACE_ADV_START and
+ * LE_APP_TRACE_LED */
+#define LE_APP_TRACE(milestone, conn_id)    le_app_trace_record((milestone), (conn_id))
+
+/* Records LE_APP_TRACE_ALERT_WRITE when a write or prepare write request to the IAS Alert
+ * Level is received */
+#define LE_APP_TRACE_WRITE(conn_id, attr_handle)                                \
+    do                                                                          \
+    {                                                                           \
+        if (HDLC_IAS_ALERT_LEVEL_VALUE == (attr_handle))                        \
+        {                                                                       \
+            le_app_trace_record(LE_APP_TRACE_ALERT_WRITE, (conn_id));           \
+        }                                                                       \
+    } while (0)
+#else
+#define LE_APP_TRACE(milestone, conn_id)
+#define LE_APP_TRACE_WRITE(conn_id, attr_handle)
+#endif
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+/* Milestones in the order they are expected. Stage n is the time from milestone n - 1 to n */
+typedef enum
+{
+    LE_APP_TRACE_ADV_START,         /* Advertising started for the next connection */
+    LE_APP_TRACE_CONNECT,           /* Connection up */
+    LE_APP_TRACE_MTU,               /* ATT MTU agreed */
+    LE_APP_TRACE_ALERT_WRITE,       /* Write or prepare write request to the IAS Alert Level received */
+    LE_APP_TRACE_SET_VALUE,         /* Alert level passed the checks and reached its write callback */
+    LE_APP_TRACE_LED,               /* ias_led_update() applied the alert level */
+    LE_APP_TRACE_MILESTONE_COUNT
+} le_app_trace_milestone_t;
+
+/* Stage histograms, by the milestone that ends the stage. The slot of LE_APP_TRACE_ADV_START
+ * holds the total from advertising to the first LED change of a connection */
+#define LE_APP_TRACE_STAGE_TOTAL        (LE_APP_TRACE_ADV_START)
+
+/* One milestone in the ring */
+typedef struct
+{
+    uint32_t time_ms;               /* cy_rtos_get_time() */
+    uint32_t cycles;                /* DWT->CYCCNT */
+    uint16_t conn_id;
+    uint8_t milestone;              /* le_app_trace_milestone_t */
+    uint8_t reserved;
+} le_app_trace_record_t;
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t max_us;
+    uint64_t total_us;
+    uint32_t buckets[LE_APP_TRACE_BUCKETS];
+} le_app_trace_hist_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+#if LE_APP_TRACE_ENABLE
+
+/**************************************************************************************************
+* Function Name: le_app_trace_init
+***************************************************************************************************
+* Summary:
+*   This function starts the DWT cycle counter and clears the ring and the histograms.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_trace_init(void);
+
+/**************************************************************************************************
+* Function Name: le_app_trace_record
+***************************************************************************************************
+* Summary:
+*   This function adds a milestone to the ring and, when the milestone before it is pending for
+*   the connection, the stage latency to its histogram. It is called through LE_APP_TRACE()
+*   from the Bluetooth stack context, and from the application thread for LE_APP_TRACE_LED.
+*
+* Parameters:
+*   le_app_trace_milestone_t milestone  : Milestone reached
+*   uint16_t conn_id                    : Connection ID
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_trace_record(le_app_trace_milestone_t milestone, uint16_t conn_id);
+
+/**************************************************************************************************
+* Function Name: le_app_trace_on_disconnect
+***************************************************************************************************
+* Summary:
+*   This function logs the stage latencies of a connection and releases its trace slot.
+*
+* Parameters:
+*   uint16_t conn_id                    : Connection ID
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_trace_on_disconnect(uint16_t conn_id);
+
+/**************************************************************************************************
+* Function Name: le_app_trace_get_hist
+***************************************************************************************************
+* Summary:
+*   This function copies the histogram of one stage.
+*
+* Parameters:
+*   le_app_trace_milestone_t stage      : Milestone that ends the stage, or LE_APP_TRACE_STAGE_TOTAL
+*   le_app_trace_hist_t *p_hist         : Destination of the histogram
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_trace_get_hist(le_app_trace_milestone_t stage, le_app_trace_hist_t *p_hist);
+
+/**************************************************************************************************
+* Function Name: le_app_trace_print
+***************************************************************************************************
+* Summary:
+*   This function prints the records in the ring, oldest first, and every stage histogram that
+*   has samples, in us.
+*
+* Parameters:
+*   None
+*
+* Return:
+*  None
+*
+**************************************************************************************************/
+void le_app_trace_print(void);
+
+#endif /* LE_APP_TRACE_ENABLE */
+
+#endif /* LE_APP_TRACE_H_ */
+
+/* [] END OF FILE */
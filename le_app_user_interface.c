@@ -42,32 +42,14 @@
  *        Header Files
  *******************************************************************************/
 #include "le_app_user_interface.h"
+#include "le_app_led.h"
+#include "le_app_trace.h"
 /*******************************************************************************
  *        Variable Definitions
  *******************************************************************************/
-#ifdef CYBSP_USER_LED1
-/* create PWM object for Alert LED */
-cyhal_pwm_t ias_led_pwm;
-#endif
-/* CYBSP_USER_LED2 is only present on some kits. For those kits,it is used to indicate advertising/connection status */
-/* create PWM object for second LED only if it exists */
-
-/*******************************************************************************
- *        External Variable Declarations
- *******************************************************************************/
-extern app_bt_adv_conn_mode_t app_bt_adv_conn_state;
-
-#ifdef CYBSP_USER_LED2
-cyhal_pwm_t adv_led_pwm;
-#endif
-
-/* PWM Duty Cycle of LED's for different states */
-enum
-{
-    LED_ON_DUTY_CYCLE = 0,
-    LED_BLINKING_DUTY_CYCLE = 50,
-    LED_OFF_DUTY_CYCLE = 100
-} led_duty_cycles;
+/* LED state, owned by the application thread */
+app_bt_adv_conn_mode_t app_bt_adv_conn_state = APP_BT_ADV_OFF_CONN_OFF;
+uint8_t app_bt_alert_level = IAS_ALERT_LEVEL_LOW;
 
 /*******************************************************************************
  *        Function Prototypes
@@ -82,8 +64,9 @@ enum
  ********************************************************************************
  *
  * Summary:
- *   This function updates the advertising LED state based on LE advertising/
- *   connection state
+ *   This function updates the advertising LED pattern based on LE advertising/
+ *   connection state. The LED engine ignores the request if the pattern does
+ *   not change.
  *
  * Parameters:
  *   None
@@ -94,48 +77,26 @@ enum
  *******************************************************************************/
 void adv_led_update(void)
 {
-    /* CYBSP_USER_LED2 is only present on some kits. For those kits,it is used to indicate advertising/connection status */
-#ifdef CYBSP_USER_LED2
-    cy_rslt_t cy_result = CY_RSLT_SUCCESS;
-    /* Stop the advertising led pwm */
-    cyhal_pwm_stop(&adv_led_pwm);
-
     /* Update LED state based on LE advertising/connection state.
      * LED OFF for no advertisement/connection, LED blinking for advertisement
      * state, and LED ON for connected state  */
-
     switch (app_bt_adv_conn_state)
     {
-    case APP_BT_ADV_OFF_CONN_OFF:
-        cy_result = cyhal_pwm_set_duty_cycle(&adv_led_pwm, 0, ADV_LED_PWM_FREQUENCY);
-        break;
-
     case APP_BT_ADV_ON_CONN_OFF:
-        cy_result = cyhal_pwm_set_duty_cycle(&adv_led_pwm, LED_BLINKING_DUTY_CYCLE, ADV_LED_PWM_FREQUENCY);
+        le_app_led_set(LE_APP_LED_ADV, LE_APP_LED_PATTERN_BLINK);
         break;
 
     case APP_BT_ADV_OFF_CONN_ON:
-        cy_result = cyhal_pwm_set_duty_cycle(&adv_led_pwm, 100, ADV_LED_PWM_FREQUENCY);
+    case APP_BT_ADV_ON_CONN_ON:
+        le_app_led_set(LE_APP_LED_ADV, LE_APP_LED_PATTERN_ON);
         break;
 
+    case APP_BT_ADV_OFF_CONN_OFF:
     default:
         /* LED OFF for unexpected states */
-        cy_result = cyhal_pwm_set_duty_cycle(&adv_led_pwm, 0, ADV_LED_PWM_FREQUENCY);
+        le_app_led_set(LE_APP_LED_ADV, LE_APP_LED_PATTERN_OFF);
         break;
     }
-    /* Check if update to PWM parameters is successful*/
-    if (CY_RSLT_SUCCESS != cy_result)
-    {
-        printf("Failed to set duty cycle parameters!!");
-    }
-
-    cy_result = cyhal_pwm_start(&adv_led_pwm);
-    /* Check if PWM started successfully */
-    if (CY_RSLT_SUCCESS != cy_result)
-    {
-        printf("Failed to start PWM !!");
-    }
-#endif
 }
 #endif
 #ifdef CYBSP_USER_LED1
@@ -144,8 +105,8 @@ void adv_led_update(void)
  ********************************************************************************
  *
  * Summary:
- *   This function updates the IAS alert level LED state based on LE
- *   advertising/connection state
+ *   This function updates the IAS alert level LED pattern based on LE
+ *   advertising/connection state and app_bt_alert_level
  *
  * Parameters:
  *   None
@@ -156,52 +117,33 @@ void adv_led_update(void)
  *******************************************************************************/
 void ias_led_update(void)
 {
-    cy_rslt_t cy_result = CY_RSLT_SUCCESS;
-    /* Stop the IAS led pwm */
-    cyhal_pwm_stop(&ias_led_pwm);
-
     /* Update LED based on IAS alert level only when the device is connected */
-    if (APP_BT_ADV_OFF_CONN_ON == app_bt_adv_conn_state)
+    if ((APP_BT_ADV_OFF_CONN_ON == app_bt_adv_conn_state) || (APP_BT_ADV_ON_CONN_ON == app_bt_adv_conn_state))
     {
         /* Update LED state based on IAS alert level. LED OFF for low level,
          * LED blinking for mid level, and LED ON for high level  */
-        switch (app_ias_alert_level[0])
+        switch (app_bt_alert_level)
         {
         case IAS_ALERT_LEVEL_LOW:
-            cy_result = cyhal_pwm_set_duty_cycle(&ias_led_pwm, LED_OFF_DUTY_CYCLE, IAS_LED_PWM_FREQUENCY);
+            le_app_led_set(LE_APP_LED_IAS, LE_APP_LED_PATTERN_OFF);
             break;
 
         case IAS_ALERT_LEVEL_MID:
-            cy_result = cyhal_pwm_set_duty_cycle(&ias_led_pwm, LED_BLINKING_DUTY_CYCLE, IAS_LED_PWM_FREQUENCY);
+            le_app_led_set(LE_APP_LED_IAS, LE_APP_LED_PATTERN_BLINK);
             break;
 
         case IAS_ALERT_LEVEL_HIGH:
-            cy_result = cyhal_pwm_set_duty_cycle(&ias_led_pwm, LED_ON_DUTY_CYCLE, IAS_LED_PWM_FREQUENCY);
-            break;
-
         default:
             /* Consider any other level as High alert level */
-            cy_result = cyhal_pwm_set_duty_cycle(&ias_led_pwm, LED_ON_DUTY_CYCLE, IAS_LED_PWM_FREQUENCY);
+            le_app_led_set(LE_APP_LED_IAS, LE_APP_LED_PATTERN_ON);
             break;
         }
+        LE_APP_TRACE(LE_APP_TRACE_LED, 0);
     }
     else
     {
         /* In case of disconnection, turn off the IAS LED */
-        cy_result = cyhal_pwm_set_duty_cycle(&ias_led_pwm, LED_OFF_DUTY_CYCLE, IAS_LED_PWM_FREQUENCY);
-    }
-
-    /* Check if update to PWM parameters is successful*/
-    if (CY_RSLT_SUCCESS != cy_result)
-    {
-        printf("Failed to set duty cycle parameters!!");
-    }
-
-    cy_result = cyhal_pwm_start(&ias_led_pwm);
-    /* Check if PWM started successfully */
-    if (CY_RSLT_SUCCESS != cy_result)
-    {
-        printf("Failed to start PWM !!");
+        le_app_led_set(LE_APP_LED_IAS, LE_APP_LED_PATTERN_OFF);
     }
 }
 #endif
@@ -53,10 +53,6 @@
 *        Macro Definitions
 *******************************************************************************/
 
-/* PWM frequency of LED's in Hertz when blinking */
-#define IAS_LED_PWM_FREQUENCY          (2)
-#define ADV_LED_PWM_FREQUENCY          (2)
-
 /* IAS Alert Levels */
 #define IAS_ALERT_LEVEL_LOW             (0u)
 #define IAS_ALERT_LEVEL_MID             (1u)
@@ -68,9 +64,17 @@ typedef enum
 {
     APP_BT_ADV_OFF_CONN_OFF,
     APP_BT_ADV_ON_CONN_OFF,
-    APP_BT_ADV_OFF_CONN_ON
+    APP_BT_ADV_OFF_CONN_ON,
+    APP_BT_ADV_ON_CONN_ON
 } app_bt_adv_conn_mode_t;
 
+/*******************************************************************************
+*        External Variable Declarations
+*******************************************************************************/
+/* LED state. Only the application thread reads or writes these */
+extern app_bt_adv_conn_mode_t app_bt_adv_conn_state;
+extern uint8_t app_bt_alert_level;
+
 /*******************************************************************************
 *        Function Prototypes
 *******************************************************************************/
@@ -80,7 +84,7 @@ typedef enum
 ********************************************************************************
 *
 * Summary:
-*   This function updates the advertising LED state based on LE advertising/
+*   This function updates the advertising LED pattern based on LE advertising/
 *   connection state
 *
 * Parameters:
@@ -97,8 +101,8 @@ void adv_led_update(void);
 ********************************************************************************
 *
 * Summary:
-*   This function updates the IAS alert level LED state based on LE
-*   advertising/connection state
+*   This function updates the IAS alert level LED pattern based on LE
+*   advertising/connection state and app_bt_alert_level
 *
 * Parameters:
 *   None
@@ -44,7 +44,26 @@
 #include "le_app_utils.h"
 #include "wiced_bt_dev.h"
 #include "cy_retarget_io.h"
-#include "stdlib.h"
+#include "cyhal.h"
+#include <string.h>
+/******************************************************************************
+ * Variable Definitions
+ ******************************************************************************/
+/* Pool storage, word aligned so that every block is word aligned */
+static uint32_t app_buffer_pool[APP_BUFFER_POOL_BLOCK_COUNT][(APP_BUFFER_POOL_BLOCK_SIZE + 3u) / 4u];
+
+/* Stack of free block indices; the top app_buffer_free_count entries are free */
+static uint8_t app_buffer_free_list[APP_BUFFER_POOL_BLOCK_COUNT];
+static uint32_t app_buffer_free_count;
+
+/* Bitmap of the allocated blocks, used to reject a second free of the same block */
+static uint32_t app_buffer_in_use;
+#if (APP_BUFFER_POOL_BLOCK_COUNT > 32u)
+#error "app_buffer_in_use holds one bit per block; APP_BUFFER_POOL_BLOCK_COUNT must not exceed 32"
+#endif
+
+static app_buffer_pool_stats_t app_buffer_pool_stats;
+
 /****************************************************************************
  * FUNCTION DEFINITIONS
  ***************************************************************************/
@@ -111,7 +130,7 @@ void print_array(void * to_print, uint16_t len)
 *  wiced_bt_management_evt_t
 *
 *******************************************************************************/
-const char *get_btm_event_name(wiced_bt_management_evt_t event)
+le_app_log_str_t get_btm_event_name(wiced_bt_management_evt_t event)
 {
     switch ( (int)event )
     {
@@ -153,7 +172,7 @@ const char *get_btm_event_name(wiced_bt_management_evt_t event)
     CASE_RETURN_STR(BTM_BLE_DATA_LENGTH_UPDATE_EVENT)
     }
 
-    return "UNKNOWN_EVENT";
+    return LE_APP_LOG_NAME("UNKNOWN_EVENT");
 }
 
 /*******************************************************************************
@@ -171,7 +190,7 @@ const char *get_btm_event_name(wiced_bt_management_evt_t event)
 *  wiced_bt_ble_advert_mode_t
 *
 *******************************************************************************/
-const char *get_bt_advert_mode_name(wiced_bt_ble_advert_mode_t mode)
+le_app_log_str_t get_bt_advert_mode_name(wiced_bt_ble_advert_mode_t mode)
 {
     switch ( (int)mode )
     {
@@ -186,7 +205,7 @@ const char *get_bt_advert_mode_name(wiced_bt_ble_advert_mode_t mode)
     CASE_RETURN_STR(BTM_BLE_ADVERT_DISCOVERABLE_LOW)
     }
 
-    return "UNKNOWN_MODE";
+    return LE_APP_LOG_NAME("UNKNOWN_MODE");
 }
 
 /*******************************************************************************
@@ -204,7 +223,7 @@ const char *get_bt_advert_mode_name(wiced_bt_ble_advert_mode_t mode)
 *  wiced_bt_gatt_disconn_reason_t
 *
 *******************************************************************************/
-const char *get_bt_gatt_disconn_reason_name(wiced_bt_gatt_disconn_reason_t reason)
+le_app_log_str_t get_bt_gatt_disconn_reason_name(wiced_bt_gatt_disconn_reason_t reason)
 {
     switch ( (int)reason )
     {
@@ -218,7 +237,7 @@ const char *get_bt_gatt_disconn_reason_name(wiced_bt_gatt_disconn_reason_t reaso
     CASE_RETURN_STR(GATT_CONN_CANCEL)
     }
 
-    return "UNKNOWN_REASON";
+    return LE_APP_LOG_NAME("UNKNOWN_REASON");
 }
 
 /*******************************************************************************
@@ -236,7 +255,7 @@ const char *get_bt_gatt_disconn_reason_name(wiced_bt_gatt_disconn_reason_t reaso
 *  wiced_bt_gatt_status_t
 *
 *******************************************************************************/
-const char *get_bt_gatt_status_name(wiced_bt_gatt_status_t status)
+le_app_log_str_t get_bt_gatt_status_name(wiced_bt_gatt_status_t status)
 {
     switch ( (int)status )
     {
@@ -288,7 +307,7 @@ const char *get_bt_gatt_status_name(wiced_bt_gatt_status_t status)
     CASE_RETURN_STR(WICED_BT_GATT_INVALID_CONNECTION_ID)
     }
 
-    return "UNKNOWN_STATUS";
+    return LE_APP_LOG_NAME("UNKNOWN_STATUS");
 }
 
 /*******************************************************************************
@@ -306,7 +325,7 @@ const char *get_bt_gatt_status_name(wiced_bt_gatt_status_t status)
 *  wiced_bt_smp_status_t
 *
 *******************************************************************************/
-const char *get_bt_smp_status_name(wiced_bt_smp_status_t status)
+le_app_log_str_t get_bt_smp_status_name(wiced_bt_smp_status_t status)
 {
 
     switch ((int)status)
@@ -340,16 +359,60 @@ const char *get_bt_smp_status_name(wiced_bt_smp_status_t status)
         CASE_RETURN_STR(SMP_CONN_TOUT)         /**< Connection timeout */
     }
 
-    return "UNKNOWN_STATUS";
+    return LE_APP_LOG_NAME("UNKNOWN_STATUS");
 }
 
 
 /*******************************************************************************
- * Function Name: app_free_buffer
+ * Function Name: app_buffer_pool_init
+ *******************************************************************************
+ * Summary:
+ *  This function marks every block of the GATT response buffer pool as free.
+ *  It must be called before the GATT callback is registered with the stack.
+ *
+ ******************************************************************************/
+void app_buffer_pool_init(void)
+{
+    uint32_t saved_intr_status = cyhal_system_critical_section_enter();
+
+    for (uint32_t i = 0; i < APP_BUFFER_POOL_BLOCK_COUNT; i++)
+    {
+        app_buffer_free_list[i] = (uint8_t)i;
+    }
+    app_buffer_free_count = APP_BUFFER_POOL_BLOCK_COUNT;
+    app_buffer_in_use = 0;
+    memset(&app_buffer_pool_stats, 0, sizeof(app_buffer_pool_stats));
+
+    cyhal_system_critical_section_exit(saved_intr_status);
+}
+
+/*******************************************************************************
+ * Function Name: app_buffer_pool_get_stats
  *******************************************************************************
  * Summary:
- *  This function frees up the memory buffer
+ *  This function copies the GATT response buffer pool counters.
  *
+ * Parameters:
+ *  app_buffer_pool_stats_t *p_stats: Destination of the counters
+ *
+ ******************************************************************************/
+void app_buffer_pool_get_stats(app_buffer_pool_stats_t *p_stats)
+{
+    uint32_t saved_intr_status = cyhal_system_critical_section_enter();
+
+    *p_stats = app_buffer_pool_stats;
+
+    cyhal_system_critical_section_exit(saved_intr_status);
+}
+
+/*******************************************************************************
+ * Function Name: app_free_buffer
+ *******************************************************************************
+ * Summary:
+ *  This function returns a buffer to the GATT response buffer pool. Pointers
+ *  outside the pool are ignored, and a free of a block that is not allocated
+ *  asserts and is ignored. It may be called from the Bluetooth stack context
+ *  and from the application threads.
  *
  * Parameters:
  *  uint8_t *p_data: Pointer to the buffer to be free
@@ -357,28 +420,85 @@ const char *get_bt_smp_status_name(wiced_bt_smp_status_t status)
  ******************************************************************************/
 void app_free_buffer(uint8_t *p_buf)
 {
-    if (p_buf != NULL)
+    uint32_t saved_intr_status;
+    uintptr_t offset;
+    uint32_t block;
+
+    if (p_buf == NULL)
+    {
+        return;
+    }
+
+    /* Ignore pointers that do not point to the start of a pool block */
+    offset = (uintptr_t)p_buf - (uintptr_t)app_buffer_pool;
+    if (((uintptr_t)p_buf < (uintptr_t)app_buffer_pool) ||
+        (offset >= sizeof(app_buffer_pool)) ||
+        (0 != (offset % sizeof(app_buffer_pool[0]))))
+    {
+        return;
+    }
+
+    block = (uint32_t)(offset / sizeof(app_buffer_pool[0]));
+
+    saved_intr_status = cyhal_system_critical_section_enter();
+
+    /* A block that is not allocated is already on the free list; pushing it again
+     * would overrun the list and hand the block out twice */
+    if (0 == (app_buffer_in_use & (1u << block)))
     {
-        printf( "%s()        free:%p \r\n",__FUNCTION__, p_buf);
-        free(p_buf);
+        cyhal_system_critical_section_exit(saved_intr_status);
+        LE_APP_LOG("Free of GATT buffer block %u that is not allocated\r\n", (unsigned int)block);
+        CY_ASSERT(0);
+        return;
     }
+
+    app_buffer_in_use &= ~(1u << block);
+    app_buffer_free_list[app_buffer_free_count++] = (uint8_t)block;
+    app_buffer_pool_stats.in_use--;
+
+    cyhal_system_critical_section_exit(saved_intr_status);
 }
 
 /*******************************************************************************
  * Function Name: app_alloc_buffer
  *******************************************************************************
  * Summary:
- *  This function allocates a memory buffer.
+ *  This function allocates a buffer from the GATT response buffer pool.
  *
  *
  * Parameters:
  *  int len: Length to allocate
  *
+ * Return:
+ *  Pointer to the buffer, or NULL if len exceeds APP_BUFFER_POOL_BLOCK_SIZE
+ *  or the pool is exhausted
+ *
  ******************************************************************************/
 void* app_alloc_buffer(int len)
 {
-    uint8_t *p = (uint8_t *)malloc(len);
-    printf( "%s() len %d alloc %p \r\n", __FUNCTION__,len, p);
+    uint32_t saved_intr_status;
+    uint8_t *p = NULL;
+
+    saved_intr_status = cyhal_system_critical_section_enter();
+
+    if ((len <= (int)APP_BUFFER_POOL_BLOCK_SIZE) && (0 != app_buffer_free_count))
+    {
+        uint32_t block = app_buffer_free_list[--app_buffer_free_count];
+
+        app_buffer_in_use |= (1u << block);
+        p = (uint8_t *)app_buffer_pool[block];
+        if (++app_buffer_pool_stats.in_use > app_buffer_pool_stats.high_water)
+        {
+            app_buffer_pool_stats.high_water = app_buffer_pool_stats.in_use;
+        }
+    }
+    else
+    {
+        app_buffer_pool_stats.alloc_failures++;
+    }
+
+    cyhal_system_critical_section_exit(saved_intr_status);
+
     return p;
 }
 
@@ -48,17 +48,34 @@
  ******************************************************************************/
 #include <stdio.h>
 #include "wiced_bt_dev.h"
+#include "le_app_log.h"
 #include "wiced_bt_gatt.h"
 #include "wiced_memory.h"
+#include "le_app_gatts.h"
 /******************************************************************************
  * Constants
  ******************************************************************************/
-#define CASE_RETURN_STR(const)          case const: return #const;
+#define CASE_RETURN_STR(const)          case const: return LE_APP_LOG_NAME(#const);
 
 #define FROM_BIT16_TO_8(val)            ((uint8_t)(((val) >> 8 )& 0xff))
 
+/* Number of blocks in the GATT response buffer pool. Notifications take at most
+ * LE_APP_NOTIFY_CREDITS blocks per connection; the rest serve responses */
+#define APP_BUFFER_POOL_BLOCK_COUNT     (16u)
+
+/* Size of each pool block; a response buffer never exceeds the negotiated ATT MTU */
+#define APP_BUFFER_POOL_BLOCK_SIZE      (LE_APP_GATT_MAX_MTU_SIZE)
+
 typedef void                 (*pfn_free_buffer_t)            (uint8_t *);
 
+/* Usage counters of the GATT response buffer pool */
+typedef struct
+{
+    uint32_t in_use;            /* Blocks currently allocated */
+    uint32_t high_water;        /* Largest number of blocks allocated at the same time */
+    uint32_t alloc_failures;    /* Allocations rejected because the pool was exhausted or len was too large */
+} app_buffer_pool_stats_t;
+
 /****************************************************************************
  * FUNCTION DECLARATIONS
  ***************************************************************************/
@@ -66,15 +83,19 @@ void print_bd_address(wiced_bt_device_address_t bdadr);
 
 void print_array(void * to_print, uint16_t len);
 
-const char *get_btm_event_name(wiced_bt_management_evt_t event);
+le_app_log_str_t get_btm_event_name(wiced_bt_management_evt_t event);
+
+le_app_log_str_t get_bt_advert_mode_name(wiced_bt_ble_advert_mode_t mode);
+
+le_app_log_str_t get_bt_gatt_disconn_reason_name(wiced_bt_gatt_disconn_reason_t reason);
 
-const char *get_bt_advert_mode_name(wiced_bt_ble_advert_mode_t mode);
+le_app_log_str_t get_bt_gatt_status_name(wiced_bt_gatt_status_t status);
 
-const char *get_bt_gatt_disconn_reason_name(wiced_bt_gatt_disconn_reason_t reason);
+le_app_log_str_t get_bt_smp_status_name(wiced_bt_smp_status_t status);
 
-const char *get_bt_gatt_status_name(wiced_bt_gatt_status_t status);
+void app_buffer_pool_init(void);
 
-const char *get_bt_smp_status_name(wiced_bt_smp_status_t status);
+void app_buffer_pool_get_stats(app_buffer_pool_stats_t *p_stats);
 
 void* app_alloc_buffer(int len);
 
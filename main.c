@@ -45,6 +45,13 @@
  *******************************************************************************/
 #include <le_app_event_handler.h>
 #include <le_app_utils.h>
+#include <le_app_log.h>
+#include <le_app_latency.h>
+#include <le_app_trace.h>
+#include <le_app_evt_rec.h>
+#include <le_app_bond.h>
+#include <le_app_thread.h>
+#include <le_app_pm.h>
 #include <string.h>
 #include "cyhal.h"
 #include "cybsp.h"
@@ -100,6 +107,51 @@ int main()
 
     printf("\r\n************* Find Me Profile Application Start ************************\r\n");
 
+    /* Start the thread that prints log entries recorded from the Bluetooth callbacks */
+    cy_result = le_app_log_init();
+    if (CY_RSLT_SUCCESS != cy_result)
+    {
+        printf("Log thread creation failed\r\n");
+        CY_ASSERT(0);
+    }
+
+    /* Start the thread that handles the work posted by the Bluetooth callbacks */
+    cy_result = le_app_thread_init();
+    if (CY_RSLT_SUCCESS != cy_result)
+    {
+        printf("Application thread creation failed\r\n");
+        CY_ASSERT(0);
+    }
+
+#if LE_APP_LATENCY_ENABLE
+    /* Start the cycle counter before the stack delivers its first event */
+    le_app_latency_init();
+#endif
+
+#if LE_APP_TRACE_ENABLE
+    /* Clear the lifecycle trace before advertising starts */
+    le_app_trace_init();
+#endif
+
+#if LE_APP_EVT_REC_ENABLE
+    /* Record the stack events from the first one */
+    le_app_evt_rec_init();
+#endif
+
+    /* Load the bonds before the stack asks for the local identity keys */
+    if (WICED_BT_SUCCESS != le_app_bond_init())
+    {
+        printf("Bond store unavailable, bonds last until reset\r\n");
+    }
+
+    /* Register the deep sleep callbacks and the tickless idle wake up timer */
+    cy_result = le_app_pm_init();
+    if (CY_RSLT_SUCCESS != cy_result)
+    {
+        printf("Power manager initialization failed\r\n");
+        CY_ASSERT(0);
+    }
+
     /* Register call back and configuration with stack */
     wiced_result = wiced_bt_stack_init(le_app_management_callback, &cy_bt_cfg_settings);
     /* Check if stack initialization was successful */
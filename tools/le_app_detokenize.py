@@ -0,0 +1,211 @@
+#!/usr/bin/env python3
+"""Detokenizer for the tokenized log mode of the Find Me Target application.
+
+With TOKENIZED_LOG=1 the device replaces every LE_APP_LOG() format string, and
+every name logged with LE_APP_LOG_NAME(), with a 32-bit token. The strings are
+kept only in the non-allocated .le_app_log_fmt section of the ELF file. Each log
+entry is printed as one line:
+
+    $<base64 of: token (4 bytes, little endian), arguments (unsigned LEB128)>
+
+This tool builds the token dictionary from the ELF file and turns such lines
+back into text. Any other line is passed through unchanged.
+
+    python3 tools/le_app_detokenize.py build/APP_<TARGET>/Debug/<app>.elf < console.log
+    python3 tools/le_app_detokenize.py --dump build/APP_<TARGET>/Debug/<app>.elf
+    python3 tools/le_app_detokenize.py --header > le_app_log_token.h
+"""
+
+import argparse
+import base64
+import re
+import struct
+import sys
+
+SECTION = ".le_app_log_fmt"
+
+# Number of characters that contribute to a token; must match le_app_log_token.h
+HASH_LENGTH = 96
+HASH_COEFFICIENT = 65599
+MASK32 = 0xFFFFFFFF
+
+FORMAT_SPEC = re.compile(
+    r"%(?P<flags>[-+ #0]*)(?P<width>\d+)?(?:\.(?P<precision>\d+))?"
+    r"(?:hh|h|ll|l|j|z|t)?(?P<conversion>[diouxXcsp%])")
+
+
+def token_of(string):
+    """Returns the token of a string; the C side is LE_APP_LOG_TOKEN()."""
+    data = string.encode("latin-1")
+    token = len(data)
+    coefficient = HASH_COEFFICIENT
+    for char in data[:HASH_LENGTH]:
+        token = (token + coefficient * char) & MASK32
+        coefficient = (coefficient * HASH_COEFFICIENT) & MASK32
+    return token
+
+
+def read_section(path, name):
+    """Returns the contents of a section of a 32-bit little endian ELF file."""
+    with open(path, "rb") as elf:
+        data = elf.read()
+
+    if data[:4] != b"\x7fELF" or data[4] != 1 or data[5] != 1:
+        raise ValueError(f"{path} is not a 32-bit little endian ELF file")
+
+    shoff, = struct.unpack_from("<I", data, 0x20)
+    shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x2E)
+
+    def header(index):
+        # sh_name, sh_type, sh_flags, sh_addr, sh_offset, sh_size
+        return struct.unpack_from("<IIIIII", data, shoff + index * shentsize)
+
+    names_offset = header(shstrndx)[4]
+    for index in range(shnum):
+        sh_name, _, _, _, offset, size = header(index)
+        end = data.index(b"\0", names_offset + sh_name)
+        if data[names_offset + sh_name:end].decode() == name:
+            return data[offset:offset + size]
+
+    raise ValueError(f"{path} has no {name} section; was it built with TOKENIZED_LOG=1?")
+
+
+def load_dictionary(path):
+    """Maps every token in the ELF file to its string."""
+    dictionary = {}
+    for raw in read_section(path, SECTION).split(b"\0"):
+        if raw:
+            string = raw.decode("latin-1")
+            token = token_of(string)
+            if dictionary.get(token, string) != string:
+                print(f"warning: token 0x{token:08x} collides: {dictionary[token]!r} {string!r}",
+                      file=sys.stderr)
+            dictionary[token] = string
+    return dictionary
+
+
+def decode_arguments(payload):
+    """Decodes the unsigned LEB128 arguments that follow the token."""
+    arguments = []
+    value = shift = 0
+    for byte in payload:
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            arguments.append(value & MASK32)
+            value = shift = 0
+    return arguments
+
+
+def format_entry(dictionary, fmt, arguments):
+    """Formats a log entry like printf on the device would."""
+    arguments = list(arguments)
+
+    def convert(match):
+        conversion = match.group("conversion")
+        if conversion == "%":
+            return "%"
+        if not arguments:
+            return "<missing>"
+        value = arguments.pop(0)
+
+        spec = "%" + match.group("flags") + (match.group("width") or "")
+        if match.group("precision") is not None:
+            spec += "." + match.group("precision")
+
+        if conversion == "s":
+            return (spec + "s") % dictionary.get(value, f"${value:08x}")
+        if conversion in "di":
+            value -= (value & 0x80000000) << 1
+            return (spec + "d") % value
+        if conversion == "c":
+            return (spec + "c") % chr(value & 0xFF)
+        if conversion == "p":
+            return "0x%08x" % value
+        return (spec + conversion) % value
+
+    return FORMAT_SPEC.sub(convert, fmt)
+
+
+def detokenize_line(dictionary, line):
+    """Returns the text of a tokenized line, or the line itself."""
+    if not line.startswith("$"):
+        return line
+
+    try:
+        frame = base64.b64decode(line[1:].strip(), validate=True)
+    except ValueError:
+        return line
+    if len(frame) < 4:
+        return line
+
+    token, = struct.unpack_from("<I", frame)
+    fmt = dictionary.get(token)
+    if fmt is None:
+        return f"<unknown token 0x{token:08x}>\n"
+
+    text = format_entry(dictionary, fmt, decode_arguments(frame[4:]))
+    return text.replace("\r\n", "\n")
+
+
+def print_header():
+    """Prints le_app_log_token.h, which computes tokens at build time."""
+    coefficient = HASH_COEFFICIENT
+    terms = []
+    for index in range(HASH_LENGTH):
+        terms.append(f"    0x{coefficient:08x}u * LE_APP_LOG_TOKEN_CHAR(str, {index}u)")
+        coefficient = (coefficient * HASH_COEFFICIENT) & MASK32
+
+    print(f"""/* Generated by tools/le_app_detokenize.py --header. Do not edit.
+ *
+ * LE_APP_LOG_TOKEN(str) is the 65599 hash of a string literal, seeded with its
+ * length and taken over its first {HASH_LENGTH} characters. The compiler folds it into a
+ * constant, so no string is needed on the device to compute it. */
+#ifndef LE_APP_LOG_TOKEN_H_
+#define LE_APP_LOG_TOKEN_H_
+
+#include <stdint.h>
+
+#define LE_APP_LOG_TOKEN_HASH_LENGTH    ({HASH_LENGTH}u)
+
+#define LE_APP_LOG_TOKEN_CHAR(str, index) \\
+    ((uint32_t)(uint8_t)((sizeof(str) > (index)) ? (str)[index] : 0))
+
+/* str must be a string literal */
+#define LE_APP_LOG_TOKEN(str) ((uint32_t)(sizeof(str "") - 1u + \\""")
+    print(" + \\\n".join(terms) + "))")
+    print("""
+#endif /* LE_APP_LOG_TOKEN_H_ */
+
+/* [] END OF FILE */""")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", nargs="?", help="ELF file built with TOKENIZED_LOG=1")
+    parser.add_argument("log", nargs="?", type=argparse.FileType("r", errors="replace"),
+                        default=sys.stdin, help="console output (default: stdin)")
+    parser.add_argument("--dump", action="store_true", help="print the token dictionary")
+    parser.add_argument("--header", action="store_true", help="print le_app_log_token.h")
+    args = parser.parse_args()
+
+    if args.header:
+        print_header()
+        return 0
+    if args.elf is None:
+        parser.error("the ELF file is required")
+
+    dictionary = load_dictionary(args.elf)
+    if args.dump:
+        for token, string in sorted(dictionary.items()):
+            print(f"{token:08x} {string!r}")
+        return 0
+
+    for line in args.log:
+        sys.stdout.write(detokenize_line(dictionary, line))
+        sys.stdout.flush()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
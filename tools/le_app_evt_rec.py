@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+"""Decoder for the event record of the Find Me Target application.
+
+With EVENT_RECORD=1 the device records every management and GATT event the
+Bluetooth stack delivers, and le_app_evt_rec_dump() prints the trace as lines
+of hex bytes that start with '@'. This tool collects those lines from the
+console output, writes the binary trace, and prints the events with their
+payloads and the time between them.
+
+    python3 tools/le_app_evt_rec.py < console.log
+    python3 tools/le_app_evt_rec.py -o session.leer < console.log
+    python3 tools/le_app_evt_rec.py --binary session.leer
+
+Binary layout, all little endian:
+
+    file header: "LEER", version (1 byte), 3 reserved bytes,
+                 SystemCoreClock (4 bytes), dropped events (4 bytes)
+    record:      event (1 byte), kind (1 byte), payload length (2 bytes),
+                 RTOS time in ms (4 bytes), DWT->CYCCNT (4 bytes), payload
+
+The kind selects the payload layout below and must match le_app_evt_rec_kind_t.
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = b"LEER"
+VERSION = 1
+FILE_HDR = struct.Struct("<4sB3xII")
+RECORD_HDR = struct.Struct("<BBHII")
+
+# Gaps shorter than this are timed with the cycle counter, which wraps within seconds
+CYCLES_MAX_MS = 1000
+
+KIND_NAMES = [
+    "MGMT_OTHER",
+    "MGMT_ENABLED",
+    "MGMT_ADVERT_STATE",
+    "MGMT_CONN_PARAM_UPDATE",
+    "MGMT_PHY_UPDATE",
+    "MGMT_DATA_LENGTH_UPDATE",
+    "MGMT_PAIRING_COMPLETE",
+    "MGMT_ENCRYPTION_STATUS",
+    "MGMT_BD_ADDR",
+    "MGMT_KEYS",
+    "GATT_OTHER",
+    "GATT_CONNECTION_STATUS",
+    "GATT_ATTRIBUTE_REQUEST",
+    "GATT_BUFFER_REQUEST",
+]
+
+# Fixed payload fields per kind: (name, struct format). "6s" is a device address
+KIND_FIELDS = {
+    "MGMT_ENABLED": [("status", "I")],
+    "MGMT_ADVERT_STATE": [("mode", "B")],
+    "MGMT_CONN_PARAM_UPDATE": [("status", "B"), ("bd_addr", "6s"), ("conn_interval", "H"),
+                               ("conn_latency", "H"), ("supervision_timeout", "H")],
+    "MGMT_PHY_UPDATE": [("status", "B"), ("bd_addr", "6s"), ("tx_phy", "B"), ("rx_phy", "B")],
+    "MGMT_DATA_LENGTH_UPDATE": [("bd_addr", "6s"), ("max_tx_octets", "H"), ("max_tx_time", "H"),
+                                ("max_rx_octets", "H"), ("max_rx_time", "H")],
+    "MGMT_PAIRING_COMPLETE": [("bd_addr", "6s"), ("reason", "B")],
+    "MGMT_ENCRYPTION_STATUS": [("bd_addr", "6s"), ("result", "I")],
+    "MGMT_BD_ADDR": [("bd_addr", "6s")],
+    "GATT_CONNECTION_STATUS": [("conn_id", "H"), ("connected", "B"), ("reason", "H"),
+                               ("addr_type", "B"), ("transport", "B"), ("link_role", "B"),
+                               ("bd_addr", "6s")],
+    "GATT_ATTRIBUTE_REQUEST": [("conn_id", "H"), ("opcode", "B"), ("len_requested", "H")],
+    "GATT_BUFFER_REQUEST": [("len_requested", "H")],
+}
+
+# Attribute request opcodes (wiced_bt_gatt_opcode_t, from the Bluetooth Core specification)
+OPCODES = {
+    0x02: "MTU", 0x08: "READ_BY_TYPE", 0x0A: "READ", 0x0C: "READ_BLOB", 0x0E: "READ_MULTI",
+    0x12: "WRITE", 0x16: "PREPARE_WRITE", 0x18: "EXECUTE_WRITE", 0x1B: "NOTIF",
+    0x1E: "CONF", 0x20: "READ_MULTI_VAR_LENGTH", 0x52: "CMD_WRITE",
+}
+
+
+def read_console(stream):
+    """Returns the bytes of the '@' lines of a console log."""
+    data = bytearray()
+    for line in stream:
+        line = line.strip()
+        if line.startswith("@"):
+            data += bytes.fromhex(line[1:])
+    return bytes(data)
+
+
+def format_value(value):
+    if isinstance(value, bytes):
+        # Device addresses are stored as wiced_bt_device_address_t, most significant byte first
+        return ":".join(f"{b:02X}" for b in value)
+    return str(value)
+
+
+def decode_attribute_request(fields, payload):
+    """Decodes the opcode specific part of an attribute request."""
+    opcode = fields["opcode"]
+    name = OPCODES.get(opcode, f"0x{opcode:02X}")
+    fields["opcode"] = name
+
+    if name in ("READ", "READ_BLOB"):
+        fields["handle"], fields["offset"] = struct.unpack_from("<HH", payload)
+    elif name == "READ_BY_TYPE":
+        fields["s_handle"], fields["e_handle"], uuid_len = struct.unpack_from("<HHH", payload)
+        fields["uuid"] = payload[6:6 + uuid_len][::-1].hex().upper()
+    elif name in ("READ_MULTI", "READ_MULTI_VAR_LENGTH"):
+        num, = struct.unpack_from("<H", payload)
+        fields["handles"] = list(struct.unpack_from(f"<{num}H", payload, 2))
+    elif name in ("WRITE", "CMD_WRITE", "PREPARE_WRITE"):
+        fields["handle"], fields["offset"], val_len = struct.unpack_from("<HHH", payload)
+        fields["value"] = payload[6:6 + val_len].hex()
+    elif name == "EXECUTE_WRITE":
+        fields["exec_write"] = payload[0]
+    elif name == "MTU":
+        fields["remote_mtu"], = struct.unpack_from("<H", payload)
+
+
+def parse(data):
+    """Yields the file header fields, then one tuple per record."""
+    if len(data) < FILE_HDR.size:
+        raise ValueError("trace is shorter than its file header")
+
+    magic, version, core_clock, dropped = FILE_HDR.unpack_from(data)
+    if magic != MAGIC or version != VERSION:
+        raise ValueError(f"not a version {VERSION} event record")
+    yield core_clock, dropped
+
+    pos = FILE_HDR.size
+    while pos + RECORD_HDR.size <= len(data):
+        event, kind, length, time_ms, cycles = RECORD_HDR.unpack_from(data, pos)
+        pos += RECORD_HDR.size
+        yield event, kind, time_ms, cycles, data[pos:pos + length]
+        pos += length
+
+
+def elapsed_us(prev, time_ms, cycles, core_clock):
+    """Time since the previous record; the cycle counter wraps within seconds."""
+    prev_ms, prev_cycles = prev
+    delta_ms = (time_ms - prev_ms) & 0xFFFFFFFF
+    if delta_ms < CYCLES_MAX_MS and core_clock:
+        return ((cycles - prev_cycles) & 0xFFFFFFFF) * 1000000 // core_clock
+    return delta_ms * 1000
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--binary", metavar="FILE", help="read a binary trace instead of a console log")
+    parser.add_argument("-o", "--output", metavar="FILE", help="write the binary trace to FILE")
+    args = parser.parse_args()
+
+    if args.binary:
+        with open(args.binary, "rb") as trace:
+            data = trace.read()
+    else:
+        data = read_console(sys.stdin)
+
+    if args.output:
+        with open(args.output, "wb") as trace:
+            trace.write(data)
+
+    records = parse(data)
+    core_clock, dropped = next(records)
+    print(f"SystemCoreClock {core_clock} Hz, {dropped} events dropped")
+
+    prev = None
+    for event, kind, time_ms, cycles, payload in records:
+        kind_name = KIND_NAMES[kind] if kind < len(KIND_NAMES) else f"KIND_{kind}"
+        fields = {}
+        fmt = KIND_FIELDS.get(kind_name, [])
+        if fmt:
+            values = struct.unpack_from("<" + "".join(f for _, f in fmt), payload)
+            fields = dict(zip((n for n, _ in fmt), values))
+            if kind_name == "GATT_ATTRIBUTE_REQUEST":
+                decode_attribute_request(fields, payload[struct.calcsize("<HBH"):])
+
+        delta = "" if prev is None else f" +{elapsed_us(prev, time_ms, cycles, core_clock)} us"
+        prev = (time_ms, cycles)
+        print(" ".join([f"{time_ms} ms{delta} event 0x{event:02X} {kind_name}"] +
+                       [f"{k}={format_value(v)}" for k, v in fields.items()]))
+
+
+if __name__ == "__main__":
+    main()